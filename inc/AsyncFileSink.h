@@ -0,0 +1,230 @@
+// inc/AsyncFileSink.h
+#ifndef ASYNC_FILE_SINK_H
+#define ASYNC_FILE_SINK_H
+
+#include <array>   // For std::array
+#include <atomic>  // For std::atomic
+#include <cstddef> // For size_t
+#include <cstdint> // For uint8_t, uint32_t, uint64_t
+#include <memory>  // For std::unique_ptr
+#include <string>  // For std::string
+#include <thread>  // For std::thread
+#include <vector>  // For std::vector
+#include "../inc/Constants.h" // For ASYNC_SINK_* parameters
+#include "../inc/SpscRing.h"  // For SpscRing class
+#include "../inc/WakeSignal.h" // For WakeSignal class
+
+// Sink options
+const uint8_t ASYNC_SINK_DIRECT_IO = 0x01;          // Open the file with O_DIRECT, bypassing the page cache
+const uint8_t ASYNC_SINK_REGISTERED_BUFFERS = 0x02; // Register the buffers with io_uring (fixed-buffer writes)
+
+/**
+ * @brief How an AsyncFileSink performs its writes.
+ */
+enum class SinkBackend : uint8_t {
+    AUTO,        // io_uring if the kernel provides it, otherwise THREAD_POOL
+    IO_URING,    // Writes are submitted to an io_uring by the producing thread
+    THREAD_POOL  // Writes are handed to ASYNC_SINK_POOL_THREADS writer threads
+};
+
+/**
+ * @brief Converts a SinkBackend enum to a string.
+ * @param backend The backend to convert.
+ * @return The name of the backend.
+ */
+const char* toString(SinkBackend backend);
+
+/**
+ * @brief Append-only file writer that never blocks its producer on the disk.
+ * The producer copies records into one of ASYNC_SINK_BUFFER_COUNT page-aligned buffers of
+ * ASYNC_SINK_BUFFER_BYTES; a full buffer is written as one large write at its own file
+ * offset while the producer continues in the next. With io_uring the producer submits the
+ * write itself (one system call, no copy) and reaps completions on later calls; without it
+ * a small pool of writer threads performs blocking pwrite() calls instead, fed through
+ * lock-free rings. If every buffer is still being written, records are dropped and
+ * counted rather than blocking, like the event bus and the flight recorder do.
+ * With ASYNC_SINK_DIRECT_IO the writes bypass the page cache; the unaligned tail of a
+ * flush is carried over to the next buffer and the file is cut to its exact length on
+ * close(). Falls back to buffered writes where the file system rejects O_DIRECT.
+ * There must be a single producing thread per sink.
+ */
+class AsyncFileSink {
+public:
+    /**
+     * @brief Constructor for AsyncFileSink.
+     * The file is not opened until open() is called.
+     * @param path The file to write; truncated when opened.
+     * @param backend How the writes are performed.
+     * @param options Bit mask of ASYNC_SINK_* options.
+     */
+    explicit AsyncFileSink(const std::string& path, SinkBackend backend = SinkBackend::AUTO, uint8_t options = 0);
+
+    /**
+     * @brief Destructor. Closes the file after writing everything accepted.
+     */
+    ~AsyncFileSink();
+
+    AsyncFileSink(const AsyncFileSink&) = delete;
+    AsyncFileSink& operator=(const AsyncFileSink&) = delete;
+
+    /**
+     * @brief Opens the file and sets up the buffers and the backend.
+     * @return True on success, false if the file or the buffers could not be set up.
+     */
+    bool open();
+
+    /**
+     * @brief Appends a record (producer thread). Non-blocking.
+     * The record is stored contiguously in the file; it may span buffers.
+     * @param data The bytes to append.
+     * @param size Number of bytes.
+     * @return True if accepted, false if the sink is closed or the record was dropped for lack of free buffers.
+     */
+    bool write(const void* data, size_t size);
+
+    /**
+     * @brief Starts writing the partially filled buffer (producer thread). Non-blocking.
+     */
+    void flush();
+
+    /**
+     * @brief Writes everything accepted, waits for the writes and closes the file (producer thread).
+     */
+    void close();
+
+    /**
+     * @brief Checks whether the sink is open.
+     * @return True if open, false otherwise.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Gets the backend in use; AUTO is resolved when the sink is opened.
+     * @return The backend.
+     */
+    SinkBackend getBackend() const;
+
+    /**
+     * @brief Gets the options in effect, after any fallback on open.
+     * @return Bit mask of ASYNC_SINK_* options.
+     */
+    uint8_t getOptions() const;
+
+    /**
+     * @brief Gets the number of bytes accepted by write().
+     * @return Accepted bytes.
+     */
+    uint64_t getAcceptedBytes() const;
+
+    /**
+     * @brief Gets the number of bytes whose writes have completed (any thread).
+     * @return Written bytes, including the alignment padding of direct writes.
+     */
+    uint64_t getWrittenBytes() const;
+
+    /**
+     * @brief Gets the number of bytes dropped because every buffer was being written.
+     * @return Dropped bytes.
+     */
+    uint64_t getDroppedBytes() const;
+
+    /**
+     * @brief Gets the number of failed writes, including short writes whose remainder failed (any thread).
+     * @return Number of errors.
+     */
+    uint64_t getErrorCount() const;
+
+private:
+    struct UringQueue; // io_uring submission and completion rings, defined in AsyncFileSink.cpp
+
+    /**
+     * @brief One write buffer; owned by the producer until submitted, then by the backend.
+     */
+    struct SinkBuffer {
+        uint8_t* data = nullptr;          // ASYNC_SINK_BUFFER_BYTES, page-aligned
+        uint32_t used = 0;                // Bytes filled by the producer
+        uint32_t length = 0;              // Bytes of the submitted write
+        uint64_t offset = 0;              // File offset of the submitted write
+        uint32_t written = 0;             // io_uring: bytes of the submitted write completed so far
+        std::atomic<bool> busy{false};    // Submitted and not yet completed
+    };
+
+    /**
+     * @brief Hand-off ring of one pool writer thread.
+     */
+    struct PoolWorker {
+        SpscRing<uint32_t, ASYNC_SINK_BUFFER_COUNT> queue; // Indices of buffers to write
+        std::thread thread;                                // Writer thread
+        WakeSignal wakeUp;                                 // Signalled on every hand-off and on release
+    };
+
+    const std::string m_path;                 // The file to write
+    SinkBackend m_backend;                    // Backend in use
+    uint8_t m_options;                        // ASYNC_SINK_* options in effect
+    int m_fd;                                 // File descriptor, -1 while closed
+    void* m_memory;                           // Mapping of all buffers
+    std::array<SinkBuffer, ASYNC_SINK_BUFFER_COUNT> m_buffers; // Write buffers
+    int m_current;                            // Buffer the producer fills, -1 for none
+    uint32_t m_inFlight;                      // io_uring: submitted writes not yet reaped
+    uint32_t m_nextWorker;                    // Thread pool: worker of the next write
+    uint64_t m_fileOffset;                    // Offset of the next submitted write
+    uint64_t m_acceptedBytes;                 // Bytes accepted by write()
+    std::unique_ptr<UringQueue> m_uring;      // io_uring rings, null for the thread pool
+    std::vector<std::unique_ptr<PoolWorker>> m_workers; // Thread pool writers
+    std::atomic<bool> m_running;              // Pool writer threads should keep running
+    WakeSignal m_completed;                   // Signalled by the pool writers when a write completes
+    std::atomic<uint64_t> m_writtenBytes;     // Bytes of completed writes
+    std::atomic<uint64_t> m_droppedBytes;     // Bytes dropped on full buffers
+    std::atomic<uint64_t> m_errors;           // Failed writes
+
+    /**
+     * @brief Finds a free buffer other than the current one.
+     * @return Index of the buffer, -1 if every buffer is in use.
+     */
+    int findFreeBuffer() const;
+
+    /**
+     * @brief Counts the free buffers other than the current one.
+     * @return Number of free buffers.
+     */
+    uint32_t countFreeBuffers() const;
+
+    /**
+     * @brief Submits the filled part of the current buffer.
+     * @param final True on close: direct writes are padded to the alignment instead of carrying the tail over.
+     * @return True if submitted (or nothing to submit), false if the tail found no free buffer.
+     */
+    bool submitCurrent(bool final);
+
+    /**
+     * @brief Hands one buffer to the backend.
+     * @param index Index of the buffer, with length and offset set.
+     */
+    void submitBuffer(uint32_t index);
+
+    /**
+     * @brief Marks the buffers of completed io_uring writes free (producer thread).
+     * The remainder of a short write is submitted again first.
+     * @param wait True to block until at least one write completes.
+     */
+    void reapCompletions(bool wait);
+
+    /**
+     * @brief Writes one buffer with blocking pwrite() calls (pool writer thread).
+     * @param index Index of the buffer.
+     */
+    void writeBuffer(uint32_t index);
+
+    /**
+     * @brief Body of a pool writer thread.
+     * @param worker The worker's hand-off ring.
+     */
+    void poolLoop(PoolWorker* worker);
+
+    /**
+     * @brief Releases the backend, the buffers and the file descriptor.
+     */
+    void release();
+};
+
+#endif // ASYNC_FILE_SINK_H
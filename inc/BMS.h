@@ -3,19 +3,129 @@
 #define BMS_H
 
 #include <array>    // For std::array
+#include <cstdint>  // For uint32_t
+#include <memory>   // For std::unique_ptr
+#include <memory_resource> // For std::pmr::memory_resource
 #include <string>   // For std::string
+#include <vector>   // For std::vector
 #include "../inc/BatteryCell.h"   // For BatteryCell class
 #include "../inc/SensorSimulator.h" // For SensorSimulator class
 #include "../inc/SafetyManager.h"   // For SafetyManager class
+#include "../inc/SensorDiagnostics.h" // For SensorDiagnostics class
+#include "../inc/ResidencyHistogram.h" // For ResidencyHistogram class
+#include "../inc/EventBus.h"        // For EventBus class
+#include "../inc/Telemetry.h"       // For TelemetryChannels
+#include "../inc/Seqlock.h"         // For Seqlock class
+#include "../inc/ThermalManager.h"  // For ThermalManager class
+#include "../inc/CapacityEstimator.h" // For CapacityEstimatorState
+#include "../inc/CurrentAcquisition.h" // For CurrentAcquisition class
 #include "../inc/Constants.h"       // For NUM_CELLS
 
+class FlightRecorder; // Defined in FlightRecorder.h, which needs PackHotState
+
+/**
+ * @brief Energy and throughput figures of a single pack.
+ * Returned by BMS::getEnergyReport() and the batch fleet query BMS::queryFleetEnergy().
+ */
+struct EnergyReport {
+    double energyIn_Wh;             // Energy charged into the pack since start (Wh)
+    double energyOut_Wh;            // Energy discharged from the pack since start (Wh)
+    double throughput_Ah;           // Lifetime charge throughput, both directions (Ah)
+    double throughput_Wh;           // Lifetime energy throughput, both directions (Wh)
+    float averageDischargePower_W;  // Moving average of recent discharge power (W)
+    float remainingEnergy_Wh;       // Energy left until empty at nominal voltage (Wh)
+    float timeToEmpty_h;            // Time to empty at the average discharge power (hours), infinity if not discharging
+};
+
+/**
+ * @brief Estimator state of the BMS that must survive a restart.
+ * Written and read as a plain binary record by saveCheckpoint()/loadCheckpoint().
+ */
+struct BMSCheckpoint {
+    uint32_t magic;                 // Must be BMS_CHECKPOINT_MAGIC
+    uint32_t version;               // Must be BMS_CHECKPOINT_VERSION
+    float accumulatedCharge_mAh;
+    float stateOfCharge_percent;
+    float stateOfHealth_percent;
+    float chargeCycles;
+    bool wasFull;
+    bool wasEmpty;
+    float estimatedCapacity_mAh;
+    double capacitySumXX;           // Fit sums of the capacity estimator
+    double capacitySumXY;
+    double capacitySumYY;
+    double energyIn_Wh;
+    double energyOut_Wh;
+    double throughput_Ah;
+    double throughput_Wh;
+    float dischargePowerEwma_W;
+};
+
+/**
+ * @brief Copy of the BMS state published once per update for display threads.
+ * Plain data so it can be shared through a Seqlock.
+ */
+struct BmsSnapshot {
+    SystemState state;
+    float stateOfCharge_percent;
+    float stateOfHealth_percent;
+    float packCurrent_A;
+    float packVoltage_V;
+    bool charging;
+    std::array<float, NUM_CELLS> cellVoltages_V;
+    std::array<float, NUM_CELLS> cellTemperatures_C;
+};
+
+/**
+ * @brief Per-pack state read or written on every update (hot).
+ * Cache-line aligned, so in a fleet the hot states of neighbouring packs never share a
+ * cache line and a loop over many packs streams only these lines.
+ */
+struct alignas(64) PackHotState {
+    std::array<BatteryCell, NUM_CELLS> cells;                 // Latest reading of each cell
+    float packCurrent_A = 0.0f;                               // Total current of the battery pack
+    std::array<float, NUM_PARALLEL_STRINGS> stringCurrents_A = {}; // Current of each parallel string
+    float packVoltage_V = 0.0f;                               // Pack voltage from the independent channel
+    float accumulatedCharge_mAh = NOMINAL_CAPACITY_MAH * 0.5f; // Accumulated charge for SoC (start at 50% for simulation)
+    float chargeCompensation_mAh = 0.0f;                      // Rounding error of the accumulated charge (Kahan)
+    float stateOfCharge_percent = 50.0f;                      // Estimated State of Charge (%)
+    float stateOfHealth_percent = 100.0f;                     // Estimated State of Health (%)
+    float estimatedCapacity_mAh = NOMINAL_CAPACITY_MAH;       // Online capacity estimate the SoC is based on
+    bool charging = false;                                    // Battery is currently charging
+};
+
+/**
+ * @brief Per-pack estimator state that is updated every update but rarely read (warm).
+ * Cache-line aligned like PackHotState.
+ */
+struct alignas(64) PackWarmState {
+    double energyIn_Wh = 0.0;            // Energy charged into the pack
+    double energyOut_Wh = 0.0;           // Energy discharged from the pack
+    double throughput_Ah = 0.0;          // Lifetime charge throughput
+    double throughput_Wh = 0.0;          // Lifetime energy throughput
+    float dischargePowerEwma_W = 0.0f;   // Moving average of discharge power
+    float chargeCycles = 0.0f;           // Number of full charge cycles
+    bool wasFull = false;                // SoH cycle counting: was full in the current cycle
+    bool wasEmpty = false;               // SoH cycle counting: was empty in the current cycle
+    CapacityEstimatorState capacityEstimator; // Rest anchors and fit sums of the capacity estimate
+};
+
+const uint32_t BMS_CHECKPOINT_MAGIC = 0x434D5342u; // "BSMC" in little-endian byte order
+const uint32_t BMS_CHECKPOINT_VERSION = 2;
+
 /**
  * @brief Main Battery Management System class.
  * This class orchestrates the reading of sensor data,
  * evaluation of safety limits, and management of the system state.
  * It's designed to be hardware-agnostic by using an abstract sensor layer.
+ * Per-pack state is split by access frequency: the hot (PackHotState) and warm
+ * (PackWarmState) parts live outside the object, by default in storage the BMS owns,
+ * or in arrays of a fleet (see attachState()); the object itself keeps the cold part,
+ * i.e. the sensor simulator, the sub-modules and the configuration.
+ * The object is cache-line aligned, so packs laid out in an array (as in a fleet)
+ * never share a cache line with their neighbours.
  */
-class BMS {
+class alignas(64) BMS {
 public:
     /**
      * @brief Constructor for the BMS.
@@ -23,6 +133,14 @@ public:
      */
     BMS();
 
+    /**
+     * @brief Constructor for a BMS whose state lives in caller-provided memory, e.g. a fleet arena.
+     * @param hotState Storage for the hot state, or nullptr for storage owned by the BMS.
+     * @param warmState Storage for the warm state, or nullptr for storage owned by the BMS.
+     * @param memory Memory resource the sensor simulator's cell model is allocated from.
+     */
+    BMS(PackHotState* hotState, PackWarmState* warmState, std::pmr::memory_resource* memory);
+
     /**
      * @brief Initializes the BMS.
      * Performs any necessary setup for the system.
@@ -37,6 +155,84 @@ public:
      */
     void update(float deltaTime_s);
 
+    /**
+     * @brief Second phase of update(): runs the SoC, SoH and safety estimators on the readings and completes the update.
+     * Used after readCellSensors() by the fleet, which solves the string currents of many
+     * packs at once before reading their cells.
+     * @param deltaTime_s The time elapsed since the last update in seconds.
+     */
+    void updateFromReadings(float deltaTime_s);
+
+    /**
+     * @brief First phase of update(): reads the sensors and runs the residency histogram and thermal management.
+     * Reads the pack current, divides it between the strings and reads the cells under
+     * their strings' currents. Used with completeUpdate() by the fleet's pack-major mode,
+     * which runs the SoC, SoH and safety kernels for many packs between the two phases.
+     * @param deltaTime_s The time elapsed since the last update in seconds.
+     */
+    void readSensors(float deltaTime_s);
+
+    /**
+     * @brief Reads the pack current and gets the string model it divides by.
+     * First part of readSensors(); the fleet solves the string currents of a block of packs
+     * in one call between this and readCellSensors().
+     * @param stringOcv_V Receives the open-circuit voltage per string (NUM_PARALLEL_STRINGS entries).
+     * @param stringResistance_Ohm Receives the resistance per string (NUM_PARALLEL_STRINGS entries).
+     */
+    void readPackCurrent(float* stringOcv_V, float* stringResistance_Ohm);
+
+    /**
+     * @brief Reads the cells under their strings' currents and runs the residency histogram and thermal management.
+     * Second part of readSensors(), given the string currents solved for the pack current.
+     * @param stringCurrent_A Current per string (NUM_PARALLEL_STRINGS entries, positive for charge).
+     * @param deltaTime_s The time elapsed since the last update in seconds.
+     */
+    void readCellSensors(const float* stringCurrent_A, float deltaTime_s);
+
+    /**
+     * @brief Last phase of update(), given the results of the SoC, SoH and safety kernels.
+     * Publishes the cycle and threshold events, updates the energy counters and the sensor
+     * diagnostics, applies the proposed safety state and runs the state actions.
+     * @param deltaTime_s The time elapsed since the last update in seconds.
+     * @param previousSoC The SoC before the kernels ran (%).
+     * @param previousSoH The SoH before the kernels ran (%).
+     * @param cycleCompleted True if the SoH kernel counted a half cycle.
+     * @param proposedState The state proposed by the safety kernel.
+     */
+    void completeUpdate(float deltaTime_s, float previousSoC, float previousSoH, bool cycleCompleted, SystemState proposedState);
+
+    /**
+     * @brief Coulomb counting kernel, vectorized across packs (pack-major arrays).
+     * updateSoC() runs the same loop for a single pack without high-rate current acquisition,
+     * so both paths give bit-identical results.
+     * @param packCount Number of packs.
+     * @param packCurrent_A Pack current of each pack.
+     * @param deltaTime_s The time elapsed since the last update in seconds.
+     * @param capacity_mAh Estimated capacity of each pack.
+     * @param accumulatedCharge_mAh Accumulated charge of each pack, updated.
+     * @param chargeCompensation_mAh Rounding compensation of each accumulated charge, updated.
+     * @param stateOfCharge_percent Output, SoC of each pack.
+     */
+    static void integrateStateOfCharge(size_t packCount, const float* packCurrent_A, float deltaTime_s,
+                                       const float* capacity_mAh, float* accumulatedCharge_mAh, float* chargeCompensation_mAh,
+                                       float* stateOfCharge_percent);
+
+    /**
+     * @brief Cycle counting and SoH kernel, vectorized across packs (pack-major arrays).
+     * updateSoH() runs the same loop for a single pack, so both paths give bit-identical results.
+     * @param packCount Number of packs.
+     * @param stateOfCharge_percent SoC of each pack.
+     * @param capacity_mAh Estimated capacity of each pack.
+     * @param wasFull Cycle flag of each pack (0 or 1), updated.
+     * @param wasEmpty Cycle flag of each pack (0 or 1), updated.
+     * @param chargeCycles Charge cycles of each pack, updated.
+     * @param stateOfHealth_percent Output, SoH of each pack.
+     * @param cycleCompleted Output, 1 for each pack that completed a half cycle, else 0.
+     */
+    static void countChargeCycles(size_t packCount, const float* stateOfCharge_percent, const float* capacity_mAh,
+                                  uint8_t* wasFull, uint8_t* wasEmpty, float* chargeCycles, float* stateOfHealth_percent,
+                                  uint8_t* cycleCompleted);
+
     /**
      * @brief Gets the current safety state of the BMS.
      * @return The current SystemState.
@@ -55,56 +251,245 @@ public:
      */
     float getSoH() const;
 
+    /**
+     * @brief Gets the online estimate of the pack capacity.
+     * @return Capacity in mAh.
+     */
+    float getEstimatedCapacity_mAh() const;
+
     /**
      * @brief Gets the current total pack current.
      * @return Current in Amperes (positive for charge, negative for discharge).
      */
     float getPackCurrent() const;
 
+    /**
+     * @brief Gets the current of one parallel string.
+     * @param stringIndex The index of the string (0 to NUM_PARALLEL_STRINGS - 1).
+     * @return Current in Amperes (positive for charge, negative for discharge).
+     */
+    float getStringCurrent(uint8_t stringIndex) const;
+
+    /**
+     * @brief Gets the latest readings of all cells.
+     * @return Reference to the array of BatteryCell objects.
+     */
+    const std::array<BatteryCell, NUM_CELLS>& getCells() const;
+
+    /**
+     * @brief Gets the pack voltage measured by the independent pack-voltage channel.
+     * @return Pack voltage in Volts.
+     */
+    float getPackVoltage() const;
+
+    /**
+     * @brief Fills the telemetry channels with the latest readings and estimates.
+     * @param channels Receives the values in the telemetry channel layout.
+     */
+    void getTelemetryChannels(TelemetryChannels& channels) const;
+
+    /**
+     * @brief Gets the sensor plausibility diagnostics.
+     * @return Reference to the SensorDiagnostics object.
+     */
+    const SensorDiagnostics& getSensorDiagnostics() const;
+
+    /**
+     * @brief Gets the internal resistance (R0) of every cell.
+     * @return Resistances in Ohms, one per cell, as sampled or applied by loadCellParameters().
+     */
+    const std::pmr::vector<float>& getCellResistances_Ohm() const;
+
+    /**
+     * @brief Gets the thermal management subsystem.
+     * @return Reference to the ThermalManager object.
+     */
+    const ThermalManager& getThermalManager() const;
+
+    /**
+     * @brief Enables or disables thermal preconditioning for an upcoming charge.
+     * @param enabled True to bring the cells into the charging temperature window.
+     */
+    void setPreconditioning(bool enabled);
+
+    /**
+     * @brief Gets the per-cell voltage/temperature residency histograms.
+     * @return Reference to the ResidencyHistogram object.
+     */
+    const ResidencyHistogram& getResidencyHistogram() const;
+
+    /**
+     * @brief Enables or disables all console output of this BMS and its sub-modules.
+     * @param enabled True to print (default), false to stay silent.
+     */
+    void setConsoleOutput(bool enabled);
+
+    /**
+     * @brief Attaches the event bus that state transitions, faults, cycle increments,
+     * threshold crossings and log messages are published to.
+     * @param eventBus The bus to publish to, or nullptr to detach.
+     */
+    void attachEventBus(EventBus* eventBus);
+
+    /**
+     * @brief Attaches the seqlock a BmsSnapshot is published to at the end of every update.
+     * @param snapshot The seqlock to write to, or nullptr to detach.
+     */
+    void attachSnapshot(Seqlock<BmsSnapshot>* snapshot);
+
+    /**
+     * @brief Attaches the high-rate current acquisition the pack current is measured with.
+     * @param acquisition The acquisition to drain every update, or nullptr to detach.
+     */
+    void attachCurrentAcquisition(CurrentAcquisition* acquisition);
+
+    /**
+     * @brief Attaches the flight recorder every update is recorded to and faults trigger.
+     * @param recorder The recorder (not owned), or nullptr to detach.
+     */
+    void attachFlightRecorder(FlightRecorder* recorder);
+
+    /**
+     * @brief Gets the energy and throughput figures of the pack.
+     * @return EnergyReport with the current counters and range estimate.
+     */
+    EnergyReport getEnergyReport() const;
+
+    /**
+     * @brief Fills one EnergyReport per pack for a whole fleet.
+     * Reuses the capacity of the reports vector, so repeated queries do not allocate.
+     * @param packs The packs to query, stored contiguously (e.g. in the fleet arena).
+     * @param packCount Number of packs.
+     * @param reports Output vector, resized to packCount.
+     */
+    static void queryFleetEnergy(const BMS* packs, size_t packCount, std::vector<EnergyReport>& reports);
+
+    /**
+     * @brief Captures the estimator state for persistence.
+     * @return BMSCheckpoint holding SoC, SoH, cycle and energy counters.
+     */
+    BMSCheckpoint getCheckpoint() const;
+
+    /**
+     * @brief Restores the estimator state from a checkpoint.
+     * A checkpoint of another format, or with a value that is not finite or out of range, is
+     * rejected as a whole and the state keeps its defaults.
+     * @param checkpoint The checkpoint to restore.
+     * @return True if the checkpoint was valid and applied, false otherwise.
+     */
+    bool restoreCheckpoint(const BMSCheckpoint& checkpoint);
+
+    /**
+     * @brief Writes the estimator state to a checkpoint file.
+     * @param path The file to write.
+     * @return True on success, false otherwise.
+     */
+    bool saveCheckpoint(const std::string& path) const;
+
+    /**
+     * @brief Reads the estimator state from a checkpoint file.
+     * @param path The file to read.
+     * @return True if a valid checkpoint was read and applied, false otherwise.
+     */
+    bool loadCheckpoint(const std::string& path);
+
+    /**
+     * @brief Applies identified cell parameters from a file written by EcmIdentifier.
+     * @param path The parameter file to read.
+     * @return True if parameters for every cell were read and applied, false otherwise.
+     */
+    bool loadCellParameters(const std::string& path);
+
     /**
      * @brief Checks if the battery is currently charging.
      * @return True if charging, false otherwise.
      */
     bool isCharging() const;
 
+    /**
+     * @brief Moves the hot and warm state into storage provided by the caller, e.g. a fleet arena.
+     * @param hotState Storage for the hot state; must outlive the BMS or the next attachState().
+     * @param warmState Storage for the warm state; must outlive the BMS or the next attachState().
+     * @return True on success, false if a storage pointer is null.
+     */
+    bool attachState(PackHotState* hotState, PackWarmState* warmState);
+
+    /**
+     * @brief Gets the hot state of the pack.
+     * @return Reference to the hot state.
+     */
+    const PackHotState& getHotState() const;
+
+    /**
+     * @brief Gets the warm state of the pack.
+     * @return Reference to the warm state.
+     */
+    const PackWarmState& getWarmState() const;
+
 private:
     SensorSimulator m_sensorSimulator;      // Object for simulating sensor readings
     SafetyManager m_safetyManager;          // Object for managing safety states
-    std::array<BatteryCell, NUM_CELLS> m_cells; // Array to hold data for each battery cell
+    ThermalManager m_thermalManager;        // Closed-loop cooling and heating
+    SensorDiagnostics m_sensorDiagnostics;  // Object for detecting sensor faults
+    ResidencyHistogram m_residencyHistogram; // Time-at-voltage/temperature counters for warranty data
 
-    float m_packCurrent;                // Total current of the battery pack (Amperes)
-    float m_accumulatedCharge_mAh;      // Accumulated charge in mAh for SoC calculation
-    float m_stateOfCharge_percent;      // Estimated State of Charge (%)
-    float m_stateOfHealth_percent;      // Estimated State of Health (%)
-    float m_chargeCycles;               // Number of full charge cycles
-    bool m_wasFull;                     // Flag for SoH cycle counting (was full in previous cycle)
-    bool m_wasEmpty;                    // Flag for SoH cycle counting (was empty in previous cycle)
-    bool m_isChargingFlag;              // Flag indicating if the battery is currently charging
+    PackHotState* m_hot;                // Hot state (owned storage or attached)
+    PackWarmState* m_warm;              // Warm state (owned storage or attached)
+    std::unique_ptr<PackHotState> m_ownedHotState;   // Own storage until attachState() is called
+    std::unique_ptr<PackWarmState> m_ownedWarmState; // Own storage until attachState() is called
+    bool m_consoleOutput;               // Print readings and status to the console
+    EventBus* m_eventBus;               // Bus events are published to (not owned, may be null)
+    Seqlock<BmsSnapshot>* m_snapshot;   // Seqlock snapshots are published to (not owned, may be null)
+    CurrentAcquisition* m_currentAcquisition; // High-rate current acquisition (not owned, may be null)
+    DecimatedCurrent m_currentInterval; // Current over the last update from the acquisition
+    FlightRecorder* m_flightRecorder;   // Freeze-frame capture around faults (not owned, may be null)
 
     /**
      * @brief Updates the State of Charge (SoC) using Coulomb counting.
+     * With the high-rate acquisition, the charge drained from it is counted as it is.
      * @param deltaTime_s The time elapsed since the last update in seconds.
      */
     void updateSoC(float deltaTime_s);
 
     /**
      * @brief Updates the State of Health (SoH) using a simplified cycle count.
+     * @return True if a half cycle was completed (the caller publishes CYCLE_INCREMENT).
+     */
+    bool updateSoH();
+
+    /**
+     * @brief Updates the energy and throughput counters.
+     * @param deltaTime_s The time elapsed since the last update in seconds.
+     */
+    void updateEnergy(float deltaTime_s);
+
+    /**
+     * @brief Publishes an event on the attached event bus, if any.
+     * @param event The event to publish.
+     */
+    void publishEvent(const BmsEvent& event);
+
+    /**
+     * @brief Publishes THRESHOLD_CROSSING events for SoC and SoH thresholds crossed this update.
+     * @param previousSoC The SoC before this update (%).
+     * @param previousSoH The SoH before this update (%).
      */
-    void updateSoH();
+    void publishThresholdCrossings(float previousSoC, float previousSoH);
 
     /**
-     * @brief Logs an event or message to the console.
-     * In a real system, this would write to a log file or send over a comms bus.
-     * @param message The message to log.
+     * @brief Publishes a log message as a LOG event.
+     * Subscribers on the event bus decide where it goes (console, file, comms bus).
+     * The message is formatted straight into the event text, and only if a bus is attached.
+     * @param format printf-style format of the message, followed by its arguments.
      */
-    void logEvent(const std::string& message);
+    void logEvent(const char* format, ...);
 
     /**
-     * @brief Handles a detected fault.
-     * In a real system, this would trigger specific safety actions (e.g., shutdown, isolation).
+     * @brief Handles a detected fault by publishing a FAULT event.
+     * Subscribers such as contactor control trigger the safety actions (e.g., shutdown, isolation).
      * @param faultDescription A description of the fault.
      */
-    void handleFault(const std::string& faultDescription);
+    void handleFault(const char* faultDescription);
 };
 
 #endif // BMS_H
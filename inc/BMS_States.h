@@ -20,4 +20,19 @@ enum class SystemState {
     FAULT
 };
 
+/**
+ * @brief Gets the name of a system state for display and logging.
+ * @param state The state to name.
+ * @return The state name, e.g. "NORMAL".
+ */
+inline const char* toString(SystemState state) {
+    switch (state) {
+        case SystemState::NORMAL:   return "NORMAL";
+        case SystemState::WARNING:  return "WARNING";
+        case SystemState::CRITICAL: return "CRITICAL";
+        case SystemState::FAULT:    return "FAULT";
+    }
+    return "UNKNOWN";
+}
+
 #endif // BMS_STATES_H
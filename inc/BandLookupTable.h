@@ -0,0 +1,102 @@
+// inc/BandLookupTable.h
+#ifndef BAND_LOOKUP_TABLE_H
+#define BAND_LOOKUP_TABLE_H
+
+#include <cstddef>   // For size_t
+#include <cstdint>   // For uint8_t, uint16_t, int16_t
+#include <vector>    // For std::vector
+#include "../inc/BMS_States.h"    // For SystemState enum
+#include "../inc/Constants.h"     // For the default limits and ADC resolutions
+
+/**
+ * @brief Limits of one measured quantity, from the normal band outwards.
+ * A value is in the WARNING band between the normal and warning limits, in the CRITICAL
+ * band between the warning and critical limits and in the FAULT band beyond the fault
+ * limits. Like SafetyManager, a value between a critical and a fault limit is in no band
+ * and classifies as NORMAL.
+ */
+struct BandLimits {
+    float minNormal;
+    float minWarning;
+    float minCritical;
+    float minFault;
+    float maxNormal;
+    float maxWarning;
+    float maxCritical;
+    float maxFault;
+};
+
+/**
+ * @brief Band limits the lookup tables are built from.
+ * Defaults are the cell voltage and temperature limits from Constants.h.
+ */
+struct BandThresholds {
+    BandLimits voltage_V = {MIN_VOLTAGE_NORMAL, MIN_VOLTAGE_WARNING, MIN_VOLTAGE_CRITICAL, MIN_VOLTAGE_FAULT,
+                            MAX_VOLTAGE_NORMAL, MAX_VOLTAGE_WARNING, MAX_VOLTAGE_CRITICAL, MAX_VOLTAGE_FAULT};
+    BandLimits temperature_C = {MIN_TEMP_NORMAL, MIN_TEMP_WARNING, MIN_TEMP_CRITICAL, MIN_TEMP_FAULT,
+                                MAX_TEMP_NORMAL, MAX_TEMP_WARNING, MAX_TEMP_CRITICAL, MAX_TEMP_FAULT};
+};
+
+/**
+ * @brief Classifies raw ADC codes of cell voltages and temperatures into safety bands.
+ * Instead of evaluating the chained range predicates per reading, the band of every
+ * possible code is computed once: one table for the unsigned 16-bit voltage codes
+ * (ADC_VOLTAGE_LSB_V per code) and one for the signed 16-bit temperature codes
+ * (ADC_TEMPERATURE_LSB_C per code). A classification is then a single byte load.
+ * The tables hold 64 KiB each and must be rebuilt when the limits change.
+ */
+class BandLookupTable {
+public:
+    /**
+     * @brief Constructor for BandLookupTable.
+     * Builds the tables from the given limits.
+     * @param thresholds The band limits.
+     */
+    explicit BandLookupTable(const BandThresholds& thresholds = BandThresholds());
+
+    /**
+     * @brief Recomputes both tables, e.g. after the limits have been reconfigured.
+     * @param thresholds The new band limits.
+     */
+    void rebuild(const BandThresholds& thresholds);
+
+    /**
+     * @brief Classifies a cell voltage code.
+     * @param code Voltage in units of ADC_VOLTAGE_LSB_V.
+     * @return The band of the voltage.
+     */
+    SystemState classifyVoltage(uint16_t code) const {
+        return static_cast<SystemState>(m_voltageBands[code]);
+    }
+
+    /**
+     * @brief Classifies a cell temperature code.
+     * @param code Temperature in units of ADC_TEMPERATURE_LSB_C.
+     * @return The band of the temperature.
+     */
+    SystemState classifyTemperature(int16_t code) const {
+        return static_cast<SystemState>(m_temperatureBands[static_cast<uint16_t>(code)]);
+    }
+
+    /**
+     * @brief Classifies the readings of several cells and returns the most severe band.
+     * @param voltageCodes Voltage codes, one per cell.
+     * @param temperatureCodes Temperature codes, one per cell.
+     * @param cellCount Number of cells.
+     * @return The most severe band of all readings (NORMAL for no cells).
+     */
+    SystemState classifyCells(const uint16_t* voltageCodes, const int16_t* temperatureCodes, size_t cellCount) const;
+
+    /**
+     * @brief Gets the limits the tables were built from.
+     * @return The band limits.
+     */
+    const BandThresholds& getThresholds() const;
+
+private:
+    BandThresholds m_thresholds;             // Limits of the current tables
+    std::vector<uint8_t> m_voltageBands;     // Band (SystemState value) per voltage code
+    std::vector<uint8_t> m_temperatureBands; // Band per temperature code, indexed by the code's bit pattern
+};
+
+#endif // BAND_LOOKUP_TABLE_H
@@ -0,0 +1,64 @@
+// inc/CapacityEstimator.h
+#ifndef CAPACITY_ESTIMATOR_H
+#define CAPACITY_ESTIMATOR_H
+
+#include <array>   // For std::array
+#include "../inc/BatteryCell.h" // For BatteryCell class
+#include "../inc/Constants.h"   // For NUM_CELLS and CAPACITY_* parameters
+
+/**
+ * @brief Per-pack state of the online capacity estimator; constant size, plain data.
+ * Starts with the prior at NOMINAL_CAPACITY_MAH and no anchor.
+ */
+struct CapacityEstimatorState {
+    // Faded sums of the anchor pairs (x = SoC change, y = charge in mAh), seeded with the prior
+    double sumXX = CAPACITY_PRIOR_DELTA_SOC * CAPACITY_PRIOR_DELTA_SOC;
+    double sumXY = CAPACITY_PRIOR_DELTA_SOC * CAPACITY_PRIOR_DELTA_SOC * NOMINAL_CAPACITY_MAH;
+    double sumYY = CAPACITY_PRIOR_DELTA_SOC * CAPACITY_PRIOR_DELTA_SOC * NOMINAL_CAPACITY_MAH * NOMINAL_CAPACITY_MAH;
+    double chargeSinceAnchor_mAh = 0.0; // Charge counted since the last anchor
+    float restTime_s = 0.0f;            // Time the current has been below IDLE_CURRENT_THRESHOLD_A
+    float anchorSoc = -1.0f;            // SoC of the last anchor (0.0 to 1.0), negative if none
+    float restSoc = -1.0f;              // SoC of the latest rested reading, negative if not rested
+};
+
+/**
+ * @brief Online estimation of the pack capacity from charge throughput between rest anchors.
+ * When the pack has rested for CAPACITY_REST_MIN_S, its cell voltages are open-circuit
+ * voltages and give the SoC independently of the Coulomb counter; the last rested SoC
+ * before current flows again becomes an anchor. The charge counted between two anchors
+ * and their SoC difference form one observation of the capacity. Both are noisy (current
+ * sensor and OCV), so the capacity is the total-least-squares fit through all
+ * observations, which needs only three faded sums; the fit is in closed form and the
+ * state per pack stays constant. Each update costs a few operations; a fit runs only
+ * when an anchor is taken.
+ */
+class CapacityEstimator {
+public:
+    /**
+     * @brief Advances the estimator by one update.
+     * @param state The pack's estimator state.
+     * @param cells The latest readings.
+     * @param packCurrent_A Pack current (positive for charge).
+     * @param deltaTime_s The time elapsed since the last update in seconds.
+     * @param capacity_mAh The capacity estimate, updated when an anchor pair is taken.
+     * @return True if the capacity estimate changed, false otherwise.
+     */
+    static bool update(CapacityEstimatorState& state, const std::array<BatteryCell, NUM_CELLS>& cells,
+                       float packCurrent_A, float deltaTime_s, float& capacity_mAh);
+
+    /**
+     * @brief Converts a rested cell voltage to SoC with the OCV curve.
+     * @param openCircuitVoltage_V Cell voltage at rest.
+     * @return SoC (0.0 to 1.0).
+     */
+    static float socFromOpenCircuitVoltage(float openCircuitVoltage_V);
+
+    /**
+     * @brief Computes the total-least-squares capacity from the faded sums.
+     * @param state The estimator state.
+     * @return Capacity in mAh, or 0 if the sums hold no usable observation.
+     */
+    static float fitCapacity_mAh(const CapacityEstimatorState& state);
+};
+
+#endif // CAPACITY_ESTIMATOR_H
@@ -0,0 +1,291 @@
+// inc/CellKernels.h
+#ifndef CELL_KERNELS_H
+#define CELL_KERNELS_H
+
+#include <array>       // For std::array
+#include <cmath>       // For std::fabs
+#include <cstddef>     // For size_t
+#include <cstdint>     // For uint16_t, uint32_t
+#include <type_traits> // For std::conditional
+#include <utility>     // For std::index_sequence
+#include "../inc/BatteryCell.h" // For BatteryCell class
+#include "../inc/Constants.h"   // For the voltage and temperature limits
+
+// Condition flags of the safety classification. Flags of several cells are combined with a
+// bitwise OR, which vectorizes where a maximum over state values would not, and the most
+// severe flag set decides the state. Flags are 32 bits wide like the readings, so the
+// vectorized loops need no packing or unpacking between lane widths.
+const uint32_t SAFETY_FLAG_WARNING = 0x01;
+const uint32_t SAFETY_FLAG_CRITICAL = 0x02;
+const uint32_t SAFETY_FLAG_FAULT = 0x04;
+
+/**
+ * @brief Classifies a cell voltage without branches.
+ * The bands are half-open as in the current and SoH checks of SafetyManager, so NaN readings
+ * and values between the bands (e.g. a voltage between MIN_VOLTAGE_FAULT and
+ * MIN_VOLTAGE_CRITICAL) raise no flag.
+ * @param voltage The voltage to classify.
+ * @return Condition flags (0 for normal).
+ */
+inline uint32_t cellVoltageFlags(float voltage) {
+    uint32_t warning = ((voltage >= MIN_VOLTAGE_WARNING) & (voltage < MIN_VOLTAGE_NORMAL))
+                 | ((voltage > MAX_VOLTAGE_NORMAL) & (voltage <= MAX_VOLTAGE_WARNING));
+    uint32_t critical = ((voltage >= MIN_VOLTAGE_CRITICAL) & (voltage < MIN_VOLTAGE_WARNING))
+                  | ((voltage > MAX_VOLTAGE_WARNING) & (voltage <= MAX_VOLTAGE_CRITICAL));
+    uint32_t fault = (voltage < MIN_VOLTAGE_FAULT) | (voltage > MAX_VOLTAGE_FAULT);
+    return warning * SAFETY_FLAG_WARNING | critical * SAFETY_FLAG_CRITICAL | fault * SAFETY_FLAG_FAULT;
+}
+
+/**
+ * @brief Classifies a cell temperature without branches.
+ * @param temperature The temperature to classify.
+ * @return Condition flags (0 for normal).
+ */
+inline uint32_t cellTemperatureFlags(float temperature) {
+    uint32_t warning = ((temperature >= MIN_TEMP_WARNING) & (temperature < MIN_TEMP_NORMAL))
+                 | ((temperature > MAX_TEMP_NORMAL) & (temperature <= MAX_TEMP_WARNING));
+    uint32_t critical = ((temperature >= MIN_TEMP_CRITICAL) & (temperature < MIN_TEMP_WARNING))
+                  | ((temperature > MAX_TEMP_WARNING) & (temperature <= MAX_TEMP_CRITICAL));
+    uint32_t fault = (temperature < MIN_TEMP_FAULT) | (temperature > MAX_TEMP_FAULT);
+    return warning * SAFETY_FLAG_WARNING | critical * SAFETY_FLAG_CRITICAL | fault * SAFETY_FLAG_FAULT;
+}
+
+/**
+ * @brief Minimum, maximum and sum of the cell readings of one pack.
+ */
+struct CellStatistics {
+    float minVoltage_V;
+    float maxVoltage_V;
+    float sumVoltage_V;
+    float minTemperature_C;
+    float maxTemperature_C;
+};
+
+/**
+ * @brief Per-cell loops of one pack for a cell count known at compile time.
+ * Readings are passed as plain arrays (voltages and temperatures separately). Every loop
+ * runs over N / LANES chunks of LANES independent lanes with a fixed trip count, like the
+ * block kernels elsewhere; the chunks of the accumulating loops are unrolled completely
+ * (see forEachChunk()) and the lanes of a chunk vectorize without a remainder loop. LANES
+ * is 8 where it divides N, else 4, else 1.
+ * Sums are accumulated per lane and the lanes added in order; for single-chunk packs this is
+ * the sequential sum, for larger packs it differs from it by rounding only. The minimum and
+ * maximum compare like std::min / std::max, which skip a NaN reading unless it is the first
+ * value seen, so with several lanes it can depend on the position of a NaN whether it shows.
+ * @tparam N Number of cells.
+ */
+template <size_t N>
+struct CellKernels {
+    static const size_t LANES = N % 8 == 0 ? 8 : (N % 4 == 0 ? 4 : 1);
+    // Lanes of the statistics: a pack of a single chunk has nothing to accumulate across
+    // chunks, and the scalar minimum / maximum chains beat a vector load plus lane reduction
+    static const size_t STATISTICS_LANES = N > LANES ? LANES : 1;
+
+    /**
+     * @brief Calls a chunk body once per chunk index, fully unrolled at compile time.
+     * With every lane index a constant, the lane accumulators live in registers instead of
+     * on the stack, where the vector stores and scalar reloads of a rolled loop stall.
+     * @tparam STRIDE Number of cells per chunk.
+     * @param body Called with the offset of each chunk (C * STRIDE).
+     */
+    template <size_t STRIDE, typename Body, size_t... C>
+    static void forEachChunk(Body body, std::index_sequence<C...>) {
+        static_cast<void>(body); // Unused when there are no chunks
+        (body(C * STRIDE), ...);
+    }
+
+    /**
+     * @brief Copies the readings of the cells into plain arrays.
+     * @param cells The cells.
+     * @param voltages Output, N voltages.
+     * @param temperatures Output, N temperatures.
+     */
+    static void gather(const std::array<BatteryCell, N>& cells, float* voltages, float* temperatures) {
+        for (size_t i = 0; i < N; ++i) {
+            voltages[i] = cells[i].getVoltage();
+            temperatures[i] = cells[i].getTemperature();
+        }
+    }
+
+    /**
+     * @brief Safety condition flags of all cells, combined.
+     * @param voltages N cell voltages.
+     * @param temperatures N cell temperatures.
+     * @return OR of the SAFETY_FLAG_* flags of every cell.
+     */
+    static uint32_t safetyFlags(const float* __restrict voltages, const float* __restrict temperatures) {
+        uint32_t flags[LANES] = {};
+        forEachChunk<LANES>([&](size_t i) {
+            const float* chunkVoltages = voltages + i;
+            const float* chunkTemperatures = temperatures + i;
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                flags[lane] |= cellVoltageFlags(chunkVoltages[lane]) | cellTemperatureFlags(chunkTemperatures[lane]);
+            }
+        }, std::make_index_sequence<N / LANES>());
+        uint32_t combined = 0;
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            combined |= flags[lane];
+        }
+        return combined;
+    }
+
+    /**
+     * @brief Minimum, maximum and sum of the cell readings.
+     * @param voltages N cell voltages.
+     * @param temperatures N cell temperatures.
+     * @return The statistics.
+     */
+    static CellStatistics statistics(const float* __restrict voltages, const float* __restrict temperatures) {
+        const size_t lanes = STATISTICS_LANES;
+        float minVoltage[lanes], maxVoltage[lanes], sumVoltage[lanes], minTemperature[lanes], maxTemperature[lanes];
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            minVoltage[lane] = voltages[lane];
+            maxVoltage[lane] = voltages[lane];
+            sumVoltage[lane] = voltages[lane];
+            minTemperature[lane] = temperatures[lane];
+            maxTemperature[lane] = temperatures[lane];
+        }
+        forEachChunk<lanes>([&](size_t i) {
+            const float* chunkVoltages = voltages + lanes + i;
+            const float* chunkTemperatures = temperatures + lanes + i;
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                float voltage = chunkVoltages[lane];
+                float temperature = chunkTemperatures[lane];
+                minVoltage[lane] = voltage < minVoltage[lane] ? voltage : minVoltage[lane];
+                maxVoltage[lane] = voltage > maxVoltage[lane] ? voltage : maxVoltage[lane];
+                sumVoltage[lane] += voltage;
+                minTemperature[lane] = temperature < minTemperature[lane] ? temperature : minTemperature[lane];
+                maxTemperature[lane] = temperature > maxTemperature[lane] ? temperature : maxTemperature[lane];
+            }
+        }, std::make_index_sequence<N / lanes - 1>());
+        CellStatistics statistics = {minVoltage[0], maxVoltage[0], sumVoltage[0], minTemperature[0], maxTemperature[0]};
+        for (size_t lane = 1; lane < lanes; ++lane) {
+            statistics.minVoltage_V = minVoltage[lane] < statistics.minVoltage_V ? minVoltage[lane] : statistics.minVoltage_V;
+            statistics.maxVoltage_V = maxVoltage[lane] > statistics.maxVoltage_V ? maxVoltage[lane] : statistics.maxVoltage_V;
+            statistics.sumVoltage_V += sumVoltage[lane];
+            statistics.minTemperature_C = minTemperature[lane] < statistics.minTemperature_C ? minTemperature[lane] : statistics.minTemperature_C;
+            statistics.maxTemperature_C = maxTemperature[lane] > statistics.maxTemperature_C ? maxTemperature[lane] : statistics.maxTemperature_C;
+        }
+        return statistics;
+    }
+
+    /**
+     * @brief Persistence filter: counts consecutive readings within epsilon of the previous one.
+     * A count saturates at window; a reading that moved by more than epsilon resets it.
+     * @param readings N new readings.
+     * @param last N previous readings, replaced by the new ones.
+     * @param unchanged N counts of consecutive unchanged readings.
+     * @param epsilon Largest change that counts as unchanged.
+     * @param window Count at which the counts saturate.
+     * @param hasHistory False for the first readings, which have no previous ones.
+     */
+    static void persistenceFilter(const float* __restrict readings, float* __restrict last, uint16_t* __restrict unchanged,
+                                  float epsilon, uint16_t window, bool hasHistory) {
+        for (size_t i = 0; i < N; ++i) {
+            bool same = hasHistory && std::fabs(readings[i] - last[i]) <= epsilon;
+            uint16_t count = unchanged[i];
+            unchanged[i] = same ? static_cast<uint16_t>(count + (count < window)) : 0;
+            last[i] = readings[i];
+        }
+    }
+};
+
+/**
+ * @brief The same per-cell loops for a cell count known only at run time.
+ * Straight loops over the cells; the fallback for pack sizes without a compiled kernel.
+ */
+struct GenericCellKernels {
+    /**
+     * @brief Safety condition flags of all cells, combined.
+     * @param cellCount Number of cells.
+     * @param voltages cellCount cell voltages.
+     * @param temperatures cellCount cell temperatures.
+     * @return OR of the SAFETY_FLAG_* flags of every cell.
+     */
+    static uint32_t safetyFlags(size_t cellCount, const float* voltages, const float* temperatures) {
+        uint32_t flags = 0;
+        for (size_t i = 0; i < cellCount; ++i) {
+            flags |= cellVoltageFlags(voltages[i]) | cellTemperatureFlags(temperatures[i]);
+        }
+        return flags;
+    }
+
+    /**
+     * @brief Minimum, maximum and sum of the cell readings.
+     * @param cellCount Number of cells (at least 1).
+     * @param voltages cellCount cell voltages.
+     * @param temperatures cellCount cell temperatures.
+     * @return The statistics.
+     */
+    static CellStatistics statistics(size_t cellCount, const float* voltages, const float* temperatures) {
+        CellStatistics statistics = {voltages[0], voltages[0], voltages[0], temperatures[0], temperatures[0]};
+        for (size_t i = 1; i < cellCount; ++i) {
+            statistics.minVoltage_V = voltages[i] < statistics.minVoltage_V ? voltages[i] : statistics.minVoltage_V;
+            statistics.maxVoltage_V = voltages[i] > statistics.maxVoltage_V ? voltages[i] : statistics.maxVoltage_V;
+            statistics.sumVoltage_V += voltages[i];
+            statistics.minTemperature_C = temperatures[i] < statistics.minTemperature_C ? temperatures[i] : statistics.minTemperature_C;
+            statistics.maxTemperature_C = temperatures[i] > statistics.maxTemperature_C ? temperatures[i] : statistics.maxTemperature_C;
+        }
+        return statistics;
+    }
+
+    /**
+     * @brief Persistence filter: counts consecutive readings within epsilon of the previous one.
+     * @param cellCount Number of cells.
+     * @param readings cellCount new readings.
+     * @param last cellCount previous readings, replaced by the new ones.
+     * @param unchanged cellCount counts of consecutive unchanged readings.
+     * @param epsilon Largest change that counts as unchanged.
+     * @param window Count at which the counts saturate.
+     * @param hasHistory False for the first readings, which have no previous ones.
+     */
+    static void persistenceFilter(size_t cellCount, const float* readings, float* last, uint16_t* unchanged,
+                                  float epsilon, uint16_t window, bool hasHistory) {
+        for (size_t i = 0; i < cellCount; ++i) {
+            bool same = hasHistory && std::fabs(readings[i] - last[i]) <= epsilon;
+            unchanged[i] = same ? static_cast<uint16_t>(unchanged[i] + (unchanged[i] < window)) : 0;
+            last[i] = readings[i];
+        }
+    }
+};
+
+/**
+ * @brief GenericCellKernels with the interface of CellKernels, for a cell count without a compiled kernel.
+ * @tparam N Number of cells.
+ */
+template <size_t N>
+struct RuntimeCellKernels {
+    static void gather(const std::array<BatteryCell, N>& cells, float* voltages, float* temperatures) {
+        CellKernels<N>::gather(cells, voltages, temperatures);
+    }
+    static uint32_t safetyFlags(const float* voltages, const float* temperatures) {
+        return GenericCellKernels::safetyFlags(N, voltages, temperatures);
+    }
+    static CellStatistics statistics(const float* voltages, const float* temperatures) {
+        return GenericCellKernels::statistics(N, voltages, temperatures);
+    }
+    static void persistenceFilter(const float* readings, float* last, uint16_t* unchanged,
+                                  float epsilon, uint16_t window, bool hasHistory) {
+        GenericCellKernels::persistenceFilter(N, readings, last, unchanged, epsilon, window, hasHistory);
+    }
+};
+
+/**
+ * @brief Whether a cell count has compiled kernels: the pack sizes of the product range.
+ * @tparam N Number of cells.
+ */
+template <size_t N>
+struct HasCellKernels {
+    static const bool value = N == 4 || N == 12 || N == 16 || N == 96 || N == 108;
+};
+
+/**
+ * @brief The per-cell kernels for a pack of N cells: CellKernels<N> for the pack sizes of
+ * the product range, RuntimeCellKernels<N> for any other size, so odd configurations
+ * still build without instantiating a kernel set of their own.
+ * @tparam N Number of cells.
+ */
+template <size_t N>
+using PackCellKernels = typename std::conditional<HasCellKernels<N>::value, CellKernels<N>, RuntimeCellKernels<N>>::type;
+
+#endif // CELL_KERNELS_H
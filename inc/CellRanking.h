@@ -0,0 +1,81 @@
+// inc/CellRanking.h
+#ifndef CELL_RANKING_H
+#define CELL_RANKING_H
+
+#include <array>     // For std::array
+#include <cstddef>   // For size_t
+#include <cstdint>   // For uint8_t, uint32_t
+#include "../inc/Constants.h"     // For FLEET_TOP_K
+
+/**
+ * @brief Metrics by which cells are ranked fleet-wide.
+ */
+enum class CellMetric : uint8_t {
+    MAX_TEMPERATURE, // Hottest cells
+    MIN_VOLTAGE,     // Lowest cell voltages
+    MAX_DEVIATION,   // Largest deviation from the pack's mean cell voltage
+    MAX_RESISTANCE   // Highest internal resistance (R0)
+};
+
+// Number of CellMetric values
+const uint8_t CELL_METRIC_COUNT = 4;
+
+/**
+ * @brief One ranked cell: where it is and how bad it is.
+ */
+struct RankedCell {
+    float score;        // Ranking key, higher is worse
+    float value;        // The measured value (Volts, Celsius or Ohms)
+    uint32_t packIndex; // Index of the pack in the fleet
+    uint8_t cellId;     // ID of the cell within the pack
+};
+
+/**
+ * @brief Bounded heap keeping the FLEET_TOP_K worst cells seen so far.
+ * Stored as a min-heap on score in a fixed array, so offering a cell that does not
+ * make the cut costs a single comparison and nothing is ever allocated.
+ */
+class TopKHeap {
+public:
+    /**
+     * @brief Constructor for TopKHeap.
+     * Starts empty.
+     */
+    TopKHeap();
+
+    /**
+     * @brief Removes all entries.
+     */
+    void clear();
+
+    /**
+     * @brief Offers a cell for ranking; it is kept if it is among the worst FLEET_TOP_K.
+     * @param cell The cell to offer.
+     */
+    void offer(const RankedCell& cell);
+
+    /**
+     * @brief Offers all entries of another heap.
+     * @param other The heap to merge in.
+     */
+    void merge(const TopKHeap& other);
+
+    /**
+     * @brief Gets the number of entries held.
+     * @return Number of entries (at most FLEET_TOP_K).
+     */
+    size_t size() const;
+
+    /**
+     * @brief Copies the entries out, worst first.
+     * @param out Array receiving the entries; only the first size() are valid.
+     * @return Number of entries written.
+     */
+    size_t getSorted(std::array<RankedCell, FLEET_TOP_K>& out) const;
+
+private:
+    std::array<RankedCell, FLEET_TOP_K> m_entries; // Min-heap on score
+    size_t m_size;                                 // Number of valid entries
+};
+
+#endif // CELL_RANKING_H
@@ -6,16 +6,25 @@
 
 // Define the number of cells in the battery pack
 const uint8_t NUM_CELLS = 4;
+// Define the number of parallel strings the pack current divides between
+const uint8_t NUM_PARALLEL_STRINGS = 2;
+// Number of series cells in each string; string k holds cells k * CELLS_PER_STRING onwards
+const uint8_t CELLS_PER_STRING = NUM_CELLS / NUM_PARALLEL_STRINGS;
 
 // --- Battery Pack Characteristics ---
 // Nominal capacity of the battery pack in milliampere-hours (mAh)
 const float NOMINAL_CAPACITY_MAH = 3000.0f;
 // Efficiency of charging (e.g., 0.95 means 95% efficient)
 const float CHARGE_EFFICIENCY = 0.98f;
+// Nominal voltage of a single cell, used to convert remaining charge into energy (Volts)
+const float NOMINAL_CELL_VOLTAGE_V = 3.7f;
 // Threshold for considering battery fully charged for cycle counting
 const float SOC_FULL_THRESHOLD_PERCENT = 98.0f;
 // Threshold for considering battery fully discharged for cycle counting
 const float SOC_EMPTY_THRESHOLD_PERCENT = 10.0f;
+// Open-circuit voltage of a cell at 0% and 100% SoC; the OCV curve is linear in between (Volts)
+const float OCV_EMPTY_V = 3.0f;
+const float OCV_FULL_V = 4.2f;
 
 // --- Voltage Limits (Volts) ---
 // Minimum safe voltage for a single cell
@@ -76,19 +85,344 @@ const float MAX_CHARGE_CURRENT_CRITICAL_A = 4.0f;
 const float SOH_THRESHOLD_WARNING = 80.0f; // SoH below this triggers WARNING
 const float SOH_THRESHOLD_CRITICAL = 60.0f; // SoH below this triggers CRITICAL
 
+// --- ADC Codes ---
+// Cell voltage per ADC code of the quantized band lookup (Volts, unsigned 16-bit codes)
+const float ADC_VOLTAGE_LSB_V = 0.001f;
+// Cell temperature per ADC code of the quantized band lookup (Celsius, signed 16-bit codes)
+const float ADC_TEMPERATURE_LSB_C = 0.1f;
+// Frames of random ADC codes the band classifier benchmark classifies per round
+const uint32_t BAND_BENCH_FRAMES = 262144;
+// Benchmark rounds per classifier and mix of readings
+const uint32_t BAND_BENCH_ROUNDS = 8;
+
+// --- Batch Safety Evaluation (offline replay) ---
+// Frames classified per block; keeps the per-block scratch arrays in L1 cache
+const uint16_t SAFETY_BATCH_BLOCK_FRAMES = 512;
+// Randomized frames the safety benchmark checks the batch evaluation against evaluate() on
+const uint32_t SAFETY_BENCH_RANDOM_FRAMES = 200000;
+// Share (0.0 to 1.0) of the randomized readings that are NaN
+const float SAFETY_BENCH_NAN_SHARE = 0.01f;
+// Recorded time the safety benchmark replays at 1 Hz (seconds; 30 days)
+const uint32_t SAFETY_BENCH_REPLAY_SECONDS = 30u * 86400u;
+
+// --- Energy Accounting ---
+// Time constant of the moving average of discharge power (seconds of discharge)
+const float ENERGY_EWMA_TIME_CONSTANT_S = 20.0f;
+// Average discharge power below which no time-to-empty is reported (Watts)
+const float ENERGY_MIN_DISCHARGE_POWER_W = 0.1f;
+
+// --- Residency Histograms (warranty data) ---
+// Number of voltage bins per cell; readings outside the range fall into the edge bins
+const uint8_t RESIDENCY_VOLTAGE_BINS = 16;
+// Lower edge of the first voltage bin (Volts)
+const float RESIDENCY_VOLTAGE_MIN_V = 2.0f;
+// Upper edge of the last voltage bin (Volts)
+const float RESIDENCY_VOLTAGE_MAX_V = 4.6f;
+// Number of temperature bins per cell; readings outside the range fall into the edge bins
+const uint8_t RESIDENCY_TEMP_BINS = 16;
+// Lower edge of the first temperature bin (Celsius)
+const float RESIDENCY_TEMP_MIN_C = -20.0f;
+// Upper edge of the last temperature bin (Celsius)
+const float RESIDENCY_TEMP_MAX_C = 70.0f;
+// CSV the single-pack mode exports its residency histograms to at every checkpoint
+const char* const RESIDENCY_FILE_PATH = "bms_residency.csv";
+// CSV the fleet mode exports the merged residency histograms of all packs to
+const char* const FLEET_RESIDENCY_FILE_PATH = "fleet_residency.csv";
+// Fleet updates between exports of the merged residency histograms
+const uint32_t FLEET_RESIDENCY_EXPORT_TICKS = 60;
+
+// --- Event Bus ---
+// Number of events the event queue can hold (power of two)
+const uint32_t EVENT_QUEUE_CAPACITY = 256;
+// Maximum length of an event message including the terminating NUL
+const uint8_t EVENT_TEXT_LENGTH = 96;
+
+// --- Thermal Management ---
+// Period of the thermal controller, independent of the BMS update interval (seconds)
+const float THERMAL_CONTROL_PERIOD_S = 2.0f;
+// Maximum cell temperature the cooling controller (fan/pump) regulates to (Celsius)
+const float THERMAL_COOLING_SETPOINT_C = 35.0f;
+// Minimum cell temperature the heating controller regulates to (Celsius)
+const float THERMAL_HEATING_SETPOINT_C = 5.0f;
+// Charging window preconditioning brings the cells into (Celsius)
+const float THERMAL_PRECONDITION_MIN_C = 15.0f;
+const float THERMAL_PRECONDITION_MAX_C = 30.0f;
+// PI gains of the cooling controller (duty per Celsius, duty per Celsius-second)
+const float THERMAL_COOLING_KP = 0.15f;
+const float THERMAL_COOLING_KI = 0.01f;
+// PI gains of the heating controller (duty per Celsius, duty per Celsius-second)
+const float THERMAL_HEATING_KP = 0.2f;
+const float THERMAL_HEATING_KI = 0.01f;
+// Aggressive drive cycle of the thermal benchmark: cell current of each phase (Amperes)
+const float THERMAL_BENCH_ACCELERATION_A = -40.0f;
+const float THERMAL_BENCH_CRUISE_A = -5.0f;
+const float THERMAL_BENCH_REGENERATION_A = 15.0f;
+// Duration of each phase of the thermal benchmark drive cycle (seconds)
+const uint32_t THERMAL_BENCH_ACCELERATION_S = 60;
+const uint32_t THERMAL_BENCH_CRUISE_S = 30;
+const uint32_t THERMAL_BENCH_REGENERATION_S = 20;
+// Simulated time of each thermal benchmark run (seconds)
+const uint32_t THERMAL_BENCH_SECONDS = 7200;
+
+// --- Telemetry ---
+// A full keyframe is sent every this many telemetry frames
+const uint16_t TELEMETRY_KEYFRAME_INTERVAL = 50;
+// Deadbands sit well outside the sensor noise (SIM_*_NOISE), so steady readings are not
+// re-sent for noise alone
+// Cell voltage change required before it is re-sent (Volts; 5 sigma of the reading noise)
+const float TELEMETRY_VOLTAGE_DEADBAND_V = 0.01f;
+// Cell temperature change required before it is re-sent (Celsius; 5 sigma of the reading noise)
+const float TELEMETRY_TEMP_DEADBAND_C = 0.5f;
+// Pack current change required before it is re-sent (Amperes; the full span of the sample noise)
+const float TELEMETRY_CURRENT_DEADBAND_A = 0.1f;
+// Pack voltage change required before it is re-sent (Volts; beyond the full span of its noise)
+const float TELEMETRY_PACK_VOLTAGE_DEADBAND_V = 0.05f;
+// SoC change required before it is re-sent (%)
+const float TELEMETRY_SOC_DEADBAND_PERCENT = 0.1f;
+// Telemetry benchmark: a constant pack current (Amperes, negative for discharge) for this long (seconds)
+const float TELEMETRY_BENCH_LOAD_A = -1.0f;
+const uint32_t TELEMETRY_BENCH_SECONDS = 3600;
+
+// --- Dashboard ---
+// Dashboard redraw rate (frames per second)
+const uint8_t DASHBOARD_REFRESH_HZ = 10;
+// Cells per heatmap row
+const uint8_t DASHBOARD_HEATMAP_COLUMNS = 20;
+// Number of recent events shown
+const uint8_t DASHBOARD_EVENT_LINES = 8;
+// Events the dashboard can buffer between redraws (power of two)
+const uint32_t DASHBOARD_EVENT_QUEUE_CAPACITY = 64;
+// Width of the dashboard screen (characters)
+const uint16_t DASHBOARD_SCREEN_WIDTH = 100;
+
+// --- Sensor Diagnostics ---
+// Number of consecutive unchanged readings after which a sensor is considered stuck
+const uint16_t DIAG_STUCK_WINDOW_TICKS = 10;
+// Largest change between two voltage readings still treated as "unchanged" (Volts)
+const float DIAG_STUCK_VOLTAGE_EPSILON_V = 0.0005f;
+// Largest change between two temperature readings still treated as "unchanged" (Celsius)
+const float DIAG_STUCK_TEMP_EPSILON_C = 0.01f;
+// Allowed disagreement between the mean string sum of the cell voltages and the pack-voltage channel (Volts)
+const float DIAG_PACK_SUM_TOLERANCE_V = 0.25f;
+// Temperature below which a reading is attributed to an open thermistor (Celsius)
+const float DIAG_THERMISTOR_OPEN_TEMP_C = MIN_TEMP_FAULT;
+// Updates timed by the diagnostics benchmark, and distinct readings it replays (a power of two)
+const uint32_t DIAG_BENCH_TICKS = 200000;
+const uint32_t DIAG_BENCH_READINGS = 1024;
+
+// --- Fleet Simulation ---
+// Number of worst cells kept per metric in the fleet-wide ranking
+const uint8_t FLEET_TOP_K = 16;
+// Compression of the fleet quantile sketches (t-digest); higher is more accurate and larger
+const uint16_t SKETCH_COMPRESSION = 100;
+// Number of centroids merged into a quantile sketch that are buffered before it is compressed
+const uint16_t SKETCH_BUFFER_SIZE = 256;
+// Number of added values a quantile sketch buffers as floats before it is compressed
+const uint16_t SKETCH_VALUE_BUFFER_SIZE = 2048;
+// Values per distribution in the sketch benchmark
+const uint32_t SKETCH_BENCH_VALUES = 1000000;
+// Shard sketches the values are spread over in the sketch accuracy benchmark
+const uint32_t SKETCH_BENCH_SHARDS = 64;
+// Largest number of shard sketches merged in the sketch merge benchmark (powers of two up to it)
+const uint32_t SKETCH_BENCH_MAX_SHARDS = 1024;
+// Size of the memory blocks the fleet's packs are allocated from (bytes)
+const uint32_t FLEET_ARENA_BLOCK_BYTES = 64u * 1024u * 1024u;
+// Alignment and size granularity of the fleet memory blocks; the transparent huge page size (bytes)
+const uint32_t FLEET_ARENA_PAGE_BYTES = 2u * 1024u * 1024u;
+// Packs a fleet shard updates per block; in pack-major mode the kernels run over one block at a time
+const uint32_t FLEET_PACK_MAJOR_BLOCK_PACKS = 512;
+// Packs per vectorized loop of the SoC/SoH kernels; a multiple of the widest vector (16 floats)
+const uint32_t PACK_KERNEL_BLOCK_PACKS = 16;
+
 // --- Simulation Parameters ---
 // Delay in milliseconds between BMS updates in the main loop
 const uint32_t BMS_UPDATE_INTERVAL_MS = 1000; // 1 second
 
+// Number of BMS updates between checkpoint writes in the main loop
+const uint32_t CHECKPOINT_INTERVAL_UPDATES = 60;
+// File the main loop persists the BMS estimator state to
+const char* const CHECKPOINT_FILE_PATH = "bms_checkpoint.bin";
+
 // Sensor simulation ranges
-const float SIM_VOLTAGE_MIN = 2.00f; // Extended range for fault simulation
-const float SIM_VOLTAGE_MAX = 4.60f; // Extended range for fault simulation
-const float SIM_TEMP_MIN = -15.0f;   // Extended range for fault simulation
-const float SIM_TEMP_MAX = 65.0f;    // Extended range for fault simulation
 const float SIM_CURRENT_MIN = -25.0f; // Negative for discharge, Amperes
 const float SIM_CURRENT_MAX = 5.0f;   // Positive for charge, Amperes
 
+// Noise (standard deviation) of the cell voltage and temperature readings
+const float SIM_CELL_VOLTAGE_NOISE_V = 0.002f;
+const float SIM_CELL_TEMP_NOISE_C = 0.1f;
+
+// Cell model: mean parameters and their relative spread (standard deviation / mean) between cells
+const float SIM_CELL_CAPACITY_SPREAD = 0.02f;          // Mean capacity is NOMINAL_CAPACITY_MAH
+const float SIM_CELL_RESISTANCE_OHM = 0.02f;           // Internal resistance R0
+const float SIM_CELL_RESISTANCE_SPREAD = 0.08f;
+const float SIM_CELL_SELF_DISCHARGE_PERCENT_PER_DAY = 0.1f;
+const float SIM_CELL_SELF_DISCHARGE_SPREAD = 0.3f;
+const float SIM_CELL_THERMAL_MASS_J_PER_K = 45.0f;
+const float SIM_CELL_THERMAL_MASS_SPREAD = 0.05f;
+// Heat transfer from a cell to the coolant (W/K) and ambient temperature (Celsius)
+const float SIM_CELL_HEAT_TRANSFER_W_PER_K = 0.5f;
+const float SIM_AMBIENT_TEMP_C = 25.0f;
+// Coolant loop, per cell so it scales with the bank: coolant thermal mass (J/K), passive
+// radiator and full-speed fan conductance to ambient (W/K), heater power (W)
+const float SIM_COOLANT_THERMAL_MASS_J_PER_K = 400.0f;
+const float SIM_RADIATOR_W_PER_K = 2.5f;
+const float SIM_FAN_W_PER_K = 10.0f;
+const float SIM_HEATER_POWER_W = 40.0f;
+// Factor the cell-to-coolant heat transfer grows by at full pump speed
+const float SIM_PUMP_TRANSFER_GAIN = 3.0f;
+// Longest step the cell bank takes with forward Euler (seconds); longer, accelerated steps
+// use the adaptive Runge-Kutta integrator
+const float SIM_EULER_MAX_STEP_S = 2.0f;
+// Largest local error of a temperature the adaptive integrator accepts per substep (K)
+const float SIM_ADAPTIVE_TOLERANCE_C = 0.001f;
+// Shortest substep of the adaptive integrator (seconds)
+const float SIM_ADAPTIVE_MIN_STEP_S = 0.01f;
+// Integrator benchmark: a discharge at this cell current (Amperes) for the load time, then
+// rest until the end of the run (seconds)
+const float INTEGRATOR_BENCH_CURRENT_A = -18.0f;
+const uint32_t INTEGRATOR_BENCH_LOAD_S = 1800;
+const uint32_t INTEGRATOR_BENCH_SECONDS = 3600;
+// Step of the double-precision RK4 reference solution of the integrator benchmark (seconds)
+const double INTEGRATOR_BENCH_REFERENCE_STEP_S = 0.01;
+// Banks timed per configuration of the integrator benchmark
+const uint32_t INTEGRATOR_BENCH_BANKS = 2000;
+// Temperature error above which the integrator benchmark reports a run as diverged (K)
+const float INTEGRATOR_BENCH_DIVERGED_C = 100.0f;
+// Initial SoC of the simulated cells (0.0 to 1.0)
+const float SIM_CELL_INITIAL_SOC = 0.5f;
+
+// Noise amplitude of the independent pack-voltage channel (Volts)
+const float SIM_PACK_VOLTAGE_NOISE_V = 0.02f;
+
+// Cell open-circuit voltage is linear in SoC between these values (Volts)
+const float SIM_CELL_OCV_EMPTY_V = 3.0f;
+const float SIM_CELL_OCV_FULL_V = 4.2f;
+
 // Probability (0.0 to 1.0) of a simulated fault occurring
 const float SIM_FAULT_PROBABILITY = 0.02f; // 2% chance of a fault
 
+// --- Lifetime Simulation ---
+// Duration of a parked (idle) period, drawn uniformly between these values (seconds)
+const uint32_t LIFETIME_IDLE_MIN_S = 2u * 3600u;
+const uint32_t LIFETIME_IDLE_MAX_S = 48u * 3600u;
+// Duration of a drive, drawn uniformly between these values (seconds)
+const uint32_t LIFETIME_DRIVE_MIN_S = 5u * 60u;
+const uint32_t LIFETIME_DRIVE_MAX_S = 30u * 60u;
+// Constant pack current of a drive, drawn uniformly between these values (Amperes, negative for discharge)
+const float LIFETIME_DRIVE_CURRENT_MIN_A = -18.0f;
+const float LIFETIME_DRIVE_CURRENT_MAX_A = -3.0f;
+// Pack current while charging (Amperes); a charge lasts until the estimated SoC reaches 100%
+const float LIFETIME_CHARGE_CURRENT_A = 2.0f;
+// A parked pack with an estimated SoC below this charges next instead of driving (%)
+const float LIFETIME_RECHARGE_SOC_PERCENT = 30.0f;
+// Largest per-pack SoH difference between event-driven and fixed stepping that --compare accepts (%)
+const float LIFETIME_COMPARE_SOH_TOLERANCE_PERCENT = 0.01f;
+
+// --- ECM Identification ---
+// Parameter file the fitter writes and the BMS loads at startup
+const char* const ECM_PARAMETER_FILE_PATH = "ecm_parameters.txt";
+// Cells fitted together in the vectorized loops of the fitter
+const uint32_t ECM_FIT_BLOCK_CELLS = 8;
+// Levenberg-Marquardt iterations per cell at most
+const uint32_t ECM_FIT_MAX_ITERATIONS = 40;
+// A fit has converged when an accepted step lowers the cost by less than this fraction
+const double ECM_FIT_CONVERGENCE = 1e-9;
+// Initial guesses of the polarization branch: resistance (Ohms) and time constant (seconds)
+const float ECM_FIT_INITIAL_R1_OHM = 0.01f;
+const float ECM_FIT_INITIAL_TAU_S = 20.0f;
+// ECM benchmark: synthetic trace of this many cells and 1 Hz samples, with Gaussian voltage noise (Volts)
+const uint32_t ECM_BENCH_CELLS = 400;
+const uint32_t ECM_BENCH_SAMPLES = 86400;
+const float ECM_BENCH_NOISE_V = 0.001f;
+// Length of the constant-current segments of the synthetic trace, drawn uniformly between these (seconds)
+const uint32_t ECM_BENCH_SEGMENT_MIN_S = 10;
+const uint32_t ECM_BENCH_SEGMENT_MAX_S = 600;
+
+// --- Capacity Estimation ---
+// Rest time after which the cell voltages are taken as open-circuit voltages (seconds)
+const float CAPACITY_REST_MIN_S = 1800.0f;
+// Smallest SoC change between two rest anchors that is used as a capacity observation (0.0 to 1.0)
+const float CAPACITY_MIN_DELTA_SOC = 0.2f;
+// Weight kept by the older observations when a new one is added (fading memory)
+const double CAPACITY_FADING_FACTOR = 0.95;
+// Weight of the nominal-capacity prior, as the SoC change of an equivalent observation
+const double CAPACITY_PRIOR_DELTA_SOC = 0.5;
+// Standard deviations of an observation: counted charge (mAh) and SoC change from the OCV (0.0 to 1.0)
+const float CAPACITY_CHARGE_NOISE_MAH = 10.0f;
+const float CAPACITY_SOC_NOISE = 0.01f;
+
+// --- High-Rate Current Acquisition ---
+// Rate of the current samples (Hz)
+const uint32_t CURRENT_SAMPLE_RATE_HZ = 10000;
+// Samples per block passed from the acquisition thread to the control loop (multiple of CURRENT_KERNEL_LANES)
+const uint32_t CURRENT_BLOCK_SAMPLES = 128;
+// Independent accumulators of the decimation kernel, so its loop vectorizes
+const uint32_t CURRENT_KERNEL_LANES = 8;
+// Blocks the ring between the acquisition thread and the control loop holds (power of two)
+const uint32_t CURRENT_RING_BLOCKS = 256;
+// Noise of a current sample, uniformly distributed within +/- this value (Amperes)
+const float CURRENT_SAMPLE_NOISE_A = 0.05f;
+// Average number of simulated load transients per second, their duration (seconds) and peak current (Amperes)
+const float CURRENT_TRANSIENT_RATE_HZ = 2.0f;
+const float CURRENT_TRANSIENT_DURATION_S = 0.02f;
+const float CURRENT_TRANSIENT_PEAK_A = -25.0f;
+
+// --- Overcurrent Protection ---
+// Current the I2t integrator tolerates indefinitely; above it the squared excess accumulates (Amperes)
+const float I2T_RATED_CURRENT_A = 15.0f;
+// Accumulated I2t at which the overload protection trips to FAULT (A^2 s)
+const float I2T_TRIP_A2S = 2500.0f;
+// Fraction of I2T_TRIP_A2S above which the overload is a WARNING, and below which a trip clears
+const float I2T_WARNING_FRACTION = 0.5f;
+// Current magnitude of a high-rate sample that counts as a short circuit (Amperes)
+const float SHORT_CIRCUIT_CURRENT_A = 100.0f;
+// Consecutive high-rate samples at SHORT_CIRCUIT_CURRENT_A needed to trip
+const uint32_t SHORT_CIRCUIT_DEBOUNCE_SAMPLES = 3;
+// Short-circuit benchmark: load current before the fault and fault current (Amperes)
+const float SHORT_CIRCUIT_BENCH_LOAD_A = -10.0f;
+const float SHORT_CIRCUIT_BENCH_FAULT_A = -300.0f;
+// Normal blocks screened per granularity to time the short-circuit detector
+const uint32_t SHORT_CIRCUIT_BENCH_BLOCKS = 1000000;
+
+// --- Flight Recorder ---
+// Frames kept before a fault, the fault's own frame included (one frame per update)
+const uint32_t FLIGHT_RECORDER_PRE_FRAMES = 30;
+// Frames captured after the fault before the freeze frame is written
+const uint32_t FLIGHT_RECORDER_POST_FRAMES = 10;
+// Freeze-frame files are named <prefix>_<capture number>.bin
+const char* const FLIGHT_RECORDER_FILE_PREFIX = "freeze_frame";
+// Identifies a freeze-frame file ("FRZF") and its layout version
+const uint32_t FLIGHT_RECORDER_MAGIC = 0x46525A46;
+const uint32_t FLIGHT_RECORDER_VERSION = 1;
+// Nap of the writer thread while no capture is waiting (milliseconds)
+const uint32_t FLIGHT_RECORDER_WRITER_IDLE_MS = 20;
+
+// --- Cell Kernels ---
+// Packs of random readings each kernel runs over per benchmark round
+const uint32_t CELL_KERNEL_BENCH_PACKS = 64;
+// Benchmark rounds per kernel and pack size (scaled down for the larger packs)
+const uint32_t CELL_KERNEL_BENCH_ROUNDS = 200000;
+
+// --- Async File Sink ---
+// Size of each write buffer; every full buffer is one write (bytes, a multiple of ASYNC_SINK_ALIGNMENT_BYTES)
+const uint32_t ASYNC_SINK_BUFFER_BYTES = 256 * 1024;
+// Write buffers per sink (power of two); records are dropped while all of them are being written
+const uint32_t ASYNC_SINK_BUFFER_COUNT = 8;
+// Alignment of the offsets and lengths of direct (O_DIRECT) writes (bytes)
+const uint32_t ASYNC_SINK_ALIGNMENT_BYTES = 4096;
+// Writer threads of the thread-pool backend
+const uint32_t ASYNC_SINK_POOL_THREADS = 2;
+// Telemetry frames of the single-pack modes, each preceded by its 16-bit length
+const char* const TELEMETRY_FILE_PATH = "bms_telemetry.bin";
+// Journal of the BMS events, one line per event
+const char* const EVENT_JOURNAL_FILE_PATH = "bms_events.log";
+// The event journal is flushed once this many bytes are pending, or this long after its
+// last flush (milliseconds), and after every FAULT event
+const uint32_t EVENT_JOURNAL_FLUSH_BYTES = 4096;
+const uint32_t EVENT_JOURNAL_FLUSH_INTERVAL_MS = 1000;
+// Duration of each configuration of the sink benchmark (seconds)
+const uint32_t ASYNC_SINK_BENCH_SECONDS = 3;
+// File written by the sink benchmark, removed afterwards
+const char* const ASYNC_SINK_BENCH_FILE_PATH = "sink_benchmark.bin";
+
 #endif // CONSTANTS_H
@@ -0,0 +1,191 @@
+// inc/CurrentAcquisition.h
+#ifndef CURRENT_ACQUISITION_H
+#define CURRENT_ACQUISITION_H
+
+#include <array>   // For std::array
+#include <atomic>  // For std::atomic
+#include <cstdint> // For uint32_t, uint64_t
+#include <thread>  // For std::thread
+#include "../inc/Constants.h"   // For CURRENT_* parameters
+#include "../inc/ShortCircuitDetector.h" // For ShortCircuitDetector class
+#include "../inc/SplitMix64.h"  // For SplitMix64 class
+#include "../inc/SpscRing.h"    // For SpscRing class
+
+/**
+ * @brief One block of consecutive current samples.
+ */
+struct CurrentSampleBlock {
+    std::array<float, CURRENT_BLOCK_SAMPLES> current_A; // Samples, oldest first (positive for charge)
+};
+
+/**
+ * @brief Sum, sum of squares, minimum and maximum of one block of samples.
+ */
+struct CurrentBlockReduction {
+    float sum_A;
+    float sumSquares_A2;
+    float min_A;
+    float max_A;
+};
+
+/**
+ * @brief Current over one control interval, decimated from the high-rate samples.
+ */
+struct DecimatedCurrent {
+    float mean_A = 0.0f;       // Boxcar average of the samples (first-order CIC output)
+    float meanSquare_A2 = 0.0f; // Average of the squared samples, for I2t protection
+    float min_A = 0.0f;        // Lowest sample
+    float max_A = 0.0f;        // Highest sample
+    double charge_As = 0.0;    // Trapezoidal integral of the samples, plus the mean current over lostDuration_s
+    double duration_s = 0.0;   // Time the samples span
+    double lostDuration_s = 0.0; // Time of the blocks dropped on overruns since the previous drain
+    uint64_t sampleCount = 0;  // Number of samples
+};
+
+/**
+ * @brief High-rate pack current acquisition for exact Coulomb counting.
+ * A producer thread samples the pack current at CURRENT_SAMPLE_RATE_HZ, paced in real
+ * time, and passes blocks of CURRENT_BLOCK_SAMPLES samples through a lock-free ring; a
+ * replay can push recorded blocks instead. The simulated current is the load set by the
+ * control loop plus short load transients and noise, which a single sample per control
+ * update would miss. The control loop drains the ring once per update and gets the
+ * decimated current and the charge of the whole interval. Decimation is a boxcar over
+ * the interval, i.e. a first-order CIC filter with a decimation factor of the samples per
+ * update; its block kernel keeps CURRENT_KERNEL_LANES independent accumulators, so the
+ * compiler vectorizes it. The trapezoidal integral follows from the same sums and the
+ * sample carried over from the previous block, so it is exact for a current that is
+ * linear between samples. An attached ShortCircuitDetector checks every chunk of
+ * CURRENT_KERNEL_LANES samples on the producer side as it is sampled and, when it trips,
+ * the simulated contactor opens: from the next chunk of the same block on the samples
+ * drop to zero load until closeContactor().
+ */
+class CurrentAcquisition {
+public:
+    /**
+     * @brief Constructor for CurrentAcquisition.
+     * @param sampleRate_Hz Sample rate.
+     * @param seed Seed of the simulated transients and noise.
+     */
+    explicit CurrentAcquisition(uint32_t sampleRate_Hz = CURRENT_SAMPLE_RATE_HZ, uint64_t seed = 1);
+
+    /**
+     * @brief Destructor for CurrentAcquisition. Stops the producer thread.
+     */
+    ~CurrentAcquisition();
+
+    CurrentAcquisition(const CurrentAcquisition&) = delete;
+    CurrentAcquisition& operator=(const CurrentAcquisition&) = delete;
+
+    /**
+     * @brief Starts the producer thread, which samples in real time.
+     */
+    void start();
+
+    /**
+     * @brief Stops the producer thread.
+     */
+    void stop();
+
+    /**
+     * @brief Attaches the short-circuit detector that checks every chunk of samples as it is sampled.
+     * Must be called before start().
+     * @param detector The detector (not owned), or nullptr to detach.
+     */
+    void attachShortCircuitDetector(ShortCircuitDetector* detector);
+
+    /**
+     * @brief Gets the attached short-circuit detector.
+     * @return The detector, or nullptr if none is attached.
+     */
+    const ShortCircuitDetector* getShortCircuitDetector() const;
+
+    /**
+     * @brief Closes the simulated contactor after a short-circuit trip (any thread).
+     */
+    void closeContactor();
+
+    /**
+     * @brief Sets the load current the simulated samples follow (any thread).
+     * @param current_A Load current in Amperes (positive for charge).
+     */
+    void setLoadCurrent_A(float current_A);
+
+    /**
+     * @brief Simulates one block of samples and queues it (producer side).
+     * @return True if queued, false if the ring was full and the block was dropped.
+     */
+    bool produceBlock();
+
+    /**
+     * @brief Queues a block of samples, e.g. from a replay (producer side).
+     * @param block The samples.
+     * @return True if queued, false if the ring was full and the block was dropped.
+     */
+    bool pushBlock(const CurrentSampleBlock& block);
+
+    /**
+     * @brief Decimates and integrates all queued samples (consumer side).
+     * Blocks dropped on overruns since the previous drain are counted at the interval's mean current.
+     * @param interval Output, the current over the samples queued since the last drain.
+     * @return True if any samples were queued, false otherwise (interval is left unchanged).
+     */
+    bool drain(DecimatedCurrent& interval);
+
+    /**
+     * @brief Gets the number of blocks dropped because the ring was full.
+     * @return Number of dropped blocks.
+     */
+    uint64_t getOverrunCount() const;
+
+    /**
+     * @brief Decimation kernel: sum, sum of squares, minimum and maximum of one block of samples.
+     * @param samples CURRENT_BLOCK_SAMPLES samples.
+     * @return The reduction.
+     */
+    static CurrentBlockReduction reduceBlock(const float* samples);
+
+private:
+    SpscRing<CurrentSampleBlock, CURRENT_RING_BLOCKS> m_ring; // Blocks waiting for the control loop
+    std::thread m_producer;                 // Producer thread
+    std::atomic<bool> m_running;            // Producer thread should keep running
+    std::atomic<float> m_load_A;            // Load current the samples follow
+    std::atomic<uint64_t> m_overruns;       // Blocks dropped on a full ring
+    std::atomic<bool> m_contactorOpen;      // Simulated contactor opened by a short-circuit trip
+    ShortCircuitDetector* m_shortCircuitDetector; // Fast-path detector (not owned, may be null)
+    const double m_sampleInterval_s;        // Time between two samples
+
+    // Producer-owned simulation state
+    SplitMix64 m_random;                    // Generator of transients and noise
+    uint32_t m_transientSamplesLeft;        // Remaining samples of the current transient
+
+    // Consumer-owned integration state
+    float m_previousSample_A;               // Last sample of the previous block
+    bool m_hasPreviousSample;               // False until the first block was drained
+    uint64_t m_drainedOverruns;             // Overruns already accounted for by drain()
+
+    /**
+     * @brief Runs the short-circuit detector on one chunk of samples and opens the contactor on a trip (producer side).
+     * @param samples CURRENT_KERNEL_LANES samples.
+     */
+    void checkChunk(const float* samples);
+
+    /**
+     * @brief Queues a block that has been checked (producer side).
+     * @param block The samples.
+     * @return True if queued, false if the ring was full and the block was dropped.
+     */
+    bool queueBlock(const CurrentSampleBlock& block);
+
+    /**
+     * @brief Body of the producer thread.
+     */
+    void produceLoop();
+
+    /**
+     * @brief Draws a uniformly distributed value between 0 and 1 (producer side).
+     * @return The value.
+     */
+    float drawUnit();
+};
+
+#endif // CURRENT_ACQUISITION_H
@@ -0,0 +1,120 @@
+// inc/Dashboard.h
+#ifndef DASHBOARD_H
+#define DASHBOARD_H
+
+#include <array>     // For std::array
+#include <atomic>    // For std::atomic
+#include <cstddef>   // For size_t
+#include <cstdint>   // For uint8_t, uint32_t
+#include <string>    // For std::string
+#include <thread>    // For std::thread
+#include <vector>    // For std::vector
+#include "../inc/BMS.h"       // For BmsSnapshot
+#include "../inc/EventBus.h"  // For EventBus, BmsEvent
+#include "../inc/Seqlock.h"   // For Seqlock class
+#include "../inc/SpscRing.h"  // For SpscRing class
+#include "../inc/Constants.h" // For DASHBOARD_* settings
+
+/**
+ * @brief Live terminal dashboard of a single pack.
+ * Shows the state, SoC/SoH, pack readings, a voltage and a temperature heatmap of the
+ * cells and the most recent events. A render thread reads the BMS state from a seqlock
+ * snapshot, composes the next screen into a character grid and writes only the grid
+ * cells that differ from what is on the terminal, using ANSI cursor moves, in a single
+ * write. Frames with no new snapshot and no new event are skipped entirely.
+ */
+class Dashboard {
+public:
+    /**
+     * @brief Constructor for Dashboard.
+     * Subscribes to every event type; must therefore be created before the bus is started.
+     * @param snapshot The seqlock the BMS publishes its snapshots to.
+     * @param eventBus The bus the BMS publishes its events to.
+     */
+    Dashboard(const Seqlock<BmsSnapshot>& snapshot, EventBus& eventBus);
+
+    /**
+     * @brief Destructor. Stops the render thread and restores the terminal.
+     */
+    ~Dashboard();
+
+    Dashboard(const Dashboard&) = delete;
+    Dashboard& operator=(const Dashboard&) = delete;
+
+    /**
+     * @brief Clears the terminal and starts the render thread.
+     */
+    void start();
+
+    /**
+     * @brief Stops the render thread and restores the terminal.
+     */
+    void stop();
+
+private:
+    /**
+     * @brief One character position of the screen.
+     */
+    struct ScreenCell {
+        char character;     // Character shown
+        uint8_t background; // 256-color background index, 0 for the terminal default
+
+        bool operator==(const ScreenCell& other) const {
+            return character == other.character && background == other.background;
+        }
+    };
+
+    const Seqlock<BmsSnapshot>& m_snapshot;                                // Source of BMS state
+    SpscRing<BmsEvent, DASHBOARD_EVENT_QUEUE_CAPACITY> m_events;           // Events from the dispatcher thread
+    std::array<std::string, DASHBOARD_EVENT_LINES> m_recentEvents;         // Recent event lines (ring)
+    size_t m_recentEventCount;                                             // Total events received
+    std::vector<ScreenCell> m_front;                                       // What the terminal shows
+    std::vector<ScreenCell> m_back;                                        // Frame being composed
+    std::string m_output;                                                  // Escape sequences of one redraw
+    BmsSnapshot m_latest;                                                  // Last snapshot read
+    uint32_t m_lastSequence;                                               // Seqlock sequence of m_latest
+    std::thread m_renderer;                                                // Render thread
+    std::atomic<bool> m_running;                                           // Render thread should keep running
+
+    /**
+     * @brief Body of the render thread.
+     */
+    void renderLoop();
+
+    /**
+     * @brief Moves newly received events into the recent event lines.
+     * @return True if any event was received.
+     */
+    bool drainEvents();
+
+    /**
+     * @brief Composes the next screen from the latest snapshot and events.
+     */
+    void composeFrame();
+
+    /**
+     * @brief Writes the screen cells that changed since the last redraw.
+     */
+    void flushDifferences();
+
+    /**
+     * @brief Writes text into the frame being composed, clipped to the screen width.
+     * @param row Screen row.
+     * @param column Screen column of the first character.
+     * @param text The text.
+     * @param background Background color of the text.
+     */
+    void putText(size_t row, size_t column, const char* text, uint8_t background = 0);
+
+    /**
+     * @brief Draws one heatmap of per-cell values.
+     * @param row Screen row of the top of the heatmap.
+     * @param column Screen column of the left of the heatmap.
+     * @param values The per-cell values.
+     * @param minValue Value shown in the coldest color.
+     * @param maxValue Value shown in the hottest color.
+     */
+    void putHeatmap(size_t row, size_t column, const std::array<float, NUM_CELLS>& values, float minValue, float maxValue);
+};
+
+#endif // DASHBOARD_H
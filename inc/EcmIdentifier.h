@@ -0,0 +1,111 @@
+// inc/EcmIdentifier.h
+#ifndef ECM_IDENTIFIER_H
+#define ECM_IDENTIFIER_H
+
+#include <cstddef> // For size_t
+#include <string>  // For std::string
+#include <vector>  // For std::vector
+
+/**
+ * @brief Fitted equivalent-circuit parameters of one cell.
+ * The model is the cell bank's linear open-circuit voltage in SoC, an ohmic resistance
+ * R0 and one RC polarization branch (R1 parallel to C1).
+ */
+struct EcmParameters {
+    float r0_Ohm;        // Ohmic resistance
+    float r1_Ohm;        // Polarization resistance
+    float c1_F;          // Polarization capacitance
+    float capacity_mAh;  // Capacity
+    float initialSoc;    // SoC at the first sample (0.0 to 1.0)
+    float rmsError_V;    // RMS voltage residual of the fit
+};
+
+/**
+ * @brief Recorded current and cell voltages of a series string, sampled at a fixed rate.
+ * All cells carry the same current. Voltages are time-major: the voltage of cell c at
+ * sample t is at index t * cellCount + c.
+ */
+struct EcmTrace {
+    float deltaTime_s = 1.0f;         // Sample period
+    size_t cellCount = 0;             // Number of cells
+    std::vector<float> current_A;     // Current of every sample (positive for charge)
+    std::vector<float> cellVoltages_V; // Cell voltages of every sample
+};
+
+/**
+ * @brief Identifies per-cell ECM parameters (R0, R1, C1, capacity) from recorded traces.
+ * Each cell is fitted with Levenberg-Marquardt. Cells are fitted in blocks of
+ * ECM_FIT_BLOCK_CELLS whose forward model and Jacobian run in one loop over the samples,
+ * vectorized across the cells of the block, and the blocks are spread over worker threads.
+ */
+class EcmIdentifier {
+public:
+    /**
+     * @brief Constructor for EcmIdentifier.
+     * @param threadCount Worker threads; 0 uses one per hardware thread.
+     */
+    explicit EcmIdentifier(size_t threadCount = 0);
+
+    /**
+     * @brief Fits the parameters of every cell of a trace.
+     * @param trace The recorded trace.
+     * @param parameters Output, one entry per cell.
+     */
+    void fit(const EcmTrace& trace, std::vector<EcmParameters>& parameters) const;
+
+    /**
+     * @brief Computes the cell voltages the model predicts for the current of a trace.
+     * @param trace The trace whose current drives the model.
+     * @param parameters Parameters of every cell of the trace.
+     * @param cellVoltages_V Output, time-major like EcmTrace::cellVoltages_V.
+     */
+    static void simulate(const EcmTrace& trace, const std::vector<EcmParameters>& parameters,
+                         std::vector<float>& cellVoltages_V);
+
+    /**
+     * @brief Reads a trace from a CSV file.
+     * The first line is "deltaTime_s,cellCount", every further line one sample:
+     * "current_A,voltage_0,...,voltage_n-1".
+     * @param path The file to read.
+     * @param trace Output trace.
+     * @return True if the file was read completely, false otherwise.
+     */
+    static bool loadTrace(const std::string& path, EcmTrace& trace);
+
+    /**
+     * @brief Writes a trace to a CSV file in the format loadTrace() reads.
+     * @param path The file to write.
+     * @param trace The trace.
+     * @return True if the file was written, false otherwise.
+     */
+    static bool saveTrace(const std::string& path, const EcmTrace& trace);
+
+    /**
+     * @brief Writes fitted parameters to a text file, one cell per line.
+     * @param path The file to write.
+     * @param parameters The parameters.
+     * @return True if the file was written, false otherwise.
+     */
+    static bool saveParameters(const std::string& path, const std::vector<EcmParameters>& parameters);
+
+    /**
+     * @brief Reads parameters written by saveParameters().
+     * @param path The file to read.
+     * @param parameters Output, one entry per cell.
+     * @return True if the file was read and holds at least one cell, false otherwise.
+     */
+    static bool loadParameters(const std::string& path, std::vector<EcmParameters>& parameters);
+
+private:
+    size_t m_threadCount; // Worker threads of fit()
+
+    /**
+     * @brief Fits one block of up to ECM_FIT_BLOCK_CELLS cells.
+     * @param trace The recorded trace.
+     * @param firstCell Index of the first cell of the block.
+     * @param parameters Output, entries firstCell onwards are written.
+     */
+    static void fitBlock(const EcmTrace& trace, size_t firstCell, std::vector<EcmParameters>& parameters);
+};
+
+#endif // ECM_IDENTIFIER_H
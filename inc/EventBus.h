@@ -0,0 +1,151 @@
+// inc/EventBus.h
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <array>      // For std::array
+#include <atomic>     // For std::atomic
+#include <cstdint>    // For uint8_t, uint64_t
+#include <functional> // For std::function
+#include <string>     // For std::string
+#include <thread>     // For std::thread
+#include <vector>     // For std::vector
+#include "../inc/BMS_States.h"    // For SystemState enum
+#include "../inc/Constants.h"     // For EVENT_QUEUE_CAPACITY, EVENT_TEXT_LENGTH
+#include "../inc/SpscRing.h"      // For SpscRing class
+#include "../inc/WakeSignal.h"    // For WakeSignal class
+
+/**
+ * @brief Kinds of events published by the BMS.
+ */
+enum class EventType : uint8_t {
+    STATE_TRANSITION,   // Safety state changed (fromState -> toState)
+    FAULT,              // Fault reaction requested (text holds the description)
+    CYCLE_INCREMENT,    // Charge cycle counter advanced (value holds the total)
+    THRESHOLD_CROSSING, // An estimate crossed a threshold (threshold, rising, value)
+    LOG                 // Informational message (text holds the message)
+};
+
+// Number of EventType values
+const uint8_t EVENT_TYPE_COUNT = 5;
+
+/**
+ * @brief Thresholds reported by THRESHOLD_CROSSING events.
+ */
+enum class ThresholdId : uint8_t {
+    SOC_FULL,      // SOC_FULL_THRESHOLD_PERCENT
+    SOC_EMPTY,     // SOC_EMPTY_THRESHOLD_PERCENT
+    SOH_WARNING,   // SOH_THRESHOLD_WARNING
+    SOH_CRITICAL   // SOH_THRESHOLD_CRITICAL
+};
+
+/**
+ * @brief A typed BMS event. Fixed-size so it can be queued without allocation.
+ */
+struct BmsEvent {
+    EventType type = EventType::LOG;
+    SystemState fromState = SystemState::NORMAL;  // STATE_TRANSITION: previous state
+    SystemState toState = SystemState::NORMAL;    // STATE_TRANSITION: new state
+    ThresholdId threshold = ThresholdId::SOC_FULL; // THRESHOLD_CROSSING: which threshold
+    bool rising = false;                          // THRESHOLD_CROSSING: crossed upwards
+    float value = 0.0f;                           // CYCLE_INCREMENT / THRESHOLD_CROSSING: value
+    char text[EVENT_TEXT_LENGTH] = {};            // LOG / FAULT: message, truncated and NUL-terminated
+
+    /**
+     * @brief Copies a message into the event text, truncating it if necessary.
+     * @param message The message to copy, NUL-terminated.
+     */
+    void setText(const char* message);
+};
+
+/**
+ * @brief Handler invoked for each dispatched event of a subscribed type.
+ */
+using EventHandler = std::function<void(const BmsEvent&)>;
+
+/**
+ * @brief Formats an event as a one-line, human-readable message.
+ * @param event The event to describe.
+ * @return The message (without a trailing newline).
+ */
+std::string describeEvent(const BmsEvent& event);
+
+/**
+ * @brief Typed publish/subscribe event bus.
+ * The control thread publishes into a preallocated lock-free queue and never blocks;
+ * a dispatcher thread drains the queue and invokes the handlers subscribed to each
+ * event type. Logging, telemetry or contactor control can attach as subscribers
+ * without adding latency to the BMS tick. An idle dispatcher sleeps on a futex
+ * (WakeSignal) and publish() wakes it without taking a lock, so an event is dispatched
+ * as soon as it is queued while an idle bus costs no CPU.
+ * There must be a single publishing thread per bus.
+ */
+class EventBus {
+public:
+    /**
+     * @brief Constructor for EventBus.
+     * The dispatcher thread is not started until start() is called.
+     */
+    EventBus();
+
+    /**
+     * @brief Destructor. Stops the dispatcher thread after draining the queue.
+     */
+    ~EventBus();
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    /**
+     * @brief Registers a handler for one event type.
+     * Must be called before start().
+     * @param type The event type to subscribe to.
+     * @param handler The handler to invoke.
+     */
+    void subscribe(EventType type, EventHandler handler);
+
+    /**
+     * @brief Queues an event for dispatch. Lock-free and non-blocking.
+     * Wakes the dispatcher thread if it is sleeping, with one system call and no lock.
+     * @param event The event to publish.
+     * @return True if queued, false if the queue was full and the event was dropped.
+     */
+    bool publish(const BmsEvent& event);
+
+    /**
+     * @brief Starts the dispatcher thread.
+     */
+    void start();
+
+    /**
+     * @brief Stops the dispatcher thread after dispatching everything queued.
+     */
+    void stop();
+
+    /**
+     * @brief Dispatches all queued events on the calling thread.
+     * For use when no dispatcher thread is running.
+     * @return Number of events dispatched.
+     */
+    size_t dispatchPending();
+
+    /**
+     * @brief Gets the number of events dropped because the queue was full.
+     * @return Number of dropped events.
+     */
+    uint64_t getDroppedCount() const;
+
+private:
+    SpscRing<BmsEvent, EVENT_QUEUE_CAPACITY> m_queue;               // Events waiting for dispatch
+    std::array<std::vector<EventHandler>, EVENT_TYPE_COUNT> m_handlers; // Handlers per event type
+    std::thread m_dispatcher;                                       // Dispatcher thread
+    std::atomic<bool> m_running;                                    // Dispatcher thread should keep running
+    WakeSignal m_wakeUp;                                            // Wakes the dispatcher on publish() and stop()
+    std::atomic<uint64_t> m_dropped;                                // Events dropped on a full queue
+
+    /**
+     * @brief Body of the dispatcher thread.
+     */
+    void dispatchLoop();
+};
+
+#endif // EVENT_BUS_H
@@ -0,0 +1,177 @@
+// inc/EventDrivenSimulator.h
+#ifndef EVENT_DRIVEN_SIMULATOR_H
+#define EVENT_DRIVEN_SIMULATOR_H
+
+#include <array>      // For std::array
+#include <cstddef>    // For size_t
+#include <cstdint>    // For uint64_t
+#include <functional> // For std::greater
+#include <queue>      // For std::priority_queue
+#include <vector>     // For std::vector
+#include "../inc/BMS_States.h"        // For SystemState enum
+#include "../inc/BatteryCell.h"       // For BatteryCell class
+#include "../inc/CapacityEstimator.h" // For CapacityEstimatorState
+#include "../inc/Constants.h"         // For NUM_CELLS and LIFETIME_* parameters
+#include "../inc/SafetyManager.h"     // For SafetyManager class
+#include "../inc/SimulatedCellBank.h" // For SimulatedCellBank class
+#include "../inc/SplitMix64.h"        // For SplitMix64 class
+
+/**
+ * @brief How a lifetime simulation advances its packs.
+ */
+enum class SimulationStepping : uint8_t {
+    FIXED_STEP,   // Every pack is evaluated every time step (the reference)
+    EVENT_DRIVEN  // Idle packs jump to their next interesting time step
+};
+
+/**
+ * @brief Outcome totals of a lifetime simulation, summed over all packs.
+ */
+struct LifetimeStatistics {
+    std::array<uint64_t, 4> stepsInState = {};     // Pack time steps spent in each SystemState
+    std::array<uint64_t, 4> entriesIntoState = {}; // Transitions into each SystemState
+    uint64_t evaluatedSteps = 0;                   // Pack time steps evaluated one by one
+    uint64_t skippedSteps = 0;                     // Pack time steps jumped over while idle
+    uint64_t idleJumps = 0;                        // Number of idle jumps
+    float chargeCycles = 0.0f;                     // Charge cycles counted by the estimators
+};
+
+/**
+ * @brief Discrete-event lifetime simulation of many packs, for fleet-years of usage.
+ * Each pack follows its own usage schedule of drives and charges at constant current,
+ * separated by long parked periods. The cell bank supplies noise-free readings, and the
+ * SoC/SoH estimators and the SafetyManager evaluate them every time step, like a BMS.
+ * In event-driven mode a priority queue orders the packs by their next interesting time
+ * step. Active packs step normally through their drive or charge. Idle packs jump to the
+ * first time step whose readings would change the safety state, or to the end of the
+ * parked period, analytically through self-discharge and thermal relaxation; the time
+ * steps skipped would not have changed the estimators or the state, so the safety
+ * outcomes equal those of fixed stepping.
+ */
+class EventDrivenSimulator {
+public:
+    /**
+     * @brief Constructor for EventDrivenSimulator.
+     * All packs start parked, at SIM_CELL_INITIAL_SOC and ambient temperature.
+     * @param packCount Number of packs to simulate.
+     * @param stepping How the packs are advanced.
+     * @param seed Seed of the cell parameters and the usage schedules.
+     * @param variability Distributions the cell parameters are drawn from.
+     */
+    EventDrivenSimulator(size_t packCount, SimulationStepping stepping, uint64_t seed,
+                         const CellVariability& variability = CellVariability());
+
+    /**
+     * @brief Advances every pack by a duration of simulated time.
+     * @param duration_s Simulated time in seconds.
+     */
+    void run(uint64_t duration_s);
+
+    /**
+     * @brief Gets the simulated time all packs have reached.
+     * @return Simulated time in seconds.
+     */
+    uint64_t getTime_s() const;
+
+    /**
+     * @brief Gets the outcome totals of all packs so far.
+     * @return Statistics summed over all packs.
+     */
+    LifetimeStatistics getStatistics() const;
+
+    /**
+     * @brief Gets the number of packs.
+     * @return Number of packs.
+     */
+    size_t getPackCount() const;
+
+    /**
+     * @brief Gets the safety state of a pack.
+     * @param pack Index of the pack.
+     * @return The pack's current SystemState.
+     */
+    SystemState getPackState(size_t pack) const;
+
+    /**
+     * @brief Gets the estimated State of Health of a pack.
+     * @param pack Index of the pack.
+     * @return SoH in percent.
+     */
+    float getPackStateOfHealth_percent(size_t pack) const;
+
+    /**
+     * @brief Gets the online capacity estimate of a pack.
+     * @param pack Index of the pack.
+     * @return Capacity in mAh.
+     */
+    float getPackCapacity_mAh(size_t pack) const;
+
+private:
+    /**
+     * @brief One simulated pack with its estimators and usage schedule.
+     */
+    struct LifetimePack {
+        SimulatedCellBank cells;                   // Cell physics
+        SafetyManager safetyManager;               // Safety state
+        SplitMix64 usage;                          // Generator of the usage schedule
+        float current_A;                           // Pack current of the current phase (0 when parked)
+        uint64_t step;                             // Time step the pack has reached
+        uint64_t phaseEnd;                         // Time step the current phase ends at
+        float accumulatedCharge_mAh;               // Coulomb counter
+        float chargeCompensation_mAh;              // Rounding compensation of the Coulomb counter
+        float estimatedCapacity_mAh;               // Online capacity estimate
+        CapacityEstimatorState capacityEstimator;  // State of the capacity estimate
+        float stateOfCharge_percent;               // Estimated SoC
+        float stateOfHealth_percent;               // Estimated SoH
+        float chargeCycles;                        // Counted charge cycles
+        uint8_t wasFull;                           // Cycle counting flags (0 or 1)
+        uint8_t wasEmpty;
+        std::array<uint64_t, 4> stepsInState;      // Time steps spent in each SystemState
+        std::array<uint64_t, 4> entriesIntoState;  // Transitions into each SystemState
+        uint64_t evaluatedSteps;                   // Time steps evaluated one by one
+        uint64_t skippedSteps;                     // Time steps jumped over
+        uint64_t idleJumps;                        // Number of idle jumps
+
+        LifetimePack(const CellVariability& variability, uint64_t seed);
+    };
+
+    /**
+     * @brief Next interesting time step of a pack; ordered by time step for the event queue.
+     */
+    struct PackEvent {
+        uint64_t step;
+        size_t pack;
+
+        bool operator>(const PackEvent& other) const {
+            return step > other.step || (step == other.step && pack > other.pack);
+        }
+    };
+
+    std::vector<LifetimePack> m_packs;
+    std::priority_queue<PackEvent, std::vector<PackEvent>, std::greater<PackEvent>> m_events; // Earliest first
+    SimulationStepping m_stepping;
+    uint64_t m_step;        // Time step all packs have reached
+    float m_deltaTime_s;    // Length of a time step
+
+    /**
+     * @brief Handles a pack at its next interesting time step, up to a horizon.
+     * @param pack The pack.
+     * @param horizon Time step the current run() ends at.
+     */
+    void processEvent(LifetimePack& pack, uint64_t horizon);
+
+    /**
+     * @brief Evaluates one time step of a pack: readings, physics, estimators, safety.
+     * @param pack The pack.
+     */
+    void stepPack(LifetimePack& pack);
+
+    /**
+     * @brief Starts the next phase of a pack's usage schedule.
+     * Active phases (drive or charge) alternate with parked periods.
+     * @param pack The pack.
+     */
+    void startNextPhase(LifetimePack& pack);
+};
+
+#endif // EVENT_DRIVEN_SIMULATOR_H
@@ -0,0 +1,243 @@
+// inc/Fleet.h
+#ifndef FLEET_H
+#define FLEET_H
+
+#include <array>     // For std::array
+#include <condition_variable> // For std::condition_variable
+#include <cstddef>   // For size_t
+#include <cstdint>   // For uint64_t
+#include <memory>    // For std::shared_ptr
+#include <mutex>     // For std::mutex
+#include <thread>    // For std::thread
+#include <vector>    // For std::vector
+#include "../inc/BMS.h"           // For BMS class
+#include "../inc/CellRanking.h"   // For TopKHeap, RankedCell, CellMetric
+#include "../inc/FleetArena.h"    // For FleetArena class
+#include "../inc/QuantileSketch.h" // For QuantileSketch class
+
+/**
+ * @brief Fleet-wide distributions tracked with quantile sketches.
+ */
+enum class FleetDistribution : uint8_t {
+    STATE_OF_CHARGE,  // Pack SoC (%)
+    STATE_OF_HEALTH,  // Pack SoH (%)
+    CELL_TEMPERATURE, // Every cell temperature (Celsius)
+    IMBALANCE         // Pack max - min cell voltage (Volts)
+};
+
+// Number of FleetDistribution values
+const uint8_t FLEET_DISTRIBUTION_COUNT = 4;
+
+/**
+ * @brief How Fleet::update() runs the estimators of its packs.
+ */
+enum class FleetExecution : uint8_t {
+    PER_PACK,   // Estimators of BMS::update() for one pack after the other
+    PACK_MAJOR  // SoC, SoH and safety kernels over pack-major arrays of a whole shard
+};
+
+/**
+ * @brief Pack-major (structure of arrays) copy of the hot scalars of a block of a shard's packs.
+ * Index p holds pack p of the shard; the cell arrays are pack-major, cell c of pack p at
+ * p * NUM_CELLS + c, so they can be passed to SafetyManager::proposeStates() as frames.
+ * The string arrays are pack-major too, as SensorSimulator::solveStringCurrents() takes them.
+ */
+struct PackColumns {
+    std::vector<float> packCurrent_A;          // Pack current
+    std::vector<float> stringOcv_V;            // String open-circuit voltages, packs x NUM_PARALLEL_STRINGS
+    std::vector<float> stringResistance_Ohm;   // String resistances, packs x NUM_PARALLEL_STRINGS
+    std::vector<float> stringCurrent_A;        // Solved string currents, packs x NUM_PARALLEL_STRINGS
+    std::vector<float> cellVoltages_V;         // Cell voltages, packs x NUM_CELLS
+    std::vector<float> cellTemperatures_C;     // Cell temperatures, packs x NUM_CELLS
+    std::vector<float> estimatedCapacity_mAh;  // Capacity estimate the SoC is based on
+    std::vector<float> accumulatedCharge_mAh;  // Accumulated charge for SoC
+    std::vector<float> chargeCompensation_mAh; // Rounding compensation of the accumulated charge
+    std::vector<float> stateOfCharge_percent;  // SoC after the kernels
+    std::vector<float> stateOfHealth_percent;  // SoH after the kernels
+    std::vector<float> previousSoC_percent;    // SoC before the kernels
+    std::vector<float> previousSoH_percent;    // SoH before the kernels
+    std::vector<float> chargeCycles;           // Number of full charge cycles
+    std::vector<uint8_t> wasFull;              // SoH cycle counting flags (0 or 1)
+    std::vector<uint8_t> wasEmpty;
+    std::vector<uint8_t> cycleCompleted;       // Half cycle completed in this update (0 or 1)
+    std::vector<SystemState> proposedState;    // Safety state proposed by the kernel
+
+    /**
+     * @brief Sizes every column for a number of packs.
+     * @param packCount Number of packs.
+     */
+    void resize(size_t packCount);
+};
+
+/**
+ * @brief Working state of one fleet shard, written only by the thread updating that shard.
+ * Cache-line aligned, so the heaps and sketches of neighbouring shards never share a line.
+ */
+struct alignas(64) FleetShardState {
+    std::array<TopKHeap, CELL_METRIC_COUNT> heaps;                  // Worst cells per metric
+    std::array<QuantileSketch, FLEET_DISTRIBUTION_COUNT> sketches;  // Fleet distributions
+    PackColumns columns;                                            // Pack-major scalars
+};
+
+/**
+ * @brief Dashboard percentiles of one fleet-wide distribution.
+ */
+struct FleetPercentiles {
+    float p1;
+    float p50;
+    float p99;
+};
+
+/**
+ * @brief Fleet-wide results published once per fleet update.
+ * Snapshots are immutable once published, so readers never block the workers.
+ */
+struct FleetSnapshot {
+    uint64_t tick;                                                                  // Fleet update this snapshot belongs to
+    std::array<std::array<RankedCell, FLEET_TOP_K>, CELL_METRIC_COUNT> worstCells;  // Worst cells per CellMetric, worst first
+    std::array<size_t, CELL_METRIC_COUNT> worstCellCounts;                          // Valid entries per metric
+    std::array<FleetPercentiles, FLEET_DISTRIBUTION_COUNT> percentiles;             // Percentiles per FleetDistribution
+};
+
+/**
+ * @brief Simulates many battery packs in parallel and ranks their cells fleet-wide.
+ * Packs are split into contiguous shards, one worker thread per shard. The workers are
+ * started once with the fleet and wait for each update(), whose caller runs shard 0, so
+ * an update costs a wake-up per shard rather than a thread creation. Each worker
+ * updates its packs and keeps bounded top-k heaps of its worst cells; the heaps are
+ * merged once per update and published as an immutable FleetSnapshot. Fleet-wide
+ * percentiles come from per-shard quantile sketches merged pairwise in a tree, so no
+ * per-pack values are collected or sorted.
+ * The hot and warm state of all packs lives in two contiguous arrays of cache-line
+ * aligned records, separate from the BMS objects, so fleet-wide readouts stream only
+ * the hot records and packs of different shards never share a cache line. The packs,
+ * their state arrays and their cell models are all allocated from one FleetArena, i.e.
+ * a few huge-page-eligible blocks instead of several heap allocations per pack; the
+ * BMS objects are cache-line aligned and each pack's cell model starts on a fresh cache
+ * line, so packs on either side of a shard boundary share none. The heaps, sketches and
+ * columns each shard writes are kept in one cache-line aligned FleetShardState per shard.
+ * Packs are read in blocks: the string currents of every pack in a block are solved in
+ * one batched call over pack-major arrays before the cells are read under them.
+ * In FleetExecution::PACK_MAJOR mode each shard copies the hot scalars of its packs into
+ * PackColumns, runs the SoC, SoH and safety kernels across the packs there (several packs
+ * per instruction) and copies the results back. The kernels are the ones BMS::update()
+ * runs for a single pack, so both modes give identical results.
+ */
+class Fleet {
+public:
+    /**
+     * @brief Constructor for Fleet.
+     * Creates the packs with console output disabled.
+     * @param packCount Number of packs in the fleet.
+     * @param shardCount Number of worker shards (0 selects the number of hardware threads).
+     * @param execution How the estimators of the packs are run.
+     */
+    Fleet(size_t packCount, size_t shardCount = 0, FleetExecution execution = FleetExecution::PER_PACK);
+
+    /**
+     * @brief Destructor for Fleet.
+     * Stops the shard workers and destroys the packs; their memory is released with the arena.
+     */
+    ~Fleet();
+
+    Fleet(const Fleet&) = delete;
+    Fleet& operator=(const Fleet&) = delete;
+
+    /**
+     * @brief Updates every pack once and publishes a new FleetSnapshot.
+     * @param deltaTime_s The time elapsed since the last update in seconds.
+     */
+    void update(float deltaTime_s);
+
+    /**
+     * @brief Gets the most recently published snapshot.
+     * Safe to call from any thread while update() is running.
+     * @return Shared pointer to the snapshot (empty rankings before the first update).
+     */
+    std::shared_ptr<const FleetSnapshot> getSnapshot() const;
+
+    /**
+     * @brief Fills one EnergyReport per pack.
+     * @param reports Output vector, resized to the number of packs.
+     */
+    void queryEnergy(std::vector<EnergyReport>& reports) const;
+
+    /**
+     * @brief Adds the residency histograms of all packs into one fleet-wide histogram.
+     * Call between updates; the histograms are read without synchronization.
+     * @param histogram Output histogram; cleared first.
+     */
+    void mergeResidency(ResidencyHistogram& histogram) const;
+
+    /**
+     * @brief Gets the number of packs in the fleet.
+     * @return Number of packs.
+     */
+    size_t getPackCount() const;
+
+    /**
+     * @brief Gets one pack of the fleet.
+     * @param packIndex Index of the pack (0 to getPackCount() - 1).
+     * @return Reference to the pack.
+     */
+    const BMS& getPack(size_t packIndex) const;
+
+    /**
+     * @brief Gets the memory the fleet's packs occupy.
+     * @return Bytes allocated from the fleet arena.
+     */
+    size_t getPackMemoryBytes() const;
+
+private:
+    FleetArena m_arena;                                              // Memory of the packs and their state
+    size_t m_packCount;                                              // Number of packs
+    BMS* m_packs;                                                    // All packs of the fleet (cold state), in the arena
+    PackHotState* m_hotStates;                                       // Hot state of every pack, in the arena
+    PackWarmState* m_warmStates;                                     // Warm state of every pack, in the arena
+    std::vector<FleetShardState> m_shards;                           // Heaps, sketches and columns per shard
+    size_t m_shardCount;                                             // Number of worker shards
+    FleetExecution m_execution;                                      // How the estimators are run
+    uint64_t m_tick;                                                 // Number of completed updates
+    std::shared_ptr<const FleetSnapshot> m_snapshot;                 // Last published snapshot
+    std::vector<std::thread> m_workers;                              // Workers of shards 1 to m_shardCount - 1
+    std::mutex m_tickMutex;                                          // Guards the tick hand-off below
+    std::condition_variable m_tickStarted;                           // Signals the workers a new update
+    std::condition_variable m_tickFinished;                          // Signals update() the last worker is done
+    uint64_t m_tickGeneration;                                       // Incremented for every update handed to the workers
+    size_t m_pendingShards;                                          // Workers still updating the current tick
+    float m_tickDeltaTime_s;                                         // Time step of the current tick
+    bool m_workersRunning;                                           // Cleared to stop the workers
+
+    /**
+     * @brief Updates the packs of one shard and rebuilds its heaps and sketches.
+     * @param shard Index of the shard.
+     * @param deltaTime_s The time elapsed since the last update in seconds.
+     */
+    void updateShard(size_t shard, float deltaTime_s);
+
+    /**
+     * @brief Body of the worker thread of one shard: updates the shard once per tick.
+     * @param shard Index of the shard (1 to m_shardCount - 1).
+     */
+    void shardLoop(size_t shard);
+
+    /**
+     * @brief Reads the sensors of a block of packs [begin, end) of a shard.
+     * @param columns The shard's pack-major scalars, sized for FLEET_PACK_MAJOR_BLOCK_PACKS packs.
+     * @param begin Index of the block's first pack.
+     * @param end Index after the block's last pack (at most FLEET_PACK_MAJOR_BLOCK_PACKS after begin).
+     * @param deltaTime_s The time elapsed since the last update in seconds.
+     */
+    void readSensors(PackColumns& columns, size_t begin, size_t end, float deltaTime_s);
+
+    /**
+     * @brief Updates a block of packs [begin, end) of a shard in pack-major mode.
+     * @param columns The shard's pack-major scalars, sized for FLEET_PACK_MAJOR_BLOCK_PACKS packs.
+     * @param begin Index of the block's first pack.
+     * @param end Index after the block's last pack (at most FLEET_PACK_MAJOR_BLOCK_PACKS after begin).
+     * @param deltaTime_s The time elapsed since the last update in seconds.
+     */
+    void updatePackMajor(PackColumns& columns, size_t begin, size_t end, float deltaTime_s);
+};
+
+#endif // FLEET_H
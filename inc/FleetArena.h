@@ -0,0 +1,101 @@
+// inc/FleetArena.h
+#ifndef FLEET_ARENA_H
+#define FLEET_ARENA_H
+
+#include <cstddef>          // For size_t
+#include <memory_resource>  // For std::pmr::memory_resource
+#include <vector>           // For std::vector
+#include "../inc/Constants.h" // For FLEET_ARENA_* settings
+
+/**
+ * @brief Bump allocator over a few large, huge-page-eligible memory blocks.
+ * Meant for state that is created once and released all at once, like the packs of a
+ * fleet: allocating is a pointer increment, deallocating does nothing, and the blocks
+ * are unmapped when the arena is destroyed. Blocks are mapped with mmap, aligned to
+ * FLEET_ARENA_PAGE_BYTES and marked for transparent huge pages, so the pack state needs
+ * few page faults and TLB entries. As a std::pmr::memory_resource it can back standard
+ * containers (std::pmr::vector). Not thread-safe.
+ */
+class FleetArena : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Constructor for FleetArena.
+     * No memory is mapped until the first allocation.
+     * @param blockBytes Size of each block; rounded up to FLEET_ARENA_PAGE_BYTES.
+     */
+    explicit FleetArena(size_t blockBytes = FLEET_ARENA_BLOCK_BYTES);
+
+    /**
+     * @brief Destructor for FleetArena.
+     * Unmaps all blocks. Objects in the arena must have been destroyed before.
+     */
+    ~FleetArena() override;
+
+    FleetArena(const FleetArena&) = delete;
+    FleetArena& operator=(const FleetArena&) = delete;
+
+    /**
+     * @brief Gets the number of bytes handed out, including alignment padding.
+     * @return Used bytes.
+     */
+    size_t getUsedBytes() const;
+
+    /**
+     * @brief Gets the number of bytes mapped for all blocks.
+     * @return Reserved bytes.
+     */
+    size_t getReservedBytes() const;
+
+    /**
+     * @brief Pads the cursor to an alignment, so the next allocation starts there.
+     * Used to give every group of small allocations (e.g. the cell model of one pack)
+     * its own cache lines, so groups written by different threads share none.
+     * @param alignment Alignment (power of two).
+     */
+    void alignNext(size_t alignment);
+
+private:
+    /**
+     * @brief One mapped block.
+     */
+    struct Block {
+        void* base;
+        size_t size;
+    };
+
+    std::vector<Block> m_blocks;  // All mapped blocks
+    char* m_cursor;               // Next free byte of the current block
+    char* m_end;                  // End of the current block
+    size_t m_blockBytes;          // Size of a regular block
+    size_t m_usedBytes;           // Bytes handed out
+    size_t m_reservedBytes;       // Bytes mapped
+
+    /**
+     * @brief Allocates from the current block, mapping a new block if it is full.
+     * @param bytes Number of bytes.
+     * @param alignment Alignment (power of two).
+     * @return Pointer to the memory; throws std::bad_alloc if no block can be mapped.
+     */
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    /**
+     * @brief Does nothing; memory is released when the arena is destroyed.
+     */
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+
+    /**
+     * @brief Checks whether another resource is this arena.
+     * @param other The other resource.
+     * @return True if memory of one can be deallocated by the other.
+     */
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    /**
+     * @brief Maps a new block and makes it the current block.
+     * @param minBytes Minimum usable size of the block.
+     * @return True on success, false if the mapping failed.
+     */
+    bool addBlock(size_t minBytes);
+};
+
+#endif // FLEET_ARENA_H
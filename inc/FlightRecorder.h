@@ -0,0 +1,168 @@
+// inc/FlightRecorder.h
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <array>   // For std::array
+#include <atomic>  // For std::atomic
+#include <cstdint> // For uint32_t, uint64_t
+#include <string>  // For std::string
+#include <thread>  // For std::thread
+#include <vector>  // For std::vector
+#include "../inc/BMS.h"       // For PackHotState
+#include "../inc/BMS_States.h" // For SystemState enum
+#include "../inc/Constants.h" // For FLIGHT_RECORDER_* parameters
+
+/**
+ * @brief One recorded update: the pack's full hot state and the safety state it led to.
+ */
+struct FlightRecorderFrame {
+    double time_s;          // Time since the recorder started (seconds)
+    SystemState state;      // Safety state after the update
+    PackHotState hot;       // Readings and estimates of the update
+};
+
+/**
+ * @brief Header of a freeze-frame file, followed by frameCount FlightRecorderFrame records, oldest first.
+ */
+struct FreezeFrameHeader {
+    uint32_t magic;                  // Must be FLIGHT_RECORDER_MAGIC
+    uint32_t version;                // Must be FLIGHT_RECORDER_VERSION
+    uint32_t frameSize;              // sizeof(FlightRecorderFrame) of the writer
+    uint32_t frameCount;             // Number of frames in the file
+    uint32_t triggerFrame;           // Index of the frame the fault was detected in
+    uint32_t captureNumber;          // Number of the capture since the recorder started
+    char reason[EVENT_TEXT_LENGTH];  // Fault description, NUL-terminated
+};
+
+/**
+ * @brief Flight recorder keeping the frames around a fault of one pack.
+ * Every update is copied into a ring of FLIGHT_RECORDER_PRE_FRAMES +
+ * FLIGHT_RECORDER_POST_FRAMES frames, overwriting the oldest in place, so a tick costs one
+ * memcpy of the hot state. trigger() marks the latest frame as the fault; after
+ * FLIGHT_RECORDER_POST_FRAMES more updates the ring holds exactly the pre-trigger and the
+ * post-trigger window and is frozen. A writer thread then writes it to a freeze-frame file
+ * while recording continues in a second ring; the rings change hands through an atomic
+ * flag each, without locks. If both rings still wait for the writer, frames and triggers
+ * are dropped and counted rather than blocking the control loop.
+ */
+class FlightRecorder {
+public:
+    /**
+     * @brief Constructor for FlightRecorder.
+     * The writer thread is not started until start() is called.
+     * @param filePrefix Freeze-frame files are named <filePrefix>_<capture number>.bin.
+     */
+    explicit FlightRecorder(const std::string& filePrefix = FLIGHT_RECORDER_FILE_PREFIX);
+
+    /**
+     * @brief Destructor. Stops the writer thread after writing every frozen capture.
+     */
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    /**
+     * @brief Starts the writer thread.
+     */
+    void start();
+
+    /**
+     * @brief Stops the writer thread after writing every frozen capture.
+     */
+    void stop();
+
+    /**
+     * @brief Records the frame of one update (control thread).
+     * @param hot The pack's hot state after the update.
+     * @param state The safety state after the update.
+     * @param deltaTime_s The time elapsed since the last update in seconds.
+     */
+    void record(const PackHotState& hot, SystemState state, float deltaTime_s);
+
+    /**
+     * @brief Marks the last recorded frame as a fault and starts the post-trigger capture (control thread).
+     * @param reason Description of the fault, stored in the file (truncated to fit).
+     * @return True if a capture started, false if one is already running or no ring is free.
+     */
+    bool trigger(const char* reason);
+
+    /**
+     * @brief Checks whether a post-trigger window is being captured.
+     * @return True while capturing, false otherwise.
+     */
+    bool isCapturing() const;
+
+    /**
+     * @brief Writes every frozen capture on the calling thread.
+     * For use when no writer thread is running.
+     * @return Number of freeze-frame files written.
+     */
+    uint32_t writePending();
+
+    /**
+     * @brief Gets the number of freeze-frame files written.
+     * @return Number of files.
+     */
+    uint32_t getWrittenCount() const;
+
+    /**
+     * @brief Gets the number of triggers and frames dropped because both rings waited for the writer.
+     * @return Number of dropped triggers plus dropped frames.
+     */
+    uint64_t getDroppedCount() const;
+
+    /**
+     * @brief Reads a freeze-frame file.
+     * @param path The file to read.
+     * @param header Receives the header.
+     * @param frames Receives the frames, oldest first.
+     * @return True if a valid file of this layout was read, false otherwise.
+     */
+    static bool readFreezeFrame(const std::string& path, FreezeFrameHeader& header, std::vector<FlightRecorderFrame>& frames);
+
+private:
+    static const uint32_t RING_FRAMES = FLIGHT_RECORDER_PRE_FRAMES + FLIGHT_RECORDER_POST_FRAMES;
+
+    /**
+     * @brief One ring of frames; owned by the control thread until frozen, then by the writer.
+     */
+    struct CaptureRing {
+        std::array<FlightRecorderFrame, RING_FRAMES> frames; // Frames, overwritten in place
+        uint32_t next = 0;                  // Slot the next frame goes to
+        uint32_t count = 0;                 // Number of valid frames (up to RING_FRAMES)
+        uint32_t captureNumber = 0;         // Number of the capture, set when frozen
+        char reason[EVENT_TEXT_LENGTH] = {}; // Fault description
+        std::atomic<bool> frozen{false};    // Waiting for (or being written by) the writer
+    };
+
+    std::array<CaptureRing, 2> m_rings;  // Recording ring and the one being written
+    int m_activeRing;                    // Ring frames go to, -1 while both are frozen
+    uint32_t m_postFramesLeft;           // Post-trigger frames still to capture, 0 if not capturing
+    uint32_t m_captureCount;             // Captures frozen so far
+    double m_time_s;                     // Time since the recorder started
+    const std::string m_filePrefix;      // Prefix of the freeze-frame file names
+    std::thread m_writer;                // Writer thread
+    std::atomic<bool> m_running;         // Writer thread should keep running
+    std::atomic<uint32_t> m_written;     // Freeze-frame files written
+    std::atomic<uint64_t> m_dropped;     // Dropped triggers and frames
+
+    /**
+     * @brief Hands the active ring to the writer and continues in the other one, if free.
+     */
+    void freeze();
+
+    /**
+     * @brief Writes one frozen ring to its freeze-frame file (writer side).
+     * @param ring The ring to write.
+     * @return True on success, false otherwise.
+     */
+    bool writeRing(const CaptureRing& ring) const;
+
+    /**
+     * @brief Body of the writer thread.
+     */
+    void writeLoop();
+};
+
+#endif // FLIGHT_RECORDER_H
@@ -0,0 +1,90 @@
+// inc/QuantileSketch.h
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <array>     // For std::array
+#include <cstddef>   // For size_t
+#include "../inc/Constants.h"     // For SKETCH_COMPRESSION, SKETCH_BUFFER_SIZE, SKETCH_VALUE_BUFFER_SIZE
+
+/**
+ * @brief Mergeable streaming quantile sketch (merging t-digest).
+ * Values are buffered and periodically folded into at most SKETCH_COMPRESSION + 1
+ * centroids, whose size limit shrinks towards the tails so that p1/p99 stay accurate.
+ * Added values are buffered as plain floats, SKETCH_VALUE_BUFFER_SIZE at a time, so each
+ * compression sorts a large batch of floats and walks it together with the already sorted
+ * centroids; the per-compression cost is spread over many values.
+ * All storage is fixed-size (a few KB), so sketches can be built per worker shard and
+ * merged hierarchically without allocating.
+ */
+class QuantileSketch {
+public:
+    /**
+     * @brief Constructor for QuantileSketch.
+     * Starts empty.
+     */
+    QuantileSketch();
+
+    /**
+     * @brief Adds one value to the sketch.
+     * @param value The value to add.
+     */
+    void add(float value);
+
+    /**
+     * @brief Merges another sketch into this one.
+     * @param other The sketch to merge in.
+     */
+    void merge(const QuantileSketch& other);
+
+    /**
+     * @brief Folds all buffered values into the centroids.
+     */
+    void flush();
+
+    /**
+     * @brief Removes all values.
+     */
+    void clear();
+
+    /**
+     * @brief Estimates a quantile of all values added so far.
+     * @param q The quantile (0.0 to 1.0), e.g. 0.99 for p99.
+     * @return The estimated value, or 0.0 if the sketch is empty.
+     */
+    float quantile(float q) const;
+
+    /**
+     * @brief Gets the number of values added so far.
+     * @return Number of values.
+     */
+    double getCount() const;
+
+private:
+    /**
+     * @brief A cluster of nearby values summarised by their mean and count.
+     */
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    static constexpr size_t MAX_CENTROIDS = SKETCH_COMPRESSION + 1;
+
+    std::array<Centroid, MAX_CENTROIDS> m_centroids;        // Compressed centroids, sorted by mean
+    size_t m_centroidCount;                                 // Number of valid centroids
+    std::array<Centroid, SKETCH_BUFFER_SIZE> m_buffer;      // Merged centroids not yet compressed
+    size_t m_bufferCount;                                   // Number of valid buffer entries
+    std::array<float, SKETCH_VALUE_BUFFER_SIZE> m_values;   // Added values not yet compressed
+    size_t m_valueCount;                                    // Number of valid buffered values
+    double m_totalWeight;                                   // Number of values, compressed and buffered
+    double m_min;                                           // Smallest compressed value
+    double m_max;                                           // Largest compressed value
+
+    /**
+     * @brief Adds a weighted centroid to the buffer, compressing first if it is full.
+     * @param centroid The centroid to add.
+     */
+    void addCentroid(const Centroid& centroid);
+};
+
+#endif // QUANTILE_SKETCH_H
@@ -0,0 +1,85 @@
+// inc/ResidencyHistogram.h
+#ifndef RESIDENCY_HISTOGRAM_H
+#define RESIDENCY_HISTOGRAM_H
+
+#include <array>     // For std::array
+#include <cstdint>   // For uint8_t, uint32_t, uint64_t
+#include <ostream>   // For std::ostream
+#include "../inc/BatteryCell.h"   // For BatteryCell class
+#include "../inc/Constants.h"     // For NUM_CELLS and bin layout
+
+// Number of 2D bins (voltage x temperature) per cell
+const uint32_t RESIDENCY_BINS_PER_CELL = static_cast<uint32_t>(RESIDENCY_VOLTAGE_BINS) * RESIDENCY_TEMP_BINS;
+
+/**
+ * @brief Time-at-voltage and time-at-temperature residency histograms for warranty analysis.
+ * Keeps one 2D histogram (voltage bins x temperature bins) per cell and accumulates how
+ * long each cell spent in each bin, weighted by the time step of every update, so the
+ * result does not depend on the update rate. Times are whole milliseconds in uint64
+ * counters in one flat cell-major array (RESIDENCY_BINS_PER_CELL * 8 bytes per cell), so
+ * merging two histograms is a single vectorizable pass; the fraction of a millisecond
+ * left over by a time step is carried to the next update.
+ */
+class ResidencyHistogram {
+public:
+    /**
+     * @brief Constructor for ResidencyHistogram.
+     * Starts with all times at zero.
+     */
+    ResidencyHistogram();
+
+    /**
+     * @brief Records one update worth of residency for every cell.
+     * @param cells An array of BatteryCell objects holding the latest readings.
+     * @param deltaTime_s The time the readings stand for in seconds.
+     */
+    void record(const std::array<BatteryCell, NUM_CELLS>& cells, float deltaTime_s);
+
+    /**
+     * @brief Adds the times of another histogram, e.g. from another pack.
+     * Times saturate instead of wrapping around.
+     * @param other The histogram to merge in.
+     */
+    void merge(const ResidencyHistogram& other);
+
+    /**
+     * @brief Resets all times to zero.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the time a cell spent in a bin.
+     * @param cellId The ID of the cell.
+     * @param voltageBin The voltage bin index (0 to RESIDENCY_VOLTAGE_BINS - 1).
+     * @param temperatureBin The temperature bin index (0 to RESIDENCY_TEMP_BINS - 1).
+     * @return The time in milliseconds, or 0 for an invalid index.
+     */
+    uint64_t getTime_ms(uint8_t cellId, uint8_t voltageBin, uint8_t temperatureBin) const;
+
+    /**
+     * @brief Writes all non-empty bins as CSV.
+     * Columns: cell, voltage bin range, temperature bin range and time in seconds.
+     * @param out The stream to write to.
+     */
+    void exportCsv(std::ostream& out) const;
+
+    /**
+     * @brief Computes the voltage bin index for a reading.
+     * @param voltage The voltage in Volts.
+     * @return The bin index, clamped to the edge bins.
+     */
+    static uint32_t voltageBin(float voltage);
+
+    /**
+     * @brief Computes the temperature bin index for a reading.
+     * @param temperature The temperature in Celsius.
+     * @return The bin index, clamped to the edge bins.
+     */
+    static uint32_t temperatureBin(float temperature);
+
+private:
+    std::array<uint64_t, NUM_CELLS * RESIDENCY_BINS_PER_CELL> m_times_ms; // Cell-major time per bin
+    double m_carry_ms;                                                      // Fraction of a millisecond not yet recorded
+};
+
+#endif // RESIDENCY_HISTOGRAM_H
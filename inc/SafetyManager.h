@@ -3,10 +3,39 @@
 #define SAFETY_MANAGER_H
 
 #include <array>     // For std::array
+#include <cstddef>   // For size_t
+#include <cstdint>   // For uint16_t, int16_t
+#include <vector>    // For std::vector
 #include "../inc/BMS_States.h"    // For SystemState enum
+#include "../inc/BandLookupTable.h" // For the ADC code classifier
 #include "../inc/BatteryCell.h"   // For BatteryCell class
 #include "../inc/Constants.h"     // For NUM_CELLS and limits
 
+/**
+ * @brief Recorded frames for a batch (offline replay) evaluation, or the latest readings
+ * of many packs with one frame per pack (fleet pack-major mode).
+ * Cell arrays are frame-major: the reading of cell c in frame t is at index t * NUM_CELLS + c.
+ * The arrays are owned by the caller and must hold frameCount frames.
+ */
+struct SafetyFrames {
+    size_t frameCount;                   // Number of frames (T)
+    const float* cellVoltages;           // T x NUM_CELLS cell voltages (Volts)
+    const float* cellTemperatures;       // T x NUM_CELLS cell temperatures (Celsius)
+    const float* packCurrents;           // T pack currents (Amperes)
+    const float* stateOfHealth_percent;  // T State of Health values (%)
+};
+
+/**
+ * @brief Recorded frames of raw ADC codes for a batch (offline replay) evaluation.
+ * Laid out like SafetyFrames, with the cell readings as the integer codes the ADCs deliver.
+ */
+struct SafetyCodeFrames {
+    size_t frameCount;                   // Number of frames (T)
+    const uint16_t* cellVoltageCodes;    // T x NUM_CELLS cell voltages (ADC_VOLTAGE_LSB_V per code)
+    const int16_t* cellTemperatureCodes; // T x NUM_CELLS cell temperatures (ADC_TEMPERATURE_LSB_C per code)
+    const float* packCurrents;           // T pack currents (Amperes)
+    const float* stateOfHealth_percent;  // T State of Health values (%)
+};
 
 /**
  * @brief Manages the safety state of the BMS based on battery cell parameters and pack current.
@@ -31,69 +60,116 @@ public:
     void evaluate(const std::array<BatteryCell, NUM_CELLS>& cells, float packCurrent, float stateOfHealth_percent);
 
     /**
-     * @brief Gets the current safety state of the BMS.
-     * @return The current SystemState.
+     * @brief Computes the state the given readings call for, without changing the system state.
+     * @param cells An array of BatteryCell objects representing the current battery pack data.
+     * @param packCurrent The total current flowing through the battery pack (Amperes).
+     * @param stateOfHealth_percent The current estimated State of Health of the battery pack (%).
+     * @return The proposed SystemState, i.e. the most severe condition found.
      */
-    SystemState getCurrentState() const;
+    SystemState proposeState(const std::array<BatteryCell, NUM_CELLS>& cells, float packCurrent, float stateOfHealth_percent) const;
 
-private:
-    SystemState m_currentState; // The current safety state of the BMS
+    /**
+     * @brief Makes a proposed state the current state, as the end of evaluate() does.
+     * For callers that computed the proposed state themselves, e.g. with proposeStates().
+     * @param proposedState The new state.
+     */
+    void applyState(SystemState proposedState);
 
     /**
-     * @brief Checks if a given voltage is within the normal operating range.
-     * @param voltage The voltage to check.
-     * @return True if voltage is normal, false otherwise.
+     * @brief Computes the proposed state of many frames (or packs) at once with vectorized loops.
+     * proposedStates[t] equals proposeState() of frame t.
+     * @param frames The frames to classify.
+     * @param proposedStates Output array of frames.frameCount states.
      */
-    bool isVoltageNormal(float voltage) const;
+    static void proposeStates(const SafetyFrames& frames, SystemState* proposedStates);
 
     /**
-     * @brief Checks if a given voltage is in the warning range.
-     * @param voltage The voltage to check.
-     * @return True if voltage is in warning, false otherwise.
+     * @brief Evaluates a series of recorded frames in one call, e.g. to replay logged data.
+     * Equivalent to calling evaluate() once per frame in order: states[t] is the state after
+     * frame t, and the manager is left in the state the last evaluate() call would leave it.
+     * @param frames The recorded frames.
+     * @param states Output state series, resized to frames.frameCount.
+     * @return Number of state transitions in the series, counting one from the state before the batch.
      */
-    bool isVoltageWarning(float voltage) const;
+    size_t evaluateBatch(const SafetyFrames& frames, std::vector<SystemState>& states);
 
     /**
-     * @brief Checks if a given voltage is in the critical range.
-     * @param voltage The voltage to check.
-     * @return True if voltage is critical, false otherwise.
+     * @brief Computes the proposed state of many frames of ADC codes at once.
+     * With a lookup table each cell reading is classified by one table load; without one
+     * the codes are converted to physical values and classified like proposeStates() does.
+     * Both give the same states.
+     * @param frames The frames to classify.
+     * @param table The band lookup table, or nullptr for the compare kernels.
+     * @param proposedStates Output array of frames.frameCount states.
      */
-    bool isVoltageCritical(float voltage) const;
+    static void proposeStates(const SafetyCodeFrames& frames, const BandLookupTable* table, SystemState* proposedStates);
 
     /**
-     * @brief Checks if a given voltage is in the fault range (e.g., sensor error).
-     * @param voltage The voltage to check.
-     * @return True if voltage is fault, false otherwise.
+     * @brief Evaluates a series of recorded frames of ADC codes in one call.
+     * As evaluateBatch() for physical values; classifies with the attached lookup table, if any.
+     * @param frames The recorded frames.
+     * @param states Output state series, resized to frames.frameCount.
+     * @return Number of state transitions in the series, counting one from the state before the batch.
      */
-    bool isVoltageFault(float voltage) const;
+    size_t evaluateBatch(const SafetyCodeFrames& frames, std::vector<SystemState>& states);
 
     /**
-     * @brief Checks if a given temperature is within the normal operating range.
-     * @param temperature The temperature to check.
-     * @return True if temperature is normal, false otherwise.
+     * @brief Attaches an optional lookup table that classifies ADC codes in evaluateBatch().
+     * @param table The table (not owned, may be null to classify with the compare kernels).
      */
-    bool isTemperatureNormal(float temperature) const;
+    void setBandLookupTable(const BandLookupTable* table);
 
     /**
-     * @brief Checks if a given temperature is in the warning range.
-     * @param temperature The temperature to check.
-     * @return True if temperature is in warning, false otherwise.
+     * @brief Advances the I2t overload integrator and computes the state it calls for.
+     * @param meanSquareCurrent_A2 Mean of the squared pack current over the interval (A^2).
+     * @param deltaTime_s Length of the interval in seconds.
+     * @return FAULT while tripped, WARNING above I2T_WARNING_FRACTION of the trip level, NORMAL otherwise.
      */
-    bool isTemperatureWarning(float temperature) const;
+    SystemState integrateOverload(float meanSquareCurrent_A2, float deltaTime_s);
 
     /**
-     * @brief Checks if a given temperature is in the critical range.
-     * @param temperature The temperature to check.
-     * @return True if temperature is critical, false otherwise.
+     * @brief Gets the accumulated I2t of the overload integrator.
+     * @return Accumulated I2t in A^2 s.
      */
-    bool isTemperatureCritical(float temperature) const;
+    float getOverloadIntegral_A2s() const;
+
+    /**
+     * @brief Checks whether the overload protection has tripped and not yet cleared.
+     * @return True if tripped, false otherwise.
+     */
+    bool isOverloadTripped() const;
+
+    /**
+     * @brief Gets the current safety state of the BMS.
+     * @return The current SystemState.
+     */
+    SystemState getCurrentState() const;
+
+    /**
+     * @brief Gets the safety state before the last evaluation.
+     * @return The previous SystemState.
+     */
+    SystemState getPreviousState() const;
+
+    /**
+     * @brief Checks whether the last evaluation changed the state.
+     * @return True if the state changed, false otherwise.
+     */
+    bool hasStateChanged() const;
+
+private:
+    SystemState m_currentState;  // The current safety state of the BMS
+    SystemState m_previousState; // The state before the last evaluation
+    float m_overloadIntegral_A2s; // Accumulated I2t above the rated current
+    bool m_overloadTripped;      // I2t reached I2T_TRIP_A2S and has not cooled down yet
+    const BandLookupTable* m_bandTable; // Classifier of ADC code frames (not owned, may be null)
 
     /**
-     * @brief Checks if a given temperature is in the fault range.
-     * @param temperature The temperature to check.
-     * @return True if temperature is fault, false otherwise.
+     * @brief Folds a series of proposed states in order, as evaluate() once per frame would.
+     * @param states The proposed state of every frame (at least one).
+     * @return Number of state transitions in the series, counting one from the state before the batch.
      */
-    bool isTemperatureFault(float temperature) const;
+    size_t foldStates(const std::vector<SystemState>& states);
 
     /**
      * @brief Checks if a given current is within the normal operating range.
@@ -0,0 +1,79 @@
+// inc/SensorDiagnostics.h
+#ifndef SENSOR_DIAGNOSTICS_H
+#define SENSOR_DIAGNOSTICS_H
+
+#include <array>     // For std::array
+#include <cstdint>   // For uint8_t, uint16_t
+#include "../inc/BatteryCell.h"   // For BatteryCell class
+#include "../inc/Constants.h"     // For NUM_CELLS and diagnostic limits
+
+// Per-cell sensor diagnostic flags (bit mask)
+const uint8_t SENSOR_DIAG_OK                = 0x00; // No sensor problem detected
+const uint8_t SENSOR_DIAG_VOLTAGE_STUCK     = 0x01; // Voltage reading has not changed for a full window
+const uint8_t SENSOR_DIAG_TEMPERATURE_STUCK = 0x02; // Temperature reading has not changed for a full window
+const uint8_t SENSOR_DIAG_VOLTAGE_OPEN_WIRE = 0x04; // Out-of-range voltage not confirmed by the pack channel
+const uint8_t SENSOR_DIAG_THERMISTOR_OPEN   = 0x08; // Temperature reading at the open-circuit end of the range
+
+/**
+ * @brief Sensor plausibility diagnostics running alongside the safety evaluation.
+ * Distinguishes sensor faults (stuck readings, open sense wires, open thermistors)
+ * from real cell faults by checking each reading against its own history and
+ * against an independent pack-voltage channel.
+ * State is kept per cell in structure-of-arrays form and updated incrementally,
+ * so one update costs a single pass over the cells.
+ */
+class SensorDiagnostics {
+public:
+    /**
+     * @brief Constructor for SensorDiagnostics.
+     * Clears all per-cell history and flags.
+     */
+    SensorDiagnostics();
+
+    /**
+     * @brief Updates the diagnostic state with the latest readings.
+     * @param cells An array of BatteryCell objects holding the latest readings.
+     * @param packVoltage The reading of the independent pack-voltage channel (Volts).
+     */
+    void update(const std::array<BatteryCell, NUM_CELLS>& cells, float packVoltage);
+
+    /**
+     * @brief Gets the diagnostic flags currently active for a cell.
+     * @param cellId The ID of the cell.
+     * @return Bit mask of SENSOR_DIAG_* flags.
+     */
+    uint8_t getCellFlags(uint8_t cellId) const;
+
+    /**
+     * @brief Gets the diagnostic flags of a cell that were raised by the last update.
+     * @param cellId The ID of the cell.
+     * @return Bit mask of SENSOR_DIAG_* flags that were not active before the last update.
+     */
+    uint8_t getRaisedFlags(uint8_t cellId) const;
+
+    /**
+     * @brief Checks whether the mean string sum of the cell voltages disagrees with the pack-voltage channel.
+     * @return True if the mismatch exceeds DIAG_PACK_SUM_TOLERANCE_V, false otherwise.
+     */
+    bool isPackSumMismatch() const;
+
+    /**
+     * @brief Checks whether any sensor fault is currently active.
+     * @return True if any cell has a flag set or the pack sum mismatches, false otherwise.
+     */
+    bool hasSensorFault() const;
+
+private:
+    // Per-cell history and flags (structure of arrays)
+    std::array<float, NUM_CELLS> m_lastVoltage;           // Previous voltage reading (Volts)
+    std::array<float, NUM_CELLS> m_lastTemperature;       // Previous temperature reading (Celsius)
+    std::array<uint16_t, NUM_CELLS> m_voltageUnchanged;   // Consecutive unchanged voltage readings
+    std::array<uint16_t, NUM_CELLS> m_temperatureUnchanged; // Consecutive unchanged temperature readings
+    std::array<uint8_t, NUM_CELLS> m_flags;               // Active SENSOR_DIAG_* flags
+    std::array<uint8_t, NUM_CELLS> m_raisedFlags;         // Flags raised by the last update
+
+    bool m_packSumMismatch; // Mean string sum of the cell voltages disagrees with the pack channel
+    bool m_hasHistory;      // False until the first update has been processed
+};
+
+#endif // SENSOR_DIAGNOSTICS_H
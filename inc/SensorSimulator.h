@@ -2,22 +2,32 @@
 #ifndef SENSOR_SIMULATOR_H
 #define SENSOR_SIMULATOR_H
 
+#include <array>   // For std::array
+#include <cstddef> // For size_t
 #include <cstdint> // For uint8_t
-#include <random>  // For random number generation
+#include <memory_resource> // For std::pmr::memory_resource
+#include <random>  // For random number distributions
 #include "../inc/Constants.h" // For simulation ranges
+#include "../inc/SplitMix64.h" // For SplitMix64 class
+#include "../inc/SimulatedCellBank.h" // For SimulatedCellBank class
 
 /**
  * @brief Simulates sensor readings for battery cells and pack current.
  * This class provides a hardware-agnostic way to get sensor data,
  * which can be replaced by real drivers later.
+ * Cell readings come from a SimulatedCellBank of heterogeneous cells, plus measurement
+ * noise and occasional injected faults. The cells form NUM_PARALLEL_STRINGS parallel
+ * strings of CELLS_PER_STRING series cells; each string's open-circuit voltage and
+ * resistance are the sums over its cells, and each cell carries its string's current.
  */
 class SensorSimulator {
 public:
     /**
      * @brief Constructor for SensorSimulator.
      * Initializes the random number generator.
+     * @param memory Memory resource the cell model is allocated from.
      */
-    SensorSimulator();
+    explicit SensorSimulator(std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
     /**
      * @brief Reads a simulated voltage for a given cell ID.
@@ -39,12 +49,109 @@ public:
      */
     float readCurrent();
 
+    /**
+     * @brief Gets the open-circuit voltage and resistance of every string from its cells.
+     * These are the inputs of solveStringCurrents().
+     * @param stringOcv_V Receives the open-circuit voltage per string (NUM_PARALLEL_STRINGS entries).
+     * @param stringResistance_Ohm Receives the resistance per string (NUM_PARALLEL_STRINGS entries).
+     */
+    void getStringModel(float* stringOcv_V, float* stringResistance_Ohm) const;
+
+    /**
+     * @brief Sets the string currents solved for the present step.
+     * They load the cells in the following readVoltage() calls and drive them in step().
+     * @param stringCurrent_A Current per string (NUM_PARALLEL_STRINGS entries, positive for charge).
+     */
+    void setStringCurrents(const float* stringCurrent_A);
+
+    /**
+     * @brief Reads a simulated pack voltage from a channel independent of the cell taps.
+     * Reflects the real cell voltages, so injected sensor errors on a single tap
+     * show up as a disagreement with the sum of the readings of that tap's string.
+     * @return Simulated pack voltage in Volts.
+     */
+    float readPackVoltage();
+
+    /**
+     * @brief Advances the cells by one step, each with the current of its string.
+     * @param deltaTime_s The time step in seconds.
+     */
+    void step(float deltaTime_s);
+
+    /**
+     * @brief Reads the simulated current sensor of one parallel string.
+     * Reports the current set by setStringCurrents().
+     * @param stringIndex The index of the string (0 to NUM_PARALLEL_STRINGS - 1).
+     * @return String current in Amperes (positive for charge, negative for discharge).
+     */
+    float readStringCurrent(uint8_t stringIndex) const;
+
+    /**
+     * @brief Applies the thermal actuator commands to the simulated coolant loop.
+     * @param coolingDuty Pump and radiator fan duty (0.0 to 1.0).
+     * @param heaterDuty Coolant heater duty (0.0 to 1.0).
+     */
+    void setThermalActuators(float coolingDuty, float heaterDuty);
+
+    /**
+     * @brief Replaces the parameters of a simulated cell.
+     * @param cellId ID of the cell.
+     * @param capacity_mAh Capacity.
+     * @param resistance_Ohm Internal resistance.
+     */
+    void setCellParameters(uint8_t cellId, float capacity_mAh, float resistance_Ohm);
+
+    /**
+     * @brief Reads the simulated coolant temperature sensor.
+     * @return Coolant temperature in Celsius.
+     */
+    float readCoolantTemperature() const;
+
+    /**
+     * @brief Solves how the pack current divides between parallel strings, for many packs at once.
+     * All strings of a pack share one terminal voltage V, and string k carries
+     * I_k = (V - OCV_k) / R_k. Requiring the string currents to add up to the pack current
+     * gives V = (I + sum(OCV_k / R_k)) / sum(1 / R_k) in closed form. Arrays are pack-major:
+     * entry k of pack p is at p * NUM_PARALLEL_STRINGS + k.
+     * @param packCount Number of packs.
+     * @param packCurrent_A Pack current per pack (positive for charge).
+     * @param stringOcv_V Open-circuit voltage per string.
+     * @param stringResistance_Ohm Resistance per string.
+     * @param stringCurrent_A Receives the current per string.
+     * @param terminalVoltage_V Receives the terminal voltage per pack (may be nullptr).
+     */
+    static void solveStringCurrents(size_t packCount, const float* packCurrent_A, const float* stringOcv_V,
+                                    const float* stringResistance_Ohm, float* stringCurrent_A, float* terminalVoltage_V);
+
+    /**
+     * @brief Enables or disables console messages about injected faults.
+     * @param enabled True to print messages (default), false to stay silent.
+     */
+    void setConsoleOutput(bool enabled);
+
+    /**
+     * @brief Enables or disables the injection of out-of-bounds readings.
+     * @param enabled True to inject faults at SIM_FAULT_PROBABILITY (default), false for
+     *        readings with measurement noise only.
+     */
+    void setFaultInjection(bool enabled);
+
+    /**
+     * @brief Gets the cell model behind the cell readings.
+     * @return Reference to the SimulatedCellBank.
+     */
+    const SimulatedCellBank& getCellBank() const;
+
 private:
-    std::mt19937 m_rng; // Mersenne Twister random number generator
-    std::uniform_real_distribution<float> m_voltageDist; // Distribution for voltage
-    std::uniform_real_distribution<float> m_tempDist;    // Distribution for temperature
+    SplitMix64 m_rng;   // Random number generator (small, so fleets of simulators stay compact)
+    std::normal_distribution<float> m_noiseDist;         // Distribution for measurement noise
     std::uniform_real_distribution<float> m_currentDist; // Distribution for current
     std::uniform_real_distribution<float> m_faultDist;   // Distribution for fault probability
+    SimulatedCellBank m_cellBank;                        // Models of the pack's cells
+    std::array<float, NUM_CELLS> m_cellVoltages;         // Real cell voltages seen by the pack channel
+    std::array<float, NUM_PARALLEL_STRINGS> m_stringCurrents; // Current per string for the present step
+    bool m_consoleOutput;                                // Print fault injection messages
+    bool m_faultInjection;                               // Inject out-of-bounds readings
 };
 
 #endif // SENSOR_SIMULATOR_H
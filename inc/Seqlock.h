@@ -0,0 +1,98 @@
+// inc/Seqlock.h
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <array>       // For std::array
+#include <atomic>      // For std::atomic, std::atomic_thread_fence
+#include <cstddef>     // For size_t
+#include <cstdint>     // For uint32_t, uint64_t
+#include <cstring>     // For std::memcpy
+#include <type_traits> // For std::is_trivially_copyable
+
+/**
+ * @brief Single-writer sequence lock holding one value.
+ * The writer never waits for readers; a reader copies the value and retries if a write
+ * overlapped its copy. The value is stored as relaxed atomic words, so concurrent
+ * copies are well defined.
+ * @tparam T Value type; must be trivially copyable.
+ */
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock value must be trivially copyable");
+
+public:
+    /**
+     * @brief Constructor for Seqlock.
+     * Holds a zero-filled value until the first write.
+     */
+    Seqlock() : m_sequence(0) {
+        for (auto& word : m_words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    /**
+     * @brief Publishes a new value (writer side, one writer thread only).
+     * @param value The value to publish.
+     */
+    void write(const T& value) {
+        uint64_t words[WORD_COUNT] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed); // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copies the value once (reader side).
+     * @param value Receives the value if the copy was consistent.
+     * @return True if consistent, false if a write overlapped the copy.
+     */
+    bool tryRead(T& value) const {
+        uint32_t before = m_sequence.load(std::memory_order_acquire);
+        if (before & 1u) return false;
+
+        uint64_t words[WORD_COUNT];
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) != before) return false;
+
+        std::memcpy(&value, words, sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Copies the value, retrying until no write overlapped the copy.
+     * @param value Receives the value.
+     */
+    void read(T& value) const {
+        while (!tryRead(value)) {
+        }
+    }
+
+    /**
+     * @brief Gets the sequence number; it changes with every write.
+     * @return The sequence number (even when no write is in progress).
+     */
+    uint32_t getSequence() const {
+        return m_sequence.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::array<std::atomic<uint64_t>, WORD_COUNT> m_words; // Value storage
+    std::atomic<uint32_t> m_sequence;                      // Odd while a write is in progress
+};
+
+#endif // SEQLOCK_H
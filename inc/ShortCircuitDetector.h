@@ -0,0 +1,83 @@
+// inc/ShortCircuitDetector.h
+#ifndef SHORT_CIRCUIT_DETECTOR_H
+#define SHORT_CIRCUIT_DETECTOR_H
+
+#include <atomic>     // For std::atomic
+#include <cstdint>    // For uint32_t, uint64_t
+#include <functional> // For std::function
+#include "../inc/Constants.h" // For SHORT_CIRCUIT_* parameters
+
+/**
+ * @brief Fast-path short-circuit detection on the high-rate current samples.
+ * Runs on the acquisition thread as the samples become available, in chunks of
+ * CURRENT_KERNEL_LANES samples, so a short circuit trips within a few samples instead of
+ * at the end of a block or at the next BMS update. A vectorized screen finds the peak
+ * magnitude of the checked samples; only samples that reach the threshold are scanned
+ * one by one. The detector trips when
+ * SHORT_CIRCUIT_DEBOUNCE_SAMPLES consecutive samples, possibly spanning blocks, reach
+ * SHORT_CIRCUIT_CURRENT_A in either direction. A trip latches, calls the trip handler on
+ * the acquisition thread (e.g. to open the contactor) and is reported to the control loop
+ * through an atomic flag; only reset() clears it.
+ */
+class ShortCircuitDetector {
+public:
+    /**
+     * @brief Constructor for ShortCircuitDetector.
+     * @param threshold_A Current magnitude at which a sample counts as a short circuit.
+     * @param debounceSamples Consecutive samples at the threshold needed to trip.
+     */
+    explicit ShortCircuitDetector(float threshold_A = SHORT_CIRCUIT_CURRENT_A,
+                                  uint32_t debounceSamples = SHORT_CIRCUIT_DEBOUNCE_SAMPLES);
+
+    /**
+     * @brief Sets the function called on the acquisition thread when the detector trips.
+     * Must be set before the acquisition starts; the handler must not block.
+     * @param handler The trip handler, or an empty function for none.
+     */
+    void setTripHandler(std::function<void()> handler);
+
+    /**
+     * @brief Checks the next samples, e.g. one chunk or one block (acquisition thread).
+     * @param samples The samples, oldest first.
+     * @param sampleCount Number of samples; a multiple of CURRENT_KERNEL_LANES.
+     * @return True if the detector tripped in these samples, false otherwise (also if already tripped).
+     */
+    bool checkBlock(const float* samples, uint32_t sampleCount);
+
+    /**
+     * @brief Checks whether the detector has tripped since the last reset (any thread).
+     * @return True if tripped, false otherwise.
+     */
+    bool isTripped() const;
+
+    /**
+     * @brief Gets the peak current magnitude of the samples that tripped the detector.
+     * @return Peak current in Amperes, valid once isTripped() returned true.
+     */
+    float getTripCurrent_A() const;
+
+    /**
+     * @brief Gets the trip latency in samples.
+     * Counted from the first sample of the tripping run to the last sample checked with
+     * it, i.e. the samples that had arrived before the trip could act.
+     * @return Latency in samples, valid once isTripped() returned true.
+     */
+    uint32_t getTripLatency_samples() const;
+
+    /**
+     * @brief Clears a trip, e.g. after the fault was inspected and the contactor closed again.
+     * Must not run concurrently with checkBlock().
+     */
+    void reset();
+
+private:
+    const float m_threshold_A;          // Magnitude at which a sample counts
+    const uint32_t m_debounceSamples;   // Consecutive samples needed to trip
+    uint32_t m_runSamples;              // Consecutive samples at the threshold so far
+    float m_tripCurrent_A;              // Peak of the samples that tripped
+    uint32_t m_tripLatency_samples;     // Samples from the start of the tripping run to the trip
+    std::atomic<bool> m_tripped;        // Latched trip, read by the control loop
+    std::function<void()> m_tripHandler; // Called on the acquisition thread on a trip
+};
+
+#endif // SHORT_CIRCUIT_DETECTOR_H
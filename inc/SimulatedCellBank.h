@@ -0,0 +1,235 @@
+// inc/SimulatedCellBank.h
+#ifndef SIMULATED_CELL_BANK_H
+#define SIMULATED_CELL_BANK_H
+
+#include <cstddef> // For size_t
+#include <cstdint> // For uint32_t, uint64_t
+#include <functional> // For std::function
+#include <memory_resource> // For std::pmr::memory_resource
+#include <vector>  // For std::pmr::vector
+#include "../inc/Constants.h" // For SIM_CELL_* parameters
+
+/**
+ * @brief Normal distribution of one cell parameter.
+ * Samples are truncated to mean +/- 3 standard deviations and kept positive.
+ */
+struct ParameterDistribution {
+    float mean;
+    float stddev;
+};
+
+/**
+ * @brief Manufacturing spread of the simulated cells.
+ * Defaults come from the SIM_CELL_* constants.
+ */
+struct CellVariability {
+    ParameterDistribution capacity_mAh = {NOMINAL_CAPACITY_MAH, NOMINAL_CAPACITY_MAH * SIM_CELL_CAPACITY_SPREAD};
+    ParameterDistribution resistance_Ohm = {SIM_CELL_RESISTANCE_OHM, SIM_CELL_RESISTANCE_OHM * SIM_CELL_RESISTANCE_SPREAD};
+    ParameterDistribution selfDischarge_percentPerDay = {SIM_CELL_SELF_DISCHARGE_PERCENT_PER_DAY,
+                                                         SIM_CELL_SELF_DISCHARGE_PERCENT_PER_DAY * SIM_CELL_SELF_DISCHARGE_SPREAD};
+    ParameterDistribution thermalMass_JPerK = {SIM_CELL_THERMAL_MASS_J_PER_K, SIM_CELL_THERMAL_MASS_J_PER_K * SIM_CELL_THERMAL_MASS_SPREAD};
+};
+
+/**
+ * @brief Decides whether the readings of an idle cell bank are still uninteresting.
+ * Receives the open-circuit voltage and the temperature of every cell.
+ */
+using IdleReadingsPredicate = std::function<bool(const float* openCircuitVoltages_V, const float* temperatures_C)>;
+
+/**
+ * @brief Physical model of a bank of heterogeneous simulated cells.
+ * Each cell gets its own capacity, internal resistance (R0), self-discharge rate and
+ * thermal mass, sampled once at construction. Parameters and state (SoC, temperature)
+ * are kept in structure-of-arrays form so advancing the bank is a set of straight
+ * loops over contiguous floats that the compiler can vectorize. The arrays come from a
+ * caller-chosen memory resource, e.g. the arena a fleet allocates its packs from.
+ * The cells exchange heat with a shared coolant loop, which a pump, a radiator fan and
+ * a heater act on, and the coolant exchanges heat with ambient through the radiator.
+ */
+class SimulatedCellBank {
+public:
+    /**
+     * @brief Constructor for SimulatedCellBank.
+     * Samples the parameters of every cell; all cells start at SIM_CELL_INITIAL_SOC and ambient temperature.
+     * @param cellCount Number of cells.
+     * @param variability Distributions the cell parameters are drawn from.
+     * @param seed Seed of the parameter sampling.
+     * @param memory Memory resource the per-cell arrays are allocated from.
+     */
+    SimulatedCellBank(size_t cellCount, const CellVariability& variability, uint32_t seed,
+                      std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * @brief Advances all cells by one time step with a common (series) current.
+     * @param current_A Current through every cell in Amperes (positive for charge).
+     * @param deltaTime_s The time step in seconds.
+     */
+    void advance(float current_A, float deltaTime_s);
+
+    /**
+     * @brief Advances all cells by one time step with an individual current per cell.
+     * @param cellCurrent_A Current through each cell in Amperes (positive for charge).
+     * @param deltaTime_s The time step in seconds.
+     */
+    void advance(const float* cellCurrent_A, float deltaTime_s);
+
+    /**
+     * @brief Advances all cells by a time step of any length with a common (series) current.
+     * Integrates the temperatures with an embedded Runge-Kutta 3(2) method in as many
+     * substeps as the error control needs; SoC is exact for a constant current.
+     * @param current_A Current through every cell in Amperes (positive for charge).
+     * @param deltaTime_s The time step in seconds.
+     * @return Number of substeps taken.
+     */
+    uint32_t advanceAdaptive(float current_A, float deltaTime_s);
+
+    /**
+     * @brief Advances all cells by a time step of any length with an individual current per cell.
+     * @param cellCurrent_A Current through each cell in Amperes (positive for charge).
+     * @param deltaTime_s The time step in seconds.
+     * @return Number of substeps taken.
+     */
+    uint32_t advanceAdaptive(const float* cellCurrent_A, float deltaTime_s);
+
+    /**
+     * @brief Jumps over idle time steps (no current, thermal actuators unchanged) at once.
+     * Skips as many steps as it can, up to maxSteps, while the readings at the start of
+     * every skipped step are accepted; the bank is left at the start of the next step.
+     * @param maxSteps Maximum number of time steps to skip.
+     * @param deltaTime_s The time step in seconds.
+     * @param accept Predicate on the readings; it must accept a prefix of the idle trajectory.
+     * @return Number of time steps skipped (0 if the current readings are not accepted).
+     */
+    uint64_t advanceIdle(uint64_t maxSteps, float deltaTime_s, const IdleReadingsPredicate& accept);
+
+    /**
+     * @brief Sets the thermal actuators acting on the coolant loop.
+     * @param coolingDuty Pump and radiator fan duty (0.0 to 1.0).
+     * @param heaterDuty Coolant heater duty (0.0 to 1.0).
+     */
+    void setThermalActuators(float coolingDuty, float heaterDuty);
+
+    /**
+     * @brief Sets the ambient temperature and soaks the cells and coolant to it.
+     * @param ambient_C Ambient temperature in Celsius.
+     */
+    void setAmbientTemperature_C(float ambient_C);
+
+    /**
+     * @brief Replaces the sampled parameters of a cell, e.g. with identified ones.
+     * @param cell Index of the cell.
+     * @param capacity_mAh Capacity.
+     * @param resistance_Ohm Internal resistance R0.
+     */
+    void setCellParameters(size_t cell, float capacity_mAh, float resistance_Ohm);
+
+    /**
+     * @brief Gets the coolant temperature.
+     * @return Coolant temperature in Celsius.
+     */
+    float getCoolantTemperature_C() const;
+
+    /**
+     * @brief Gets the open-circuit voltage of a cell.
+     * @param cell Index of the cell.
+     * @return Open-circuit voltage in Volts.
+     */
+    float getOpenCircuitVoltage(size_t cell) const;
+
+    /**
+     * @brief Gets the terminal voltage of a cell under load.
+     * @param cell Index of the cell.
+     * @param current_A Current through the cell in Amperes (positive for charge).
+     * @return Terminal voltage in Volts.
+     */
+    float getTerminalVoltage(size_t cell, float current_A) const;
+
+    /**
+     * @brief Gets the number of cells.
+     * @return Number of cells.
+     */
+    size_t getCellCount() const;
+
+    /**
+     * @brief Gets the sampled capacity of every cell.
+     * @return Capacities in mAh, one per cell.
+     */
+    const std::pmr::vector<float>& getCapacities_mAh() const;
+
+    /**
+     * @brief Gets the sampled internal resistance of every cell.
+     * @return Resistances in Ohms, one per cell.
+     */
+    const std::pmr::vector<float>& getResistances_Ohm() const;
+
+    /**
+     * @brief Gets the state of charge of every cell.
+     * @return SoC (0.0 to 1.0), one per cell.
+     */
+    const std::pmr::vector<float>& getStatesOfCharge() const;
+
+    /**
+     * @brief Gets the temperature of every cell.
+     * @return Temperatures in Celsius, one per cell.
+     */
+    const std::pmr::vector<float>& getTemperatures_C() const;
+
+private:
+    // Parameters, sampled once
+    std::pmr::vector<float> m_capacity_mAh;            // Capacity
+    std::pmr::vector<float> m_chargePerAmpereSecond;   // SoC change per ampere-second (1 / capacity in As)
+    std::pmr::vector<float> m_resistance_Ohm;          // Internal resistance R0
+    std::pmr::vector<float> m_selfDischarge_per_s;     // SoC lost per second at rest
+    std::pmr::vector<float> m_inverseThermalMass;      // 1 / thermal mass (K/J)
+    // State
+    std::pmr::vector<float> m_soc;                     // State of charge (0.0 to 1.0)
+    std::pmr::vector<float> m_socCompensation;         // Rounding compensation of the SoC (Kahan)
+    std::pmr::vector<float> m_temperature_C;           // Cell temperature
+    // Coolant loop
+    float m_ambientTemperature_C;                      // Ambient temperature the radiator rejects heat to
+    float m_coolantTemperature_C;                      // Coolant temperature
+    float m_coolingDuty;                               // Pump and radiator fan duty (0.0 to 1.0)
+    float m_heaterDuty;                                // Heater duty (0.0 to 1.0)
+    // Adaptive integrator
+    float m_adaptiveStep_s;                            // Substep the error control proposed last
+    std::vector<double> m_integratorScratch;           // Stage buffers, sized on first use
+
+    /**
+     * @brief Shared body of both advanceAdaptive() variants.
+     * @param current_A Current of the first cell; cell i carries current_A[i * currentStride].
+     * @param currentStride 0 for a common current, 1 for one current per cell.
+     * @param deltaTime_s The time step in seconds.
+     * @return Number of substeps taken.
+     */
+    uint32_t integrateAdaptive(const float* current_A, size_t currentStride, float deltaTime_s);
+
+    /**
+     * @brief Advances the coolant loop by one time step.
+     * @param heatFromCells_W Heat the cells gave to the coolant during the step.
+     * @param deltaTime_s The time step in seconds.
+     */
+    void advanceCoolant(float heatFromCells_W, float deltaTime_s);
+
+    /**
+     * @brief Gets the cell-to-coolant heat transfer at the current pump duty.
+     * @return Heat transfer per cell (W/K).
+     */
+    float getCellHeatTransfer_WPerK() const;
+
+    /**
+     * @brief Computes the temperature derivatives for the adaptive integrator.
+     * @param heat_W Joule heat of every cell (W).
+     * @param temperatures_C Cell temperatures followed by the coolant temperature.
+     * @param derivatives_KPerS Output, derivative of each temperature (K/s).
+     */
+    void temperatureDerivatives(const double* heat_W, const double* temperatures_C, double* derivatives_KPerS) const;
+
+    /**
+     * @brief Builds the affine map one idle time step applies to the temperatures.
+     * @param deltaTime_s The time step in seconds.
+     * @param map Output, row-major (n + 2) x (n + 2) matrix.
+     */
+    void buildIdleStepMap(float deltaTime_s, std::vector<double>& map) const;
+};
+
+#endif // SIMULATED_CELL_BANK_H
@@ -0,0 +1,41 @@
+// inc/SplitMix64.h
+#ifndef SPLIT_MIX_64_H
+#define SPLIT_MIX_64_H
+
+#include <cstdint> // For uint64_t
+
+/**
+ * @brief Small, fast pseudo-random bit generator (splitmix64).
+ * Eight bytes of state instead of the 5 KB of std::mt19937, and seeding is a single
+ * store, which matters when a fleet constructs a simulator per pack. Meets the
+ * UniformRandomBitGenerator requirements, so it works with the standard distributions.
+ */
+class SplitMix64 {
+public:
+    using result_type = uint64_t;
+
+    /**
+     * @brief Constructor for SplitMix64.
+     * @param seed Initial state; every seed gives a usable sequence.
+     */
+    explicit SplitMix64(uint64_t seed) : m_state(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+    /**
+     * @brief Generates the next 64 random bits.
+     * @return The random value.
+     */
+    result_type operator()() {
+        uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t m_state; // Counter hashed into each output
+};
+
+#endif // SPLIT_MIX_64_H
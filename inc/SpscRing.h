@@ -0,0 +1,71 @@
+// inc/SpscRing.h
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <array>     // For std::array
+#include <atomic>    // For std::atomic
+#include <cstddef>   // For size_t
+
+/**
+ * @brief Preallocated lock-free single-producer/single-consumer ring buffer.
+ * One thread may push and one other thread may pop concurrently without locks.
+ * Neither side ever blocks or allocates: a push into a full ring fails instead.
+ * @tparam T Element type (copied in and out).
+ * @tparam Capacity Number of slots; must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    /**
+     * @brief Constructor for SpscRing.
+     * Starts empty.
+     */
+    SpscRing() : m_head(0), m_tail(0) {}
+
+    /**
+     * @brief Appends an element (producer side).
+     * @param value The element to append.
+     * @return True if appended, false if the ring was full.
+     */
+    bool tryPush(const T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        m_slots[head & (Capacity - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element (consumer side).
+     * @param value Receives the element.
+     * @return True if an element was removed, false if the ring was empty.
+     */
+    bool tryPop(T& value) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = m_slots[tail & (Capacity - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Checks whether the ring is empty (approximate while the other side is active).
+     * @return True if no elements are queued.
+     */
+    bool empty() const {
+        return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, Capacity> m_slots;     // Element storage
+    alignas(64) std::atomic<size_t> m_head; // Next slot to write (producer owned)
+    alignas(64) std::atomic<size_t> m_tail; // Next slot to read (consumer owned)
+};
+
+#endif // SPSC_RING_H
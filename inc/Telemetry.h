@@ -0,0 +1,108 @@
+// inc/Telemetry.h
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <array>     // For std::array
+#include <cstddef>   // For size_t
+#include <cstdint>   // For uint8_t, uint16_t
+#include "../inc/Constants.h" // For NUM_CELLS, TELEMETRY_* deadbands
+
+// Telemetry channel layout: cell voltages, cell temperatures, then the pack channels
+const uint16_t TELEMETRY_CHANNEL_VOLTAGE_BASE = 0;
+const uint16_t TELEMETRY_CHANNEL_TEMP_BASE = NUM_CELLS;
+const uint16_t TELEMETRY_CHANNEL_PACK_CURRENT = 2 * NUM_CELLS;
+const uint16_t TELEMETRY_CHANNEL_PACK_VOLTAGE = 2 * NUM_CELLS + 1;
+const uint16_t TELEMETRY_CHANNEL_SOC = 2 * NUM_CELLS + 2;
+// Number of telemetry channels
+const uint16_t TELEMETRY_CHANNEL_COUNT = 2 * NUM_CELLS + 3;
+
+// Frame header: flags byte followed by a little-endian 16-bit sequence number
+const size_t TELEMETRY_HEADER_BYTES = 3;
+// Change mask: one bit per channel
+const size_t TELEMETRY_MASK_BYTES = (TELEMETRY_CHANNEL_COUNT + 7) / 8;
+// Largest possible encoded frame
+const size_t TELEMETRY_MAX_FRAME_BYTES = TELEMETRY_HEADER_BYTES + TELEMETRY_MASK_BYTES + TELEMETRY_CHANNEL_COUNT * sizeof(float);
+
+// Frame flags
+const uint8_t TELEMETRY_FLAG_KEYFRAME = 0x01; // All channels follow, no mask
+const uint8_t TELEMETRY_FLAG_DELTA = 0x02;    // Mask and changed channels follow
+
+/**
+ * @brief Telemetry channel values of one sample, in the channel layout above.
+ */
+using TelemetryChannels = std::array<float, TELEMETRY_CHANNEL_COUNT>;
+
+/**
+ * @brief Deadband-based telemetry encoder.
+ * Keeps the last published value of every channel and only emits channels that moved
+ * beyond their deadband since then, so the decoder's reconstruction never differs from
+ * the true value by more than the deadband. A full keyframe is sent every N frames.
+ * Frames with no changed channel shrink to the header alone.
+ */
+class TelemetryEncoder {
+public:
+    /**
+     * @brief Constructor for TelemetryEncoder.
+     * Deadbands default to the TELEMETRY_* constants.
+     * @param keyframeInterval A keyframe is sent every this many frames.
+     */
+    explicit TelemetryEncoder(uint16_t keyframeInterval = TELEMETRY_KEYFRAME_INTERVAL);
+
+    /**
+     * @brief Sets the deadband of one channel.
+     * @param channel The channel index.
+     * @param deadband The change required before the channel is re-sent (0 sends every change).
+     */
+    void setDeadband(uint16_t channel, float deadband);
+
+    /**
+     * @brief Encodes one sample into a keyframe or delta frame.
+     * @param channels The current channel values.
+     * @param buffer Output buffer of at least TELEMETRY_MAX_FRAME_BYTES bytes.
+     * @return Number of bytes written.
+     */
+    size_t encode(const TelemetryChannels& channels, uint8_t* buffer);
+
+    /**
+     * @brief Forces the next frame to be a keyframe (e.g. after a receiver reconnects).
+     */
+    void requestKeyframe();
+
+private:
+    TelemetryChannels m_published;                        // Last value sent per channel
+    std::array<float, TELEMETRY_CHANNEL_COUNT> m_deadband; // Deadband per channel
+    uint16_t m_keyframeInterval;                          // Frames between keyframes
+    uint16_t m_framesSinceKeyframe;                       // Frames since the last keyframe
+    uint16_t m_sequence;                                  // Sequence number of the next frame
+    bool m_keyframePending;                               // Next frame must be a keyframe
+};
+
+/**
+ * @brief Reconstructs full channel frames from TelemetryEncoder output.
+ * A lost frame is detected from the sequence number; deltas are then rejected until
+ * the next keyframe arrives.
+ */
+class TelemetryDecoder {
+public:
+    /**
+     * @brief Constructor for TelemetryDecoder.
+     * Waits for a keyframe before accepting deltas.
+     */
+    TelemetryDecoder();
+
+    /**
+     * @brief Decodes one frame and updates the reconstructed channel values.
+     * @param buffer The encoded frame.
+     * @param size The size of the frame in bytes.
+     * @param channels Receives the reconstructed values of all channels.
+     * @return True if decoded, false if malformed or not decodable without a keyframe.
+     */
+    bool decode(const uint8_t* buffer, size_t size, TelemetryChannels& channels);
+
+private:
+    TelemetryChannels m_channels; // Reconstructed channel values
+    uint16_t m_nextSequence;      // Expected sequence number of the next frame
+    bool m_synchronized;          // A keyframe was received and no frame was lost since
+};
+
+#endif // TELEMETRY_H
@@ -0,0 +1,106 @@
+// inc/ThermalManager.h
+#ifndef THERMAL_MANAGER_H
+#define THERMAL_MANAGER_H
+
+#include <array>   // For std::array
+#include "../inc/BatteryCell.h" // For BatteryCell class
+#include "../inc/Constants.h"   // For NUM_CELLS and THERMAL_* settings
+
+/**
+ * @brief Proportional-integral controller with a 0.0 to 1.0 output.
+ * The integral is clamped to the output range, which keeps it from winding up while
+ * the output is saturated.
+ */
+struct PiController {
+    float kp;               // Proportional gain (output per unit error)
+    float ki;               // Integral gain (output per unit error and second)
+    float integral = 0.0f;  // Integral term
+    float output = 0.0f;    // Last output
+
+    /**
+     * @brief Runs one controller step.
+     * @param error Setpoint deviation; positive asks for more output.
+     * @param deltaTime_s The time since the previous step in seconds.
+     * @return The new output (0.0 to 1.0).
+     */
+    float step(float error, float deltaTime_s);
+};
+
+/**
+ * @brief Closed-loop thermal management of the pack.
+ * A cooling PI controller drives the pump and radiator fan from the maximum cell
+ * temperature, and a heating PI controller drives the coolant heater from the minimum
+ * cell temperature. Preconditioning before a charge narrows both setpoints to the
+ * charging window. The controllers run at their own period (THERMAL_CONTROL_PERIOD_S),
+ * independent of how often update() is called. The time the pack spends above
+ * MAX_TEMP_WARNING is accumulated for evaluation.
+ */
+class ThermalManager {
+public:
+    /**
+     * @brief Constructor for ThermalManager.
+     * Starts with all actuators off and preconditioning disabled.
+     */
+    ThermalManager();
+
+    /**
+     * @brief Feeds the latest cell temperatures and runs the controllers when their period has elapsed.
+     * @param cells The latest cell readings.
+     * @param deltaTime_s The time elapsed since the last call in seconds.
+     */
+    void update(const std::array<BatteryCell, NUM_CELLS>& cells, float deltaTime_s);
+
+    /**
+     * @brief Enables or disables preconditioning for an upcoming charge.
+     * @param enabled True to bring the cells into the charging window.
+     */
+    void setPreconditioning(bool enabled);
+
+    /**
+     * @brief Checks whether preconditioning is enabled.
+     * @return True if enabled.
+     */
+    bool isPreconditioning() const;
+
+    /**
+     * @brief Checks whether all cells are inside the charging window.
+     * @return True if the minimum and maximum cell temperatures are within the window.
+     */
+    bool isInChargingWindow() const;
+
+    /**
+     * @brief Gets the pump and radiator fan duty.
+     * @return Duty (0.0 to 1.0).
+     */
+    float getCoolingDuty() const;
+
+    /**
+     * @brief Gets the coolant heater duty.
+     * @return Duty (0.0 to 1.0).
+     */
+    float getHeaterDuty() const;
+
+    /**
+     * @brief Gets the time the maximum cell temperature spent above MAX_TEMP_WARNING.
+     * @return Time in seconds.
+     */
+    double getTimeAboveWarning_s() const;
+
+    /**
+     * @brief Gets the total time covered by update() calls.
+     * @return Time in seconds.
+     */
+    double getMonitoredTime_s() const;
+
+private:
+    PiController m_cooling;        // Pump/fan controller on the maximum cell temperature
+    PiController m_heating;        // Heater controller on the minimum cell temperature
+    bool m_preconditioning;        // Bring the cells into the charging window
+    float m_minTemperature_C;      // Minimum cell temperature of the last update
+    float m_maxTemperature_C;      // Maximum cell temperature of the last update
+    float m_pendingTime_s;         // Time since the last controller step
+    double m_timeAboveWarning_s;   // Time above MAX_TEMP_WARNING
+    double m_monitoredTime_s;      // Total time covered by updates
+};
+
+#endif // THERMAL_MANAGER_H
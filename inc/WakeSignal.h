@@ -0,0 +1,84 @@
+// inc/WakeSignal.h
+#ifndef WAKE_SIGNAL_H
+#define WAKE_SIGNAL_H
+
+#include <atomic>        // For std::atomic
+#include <climits>       // For INT_MAX
+#include <cstdint>       // For uint32_t
+#include <linux/futex.h> // For FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE
+#include <sys/syscall.h> // For SYS_futex
+#include <unistd.h>      // For syscall
+
+/**
+ * @brief Lock-free wake-up of sleeping consumer threads, built on a Linux futex.
+ * A consumer calls prepareWait(), checks its condition (e.g. that its queue is empty) and
+ * then calls wait() with the returned token, or cancelWait() if the condition no longer
+ * holds. A producer changes the condition first and then calls notify(). notify() never
+ * takes a lock and only makes a system call while a consumer is between prepareWait() and
+ * the end of wait(); a notify() that lands after the consumer's check makes its wait()
+ * return at once, so no wake-up is lost. The seq_cst fences on both sides order the
+ * condition against the waiter count: either the consumer sees the producer's change, or
+ * the producer sees the waiter.
+ */
+class WakeSignal {
+public:
+    /**
+     * @brief Constructor for WakeSignal.
+     * Starts with no waiters.
+     */
+    WakeSignal() : m_sequence(0), m_waiters(0) {}
+
+    WakeSignal(const WakeSignal&) = delete;
+    WakeSignal& operator=(const WakeSignal&) = delete;
+
+    /**
+     * @brief Announces a consumer about to sleep. Check the condition after this call.
+     * @return The token to pass to wait().
+     */
+    uint32_t prepareWait() {
+        uint32_t token = m_sequence.load(std::memory_order_acquire);
+        m_waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return token;
+    }
+
+    /**
+     * @brief Sleeps until a notify() after the matching prepareWait().
+     * Returns at once if one happened already; may also return spuriously, so callers
+     * check their condition again.
+     * @param token The token returned by prepareWait().
+     */
+    void wait(uint32_t token) {
+        if (m_sequence.load(std::memory_order_acquire) == token) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_sequence), FUTEX_WAIT_PRIVATE, token, nullptr, nullptr, 0);
+        }
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Withdraws a prepareWait() whose condition no longer holds.
+     */
+    void cancelWait() {
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Wakes every sleeping consumer. Call after changing the condition.
+     * Costs a fence and a load while nobody waits.
+     */
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed) > 0) {
+            m_sequence.fetch_add(1, std::memory_order_release);
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_sequence), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+        }
+    }
+
+private:
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "the futex word must be a plain 32-bit integer");
+
+    std::atomic<uint32_t> m_sequence; // Futex word, advanced by every notify() that finds a waiter
+    std::atomic<uint32_t> m_waiters;  // Consumers between prepareWait() and the end of wait()
+};
+
+#endif // WAKE_SIGNAL_H
@@ -0,0 +1,662 @@
+// src/AsyncFileSink.cpp
+#include "../inc/AsyncFileSink.h"
+#include <cerrno>     // For errno, EINTR
+#include <cstring>    // For std::memcpy, std::memset
+#include <fcntl.h>    // For open flags
+#include <sys/mman.h> // For mmap, munmap
+#include <sys/uio.h>  // For struct iovec
+#include <unistd.h>   // For pwrite, ftruncate, close
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h> // For the io_uring ABI
+#include <sys/syscall.h>    // For the io_uring system call numbers
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+              "the ring indices shared with the kernel are accessed as std::atomic<uint32_t>");
+
+/**
+ * @brief The submission and completion rings of one io_uring, set up with raw system calls.
+ * Only the producer thread touches them: it fills submission entries, enters them with
+ * io_uring_enter() and pops completions. The kernel side of the indices is read with
+ * acquire and published with release ordering.
+ */
+struct AsyncFileSink::UringQueue {
+    int fd = -1;                                // The io_uring file descriptor
+    void* sqRing = MAP_FAILED;                  // Submission ring mapping
+    size_t sqRingBytes = 0;
+    void* cqRing = MAP_FAILED;                  // Completion ring mapping (may equal sqRing)
+    size_t cqRingBytes = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED); // Submission entries
+    size_t sqesBytes = 0;
+    std::atomic<uint32_t>* sqTail = nullptr;
+    uint32_t sqMask = 0;
+    uint32_t* sqArray = nullptr;
+    std::atomic<uint32_t>* cqHead = nullptr;
+    std::atomic<uint32_t>* cqTail = nullptr;
+    uint32_t cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+    bool fixedBuffers = false;                  // Buffers registered, writes use IORING_OP_WRITE_FIXED
+
+    ~UringQueue() {
+        if (sqes != MAP_FAILED) {
+            munmap(sqes, sqesBytes);
+        }
+        if (cqRing != MAP_FAILED && cqRing != sqRing) {
+            munmap(cqRing, cqRingBytes);
+        }
+        if (sqRing != MAP_FAILED) {
+            munmap(sqRing, sqRingBytes);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    /**
+     * @brief Creates the io_uring and maps its rings.
+     * @param entries Number of submission entries.
+     * @return True on success, false if the kernel does not provide io_uring.
+     */
+    bool setup(uint32_t entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return false;
+        }
+        sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMapping) {
+            sqRingBytes = sqRingBytes > cqRingBytes ? sqRingBytes : cqRingBytes;
+            cqRingBytes = sqRingBytes;
+        }
+        sqRing = mmap(nullptr, sqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) {
+            return false;
+        }
+        cqRing = singleMapping ? sqRing
+                               : mmap(nullptr, cqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            return false;
+        }
+        sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+
+        char* sq = static_cast<char*>(sqRing);
+        char* cq = static_cast<char*>(cqRing);
+        sqTail = reinterpret_cast<std::atomic<uint32_t>*>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<std::atomic<uint32_t>*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<std::atomic<uint32_t>*>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    /**
+     * @brief Registers the write buffers, so the kernel maps them once instead of per write.
+     * @param buffers The buffers.
+     * @param count Number of buffers.
+     * @return True on success, false otherwise (e.g. over the locked-memory limit).
+     */
+    bool registerBuffers(const iovec* buffers, uint32_t count) {
+        fixedBuffers = syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+        return fixedBuffers;
+    }
+
+    /**
+     * @brief Submits one write.
+     * @param userData Returned with the completion (the buffer index).
+     * @param fileFd The file to write.
+     * @param data The bytes to write.
+     * @param length Number of bytes.
+     * @param offset File offset.
+     * @return True if the kernel accepted the submission, false otherwise.
+     */
+    bool submitWrite(uint64_t userData, int fileFd, const uint8_t* data, uint32_t length, uint64_t offset) {
+        uint32_t tail = sqTail->load(std::memory_order_relaxed);
+        uint32_t index = tail & sqMask;
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = fixedBuffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe.fd = fileFd;
+        sqe.off = offset;
+        sqe.addr = reinterpret_cast<uint64_t>(data);
+        sqe.len = length;
+        sqe.buf_index = fixedBuffers ? static_cast<uint16_t>(userData) : 0;
+        sqe.user_data = userData;
+        sqArray[index] = index;
+        sqTail->store(tail + 1, std::memory_order_release);
+
+        long submitted;
+        do {
+            submitted = syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0);
+        } while (submitted < 0 && errno == EINTR);
+        if (submitted != 1) {
+            // Nothing was consumed, so the entry can be taken back
+            sqTail->store(tail, std::memory_order_release);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Pops one completion, if any.
+     * @param userData Receives the user data of the write.
+     * @param result Receives the result: bytes written, or a negative errno.
+     * @return True if a completion was popped, false if none is pending.
+     */
+    bool popCompletion(uint64_t& userData, int32_t& result) {
+        uint32_t head = cqHead->load(std::memory_order_relaxed);
+        if (head == cqTail->load(std::memory_order_acquire)) {
+            return false;
+        }
+        const io_uring_cqe& cqe = cqes[head & cqMask];
+        userData = cqe.user_data;
+        result = cqe.res;
+        cqHead->store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Blocks until at least one completion is pending.
+     */
+    void waitCompletion() {
+        long result;
+        do {
+            result = syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        } while (result < 0 && errno == EINTR);
+    }
+};
+#else
+/**
+ * @brief Placeholder where the kernel headers provide no io_uring; setup() always fails.
+ */
+struct AsyncFileSink::UringQueue {
+    bool fixedBuffers = false;
+    bool setup(uint32_t) { return false; }
+    bool registerBuffers(const iovec*, uint32_t) { return false; }
+    bool submitWrite(uint64_t, int, const uint8_t*, uint32_t, uint64_t) { return false; }
+    bool popCompletion(uint64_t&, int32_t&) { return false; }
+    void waitCompletion() {}
+};
+#endif
+
+/**
+ * @brief Converts a SinkBackend enum to a string.
+ * @param backend The backend to convert.
+ * @return The name of the backend.
+ */
+const char* toString(SinkBackend backend) {
+    switch (backend) {
+        case SinkBackend::AUTO: return "auto";
+        case SinkBackend::IO_URING: return "io_uring";
+        case SinkBackend::THREAD_POOL: return "thread pool";
+        default: return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief Constructor for AsyncFileSink.
+ * The file is not opened until open() is called.
+ * @param path The file to write; truncated when opened.
+ * @param backend How the writes are performed.
+ * @param options Bit mask of ASYNC_SINK_* options.
+ */
+AsyncFileSink::AsyncFileSink(const std::string& path, SinkBackend backend, uint8_t options)
+    : m_path(path),
+      m_backend(backend),
+      m_options(options),
+      m_fd(-1),
+      m_memory(MAP_FAILED),
+      m_current(-1),
+      m_inFlight(0),
+      m_nextWorker(0),
+      m_fileOffset(0),
+      m_acceptedBytes(0),
+      m_running(false),
+      m_writtenBytes(0),
+      m_droppedBytes(0),
+      m_errors(0)
+{
+}
+
+/**
+ * @brief Destructor. Closes the file after writing everything accepted.
+ */
+AsyncFileSink::~AsyncFileSink() {
+    close();
+}
+
+/**
+ * @brief Opens the file and sets up the buffers and the backend.
+ * O_DIRECT is dropped where the file system rejects it, registered buffers where the
+ * kernel refuses them, and io_uring in favour of the thread pool where it is unavailable;
+ * getBackend() and getOptions() report what is in effect.
+ * @return True on success, false if the file or the buffers could not be set up.
+ */
+bool AsyncFileSink::open() {
+    if (m_fd >= 0) {
+        return true;
+    }
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+#ifdef O_DIRECT
+    if (m_options & ASYNC_SINK_DIRECT_IO) {
+        m_fd = ::open(m_path.c_str(), flags | O_DIRECT, 0644);
+    }
+#endif
+    if (m_fd < 0) {
+        m_options &= static_cast<uint8_t>(~ASYNC_SINK_DIRECT_IO);
+        m_fd = ::open(m_path.c_str(), flags, 0644);
+        if (m_fd < 0) {
+            return false;
+        }
+    }
+
+    // One page-aligned mapping for all buffers, which also satisfies the O_DIRECT alignment
+    m_memory = mmap(nullptr, static_cast<size_t>(ASYNC_SINK_BUFFER_COUNT) * ASYNC_SINK_BUFFER_BYTES,
+                    PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (m_memory == MAP_FAILED) {
+        release();
+        return false;
+    }
+    for (uint32_t i = 0; i < ASYNC_SINK_BUFFER_COUNT; ++i) {
+        m_buffers[i].data = static_cast<uint8_t*>(m_memory) + static_cast<size_t>(i) * ASYNC_SINK_BUFFER_BYTES;
+        m_buffers[i].used = 0;
+        m_buffers[i].busy.store(false, std::memory_order_relaxed);
+    }
+    m_current = -1;
+    m_inFlight = 0;
+    m_fileOffset = 0;
+    m_acceptedBytes = 0;
+
+    if (m_backend != SinkBackend::THREAD_POOL) {
+        m_uring.reset(new UringQueue());
+        if (m_uring->setup(ASYNC_SINK_BUFFER_COUNT)) {
+            m_backend = SinkBackend::IO_URING;
+        } else {
+            m_uring.reset();
+            m_backend = SinkBackend::THREAD_POOL;
+        }
+    }
+    if (m_uring && (m_options & ASYNC_SINK_REGISTERED_BUFFERS)) {
+        std::array<iovec, ASYNC_SINK_BUFFER_COUNT> buffers;
+        for (uint32_t i = 0; i < ASYNC_SINK_BUFFER_COUNT; ++i) {
+            buffers[i].iov_base = m_buffers[i].data;
+            buffers[i].iov_len = ASYNC_SINK_BUFFER_BYTES;
+        }
+        if (!m_uring->registerBuffers(buffers.data(), ASYNC_SINK_BUFFER_COUNT)) {
+            m_options &= static_cast<uint8_t>(~ASYNC_SINK_REGISTERED_BUFFERS);
+        }
+    }
+    if (!m_uring) {
+        m_options &= static_cast<uint8_t>(~ASYNC_SINK_REGISTERED_BUFFERS);
+        m_running.store(true, std::memory_order_release);
+        for (uint32_t i = 0; i < ASYNC_SINK_POOL_THREADS; ++i) {
+            m_workers.emplace_back(new PoolWorker());
+            m_workers.back()->thread = std::thread(&AsyncFileSink::poolLoop, this, m_workers.back().get());
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Appends a record (producer thread). Non-blocking.
+ * Completed writes are reaped first. The record is copied into the current buffer; a
+ * record that does not fit continues in the next free buffers, and full buffers are
+ * submitted as they fill. A record is only accepted as a whole: if the buffers it needs
+ * are not free, it is dropped.
+ * @param data The bytes to append.
+ * @param size Number of bytes.
+ * @return True if accepted, false if the sink is closed or the record was dropped for lack of free buffers.
+ */
+bool AsyncFileSink::write(const void* data, size_t size) {
+    if (m_fd < 0) {
+        return false;
+    }
+    reapCompletions(false);
+    if (m_current < 0) {
+        m_current = findFreeBuffer();
+    }
+    size_t space = m_current < 0 ? 0 : ASYNC_SINK_BUFFER_BYTES - m_buffers[m_current].used;
+    if (size > space) {
+        size_t needed = (size - space + ASYNC_SINK_BUFFER_BYTES - 1) / ASYNC_SINK_BUFFER_BYTES;
+        if (m_current < 0 || countFreeBuffers() < needed) {
+            m_droppedBytes.fetch_add(size, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_acceptedBytes += size;
+    while (size > 0) {
+        if (m_current < 0) {
+            m_current = findFreeBuffer();
+        }
+        SinkBuffer& buffer = m_buffers[m_current];
+        size_t chunk = ASYNC_SINK_BUFFER_BYTES - buffer.used;
+        chunk = chunk < size ? chunk : size;
+        std::memcpy(buffer.data + buffer.used, bytes, chunk);
+        buffer.used += static_cast<uint32_t>(chunk);
+        bytes += chunk;
+        size -= chunk;
+        if (buffer.used == ASYNC_SINK_BUFFER_BYTES) {
+            submitCurrent(false);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Starts writing the partially filled buffer (producer thread). Non-blocking.
+ * With direct I/O only the aligned part is written; the rest stays buffered.
+ */
+void AsyncFileSink::flush() {
+    if (m_fd < 0) {
+        return;
+    }
+    reapCompletions(false);
+    submitCurrent(false);
+}
+
+/**
+ * @brief Writes everything accepted, waits for the writes and closes the file (producer thread).
+ * The only call that blocks. A direct-I/O file is cut to the accepted length, removing
+ * the padding of its last write.
+ */
+void AsyncFileSink::close() {
+    if (m_fd < 0) {
+        return;
+    }
+    reapCompletions(false);
+    submitCurrent(true);
+    if (m_uring) {
+        while (m_inFlight > 0) {
+            reapCompletions(true);
+        }
+    } else {
+        for (const SinkBuffer& buffer : m_buffers) {
+            while (buffer.busy.load(std::memory_order_acquire)) {
+                uint32_t token = m_completed.prepareWait();
+                if (buffer.busy.load(std::memory_order_acquire)) {
+                    m_completed.wait(token);
+                } else {
+                    m_completed.cancelWait();
+                }
+            }
+        }
+    }
+    if ((m_options & ASYNC_SINK_DIRECT_IO) && ftruncate(m_fd, static_cast<off_t>(m_acceptedBytes)) != 0) {
+        m_errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    release();
+}
+
+/**
+ * @brief Checks whether the sink is open.
+ * @return True if open, false otherwise.
+ */
+bool AsyncFileSink::isOpen() const {
+    return m_fd >= 0;
+}
+
+/**
+ * @brief Gets the backend in use; AUTO is resolved when the sink is opened.
+ * @return The backend.
+ */
+SinkBackend AsyncFileSink::getBackend() const {
+    return m_backend;
+}
+
+/**
+ * @brief Gets the options in effect, after any fallback on open.
+ * @return Bit mask of ASYNC_SINK_* options.
+ */
+uint8_t AsyncFileSink::getOptions() const {
+    return m_options;
+}
+
+/**
+ * @brief Gets the number of bytes accepted by write().
+ * @return Accepted bytes.
+ */
+uint64_t AsyncFileSink::getAcceptedBytes() const {
+    return m_acceptedBytes;
+}
+
+/**
+ * @brief Gets the number of bytes whose writes have completed (any thread).
+ * @return Written bytes, including the alignment padding of direct writes.
+ */
+uint64_t AsyncFileSink::getWrittenBytes() const {
+    return m_writtenBytes.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the number of bytes dropped because every buffer was being written.
+ * @return Dropped bytes.
+ */
+uint64_t AsyncFileSink::getDroppedBytes() const {
+    return m_droppedBytes.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the number of failed writes, including short writes whose remainder failed (any thread).
+ * @return Number of errors.
+ */
+uint64_t AsyncFileSink::getErrorCount() const {
+    return m_errors.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Finds a free buffer other than the current one.
+ * @return Index of the buffer, -1 if every buffer is in use.
+ */
+int AsyncFileSink::findFreeBuffer() const {
+    for (uint32_t i = 0; i < ASYNC_SINK_BUFFER_COUNT; ++i) {
+        if (static_cast<int>(i) != m_current && !m_buffers[i].busy.load(std::memory_order_acquire)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Counts the free buffers other than the current one.
+ * @return Number of free buffers.
+ */
+uint32_t AsyncFileSink::countFreeBuffers() const {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < ASYNC_SINK_BUFFER_COUNT; ++i) {
+        count += static_cast<int>(i) != m_current && !m_buffers[i].busy.load(std::memory_order_acquire);
+    }
+    return count;
+}
+
+/**
+ * @brief Submits the filled part of the current buffer.
+ * Direct writes must start and end on ASYNC_SINK_ALIGNMENT_BYTES boundaries: a flush writes
+ * the aligned part and moves the tail to the start of a free buffer, which continues at the
+ * next aligned offset; the final write is padded with zeros instead.
+ * @param final True on close: direct writes are padded to the alignment instead of carrying the tail over.
+ * @return True if submitted (or nothing to submit), false if the tail found no free buffer.
+ */
+bool AsyncFileSink::submitCurrent(bool final) {
+    if (m_current < 0) {
+        return true;
+    }
+    SinkBuffer& buffer = m_buffers[m_current];
+    uint32_t length = buffer.used;
+    uint32_t tail = 0;
+    if (m_options & ASYNC_SINK_DIRECT_IO) {
+        if (final) {
+            length = (buffer.used + ASYNC_SINK_ALIGNMENT_BYTES - 1) / ASYNC_SINK_ALIGNMENT_BYTES * ASYNC_SINK_ALIGNMENT_BYTES;
+            std::memset(buffer.data + buffer.used, 0, length - buffer.used);
+        } else {
+            tail = buffer.used % ASYNC_SINK_ALIGNMENT_BYTES;
+            length = buffer.used - tail;
+        }
+    }
+    if (length == 0) {
+        return true;
+    }
+
+    int next = -1;
+    if (tail > 0) {
+        next = findFreeBuffer();
+        if (next < 0) {
+            return false;
+        }
+        std::memcpy(m_buffers[next].data, buffer.data + length, tail);
+        m_buffers[next].used = tail;
+    }
+    buffer.length = length;
+    buffer.offset = m_fileOffset;
+    buffer.used = 0;
+    m_fileOffset += length;
+    submitBuffer(static_cast<uint32_t>(m_current));
+    m_current = next;
+    return true;
+}
+
+/**
+ * @brief Hands one buffer to the backend.
+ * The buffer is busy until its write completes. A submission the backend refuses is
+ * counted as an error and its bytes are lost.
+ * @param index Index of the buffer, with length and offset set.
+ */
+void AsyncFileSink::submitBuffer(uint32_t index) {
+    SinkBuffer& buffer = m_buffers[index];
+    buffer.busy.store(true, std::memory_order_relaxed);
+    buffer.written = 0;
+    if (m_uring) {
+        if (m_uring->submitWrite(index, m_fd, buffer.data, buffer.length, buffer.offset)) {
+            ++m_inFlight;
+            return;
+        }
+    } else {
+        // A worker ring holds every buffer, so it cannot be full
+        PoolWorker& worker = *m_workers[m_nextWorker];
+        m_nextWorker = (m_nextWorker + 1) % m_workers.size();
+        if (worker.queue.tryPush(index)) {
+            worker.wakeUp.notify();
+            return;
+        }
+    }
+    m_errors.fetch_add(1, std::memory_order_relaxed);
+    buffer.busy.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief Marks the buffers of completed io_uring writes free (producer thread).
+ * Does nothing for the thread pool, whose writers free the buffers themselves.
+ * A short write is continued like writeBuffer() does: the remainder is submitted again
+ * at its offset and the buffer stays busy. A failed write, one that makes no progress or
+ * a remainder the ring refuses is counted as an error and its bytes are lost.
+ * @param wait True to block until at least one write completes.
+ */
+void AsyncFileSink::reapCompletions(bool wait) {
+    if (!m_uring) {
+        return;
+    }
+    if (wait && m_inFlight > 0) {
+        m_uring->waitCompletion();
+    }
+    uint64_t index;
+    int32_t result;
+    while (m_uring->popCompletion(index, result)) {
+        SinkBuffer& buffer = m_buffers[index];
+        if (result > 0) {
+            m_writtenBytes.fetch_add(static_cast<uint64_t>(result), std::memory_order_relaxed);
+            buffer.written += static_cast<uint32_t>(result);
+            if (buffer.written < buffer.length
+                && m_uring->submitWrite(index, m_fd, buffer.data + buffer.written, buffer.length - buffer.written,
+                                        buffer.offset + buffer.written)) {
+                continue;
+            }
+        }
+        if (result <= 0 || buffer.written < buffer.length) {
+            m_errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        buffer.busy.store(false, std::memory_order_release);
+        --m_inFlight;
+    }
+}
+
+/**
+ * @brief Writes one buffer with blocking pwrite() calls (pool writer thread).
+ * Partial writes are continued; a failed write is counted and its bytes are lost.
+ * @param index Index of the buffer.
+ */
+void AsyncFileSink::writeBuffer(uint32_t index) {
+    SinkBuffer& buffer = m_buffers[index];
+    uint32_t written = 0;
+    while (written < buffer.length) {
+        ssize_t result = pwrite(m_fd, buffer.data + written, buffer.length - written, static_cast<off_t>(buffer.offset + written));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            m_errors.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        written += static_cast<uint32_t>(result);
+    }
+    m_writtenBytes.fetch_add(written, std::memory_order_relaxed);
+    buffer.busy.store(false, std::memory_order_release);
+    m_completed.notify();
+}
+
+/**
+ * @brief Body of a pool writer thread.
+ * Writes the buffers handed to it and sleeps on the worker's wake signal whenever there
+ * is none, until submitBuffer() hands it the next one or release() stops it.
+ * @param worker The worker's hand-off ring.
+ */
+void AsyncFileSink::poolLoop(PoolWorker* worker) {
+    while (m_running.load(std::memory_order_acquire)) {
+        uint32_t index;
+        if (worker->queue.tryPop(index)) {
+            writeBuffer(index);
+            continue;
+        }
+        uint32_t token = worker->wakeUp.prepareWait();
+        if (worker->queue.empty() && m_running.load(std::memory_order_acquire)) {
+            worker->wakeUp.wait(token);
+        } else {
+            worker->wakeUp.cancelWait();
+        }
+    }
+}
+
+/**
+ * @brief Releases the backend, the buffers and the file descriptor.
+ */
+void AsyncFileSink::release() {
+    if (m_running.exchange(false)) {
+        for (auto& worker : m_workers) {
+            worker->wakeUp.notify();
+            worker->thread.join();
+        }
+    }
+    m_workers.clear();
+    m_uring.reset();
+    if (m_memory != MAP_FAILED) {
+        munmap(m_memory, static_cast<size_t>(ASYNC_SINK_BUFFER_COUNT) * ASYNC_SINK_BUFFER_BYTES);
+        m_memory = MAP_FAILED;
+    }
+    for (SinkBuffer& buffer : m_buffers) {
+        buffer.data = nullptr;
+        buffer.used = 0;
+    }
+    m_current = -1;
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
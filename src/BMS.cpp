@@ -1,26 +1,171 @@
 // src/BMS.cpp
 #include "../inc/BMS.h"
+#include <cmath>    // For std::fabs, std::exp, std::isfinite
+#include "../inc/CellKernels.h" // For PackCellKernels
+#include "../inc/EcmIdentifier.h" // For identified cell parameters
+#include "../inc/FlightRecorder.h" // For FlightRecorder class
+#include <cstdarg>  // For va_list
+#include <cstdio>   // For std::vsnprintf, std::snprintf
+#include <fstream>  // For checkpoint files
 #include <iostream> // For printing to console
 #include <iomanip>  // For formatting output
+#include <limits>   // For std::numeric_limits
 #include <numeric>  // For std::accumulate (if needed for average voltage/temp)
+#include <sstream>  // For building status output
+
+namespace {
+// The pack-major kernels run over blocks of PACK_KERNEL_BLOCK_PACKS packs. The block loops have
+// a fixed trip count, no branches and __restrict arrays, which is what the compiler needs to
+// vectorize them at -O2; the last, partial block runs the same loop with a variable count.
+
+/**
+ * @brief Adds a charge change to the counters of one block of packs and updates their SoC.
+ * The charge is summed with Kahan compensation: at 1 Hz a small current moves the counter
+ * by less than its float resolution, and plain addition would round that away every step.
+ * SoC is computed in a second loop so the compiler cannot fold it into the clamp branches.
+ * Charge and SoC are relative to the pack's estimated capacity.
+ */
+inline void addChargeBlock(size_t packCount, const float* __restrict chargeChange_mAh,
+                           const float* __restrict capacity_mAh, float* __restrict accumulatedCharge_mAh, float* __restrict chargeCompensation_mAh,
+                           float* __restrict stateOfCharge_percent) {
+    for (size_t p = 0; p < packCount; ++p) {
+        float charge_change_mAh = chargeChange_mAh[p];
+
+        // Compensated sum; the compensation holds what the previous additions rounded away
+        float addend_mAh = charge_change_mAh - chargeCompensation_mAh[p];
+        float charge_mAh = accumulatedCharge_mAh[p] + addend_mAh;
+        float compensation_mAh = (charge_mAh - accumulatedCharge_mAh[p]) - addend_mAh;
+
+        // Clamp accumulated charge to the capacity (representing 0% to 100% physically);
+        // a clamped sum discards its rounding error along with the excess charge
+        float inRange = (charge_mAh <= capacity_mAh[p]) & (charge_mAh >= 0.0f);
+        chargeCompensation_mAh[p] = compensation_mAh * inRange;
+        charge_mAh = charge_mAh > capacity_mAh[p] ? capacity_mAh[p] : charge_mAh;
+        accumulatedCharge_mAh[p] = charge_mAh < 0.0f ? 0.0f : charge_mAh;
+    }
+    for (size_t p = 0; p < packCount; ++p) {
+        // Calculate SoC percentage and ensure it is within 0-100%
+        float soc = (accumulatedCharge_mAh[p] / capacity_mAh[p]) * 100.0f;
+        soc = soc > 100.0f ? 100.0f : soc;
+        stateOfCharge_percent[p] = soc < 0.0f ? 0.0f : soc;
+    }
+}
+
+/**
+ * @brief Coulomb counting for one block of packs; see BMS::integrateStateOfCharge().
+ * The charge efficiency is applied as the factor 1 - (1 - CHARGE_EFFICIENCY) * charging,
+ * which is exactly CHARGE_EFFICIENCY or 1 (both subtractions are exact for an efficiency
+ * between 0.5 and 1), so the result equals the branching formulation bit for bit.
+ * packCount is at most PACK_KERNEL_BLOCK_PACKS.
+ */
+inline void integrateBlock(size_t packCount, const float* __restrict packCurrent_A, float deltaTime_h,
+                           const float* __restrict capacity_mAh, float* __restrict accumulatedCharge_mAh, float* __restrict chargeCompensation_mAh,
+                           float* __restrict stateOfCharge_percent) {
+    float chargeChange_mAh[PACK_KERNEL_BLOCK_PACKS];
+    for (size_t p = 0; p < packCount; ++p) {
+        // Current is in Amperes, convert to milliamperes (mA)
+        float current_mA = packCurrent_A[p] * 1000.0f;
+        float charging = current_mA > IDLE_CURRENT_THRESHOLD_A * 1000.0f;
+
+        // Q = I * t (mAh = mA * hours), with the charge efficiency applied when charging
+        chargeChange_mAh[p] = current_mA * deltaTime_h * (1.0f - (1.0f - CHARGE_EFFICIENCY) * charging);
+    }
+    addChargeBlock(packCount, chargeChange_mAh, capacity_mAh, accumulatedCharge_mAh, chargeCompensation_mAh,
+                   stateOfCharge_percent);
+}
+
+/**
+ * @brief Cycle counting and SoH for one block of packs; see BMS::countChargeCycles().
+ * Adding 0.5 * completed adds exactly 0.5 or nothing, as the branching formulation does.
+ */
+inline void countCyclesBlock(size_t packCount, const float* __restrict stateOfCharge_percent,
+                             const float* __restrict capacity_mAh, uint8_t* __restrict wasFull, uint8_t* __restrict wasEmpty, float* __restrict chargeCycles,
+                             float* __restrict stateOfHealth_percent, uint8_t* __restrict cycleCompleted) {
+    for (size_t p = 0; p < packCount; ++p) {
+        uint8_t full = wasFull[p] | (stateOfCharge_percent[p] >= SOC_FULL_THRESHOLD_PERCENT);
+        uint8_t empty = wasEmpty[p] | (stateOfCharge_percent[p] <= SOC_EMPTY_THRESHOLD_PERCENT);
+
+        // If it was full and now it's empty, or vice-versa, it's half a cycle
+        uint8_t completed = full & empty;
+        wasFull[p] = full & (completed ^ 1);
+        wasEmpty[p] = empty & (completed ^ 1);
+        cycleCompleted[p] = completed;
+        float cycles = chargeCycles[p] + 0.5f * completed;
+        chargeCycles[p] = cycles;
+
+        // Simplified SoH degradation: 0.1% degradation per full cycle
+        // In a real system, this would be much more complex (e.g., based on temperature, current, depth of discharge)
+        float soh = 100.0f - (cycles * 0.1f);
+        // The estimated capacity takes over where the pack has faded faster than the cycle model
+        float capacitySoh = capacity_mAh[p] * (100.0f / NOMINAL_CAPACITY_MAH);
+        soh = capacitySoh < soh ? capacitySoh : soh;
+        soh = soh > 100.0f ? 100.0f : soh;
+        stateOfHealth_percent[p] = soh < 0.0f ? 0.0f : soh;
+    }
+}
+
+/**
+ * @brief Checks that every value of a checkpoint is finite and within its range.
+ * The comparisons are written so that NaN fails them.
+ * @param checkpoint The checkpoint to check.
+ * @return True if the checkpoint can be restored, false otherwise.
+ */
+bool isCheckpointPlausible(const BMSCheckpoint& checkpoint) {
+    const double counters[] = {checkpoint.energyIn_Wh, checkpoint.energyOut_Wh, checkpoint.throughput_Ah,
+                               checkpoint.throughput_Wh, checkpoint.dischargePowerEwma_W, checkpoint.chargeCycles,
+                               checkpoint.capacitySumXX, checkpoint.capacitySumYY};
+    for (double counter : counters) {
+        if (!(counter >= 0.0) || !std::isfinite(counter)) {
+            return false;
+        }
+    }
+    return std::isfinite(checkpoint.estimatedCapacity_mAh) && checkpoint.estimatedCapacity_mAh > 0.0f
+        && checkpoint.accumulatedCharge_mAh >= 0.0f && checkpoint.accumulatedCharge_mAh <= checkpoint.estimatedCapacity_mAh
+        && checkpoint.stateOfCharge_percent >= 0.0f && checkpoint.stateOfCharge_percent <= 100.0f
+        && checkpoint.stateOfHealth_percent >= 0.0f && checkpoint.stateOfHealth_percent <= 100.0f
+        && std::isfinite(checkpoint.capacitySumXY);
+}
+} // namespace
 
 /**
  * @brief Constructor for the BMS.
  * Initializes the sensor simulator and safety manager.
  */
-BMS::BMS()
-    : m_packCurrent(0.0f),
-      m_accumulatedCharge_mAh(NOMINAL_CAPACITY_MAH * 0.5f), // Start at 50% SoC for simulation
-      m_stateOfCharge_percent(50.0f),
-      m_stateOfHealth_percent(100.0f),
-      m_chargeCycles(0.0f),
-      m_wasFull(false),
-      m_wasEmpty(false),
-      m_isChargingFlag(false)
+BMS::BMS() : BMS(nullptr, nullptr, std::pmr::get_default_resource()) {}
+
+/**
+ * @brief Constructor for a BMS whose state lives in caller-provided memory, e.g. a fleet arena.
+ * The provided hot and warm storage is (re)initialized to the start values.
+ * @param hotState Storage for the hot state, or nullptr for storage owned by the BMS.
+ * @param warmState Storage for the warm state, or nullptr for storage owned by the BMS.
+ * @param memory Memory resource the sensor simulator's cell model is allocated from.
+ */
+BMS::BMS(PackHotState* hotState, PackWarmState* warmState, std::pmr::memory_resource* memory)
+    : m_sensorSimulator(memory),
+      m_hot(hotState),
+      m_warm(warmState),
+      m_consoleOutput(true),
+      m_eventBus(nullptr),
+      m_snapshot(nullptr),
+      m_currentAcquisition(nullptr),
+      m_flightRecorder(nullptr)
 {
+    if (m_hot == nullptr) {
+        m_ownedHotState.reset(new PackHotState());
+        m_hot = m_ownedHotState.get();
+    } else {
+        *m_hot = PackHotState();
+    }
+    if (m_warm == nullptr) {
+        m_ownedWarmState.reset(new PackWarmState());
+        m_warm = m_ownedWarmState.get();
+    } else {
+        *m_warm = PackWarmState();
+    }
+
     // Initialize BatteryCell objects in the array
     for (uint8_t i = 0; i < NUM_CELLS; ++i) {
-        m_cells[i] = BatteryCell(i, 0.0f, 0.0f); // Initialize with ID and dummy values
+        m_hot->cells[i] = BatteryCell(i, 0.0f, 0.0f); // Initialize with ID and dummy values
     }
 }
 
@@ -29,92 +174,208 @@ BMS::BMS()
  * Performs any necessary setup for the system.
  */
 void BMS::init() {
-    logEvent("BMS initialized with " + std::to_string(NUM_CELLS) + " cells.");
+    logEvent("BMS initialized with %d cells.", static_cast<int>(NUM_CELLS));
     logEvent("Initial state: NORMAL");
-    logEvent("Initial SoC: " + std::to_string(static_cast<int>(m_stateOfCharge_percent)) + "%");
-    logEvent("Initial SoH: " + std::to_string(static_cast<int>(m_stateOfHealth_percent)) + "%");
+    logEvent("Initial SoC: %d%%", static_cast<int>(m_hot->stateOfCharge_percent));
+    logEvent("Initial SoH: %d%%", static_cast<int>(m_hot->stateOfHealth_percent));
 }
 
 /**
- * @brief Updates the State of Charge (SoC) using Coulomb counting.
+ * @brief Coulomb counting kernel, vectorized across packs (pack-major arrays).
+ * updateSoC() runs the same loop for a single pack, so both paths give bit-identical results.
+ * @param packCount Number of packs.
+ * @param packCurrent_A Pack current of each pack.
  * @param deltaTime_s The time elapsed since the last update in seconds.
+ * @param capacity_mAh Estimated capacity of each pack.
+ * @param accumulatedCharge_mAh Accumulated charge of each pack, updated.
+ * @param chargeCompensation_mAh Rounding compensation of each accumulated charge, updated.
+ * @param stateOfCharge_percent Output, SoC of each pack.
  */
-void BMS::updateSoC(float deltaTime_s) {
-    // Current is in Amperes, convert to milliamperes (mA)
-    float current_mA = m_packCurrent * 1000.0f;
-
-    // Calculate charge change in mAh
-    // Q = I * t (mAh = mA * hours)
+void BMS::integrateStateOfCharge(size_t packCount, const float* packCurrent_A, float deltaTime_s,
+                                 const float* capacity_mAh, float* accumulatedCharge_mAh,
+                                 float* chargeCompensation_mAh, float* stateOfCharge_percent) {
     // deltaTime_s is in seconds, convert to hours by dividing by 3600
-    float charge_change_mAh = current_mA * (deltaTime_s / 3600.0f);
-
-    // Apply charge efficiency if charging
-    if (current_mA > IDLE_CURRENT_THRESHOLD_A * 1000.0f) { // If charging
-        charge_change_mAh *= CHARGE_EFFICIENCY;
+    const float deltaTime_h = deltaTime_s / 3600.0f;
+    size_t first = 0;
+    for (; first + PACK_KERNEL_BLOCK_PACKS <= packCount; first += PACK_KERNEL_BLOCK_PACKS) {
+        integrateBlock(PACK_KERNEL_BLOCK_PACKS, packCurrent_A + first, deltaTime_h, capacity_mAh + first,
+                       accumulatedCharge_mAh + first, chargeCompensation_mAh + first, stateOfCharge_percent + first);
     }
+    integrateBlock(packCount - first, packCurrent_A + first, deltaTime_h, capacity_mAh + first,
+                   accumulatedCharge_mAh + first, chargeCompensation_mAh + first, stateOfCharge_percent + first);
+}
 
-    m_accumulatedCharge_mAh += charge_change_mAh;
-
-    // Clamp accumulated charge to nominal capacity (representing 0% to 100% physically)
-    if (m_accumulatedCharge_mAh > NOMINAL_CAPACITY_MAH) {
-        m_accumulatedCharge_mAh = NOMINAL_CAPACITY_MAH;
-    } else if (m_accumulatedCharge_mAh < 0.0f) {
-        m_accumulatedCharge_mAh = 0.0f;
+/**
+ * @brief Cycle counting and SoH kernel, vectorized across packs (pack-major arrays).
+ * A full cycle is counted when the battery goes from below SOC_EMPTY_THRESHOLD to above
+ * SOC_FULL_THRESHOLD, half a cycle for each transition. updateSoH() runs the same loop for
+ * a single pack, so both paths give bit-identical results. SoH follows the cycle count,
+ * or the estimated capacity relative to NOMINAL_CAPACITY_MAH where that is lower.
+ * @param packCount Number of packs.
+ * @param stateOfCharge_percent SoC of each pack.
+ * @param capacity_mAh Estimated capacity of each pack.
+ * @param wasFull Cycle flag of each pack (0 or 1), updated.
+ * @param wasEmpty Cycle flag of each pack (0 or 1), updated.
+ * @param chargeCycles Charge cycles of each pack, updated.
+ * @param stateOfHealth_percent Output, SoH of each pack.
+ * @param cycleCompleted Output, 1 for each pack that completed a half cycle, else 0.
+ */
+void BMS::countChargeCycles(size_t packCount, const float* stateOfCharge_percent, const float* capacity_mAh,
+                            uint8_t* wasFull, uint8_t* wasEmpty, float* chargeCycles, float* stateOfHealth_percent,
+                            uint8_t* cycleCompleted) {
+    size_t first = 0;
+    for (; first + PACK_KERNEL_BLOCK_PACKS <= packCount; first += PACK_KERNEL_BLOCK_PACKS) {
+        countCyclesBlock(PACK_KERNEL_BLOCK_PACKS, stateOfCharge_percent + first, capacity_mAh + first, wasFull + first,
+                         wasEmpty + first, chargeCycles + first, stateOfHealth_percent + first, cycleCompleted + first);
     }
+    countCyclesBlock(packCount - first, stateOfCharge_percent + first, capacity_mAh + first, wasFull + first,
+                     wasEmpty + first, chargeCycles + first, stateOfHealth_percent + first, cycleCompleted + first);
+}
 
-    // Calculate SoC percentage
-    m_stateOfCharge_percent = (m_accumulatedCharge_mAh / NOMINAL_CAPACITY_MAH) * 100.0f;
-
-    // Ensure SoC is within 0-100%
-    if (m_stateOfCharge_percent > 100.0f) m_stateOfCharge_percent = 100.0f;
-    if (m_stateOfCharge_percent < 0.0f) m_stateOfCharge_percent = 0.0f;
+/**
+ * @brief Updates the State of Charge (SoC) using Coulomb counting.
+ * With the high-rate acquisition, the charge drained from it is counted as it is, since
+ * the samples need not span exactly deltaTime_s; otherwise the pack current is
+ * integrated over deltaTime_s.
+ * @param deltaTime_s The time elapsed since the last update in seconds.
+ */
+void BMS::updateSoC(float deltaTime_s) {
+    if (m_currentInterval.sampleCount > 0) {
+        // As -> mAh, with the charge efficiency applied when charging, as integrateBlock() does
+        float charging = m_currentInterval.mean_A > IDLE_CURRENT_THRESHOLD_A;
+        float chargeChange_mAh = static_cast<float>(m_currentInterval.charge_As / 3.6)
+                               * (1.0f - (1.0f - CHARGE_EFFICIENCY) * charging);
+        addChargeBlock(1, &chargeChange_mAh, &m_hot->estimatedCapacity_mAh, &m_hot->accumulatedCharge_mAh,
+                       &m_hot->chargeCompensation_mAh, &m_hot->stateOfCharge_percent);
+        return;
+    }
+    float current_A = m_hot->packCurrent_A;
+    // The block loop of integrateStateOfCharge() for a single pack, without the call overhead
+    integrateBlock(1, &current_A, deltaTime_s / 3600.0f, &m_hot->estimatedCapacity_mAh,
+                   &m_hot->accumulatedCharge_mAh, &m_hot->chargeCompensation_mAh, &m_hot->stateOfCharge_percent);
 }
 
 /**
  * @brief Updates the State of Health (SoH) using a simplified cycle count.
- * A full cycle is counted when the battery goes from below SOC_EMPTY_THRESHOLD to above SOC_FULL_THRESHOLD.
+ * @return True if a half cycle was completed (the caller publishes CYCLE_INCREMENT).
  */
-void BMS::updateSoH() {
-    if (m_stateOfCharge_percent >= SOC_FULL_THRESHOLD_PERCENT) {
-        m_wasFull = true;
-    }
-    if (m_stateOfCharge_percent <= SOC_EMPTY_THRESHOLD_PERCENT) {
-        m_wasEmpty = true;
+bool BMS::updateSoH() {
+    uint8_t wasFull = m_warm->wasFull;
+    uint8_t wasEmpty = m_warm->wasEmpty;
+    uint8_t cycleCompleted = 0;
+    countCyclesBlock(1, &m_hot->stateOfCharge_percent, &m_hot->estimatedCapacity_mAh, &wasFull, &wasEmpty,
+                     &m_warm->chargeCycles, &m_hot->stateOfHealth_percent, &cycleCompleted);
+    m_warm->wasFull = wasFull != 0;
+    m_warm->wasEmpty = wasEmpty != 0;
+    return cycleCompleted != 0;
+}
+
+/**
+ * @brief Updates the energy and throughput counters.
+ * Pack power is the terminal voltage times the pack current; every string's cells add up
+ * to the terminal voltage, so it is the sum of all cell voltages over the number of
+ * strings. Lifetime counters
+ * are kept in double precision so that small per-tick increments are not lost.
+ * @param deltaTime_s The time elapsed since the last update in seconds.
+ */
+void BMS::updateEnergy(float deltaTime_s) {
+    std::array<float, NUM_CELLS> voltages;
+    std::array<float, NUM_CELLS> temperatures;
+    PackCellKernels<NUM_CELLS>::gather(m_hot->cells, voltages.data(), temperatures.data());
+    float packVoltage = PackCellKernels<NUM_CELLS>::statistics(voltages.data(), temperatures.data()).sumVoltage_V / NUM_PARALLEL_STRINGS;
+    float power_W = packVoltage * m_hot->packCurrent_A;
+    double deltaTime_h = static_cast<double>(deltaTime_s) / 3600.0;
+    double energy_Wh = static_cast<double>(power_W) * deltaTime_h;
+
+    if (m_hot->packCurrent_A > IDLE_CURRENT_THRESHOLD_A) { // Charging
+        m_warm->energyIn_Wh += energy_Wh;
+    } else if (m_hot->packCurrent_A < -IDLE_CURRENT_THRESHOLD_A) { // Discharging
+        m_warm->energyOut_Wh -= energy_Wh;
+        // Average only over periods of use, so charging and rest do not hide consumption; the
+        // smoothing factor follows from the time step, so the time constant does not depend on
+        // the update rate or on long accelerated steps
+        float alpha = 1.0f - std::exp(-deltaTime_s / ENERGY_EWMA_TIME_CONSTANT_S);
+        m_warm->dischargePowerEwma_W += alpha * (-power_W - m_warm->dischargePowerEwma_W);
     }
+    m_warm->throughput_Ah += std::fabs(m_hot->packCurrent_A) * deltaTime_h;
+    m_warm->throughput_Wh += std::fabs(energy_Wh);
+}
 
-    // If it was full and now it's empty, or vice-versa, it's a full cycle
-    if (m_wasFull && m_wasEmpty) {
-        m_chargeCycles += 0.5f; // Count half a cycle for each transition
-        m_wasFull = false;
-        m_wasEmpty = false;
-        logEvent("Charge cycle incremented. Total cycles: " + std::to_string(m_chargeCycles));
+/**
+ * @brief Publishes an event on the attached event bus, if any.
+ * Never blocks; the event is dropped if the bus queue is full.
+ * @param event The event to publish.
+ */
+void BMS::publishEvent(const BmsEvent& event) {
+    if (m_eventBus != nullptr) {
+        m_eventBus->publish(event);
     }
+}
 
-    // Simplified SoH degradation: 0.1% degradation per full cycle
-    // In a real system, this would be much more complex (e.g., based on temperature, current, depth of discharge)
-    m_stateOfHealth_percent = 100.0f - (m_chargeCycles * 0.1f);
+/**
+ * @brief Publishes THRESHOLD_CROSSING events for SoC and SoH thresholds crossed this update.
+ * @param previousSoC The SoC before this update (%).
+ * @param previousSoH The SoH before this update (%).
+ */
+void BMS::publishThresholdCrossings(float previousSoC, float previousSoH) {
+    if (m_eventBus == nullptr) return;
 
-    // Clamp SoH to 0-100%
-    if (m_stateOfHealth_percent > 100.0f) m_stateOfHealth_percent = 100.0f;
-    if (m_stateOfHealth_percent < 0.0f) m_stateOfHealth_percent = 0.0f;
+    struct Crossing {
+        ThresholdId id;
+        float threshold;
+        float previous;
+        float current;
+    };
+    const Crossing crossings[] = {
+        {ThresholdId::SOC_FULL, SOC_FULL_THRESHOLD_PERCENT, previousSoC, m_hot->stateOfCharge_percent},
+        {ThresholdId::SOC_EMPTY, SOC_EMPTY_THRESHOLD_PERCENT, previousSoC, m_hot->stateOfCharge_percent},
+        {ThresholdId::SOH_WARNING, SOH_THRESHOLD_WARNING, previousSoH, m_hot->stateOfHealth_percent},
+        {ThresholdId::SOH_CRITICAL, SOH_THRESHOLD_CRITICAL, previousSoH, m_hot->stateOfHealth_percent},
+    };
+    for (const auto& crossing : crossings) {
+        bool wasAbove = crossing.previous >= crossing.threshold;
+        bool isAbove = crossing.current >= crossing.threshold;
+        if (wasAbove != isAbove) {
+            BmsEvent event;
+            event.type = EventType::THRESHOLD_CROSSING;
+            event.threshold = crossing.id;
+            event.rising = isAbove;
+            event.value = crossing.current;
+            publishEvent(event);
+        }
+    }
 }
 
 /**
- * @brief Logs an event or message to the console.
- * In a real system, this would write to a log file or send over a comms bus.
- * @param message The message to log.
+ * @brief Publishes a log message as a LOG event.
+ * Subscribers on the event bus decide where it goes (console, file, comms bus).
+ * The message is formatted straight into the fixed-size event text (truncated if
+ * necessary) and only if a bus is attached, so logging never allocates and costs
+ * nothing for packs without a bus, e.g. in a fleet.
+ * @param format printf-style format of the message, followed by its arguments.
  */
-void BMS::logEvent(const std::string& message) {
-    std::cout << "[LOG] " << message << std::endl;
+void BMS::logEvent(const char* format, ...) {
+    if (m_eventBus == nullptr) return;
+
+    BmsEvent event;
+    event.type = EventType::LOG;
+    va_list arguments;
+    va_start(arguments, format);
+    std::vsnprintf(event.text, sizeof(event.text), format, arguments);
+    va_end(arguments);
+    publishEvent(event);
 }
 
 /**
- * @brief Handles a detected fault.
- * In a real system, this would trigger specific safety actions (e.g., shutdown, isolation).
+ * @brief Handles a detected fault by publishing a FAULT event.
+ * Subscribers such as contactor control trigger the safety actions (e.g., shutdown, isolation).
  * @param faultDescription A description of the fault.
  */
-void BMS::handleFault(const std::string& faultDescription) {
-    std::cerr << "[FAULT] " << faultDescription << " - Immediate action required!" << std::endl;
+void BMS::handleFault(const char* faultDescription) {
+    BmsEvent event;
+    event.type = EventType::FAULT;
+    event.setText(faultDescription);
+    publishEvent(event);
     // In a real system:
     // - Trigger hardware shutdown
     // - Isolate battery pack
@@ -130,69 +391,277 @@ void BMS::handleFault(const std::string& faultDescription) {
  * @param deltaTime_s The time elapsed since the last update in seconds.
  */
 void BMS::update(float deltaTime_s) {
-    // 1. Read sensor data for each cell and pack current
-    std::cout << "\n--- Reading Sensor Data ---" << std::endl;
+    readSensors(deltaTime_s);
+    updateFromReadings(deltaTime_s);
+}
+
+/**
+ * @brief Second phase of update(): runs the SoC, SoH and safety estimators on the readings and completes the update.
+ * Used after readCellSensors() by the fleet, which solves the string currents of many
+ * packs at once before reading their cells.
+ * @param deltaTime_s The time elapsed since the last update in seconds.
+ */
+void BMS::updateFromReadings(float deltaTime_s) {
+    // 2. Update SoC and SoH, and propose a safety state from the new readings and SoH
+    float previousSoC = m_hot->stateOfCharge_percent;
+    float previousSoH = m_hot->stateOfHealth_percent;
+    updateSoC(deltaTime_s);
+    bool cycleCompleted = updateSoH();
+    SystemState proposedState = m_safetyManager.proposeState(m_hot->cells, m_hot->packCurrent_A, m_hot->stateOfHealth_percent);
+
+    completeUpdate(deltaTime_s, previousSoC, previousSoH, cycleCompleted, proposedState);
+}
+
+/**
+ * @brief First phase of update(): reads the sensors and runs the residency histogram and thermal management.
+ * Reads the pack current, divides it between the strings and reads the cells under
+ * their strings' currents. Used with completeUpdate() by the fleet's pack-major mode,
+ * which runs the SoC, SoH and safety kernels for many packs between the two phases.
+ * @param deltaTime_s The time elapsed since the last update in seconds.
+ */
+void BMS::readSensors(float deltaTime_s) {
+    std::array<float, NUM_PARALLEL_STRINGS> stringOcv_V;
+    std::array<float, NUM_PARALLEL_STRINGS> stringResistance_Ohm;
+    std::array<float, NUM_PARALLEL_STRINGS> stringCurrent_A;
+    readPackCurrent(stringOcv_V.data(), stringResistance_Ohm.data());
+    SensorSimulator::solveStringCurrents(1, &m_hot->packCurrent_A, stringOcv_V.data(), stringResistance_Ohm.data(),
+                                         stringCurrent_A.data(), nullptr);
+    readCellSensors(stringCurrent_A.data(), deltaTime_s);
+}
+
+/**
+ * @brief Reads the pack current and gets the string model it divides by.
+ * First part of readSensors(); the fleet solves the string currents of a block of packs
+ * in one call between this and readCellSensors().
+ * @param stringOcv_V Receives the open-circuit voltage per string (NUM_PARALLEL_STRINGS entries).
+ * @param stringResistance_Ohm Receives the resistance per string (NUM_PARALLEL_STRINGS entries).
+ */
+void BMS::readPackCurrent(float* stringOcv_V, float* stringResistance_Ohm) {
+    // 1. Read pack current and sensor data for each cell (cell voltages depend on the current)
+    if (m_consoleOutput) std::cout << "\n--- Reading Sensor Data ---" << std::endl;
+    m_hot->packCurrent_A = m_sensorSimulator.readCurrent();
+    if (m_currentAcquisition != nullptr) {
+        // The reading is the load demand for the next interval; the current is measured
+        // over the last one from the high-rate samples
+        m_currentAcquisition->setLoadCurrent_A(m_hot->packCurrent_A);
+        if (m_currentAcquisition->drain(m_currentInterval)) {
+            m_hot->packCurrent_A = m_currentInterval.mean_A;
+        } else {
+            m_currentInterval = DecimatedCurrent();
+        }
+    }
+    m_sensorSimulator.getStringModel(stringOcv_V, stringResistance_Ohm);
+}
+
+/**
+ * @brief Reads the cells under their strings' currents and runs the residency histogram and thermal management.
+ * Second part of readSensors(), given the string currents solved for the pack current.
+ * @param stringCurrent_A Current per string (NUM_PARALLEL_STRINGS entries, positive for charge).
+ * @param deltaTime_s The time elapsed since the last update in seconds.
+ */
+void BMS::readCellSensors(const float* stringCurrent_A, float deltaTime_s) {
+    m_sensorSimulator.setStringCurrents(stringCurrent_A);
     for (uint8_t i = 0; i < NUM_CELLS; ++i) {
         float voltage = m_sensorSimulator.readVoltage(i);
         float temperature = m_sensorSimulator.readTemperature(i);
 
-        m_cells[i].setVoltage(voltage);
-        m_cells[i].setTemperature(temperature);
+        m_hot->cells[i].setVoltage(voltage);
+        m_hot->cells[i].setTemperature(temperature);
 
-        std::cout << "Cell " << (int)i << ": Voltage = "
-                  << std::fixed << std::setprecision(3) << voltage << "V, Temperature = "
-                  << std::fixed << std::setprecision(1) << temperature << "C" << std::endl;
+        if (m_consoleOutput) {
+            std::cout << "Cell " << (int)i << ": Voltage = "
+                      << std::fixed << std::setprecision(3) << voltage << "V, Temperature = "
+                      << std::fixed << std::setprecision(1) << temperature << "C" << std::endl;
+        }
     }
-    m_packCurrent = m_sensorSimulator.readCurrent();
-    std::cout << "Pack Current: " << std::fixed << std::setprecision(2) << m_packCurrent << "A" << std::endl;
+    m_hot->packVoltage_V = m_sensorSimulator.readPackVoltage();
+    m_sensorSimulator.step(deltaTime_s);
+    for (uint8_t k = 0; k < NUM_PARALLEL_STRINGS; ++k) {
+        m_hot->stringCurrents_A[k] = m_sensorSimulator.readStringCurrent(k);
+    }
+    if (m_consoleOutput) {
+        std::cout << "Pack Current: " << std::fixed << std::setprecision(2) << m_hot->packCurrent_A << "A (strings:";
+        for (float stringCurrent : m_hot->stringCurrents_A) {
+            std::cout << " " << stringCurrent << "A";
+        }
+        std::cout << ")";
+        if (m_currentInterval.sampleCount > 0) {
+            std::cout << " [" << m_currentInterval.min_A << "A to " << m_currentInterval.max_A << "A over "
+                      << m_currentInterval.sampleCount << " samples";
+            if (m_currentInterval.lostDuration_s > 0.0) {
+                std::cout << ", " << m_currentInterval.lostDuration_s << "s lost to overruns";
+            }
+            std::cout << "]";
+        }
+        std::cout << std::endl;
+        std::cout << "Pack Voltage: " << std::fixed << std::setprecision(2) << m_hot->packVoltage_V << "V" << std::endl;
+    }
+
+    // Keep the time each cell spends at voltage/temperature for warranty analysis
+    m_residencyHistogram.record(m_hot->cells, deltaTime_s);
+
+    // Thermal management runs its controllers at its own period and drives the coolant loop
+    m_thermalManager.update(m_hot->cells, deltaTime_s);
+    m_sensorSimulator.setThermalActuators(m_thermalManager.getCoolingDuty(), m_thermalManager.getHeaterDuty());
 
     // Determine charging state
-    if (m_packCurrent > IDLE_CURRENT_THRESHOLD_A) {
-        m_isChargingFlag = true;
-    } else if (m_packCurrent < -IDLE_CURRENT_THRESHOLD_A) {
-        m_isChargingFlag = false; // Discharging
+    if (m_hot->packCurrent_A > IDLE_CURRENT_THRESHOLD_A) {
+        m_hot->charging = true;
+    } else if (m_hot->packCurrent_A < -IDLE_CURRENT_THRESHOLD_A) {
+        m_hot->charging = false; // Discharging
     }
-    // If current is near zero (idle), m_isChargingFlag retains its last state or could be set to false
+    // If current is near zero (idle), the charging flag retains its last state or could be set to false
+}
 
-    // 2. Update SoC and SoH
-    updateSoC(deltaTime_s);
-    updateSoH();
+/**
+ * @brief Last phase of update(), given the results of the SoC, SoH and safety kernels.
+ * Publishes the cycle and threshold events, updates the energy counters and the sensor
+ * diagnostics, applies the proposed safety state and runs the state actions.
+ * @param deltaTime_s The time elapsed since the last update in seconds.
+ * @param previousSoC The SoC before the kernels ran (%).
+ * @param previousSoH The SoH before the kernels ran (%).
+ * @param cycleCompleted True if the SoH kernel counted a half cycle.
+ * @param proposedState The state proposed by the safety kernel.
+ */
+void BMS::completeUpdate(float deltaTime_s, float previousSoC, float previousSoH, bool cycleCompleted, SystemState proposedState) {
+    if (cycleCompleted) {
+        BmsEvent event;
+        event.type = EventType::CYCLE_INCREMENT;
+        event.value = m_warm->chargeCycles;
+        publishEvent(event);
+    }
+    publishThresholdCrossings(previousSoC, previousSoH);
+    updateEnergy(deltaTime_s);
+    if (CapacityEstimator::update(m_warm->capacityEstimator, m_hot->cells, m_hot->packCurrent_A, deltaTime_s,
+                                  m_hot->estimatedCapacity_mAh)) {
+        logEvent("Capacity estimate updated to %d mAh.", static_cast<int>(m_hot->estimatedCapacity_mAh));
+    }
 
-    // 3. Evaluate safety based on current cell data, pack current, and SoH
-    m_safetyManager.evaluate(m_cells, m_packCurrent, m_stateOfHealth_percent);
+    // 3. Apply the safety state proposed from the current cell data, pack current, and SoH,
+    //    with the sensor plausibility diagnostics running alongside. The I2t overload
+    //    protection integrates the squared samples of the interval where the high-rate
+    //    acquisition provides them, and a short circuit latched by its fast path is a FAULT.
+    m_sensorDiagnostics.update(m_hot->cells, m_hot->packVoltage_V);
+    float meanSquareCurrent_A2 = m_currentInterval.sampleCount > 0 ? m_currentInterval.meanSquare_A2
+                                                                   : m_hot->packCurrent_A * m_hot->packCurrent_A;
+    SystemState overloadState = m_safetyManager.integrateOverload(meanSquareCurrent_A2, deltaTime_s);
+    if (overloadState > proposedState) {
+        proposedState = overloadState;
+    }
+    const ShortCircuitDetector* shortCircuitDetector =
+        m_currentAcquisition != nullptr ? m_currentAcquisition->getShortCircuitDetector() : nullptr;
+    bool shortCircuit = shortCircuitDetector != nullptr && shortCircuitDetector->isTripped();
+    if (shortCircuit) {
+        proposedState = SystemState::FAULT;
+    }
+    m_safetyManager.applyState(proposedState);
+    if (m_safetyManager.hasStateChanged()) {
+        BmsEvent event;
+        event.type = EventType::STATE_TRANSITION;
+        event.fromState = m_safetyManager.getPreviousState();
+        event.toState = m_safetyManager.getCurrentState();
+        publishEvent(event);
+    }
+
+    for (uint8_t i = 0; i < NUM_CELLS; ++i) {
+        uint8_t raised = m_sensorDiagnostics.getRaisedFlags(i);
+        if (raised & SENSOR_DIAG_VOLTAGE_STUCK) {
+            logEvent("Cell %d voltage sensor stuck.", i);
+        }
+        if (raised & SENSOR_DIAG_TEMPERATURE_STUCK) {
+            logEvent("Cell %d temperature sensor stuck.", i);
+        }
+        if (raised & SENSOR_DIAG_VOLTAGE_OPEN_WIRE) {
+            logEvent("Cell %d voltage sense wire open.", i);
+        }
+        if (raised & SENSOR_DIAG_THERMISTOR_OPEN) {
+            logEvent("Cell %d thermistor open.", i);
+        }
+    }
 
-    // 4. Handle state-specific actions
+    // 4. Handle the actions of a state when it is entered; while the state holds, nothing
+    //    is formatted or published
     SystemState currentState = m_safetyManager.getCurrentState();
-    switch (currentState) {
-        case SystemState::NORMAL:
-            logEvent("BMS operating normally.");
-            // No specific actions needed, perhaps enable full power
-            break;
-        case SystemState::WARNING:
-            logEvent("BMS in WARNING state. Check parameters!");
-            // Reduce power output, send warning to user/system
-            break;
-        case SystemState::CRITICAL:
-            logEvent("BMS in CRITICAL state. Prepare for shutdown or severe limitation!");
-            // Severely limit power, prepare for emergency shutdown, log critical event
-            break;
-        case SystemState::FAULT:
-            handleFault("BMS entered FAULT state due to critical sensor reading or persistent issue.");
-            // Trigger immediate shutdown, isolate battery
-            break;
-    }
-
-    // 5. Print current system status
-    std::cout << "Current BMS State: ";
-    switch (currentState) {
-        case SystemState::NORMAL:   std::cout << "NORMAL"; break;
-        case SystemState::WARNING:  std::cout << "WARNING"; break;
-        case SystemState::CRITICAL: std::cout << "CRITICAL"; break;
-        case SystemState::FAULT:    std::cout << "FAULT"; break;
-    }
-    std::cout << " | SoC: " << std::fixed << std::setprecision(1) << m_stateOfCharge_percent << "%";
-    std::cout << " | SoH: " << std::fixed << std::setprecision(1) << m_stateOfHealth_percent << "%";
-    std::cout << " | Charging: " << (m_isChargingFlag ? "YES" : "NO") << std::endl;
+    bool stateEntered = m_safetyManager.hasStateChanged();
+    const char* faultDescription = "";
+    char shortCircuitDescription[EVENT_TEXT_LENGTH];
+    if (stateEntered) {
+        switch (currentState) {
+            case SystemState::NORMAL:
+                logEvent("BMS operating normally.");
+                // No specific actions needed, perhaps enable full power
+                break;
+            case SystemState::WARNING:
+                logEvent("BMS in WARNING state. Check parameters!");
+                // Reduce power output, send warning to user/system
+                break;
+            case SystemState::CRITICAL:
+                logEvent("BMS in CRITICAL state. Prepare for shutdown or severe limitation!");
+                // Severely limit power, prepare for emergency shutdown, log critical event
+                break;
+            case SystemState::FAULT:
+                if (shortCircuit) {
+                    std::snprintf(shortCircuitDescription, sizeof(shortCircuitDescription),
+                                  "BMS entered FAULT state due to a short circuit (%d A); contactor opened.",
+                                  static_cast<int>(shortCircuitDetector->getTripCurrent_A()));
+                    faultDescription = shortCircuitDescription;
+                } else if (m_safetyManager.isOverloadTripped()) {
+                    faultDescription = "BMS entered FAULT state due to an overload (I2t limit exceeded).";
+                } else if (m_sensorDiagnostics.hasSensorFault()) {
+                    faultDescription = "BMS entered FAULT state due to a sensor fault (readings not plausible).";
+                } else {
+                    faultDescription = "BMS entered FAULT state due to critical sensor reading or persistent issue.";
+                }
+                handleFault(faultDescription);
+                // Trigger immediate shutdown, isolate battery
+                break;
+        }
+    }
+
+    // Keep the frames around a fault: record this update and freeze the recorder on entering FAULT
+    if (m_flightRecorder != nullptr) {
+        m_flightRecorder->record(*m_hot, currentState, deltaTime_s);
+        if (currentState == SystemState::FAULT && stateEntered && m_flightRecorder->trigger(faultDescription)) {
+            logEvent("Flight recorder triggered; freeze frame follows after %u updates.", FLIGHT_RECORDER_POST_FRAMES);
+        }
+    }
+
+    // Publish a snapshot for display threads
+    if (m_snapshot != nullptr) {
+        BmsSnapshot snapshot;
+        snapshot.state = currentState;
+        snapshot.stateOfCharge_percent = m_hot->stateOfCharge_percent;
+        snapshot.stateOfHealth_percent = m_hot->stateOfHealth_percent;
+        snapshot.packCurrent_A = m_hot->packCurrent_A;
+        snapshot.packVoltage_V = m_hot->packVoltage_V;
+        snapshot.charging = m_hot->charging;
+        for (uint8_t i = 0; i < NUM_CELLS; ++i) {
+            snapshot.cellVoltages_V[i] = m_hot->cells[i].getVoltage();
+            snapshot.cellTemperatures_C[i] = m_hot->cells[i].getTemperature();
+        }
+        m_snapshot->write(snapshot);
+    }
+
+    // 5. Print current system status (built first and written at once, since event
+    //    subscribers may be printing from the dispatcher thread at the same time)
+    if (!m_consoleOutput) return;
+    std::ostringstream status;
+    status << "Current BMS State: " << toString(currentState);
+    status << " | SoC: " << std::fixed << std::setprecision(1) << m_hot->stateOfCharge_percent << "%";
+    status << " | SoH: " << std::fixed << std::setprecision(1) << m_hot->stateOfHealth_percent << "%";
+    status << " | Capacity: " << std::setprecision(0) << m_hot->estimatedCapacity_mAh << "mAh";
+    status << " | Charging: " << (m_hot->charging ? "YES" : "NO") << "\n";
+    EnergyReport energy = getEnergyReport();
+    status << "Energy In: " << std::fixed << std::setprecision(3) << energy.energyIn_Wh << "Wh"
+           << " | Energy Out: " << energy.energyOut_Wh << "Wh"
+           << " | Remaining: " << std::setprecision(1) << energy.remainingEnergy_Wh << "Wh"
+           << " | Time to Empty: " << std::setprecision(2) << energy.timeToEmpty_h << "h" << "\n";
+    status << "Cooling: " << std::setprecision(0) << m_thermalManager.getCoolingDuty() * 100.0f << "%"
+           << " | Heater: " << m_thermalManager.getHeaterDuty() * 100.0f << "%"
+           << " | Coolant: " << std::setprecision(1) << m_sensorSimulator.readCoolantTemperature() << "C"
+           << (m_thermalManager.isPreconditioning() ? " | Preconditioning" : "")
+           << " | Above temperature warning: " << std::setprecision(0) << m_thermalManager.getTimeAboveWarning_s() << "s" << "\n";
+    std::cout << status.str() << std::flush;
 }
 
 /**
@@ -208,7 +677,7 @@ SystemState BMS::getCurrentState() const {
  * @return SoC in percentage (0.0 to 100.0).
  */
 float BMS::getSoC() const {
-    return m_stateOfCharge_percent;
+    return m_hot->stateOfCharge_percent;
 }
 
 /**
@@ -216,7 +685,15 @@ float BMS::getSoC() const {
  * @return SoH in percentage (0.0 to 100.0).
  */
 float BMS::getSoH() const {
-    return m_stateOfHealth_percent;
+    return m_hot->stateOfHealth_percent;
+}
+
+/**
+ * @brief Gets the online estimate of the pack capacity.
+ * @return Capacity in mAh.
+ */
+float BMS::getEstimatedCapacity_mAh() const {
+    return m_hot->estimatedCapacity_mAh;
 }
 
 /**
@@ -224,7 +701,79 @@ float BMS::getSoH() const {
  * @return Current in Amperes (positive for charge, negative for discharge).
  */
 float BMS::getPackCurrent() const {
-    return m_packCurrent;
+    return m_hot->packCurrent_A;
+}
+
+/**
+ * @brief Gets the current of one parallel string.
+ * @param stringIndex The index of the string (0 to NUM_PARALLEL_STRINGS - 1).
+ * @return Current in Amperes (positive for charge, negative for discharge), 0 for an invalid index.
+ */
+float BMS::getStringCurrent(uint8_t stringIndex) const {
+    return stringIndex < NUM_PARALLEL_STRINGS ? m_hot->stringCurrents_A[stringIndex] : 0.0f;
+}
+
+/**
+ * @brief Gets the latest readings of all cells.
+ * @return Reference to the array of BatteryCell objects.
+ */
+const std::array<BatteryCell, NUM_CELLS>& BMS::getCells() const {
+    return m_hot->cells;
+}
+
+/**
+ * @brief Gets the pack voltage measured by the independent pack-voltage channel.
+ * @return Pack voltage in Volts.
+ */
+float BMS::getPackVoltage() const {
+    return m_hot->packVoltage_V;
+}
+
+/**
+ * @brief Fills the telemetry channels with the latest readings and estimates.
+ * @param channels Receives the values in the telemetry channel layout.
+ */
+void BMS::getTelemetryChannels(TelemetryChannels& channels) const {
+    for (uint8_t i = 0; i < NUM_CELLS; ++i) {
+        channels[TELEMETRY_CHANNEL_VOLTAGE_BASE + i] = m_hot->cells[i].getVoltage();
+        channels[TELEMETRY_CHANNEL_TEMP_BASE + i] = m_hot->cells[i].getTemperature();
+    }
+    channels[TELEMETRY_CHANNEL_PACK_CURRENT] = m_hot->packCurrent_A;
+    channels[TELEMETRY_CHANNEL_PACK_VOLTAGE] = m_hot->packVoltage_V;
+    channels[TELEMETRY_CHANNEL_SOC] = m_hot->stateOfCharge_percent;
+}
+
+/**
+ * @brief Gets the internal resistance (R0) of every cell.
+ * The simulated cells stand in for an online resistance estimate.
+ * @return Resistances in Ohms, one per cell, as sampled or applied by loadCellParameters().
+ */
+const std::pmr::vector<float>& BMS::getCellResistances_Ohm() const {
+    return m_sensorSimulator.getCellBank().getResistances_Ohm();
+}
+
+/**
+ * @brief Gets the thermal management subsystem.
+ * @return Reference to the ThermalManager object.
+ */
+const ThermalManager& BMS::getThermalManager() const {
+    return m_thermalManager;
+}
+
+/**
+ * @brief Enables or disables thermal preconditioning for an upcoming charge.
+ * @param enabled True to bring the cells into the charging temperature window.
+ */
+void BMS::setPreconditioning(bool enabled) {
+    m_thermalManager.setPreconditioning(enabled);
+}
+
+/**
+ * @brief Gets the sensor plausibility diagnostics.
+ * @return Reference to the SensorDiagnostics object.
+ */
+const SensorDiagnostics& BMS::getSensorDiagnostics() const {
+    return m_sensorDiagnostics;
 }
 
 /**
@@ -232,5 +781,241 @@ float BMS::getPackCurrent() const {
  * @return True if charging, false otherwise.
  */
 bool BMS::isCharging() const {
-    return m_isChargingFlag;
+    return m_hot->charging;
+}
+
+/**
+ * @brief Moves the hot and warm state into storage provided by the caller, e.g. a fleet arena.
+ * The current state is copied over and the BMS's own storage is released.
+ * @param hotState Storage for the hot state; must outlive the BMS or the next attachState().
+ * @param warmState Storage for the warm state; must outlive the BMS or the next attachState().
+ * @return True on success, false if a storage pointer is null.
+ */
+bool BMS::attachState(PackHotState* hotState, PackWarmState* warmState) {
+    if (hotState == nullptr || warmState == nullptr) {
+        return false;
+    }
+    *hotState = *m_hot;
+    *warmState = *m_warm;
+    m_hot = hotState;
+    m_warm = warmState;
+    m_ownedHotState.reset();
+    m_ownedWarmState.reset();
+    return true;
+}
+
+/**
+ * @brief Gets the hot state of the pack.
+ * @return Reference to the hot state.
+ */
+const PackHotState& BMS::getHotState() const {
+    return *m_hot;
+}
+
+/**
+ * @brief Gets the warm state of the pack.
+ * @return Reference to the warm state.
+ */
+const PackWarmState& BMS::getWarmState() const {
+    return *m_warm;
+}
+
+/**
+ * @brief Gets the per-cell voltage/temperature residency histograms.
+ * @return Reference to the ResidencyHistogram object.
+ */
+const ResidencyHistogram& BMS::getResidencyHistogram() const {
+    return m_residencyHistogram;
+}
+
+/**
+ * @brief Enables or disables all console output of this BMS and its sub-modules.
+ * Fleet runs disable it so that thousands of packs do not flood the console.
+ * @param enabled True to print (default), false to stay silent.
+ */
+void BMS::setConsoleOutput(bool enabled) {
+    m_consoleOutput = enabled;
+    m_sensorSimulator.setConsoleOutput(enabled);
+}
+
+/**
+ * @brief Attaches the event bus that state transitions, faults, cycle increments,
+ * threshold crossings and log messages are published to.
+ * Without a bus (the default) events are discarded.
+ * @param eventBus The bus to publish to, or nullptr to detach.
+ */
+void BMS::attachEventBus(EventBus* eventBus) {
+    m_eventBus = eventBus;
+}
+
+/**
+ * @brief Attaches the seqlock a BmsSnapshot is published to at the end of every update.
+ * The writer never waits, so a slow display cannot delay the BMS.
+ * @param snapshot The seqlock to write to, or nullptr to detach.
+ */
+void BMS::attachSnapshot(Seqlock<BmsSnapshot>* snapshot) {
+    m_snapshot = snapshot;
+}
+
+/**
+ * @brief Attaches the high-rate current acquisition the pack current is measured with.
+ * While attached, the current read from the simulator is only the load demand: the
+ * acquisition samples it, and the pack current is the decimated current of the samples
+ * since the last update, which also drives the simulated cells. SoC counts the exact
+ * integrated charge of the samples.
+ * @param acquisition The acquisition to drain every update, or nullptr to detach.
+ */
+void BMS::attachCurrentAcquisition(CurrentAcquisition* acquisition) {
+    m_currentAcquisition = acquisition;
+    m_currentInterval = DecimatedCurrent();
+}
+
+/**
+ * @brief Attaches the flight recorder every update is recorded to and faults trigger.
+ * The hot state of every update is recorded after the state actions; entering FAULT
+ * triggers a freeze-frame capture with the fault description.
+ * @param recorder The recorder (not owned), or nullptr to detach.
+ */
+void BMS::attachFlightRecorder(FlightRecorder* recorder) {
+    m_flightRecorder = recorder;
+}
+
+/**
+ * @brief Gets the energy and throughput figures of the pack.
+ * Remaining energy is the remaining charge at nominal pack voltage; time to empty
+ * divides it by the moving average of recent discharge power.
+ * @return EnergyReport with the current counters and range estimate.
+ */
+EnergyReport BMS::getEnergyReport() const {
+    EnergyReport report;
+    report.energyIn_Wh = m_warm->energyIn_Wh;
+    report.energyOut_Wh = m_warm->energyOut_Wh;
+    report.throughput_Ah = m_warm->throughput_Ah;
+    report.throughput_Wh = m_warm->throughput_Wh;
+    report.averageDischargePower_W = m_warm->dischargePowerEwma_W;
+    report.remainingEnergy_Wh = (m_hot->accumulatedCharge_mAh / 1000.0f) * (CELLS_PER_STRING * NOMINAL_CELL_VOLTAGE_V);
+    report.timeToEmpty_h = (m_warm->dischargePowerEwma_W > ENERGY_MIN_DISCHARGE_POWER_W)
+                               ? report.remainingEnergy_Wh / m_warm->dischargePowerEwma_W
+                               : std::numeric_limits<float>::infinity();
+    return report;
+}
+
+/**
+ * @brief Fills one EnergyReport per pack for a whole fleet.
+ * Reuses the capacity of the reports vector, so repeated queries do not allocate.
+ * @param packs The packs to query, stored contiguously (e.g. in the fleet arena).
+ * @param packCount Number of packs.
+ * @param reports Output vector, resized to packCount.
+ */
+void BMS::queryFleetEnergy(const BMS* packs, size_t packCount, std::vector<EnergyReport>& reports) {
+    reports.resize(packCount);
+    for (size_t i = 0; i < packCount; ++i) {
+        reports[i] = packs[i].getEnergyReport();
+    }
+}
+
+/**
+ * @brief Captures the estimator state for persistence.
+ * @return BMSCheckpoint holding SoC, SoH, cycle and energy counters.
+ */
+BMSCheckpoint BMS::getCheckpoint() const {
+    BMSCheckpoint checkpoint{};
+    checkpoint.magic = BMS_CHECKPOINT_MAGIC;
+    checkpoint.version = BMS_CHECKPOINT_VERSION;
+    checkpoint.accumulatedCharge_mAh = m_hot->accumulatedCharge_mAh;
+    checkpoint.stateOfCharge_percent = m_hot->stateOfCharge_percent;
+    checkpoint.stateOfHealth_percent = m_hot->stateOfHealth_percent;
+    checkpoint.chargeCycles = m_warm->chargeCycles;
+    checkpoint.wasFull = m_warm->wasFull;
+    checkpoint.wasEmpty = m_warm->wasEmpty;
+    checkpoint.estimatedCapacity_mAh = m_hot->estimatedCapacity_mAh;
+    checkpoint.capacitySumXX = m_warm->capacityEstimator.sumXX;
+    checkpoint.capacitySumXY = m_warm->capacityEstimator.sumXY;
+    checkpoint.capacitySumYY = m_warm->capacityEstimator.sumYY;
+    checkpoint.energyIn_Wh = m_warm->energyIn_Wh;
+    checkpoint.energyOut_Wh = m_warm->energyOut_Wh;
+    checkpoint.throughput_Ah = m_warm->throughput_Ah;
+    checkpoint.throughput_Wh = m_warm->throughput_Wh;
+    checkpoint.dischargePowerEwma_W = m_warm->dischargePowerEwma_W;
+    return checkpoint;
+}
+
+/**
+ * @brief Restores the estimator state from a checkpoint.
+ * A checkpoint of another format, or with a value that is not finite or out of range, is
+ * rejected as a whole and the state keeps its defaults.
+ * @param checkpoint The checkpoint to restore.
+ * @return True if the checkpoint was valid and applied, false otherwise.
+ */
+bool BMS::restoreCheckpoint(const BMSCheckpoint& checkpoint) {
+    if (checkpoint.magic != BMS_CHECKPOINT_MAGIC || checkpoint.version != BMS_CHECKPOINT_VERSION
+        || !isCheckpointPlausible(checkpoint)) {
+        return false;
+    }
+    m_hot->accumulatedCharge_mAh = checkpoint.accumulatedCharge_mAh;
+    m_hot->chargeCompensation_mAh = 0.0f;
+    m_hot->stateOfCharge_percent = checkpoint.stateOfCharge_percent;
+    m_hot->stateOfHealth_percent = checkpoint.stateOfHealth_percent;
+    m_warm->chargeCycles = checkpoint.chargeCycles;
+    m_warm->wasFull = checkpoint.wasFull;
+    m_warm->wasEmpty = checkpoint.wasEmpty;
+    // The fit survives a restart; rest anchors do not, since the pack may have been used meanwhile
+    m_hot->estimatedCapacity_mAh = checkpoint.estimatedCapacity_mAh;
+    m_warm->capacityEstimator = CapacityEstimatorState();
+    m_warm->capacityEstimator.sumXX = checkpoint.capacitySumXX;
+    m_warm->capacityEstimator.sumXY = checkpoint.capacitySumXY;
+    m_warm->capacityEstimator.sumYY = checkpoint.capacitySumYY;
+    m_warm->energyIn_Wh = checkpoint.energyIn_Wh;
+    m_warm->energyOut_Wh = checkpoint.energyOut_Wh;
+    m_warm->throughput_Ah = checkpoint.throughput_Ah;
+    m_warm->throughput_Wh = checkpoint.throughput_Wh;
+    m_warm->dischargePowerEwma_W = checkpoint.dischargePowerEwma_W;
+    return true;
+}
+
+/**
+ * @brief Writes the estimator state to a checkpoint file.
+ * @param path The file to write.
+ * @return True on success, false otherwise.
+ */
+bool BMS::saveCheckpoint(const std::string& path) const {
+    BMSCheckpoint checkpoint = getCheckpoint();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&checkpoint), sizeof(checkpoint));
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief Reads the estimator state from a checkpoint file.
+ * @param path The file to read.
+ * @return True if a valid checkpoint was read and applied, false otherwise.
+ */
+bool BMS::loadCheckpoint(const std::string& path) {
+    BMSCheckpoint checkpoint{};
+    std::ifstream file(path, std::ios::binary);
+    if (!file || !file.read(reinterpret_cast<char*>(&checkpoint), sizeof(checkpoint))) {
+        return false;
+    }
+    return restoreCheckpoint(checkpoint);
+}
+
+/**
+ * @brief Applies identified cell parameters from a file written by EcmIdentifier.
+ * Capacity and R0 replace the sampled values of the simulated cells; the cell model has
+ * no polarization branch, so R1 and C1 are not used.
+ * @param path The parameter file to read.
+ * @return True if parameters for every cell were read and applied, false otherwise.
+ */
+bool BMS::loadCellParameters(const std::string& path) {
+    std::vector<EcmParameters> parameters;
+    if (!EcmIdentifier::loadParameters(path, parameters) || parameters.size() < NUM_CELLS) {
+        return false;
+    }
+    for (size_t i = 0; i < NUM_CELLS; ++i) {
+        m_sensorSimulator.setCellParameters(static_cast<uint8_t>(i), parameters[i].capacity_mAh, parameters[i].r0_Ohm);
+    }
+    return true;
 }
@@ -0,0 +1,81 @@
+// src/BandLookupTable.cpp
+#include "../inc/BandLookupTable.h"
+#include <algorithm> // For std::max
+
+namespace {
+// Number of entries of a table covering every 16-bit code
+const size_t CODE_COUNT = 65536;
+
+/**
+ * @brief Classifies a value with the same comparisons as the SafetyManager predicates.
+ * @param value The value to classify.
+ * @param limits The band limits.
+ * @return The band as a SystemState value.
+ */
+uint8_t classify(float value, const BandLimits& limits) {
+    SystemState band = SystemState::NORMAL;
+    if (value < limits.minFault || value > limits.maxFault) {
+        band = SystemState::FAULT;
+    } else if ((value >= limits.minCritical && value < limits.minWarning) ||
+               (value > limits.maxWarning && value <= limits.maxCritical)) {
+        band = SystemState::CRITICAL;
+    } else if ((value >= limits.minWarning && value < limits.minNormal) ||
+               (value > limits.maxNormal && value <= limits.maxWarning)) {
+        band = SystemState::WARNING;
+    }
+    return static_cast<uint8_t>(band);
+}
+} // namespace
+
+/**
+ * @brief Constructor for BandLookupTable.
+ * Builds the tables from the given limits.
+ * @param thresholds The band limits.
+ */
+BandLookupTable::BandLookupTable(const BandThresholds& thresholds)
+    : m_voltageBands(CODE_COUNT),
+      m_temperatureBands(CODE_COUNT)
+{
+    rebuild(thresholds);
+}
+
+/**
+ * @brief Recomputes both tables, e.g. after the limits have been reconfigured.
+ * Each code is converted to the physical value it stands for and classified once.
+ * @param thresholds The new band limits.
+ */
+void BandLookupTable::rebuild(const BandThresholds& thresholds) {
+    m_thresholds = thresholds;
+    for (size_t code = 0; code < CODE_COUNT; ++code) {
+        float voltage = static_cast<float>(code) * ADC_VOLTAGE_LSB_V;
+        float temperature = static_cast<float>(static_cast<int16_t>(code)) * ADC_TEMPERATURE_LSB_C;
+        m_voltageBands[code] = classify(voltage, thresholds.voltage_V);
+        m_temperatureBands[code] = classify(temperature, thresholds.temperature_C);
+    }
+}
+
+/**
+ * @brief Classifies the readings of several cells and returns the most severe band.
+ * The bands are ordered like SystemState, so the most severe band is the maximum.
+ * @param voltageCodes Voltage codes, one per cell.
+ * @param temperatureCodes Temperature codes, one per cell.
+ * @param cellCount Number of cells.
+ * @return The most severe band of all readings (NORMAL for no cells).
+ */
+SystemState BandLookupTable::classifyCells(const uint16_t* voltageCodes, const int16_t* temperatureCodes,
+                                           size_t cellCount) const {
+    uint8_t worst = 0;
+    for (size_t i = 0; i < cellCount; ++i) {
+        worst = std::max(worst, m_voltageBands[voltageCodes[i]]);
+        worst = std::max(worst, m_temperatureBands[static_cast<uint16_t>(temperatureCodes[i])]);
+    }
+    return static_cast<SystemState>(worst);
+}
+
+/**
+ * @brief Gets the limits the tables were built from.
+ * @return The band limits.
+ */
+const BandThresholds& BandLookupTable::getThresholds() const {
+    return m_thresholds;
+}
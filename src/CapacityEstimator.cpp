@@ -0,0 +1,112 @@
+// src/CapacityEstimator.cpp
+#include "../inc/CapacityEstimator.h"
+#include <cmath> // For std::fabs, std::sqrt
+
+/**
+ * @brief Advances the estimator by one update.
+ * Counts the charge with the Coulomb counter's efficiency, tracks the rest time and, once
+ * rested, the SoC of the readings. Readings are used only if every cell is within the
+ * normal voltage range: a rested reading outside it never becomes an anchor, and current
+ * flowing with a cell outside it drops the anchor, since charge counted while a cell is
+ * over- or underdriven need not have gone into the cells. When current flows again after
+ * a rest, the last rested SoC becomes the new anchor; if it is at least
+ * CAPACITY_MIN_DELTA_SOC away from the previous one, the pair is added to the fit.
+ * Closer anchors are skipped and the charge keeps counting from the older anchor.
+ * @param state The pack's estimator state.
+ * @param cells The latest readings.
+ * @param packCurrent_A Pack current (positive for charge).
+ * @param deltaTime_s The time elapsed since the last update in seconds.
+ * @param capacity_mAh The capacity estimate, updated when an anchor pair is taken.
+ * @return True if the capacity estimate changed, false otherwise.
+ */
+bool CapacityEstimator::update(CapacityEstimatorState& state, const std::array<BatteryCell, NUM_CELLS>& cells,
+                               float packCurrent_A, float deltaTime_s, float& capacity_mAh) {
+    float efficiency = packCurrent_A > IDLE_CURRENT_THRESHOLD_A ? CHARGE_EFFICIENCY : 1.0f;
+    double updateCharge_mAh = static_cast<double>(packCurrent_A) * 1000.0 * deltaTime_s / 3600.0 * efficiency;
+    state.chargeSinceAnchor_mAh += updateCharge_mAh;
+    float sum_V = 0.0f;
+    bool inRange = true;
+    for (const BatteryCell& cell : cells) {
+        inRange &= cell.getVoltage() >= MIN_VOLTAGE_NORMAL && cell.getVoltage() <= MAX_VOLTAGE_NORMAL;
+        sum_V += cell.getVoltage();
+    }
+
+    if (std::fabs(packCurrent_A) <= IDLE_CURRENT_THRESHOLD_A) {
+        state.restTime_s += deltaTime_s;
+        if (state.restTime_s >= CAPACITY_REST_MIN_S && inRange) {
+            state.restSoc = socFromOpenCircuitVoltage(sum_V / NUM_CELLS);
+        }
+        return false;
+    }
+    state.restTime_s = 0.0f;
+    if (!inRange) {
+        state.anchorSoc = -1.0f;
+        state.restSoc = -1.0f;
+        return false;
+    }
+    if (state.restSoc < 0.0f) {
+        return false;
+    }
+
+    // The rest has ended: take its last reading as an anchor. The readings precede the
+    // current of their update, so this update's charge already counts from the new anchor.
+    float restSoc = state.restSoc;
+    state.restSoc = -1.0f;
+    if (state.anchorSoc < 0.0f) {
+        state.anchorSoc = restSoc;
+        state.chargeSinceAnchor_mAh = updateCharge_mAh;
+        return false;
+    }
+    double deltaSoc = restSoc - state.anchorSoc;
+    if (std::fabs(deltaSoc) < CAPACITY_MIN_DELTA_SOC) {
+        return false;
+    }
+    double charge_mAh = state.chargeSinceAnchor_mAh - updateCharge_mAh;
+    state.sumXX = CAPACITY_FADING_FACTOR * state.sumXX + deltaSoc * deltaSoc;
+    state.sumXY = CAPACITY_FADING_FACTOR * state.sumXY + deltaSoc * charge_mAh;
+    state.sumYY = CAPACITY_FADING_FACTOR * state.sumYY + charge_mAh * charge_mAh;
+    state.anchorSoc = restSoc;
+    state.chargeSinceAnchor_mAh = updateCharge_mAh;
+
+    float fitted_mAh = fitCapacity_mAh(state);
+    if (!(fitted_mAh > 0.0f)) {
+        return false;
+    }
+    capacity_mAh = fitted_mAh;
+    return true;
+}
+
+/**
+ * @brief Converts a rested cell voltage to SoC with the OCV curve.
+ * The curve is linear between OCV_EMPTY_V and OCV_FULL_V.
+ * @param openCircuitVoltage_V Cell voltage at rest.
+ * @return SoC (0.0 to 1.0).
+ */
+float CapacityEstimator::socFromOpenCircuitVoltage(float openCircuitVoltage_V) {
+    float soc = (openCircuitVoltage_V - OCV_EMPTY_V) / (OCV_FULL_V - OCV_EMPTY_V);
+    soc = soc > 1.0f ? 1.0f : soc;
+    return soc < 0.0f ? 0.0f : soc;
+}
+
+/**
+ * @brief Computes the total-least-squares capacity from the faded sums.
+ * Minimizes sum((y - Q x)^2 / (sy^2 + Q^2 sx^2)) over the pairs, with sx the SoC noise of
+ * an anchor pair and sy the charge noise; with r = sy^2 / sx^2 the minimum is the root
+ * Q = (Syy - r Sxx + sqrt((Syy - r Sxx)^2 + 4 r Sxy^2)) / (2 Sxy). For a noise-free SoC
+ * (r to infinity) this is ordinary least squares, Sxy / Sxx.
+ * @param state The estimator state.
+ * @return Capacity in mAh, or 0 if the sums hold no usable observation.
+ */
+float CapacityEstimator::fitCapacity_mAh(const CapacityEstimatorState& state) {
+    if (!(state.sumXY > 0.0)) {
+        return 0.0f;
+    }
+    const double ratio = static_cast<double>(CAPACITY_CHARGE_NOISE_MAH) * CAPACITY_CHARGE_NOISE_MAH
+                       / (static_cast<double>(CAPACITY_SOC_NOISE) * CAPACITY_SOC_NOISE);
+    double difference = state.sumYY - ratio * state.sumXX;
+    double root = std::sqrt(difference * difference + 4.0 * ratio * state.sumXY * state.sumXY);
+    // Written so the two terms never cancel: for difference < 0, (d + root) = 4 r Sxy^2 / (root - d)
+    double capacity = difference >= 0.0 ? (difference + root) / (2.0 * state.sumXY)
+                                        : 2.0 * ratio * state.sumXY / (root - difference);
+    return static_cast<float>(capacity);
+}
@@ -0,0 +1,70 @@
+// src/CellRanking.cpp
+#include "../inc/CellRanking.h"
+#include <algorithm> // For std::push_heap, std::pop_heap, std::sort
+
+namespace {
+/**
+ * @brief Heap ordering that keeps the lowest score at the root.
+ */
+inline bool higherScore(const RankedCell& a, const RankedCell& b) {
+    return a.score > b.score;
+}
+} // namespace
+
+/**
+ * @brief Constructor for TopKHeap.
+ * Starts empty.
+ */
+TopKHeap::TopKHeap() : m_entries(), m_size(0) {}
+
+/**
+ * @brief Removes all entries.
+ */
+void TopKHeap::clear() {
+    m_size = 0;
+}
+
+/**
+ * @brief Offers a cell for ranking; it is kept if it is among the worst FLEET_TOP_K.
+ * @param cell The cell to offer.
+ */
+void TopKHeap::offer(const RankedCell& cell) {
+    if (m_size < FLEET_TOP_K) {
+        m_entries[m_size++] = cell;
+        std::push_heap(m_entries.begin(), m_entries.begin() + m_size, higherScore);
+    } else if (cell.score > m_entries[0].score) {
+        // Replace the least bad entry kept so far
+        std::pop_heap(m_entries.begin(), m_entries.begin() + m_size, higherScore);
+        m_entries[m_size - 1] = cell;
+        std::push_heap(m_entries.begin(), m_entries.begin() + m_size, higherScore);
+    }
+}
+
+/**
+ * @brief Offers all entries of another heap.
+ * @param other The heap to merge in.
+ */
+void TopKHeap::merge(const TopKHeap& other) {
+    for (size_t i = 0; i < other.m_size; ++i) {
+        offer(other.m_entries[i]);
+    }
+}
+
+/**
+ * @brief Gets the number of entries held.
+ * @return Number of entries (at most FLEET_TOP_K).
+ */
+size_t TopKHeap::size() const {
+    return m_size;
+}
+
+/**
+ * @brief Copies the entries out, worst first.
+ * @param out Array receiving the entries; only the first size() are valid.
+ * @return Number of entries written.
+ */
+size_t TopKHeap::getSorted(std::array<RankedCell, FLEET_TOP_K>& out) const {
+    std::copy(m_entries.begin(), m_entries.begin() + m_size, out.begin());
+    std::sort(out.begin(), out.begin() + m_size, higherScore);
+    return m_size;
+}
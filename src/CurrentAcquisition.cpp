@@ -0,0 +1,263 @@
+// src/CurrentAcquisition.cpp
+#include "../inc/CurrentAcquisition.h"
+#include <chrono> // For std::chrono::steady_clock
+
+/**
+ * @brief Constructor for CurrentAcquisition.
+ * @param sampleRate_Hz Sample rate.
+ * @param seed Seed of the simulated transients and noise.
+ */
+CurrentAcquisition::CurrentAcquisition(uint32_t sampleRate_Hz, uint64_t seed)
+    : m_running(false),
+      m_load_A(0.0f),
+      m_overruns(0),
+      m_contactorOpen(false),
+      m_shortCircuitDetector(nullptr),
+      m_sampleInterval_s(1.0 / sampleRate_Hz),
+      m_random(seed),
+      m_transientSamplesLeft(0),
+      m_previousSample_A(0.0f),
+      m_hasPreviousSample(false),
+      m_drainedOverruns(0)
+{
+}
+
+/**
+ * @brief Destructor for CurrentAcquisition. Stops the producer thread.
+ */
+CurrentAcquisition::~CurrentAcquisition() {
+    stop();
+}
+
+/**
+ * @brief Starts the producer thread, which samples in real time.
+ */
+void CurrentAcquisition::start() {
+    if (m_running.exchange(true)) return;
+    m_producer = std::thread(&CurrentAcquisition::produceLoop, this);
+}
+
+/**
+ * @brief Stops the producer thread.
+ */
+void CurrentAcquisition::stop() {
+    if (!m_running.exchange(false)) return;
+    if (m_producer.joinable()) {
+        m_producer.join();
+    }
+}
+
+/**
+ * @brief Attaches the short-circuit detector that checks every chunk of samples as it is sampled.
+ * Must be called before start().
+ * @param detector The detector (not owned), or nullptr to detach.
+ */
+void CurrentAcquisition::attachShortCircuitDetector(ShortCircuitDetector* detector) {
+    m_shortCircuitDetector = detector;
+}
+
+/**
+ * @brief Gets the attached short-circuit detector.
+ * @return The detector, or nullptr if none is attached.
+ */
+const ShortCircuitDetector* CurrentAcquisition::getShortCircuitDetector() const {
+    return m_shortCircuitDetector;
+}
+
+/**
+ * @brief Closes the simulated contactor after a short-circuit trip (any thread).
+ */
+void CurrentAcquisition::closeContactor() {
+    m_contactorOpen.store(false, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Sets the load current the simulated samples follow (any thread).
+ * @param current_A Load current in Amperes (positive for charge).
+ */
+void CurrentAcquisition::setLoadCurrent_A(float current_A) {
+    m_load_A.store(current_A, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Body of the producer thread.
+ * Produces one block per block period against an absolute schedule, so the sample rate
+ * does not drift with the time the blocks take to produce.
+ */
+void CurrentAcquisition::produceLoop() {
+    const auto blockPeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(m_sampleInterval_s * CURRENT_BLOCK_SAMPLES));
+    auto next = std::chrono::steady_clock::now();
+    while (m_running.load(std::memory_order_relaxed)) {
+        produceBlock();
+        next += blockPeriod;
+        std::this_thread::sleep_until(next);
+    }
+}
+
+/**
+ * @brief Draws a uniformly distributed value between 0 and 1 (producer side).
+ * @return The value.
+ */
+float CurrentAcquisition::drawUnit() {
+    return static_cast<float>(m_random() >> 40) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief Simulates one block of samples and queues it (producer side).
+ * Each sample is the load current plus noise; load transients of CURRENT_TRANSIENT_PEAK_A
+ * start at random (CURRENT_TRANSIENT_RATE_HZ on average) and last CURRENT_TRANSIENT_DURATION_S.
+ * With the contactor open no current flows and the samples are noise only. The samples are
+ * simulated and checked for a short circuit a chunk of CURRENT_KERNEL_LANES at a time, as
+ * they would arrive from the ADC, so a trip opens the contactor for the rest of the block.
+ * @return True if queued, false if the ring was full and the block was dropped.
+ */
+bool CurrentAcquisition::produceBlock() {
+    const float transientProbability = static_cast<float>(CURRENT_TRANSIENT_RATE_HZ * m_sampleInterval_s);
+    const uint32_t transientSamples = static_cast<uint32_t>(CURRENT_TRANSIENT_DURATION_S / m_sampleInterval_s) + 1;
+    CurrentSampleBlock block;
+    for (uint32_t chunk = 0; chunk < CURRENT_BLOCK_SAMPLES; chunk += CURRENT_KERNEL_LANES) {
+        const float load_A = m_contactorOpen.load(std::memory_order_relaxed) ? 0.0f : m_load_A.load(std::memory_order_relaxed);
+        for (uint32_t i = chunk; i < chunk + CURRENT_KERNEL_LANES; ++i) {
+            if (m_transientSamplesLeft == 0 && drawUnit() < transientProbability) {
+                m_transientSamplesLeft = transientSamples;
+            }
+            float transient_A = m_transientSamplesLeft > 0 && load_A != 0.0f ? CURRENT_TRANSIENT_PEAK_A : 0.0f;
+            m_transientSamplesLeft -= m_transientSamplesLeft > 0;
+            block.current_A[i] = load_A + transient_A + (drawUnit() - 0.5f) * 2.0f * CURRENT_SAMPLE_NOISE_A;
+        }
+        checkChunk(block.current_A.data() + chunk);
+    }
+    return queueBlock(block);
+}
+
+/**
+ * @brief Queues a block of samples, e.g. from a replay (producer side).
+ * The short-circuit detector sees the block first, chunk by chunk as if it were being
+ * sampled, so a trip does not wait for the ring and its latency matches live sampling.
+ * @param block The samples.
+ * @return True if queued, false if the ring was full and the block was dropped.
+ */
+bool CurrentAcquisition::pushBlock(const CurrentSampleBlock& block) {
+    for (uint32_t chunk = 0; chunk < CURRENT_BLOCK_SAMPLES; chunk += CURRENT_KERNEL_LANES) {
+        checkChunk(block.current_A.data() + chunk);
+    }
+    return queueBlock(block);
+}
+
+/**
+ * @brief Runs the short-circuit detector on one chunk of samples and opens the contactor on a trip (producer side).
+ * @param samples CURRENT_KERNEL_LANES samples.
+ */
+void CurrentAcquisition::checkChunk(const float* samples) {
+    if (m_shortCircuitDetector != nullptr && m_shortCircuitDetector->checkBlock(samples, CURRENT_KERNEL_LANES)) {
+        m_contactorOpen.store(true, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Queues a block that has been checked (producer side).
+ * @param block The samples.
+ * @return True if queued, false if the ring was full and the block was dropped.
+ */
+bool CurrentAcquisition::queueBlock(const CurrentSampleBlock& block) {
+    if (!m_ring.tryPush(block)) {
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Decimation kernel: sum, sum of squares, minimum and maximum of one block of samples.
+ * Every lane accumulates its own strided share of the block, so the loop has no
+ * dependency between lanes and needs no reassociation to vectorize.
+ * @param samples CURRENT_BLOCK_SAMPLES samples.
+ * @return The reduction.
+ */
+CurrentBlockReduction CurrentAcquisition::reduceBlock(const float* __restrict samples) {
+    float sum[CURRENT_KERNEL_LANES];
+    float squares[CURRENT_KERNEL_LANES];
+    float low[CURRENT_KERNEL_LANES];
+    float high[CURRENT_KERNEL_LANES];
+    for (uint32_t lane = 0; lane < CURRENT_KERNEL_LANES; ++lane) {
+        sum[lane] = samples[lane];
+        squares[lane] = samples[lane] * samples[lane];
+        low[lane] = samples[lane];
+        high[lane] = samples[lane];
+    }
+    for (uint32_t i = CURRENT_KERNEL_LANES; i < CURRENT_BLOCK_SAMPLES; i += CURRENT_KERNEL_LANES) {
+        for (uint32_t lane = 0; lane < CURRENT_KERNEL_LANES; ++lane) {
+            float sample = samples[i + lane];
+            sum[lane] += sample;
+            squares[lane] += sample * sample;
+            low[lane] = sample < low[lane] ? sample : low[lane];
+            high[lane] = sample > high[lane] ? sample : high[lane];
+        }
+    }
+    CurrentBlockReduction reduction = {sum[0], squares[0], low[0], high[0]};
+    for (uint32_t lane = 1; lane < CURRENT_KERNEL_LANES; ++lane) {
+        reduction.sum_A += sum[lane];
+        reduction.sumSquares_A2 += squares[lane];
+        reduction.min_A = low[lane] < reduction.min_A ? low[lane] : reduction.min_A;
+        reduction.max_A = high[lane] > reduction.max_A ? high[lane] : reduction.max_A;
+    }
+    return reduction;
+}
+
+/**
+ * @brief Decimates and integrates all queued samples (consumer side).
+ * The trapezoids between consecutive samples sum to
+ * dt * (previous / 2 + sum of the block - last / 2) per block, where previous is the
+ * last sample of the block before, so every block covers exactly its own sample periods.
+ * The first block ever has no previous sample and holds its first sample for one period.
+ * Blocks dropped on overruns since the previous drain left a gap in the samples; the
+ * charge of the gap is estimated as the interval's mean current times its duration, which
+ * is reported as lost time, so the Coulomb counter neither skips the gap nor hides it.
+ * @param interval Output, the current over the samples queued since the last drain.
+ * @return True if any samples were queued, false otherwise (interval is left unchanged).
+ */
+bool CurrentAcquisition::drain(DecimatedCurrent& interval) {
+    CurrentSampleBlock block;
+    double sum_A = 0.0;
+    double sumSquares_A2 = 0.0;
+    double trapezoidSum_A = 0.0;
+    uint64_t blocks = 0;
+    float low = 0.0f;
+    float high = 0.0f;
+    while (m_ring.tryPop(block)) {
+        CurrentBlockReduction reduction = reduceBlock(block.current_A.data());
+        float first_A = m_hasPreviousSample ? m_previousSample_A : block.current_A[0];
+        float last_A = block.current_A[CURRENT_BLOCK_SAMPLES - 1];
+        trapezoidSum_A += 0.5 * first_A + reduction.sum_A - 0.5 * last_A;
+        sum_A += reduction.sum_A;
+        sumSquares_A2 += reduction.sumSquares_A2;
+        low = blocks == 0 || reduction.min_A < low ? reduction.min_A : low;
+        high = blocks == 0 || reduction.max_A > high ? reduction.max_A : high;
+        m_previousSample_A = last_A;
+        m_hasPreviousSample = true;
+        ++blocks;
+    }
+    if (blocks == 0) {
+        return false;
+    }
+    interval.sampleCount = blocks * CURRENT_BLOCK_SAMPLES;
+    interval.mean_A = static_cast<float>(sum_A / interval.sampleCount);
+    interval.meanSquare_A2 = static_cast<float>(sumSquares_A2 / interval.sampleCount);
+    interval.min_A = low;
+    interval.max_A = high;
+    interval.duration_s = interval.sampleCount * m_sampleInterval_s;
+    uint64_t overruns = m_overruns.load(std::memory_order_relaxed);
+    interval.lostDuration_s = static_cast<double>(overruns - m_drainedOverruns) * CURRENT_BLOCK_SAMPLES * m_sampleInterval_s;
+    m_drainedOverruns = overruns;
+    interval.charge_As = trapezoidSum_A * m_sampleInterval_s + sum_A / interval.sampleCount * interval.lostDuration_s;
+    return true;
+}
+
+/**
+ * @brief Gets the number of blocks dropped because the ring was full.
+ * @return Number of dropped blocks.
+ */
+uint64_t CurrentAcquisition::getOverrunCount() const {
+    return m_overruns.load(std::memory_order_relaxed);
+}
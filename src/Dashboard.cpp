@@ -0,0 +1,306 @@
+// src/Dashboard.cpp
+#include "../inc/Dashboard.h"
+#include <chrono>   // For std::chrono::steady_clock
+#include <cmath>    // For std::isnan
+#include <cstdio>   // For std::snprintf
+#include <iostream> // For std::cout
+
+namespace {
+// Heatmap geometry: every cell is drawn as a block two characters wide
+const size_t HEATMAP_CELL_WIDTH = 2;
+const size_t HEATMAP_ROWS = (NUM_CELLS + DASHBOARD_HEATMAP_COLUMNS - 1) / DASHBOARD_HEATMAP_COLUMNS;
+const size_t HEATMAP_WIDTH = DASHBOARD_HEATMAP_COLUMNS * HEATMAP_CELL_WIDTH;
+const size_t HEATMAP_GAP = 6;
+
+// Screen layout (rows)
+const size_t ROW_TITLE = 0;
+const size_t ROW_READINGS = 1;
+const size_t ROW_HEATMAP_TITLES = 3;
+const size_t ROW_HEATMAPS = 4;
+const size_t ROW_VOLTAGE_RANGE = ROW_HEATMAPS + HEATMAP_ROWS + 1;
+const size_t ROW_TEMP_RANGE = ROW_VOLTAGE_RANGE + 1;
+const size_t ROW_EVENTS_TITLE = ROW_TEMP_RANGE + 2;
+const size_t ROW_EVENTS = ROW_EVENTS_TITLE + 1;
+const size_t SCREEN_ROWS = ROW_EVENTS + DASHBOARD_EVENT_LINES;
+const size_t SCREEN_WIDTH = DASHBOARD_SCREEN_WIDTH;
+
+// 256-color backgrounds from cold/low (blue) to hot/high (red)
+const uint8_t HEAT_COLORS[] = {21, 27, 33, 39, 45, 51, 48, 46, 118, 190, 226, 220, 214, 208, 202, 196};
+const size_t HEAT_COLOR_COUNT = sizeof(HEAT_COLORS) / sizeof(HEAT_COLORS[0]);
+// Background of an unreadable (NaN) value
+const uint8_t INVALID_COLOR = 201;
+// Unchanged gaps up to this long are rewritten rather than skipped with a cursor move
+const size_t MAX_REWRITTEN_GAP = 6;
+
+/**
+ * @brief Maps a value to a heatmap color.
+ * @param value The value.
+ * @param minValue Value shown in the coldest color.
+ * @param maxValue Value shown in the hottest color.
+ * @return 256-color index.
+ */
+inline uint8_t heatColor(float value, float minValue, float maxValue) {
+    if (std::isnan(value)) return INVALID_COLOR;
+    float position = (value - minValue) / (maxValue - minValue) * HEAT_COLOR_COUNT;
+    if (position <= 0.0f) return HEAT_COLORS[0];
+    size_t index = static_cast<size_t>(position);
+    return HEAT_COLORS[index < HEAT_COLOR_COUNT ? index : HEAT_COLOR_COUNT - 1];
+}
+
+/**
+ * @brief Maps a system state to the background color it is shown with.
+ * @param state The state.
+ * @return 256-color index.
+ */
+inline uint8_t stateColor(SystemState state) {
+    switch (state) {
+        case SystemState::NORMAL:   return 28;
+        case SystemState::WARNING:  return 178;
+        case SystemState::CRITICAL: return 166;
+        case SystemState::FAULT:    return 160;
+    }
+    return 0;
+}
+} // namespace
+
+/**
+ * @brief Constructor for Dashboard.
+ * Subscribes to every event type; must therefore be created before the bus is started.
+ * Events are handed from the dispatcher thread to the render thread through a
+ * lock-free queue; events arriving while it is full are not shown.
+ * @param snapshot The seqlock the BMS publishes its snapshots to.
+ * @param eventBus The bus the BMS publishes its events to.
+ */
+Dashboard::Dashboard(const Seqlock<BmsSnapshot>& snapshot, EventBus& eventBus)
+    : m_snapshot(snapshot),
+      m_recentEventCount(0),
+      m_front(SCREEN_ROWS * SCREEN_WIDTH),
+      m_back(SCREEN_ROWS * SCREEN_WIDTH),
+      m_latest(),
+      m_lastSequence(0),
+      m_running(false)
+{
+    for (uint8_t type = 0; type < EVENT_TYPE_COUNT; ++type) {
+        eventBus.subscribe(static_cast<EventType>(type), [this](const BmsEvent& event) {
+            m_events.tryPush(event);
+        });
+    }
+}
+
+/**
+ * @brief Destructor. Stops the render thread and restores the terminal.
+ */
+Dashboard::~Dashboard() {
+    stop();
+}
+
+/**
+ * @brief Clears the terminal and starts the render thread.
+ */
+void Dashboard::start() {
+    if (m_running.exchange(true)) return;
+    for (auto& cell : m_front) {
+        cell = {' ', 0};
+    }
+    std::cout << "\x1b[0m\x1b[2J\x1b[?25l" << std::flush; // Reset colors, clear, hide cursor
+    m_renderer = std::thread(&Dashboard::renderLoop, this);
+}
+
+/**
+ * @brief Stops the render thread and restores the terminal.
+ * The cursor is left below the dashboard.
+ */
+void Dashboard::stop() {
+    if (!m_running.exchange(false)) return;
+    if (m_renderer.joinable()) {
+        m_renderer.join();
+    }
+    std::cout << "\x1b[0m\x1b[" << (SCREEN_ROWS + 1) << ";1H\x1b[?25h" << std::flush;
+}
+
+/**
+ * @brief Body of the render thread.
+ * Wakes DASHBOARD_REFRESH_HZ times per second and redraws only if the snapshot
+ * changed or an event arrived.
+ */
+void Dashboard::renderLoop() {
+    const auto period = std::chrono::microseconds(1000000 / DASHBOARD_REFRESH_HZ);
+    auto nextFrame = std::chrono::steady_clock::now();
+    bool firstFrame = true;
+
+    while (m_running.load(std::memory_order_acquire)) {
+        bool changed = drainEvents();
+        uint32_t sequence = m_snapshot.getSequence();
+        if (sequence != m_lastSequence) {
+            m_snapshot.read(m_latest);
+            m_lastSequence = sequence;
+            changed = true;
+        }
+        if (changed || firstFrame) {
+            composeFrame();
+            flushDifferences();
+            firstFrame = false;
+        }
+
+        nextFrame += period;
+        std::this_thread::sleep_until(nextFrame);
+    }
+}
+
+/**
+ * @brief Moves newly received events into the recent event lines.
+ * @return True if any event was received.
+ */
+bool Dashboard::drainEvents() {
+    bool received = false;
+    BmsEvent event;
+    while (m_events.tryPop(event)) {
+        m_recentEvents[m_recentEventCount % DASHBOARD_EVENT_LINES] = describeEvent(event);
+        ++m_recentEventCount;
+        received = true;
+    }
+    return received;
+}
+
+/**
+ * @brief Composes the next screen from the latest snapshot and events.
+ */
+void Dashboard::composeFrame() {
+    for (auto& cell : m_back) {
+        cell = {' ', 0};
+    }
+    char line[SCREEN_WIDTH + 1];
+
+    putText(ROW_TITLE, 0, "BMS Dashboard | State:");
+    std::snprintf(line, sizeof(line), " %s ", toString(m_latest.state));
+    putText(ROW_TITLE, 23, line, stateColor(m_latest.state));
+
+    std::snprintf(line, sizeof(line), "SoC: %5.1f%% | SoH: %5.1f%% | Current: %7.2fA | Pack: %6.2fV | Charging: %s",
+                  m_latest.stateOfCharge_percent, m_latest.stateOfHealth_percent,
+                  m_latest.packCurrent_A, m_latest.packVoltage_V, m_latest.charging ? "YES" : "NO");
+    putText(ROW_READINGS, 0, line);
+
+    const size_t temperatureColumn = HEATMAP_WIDTH + HEATMAP_GAP;
+    std::snprintf(line, sizeof(line), "Cell voltage (%.1f-%.1fV)", MIN_VOLTAGE_CRITICAL, MAX_VOLTAGE_CRITICAL);
+    putText(ROW_HEATMAP_TITLES, 0, line);
+    std::snprintf(line, sizeof(line), "Cell temperature (%.0f-%.0fC)", MIN_TEMP_CRITICAL, MAX_TEMP_CRITICAL);
+    putText(ROW_HEATMAP_TITLES, temperatureColumn, line);
+    putHeatmap(ROW_HEATMAPS, 0, m_latest.cellVoltages_V, MIN_VOLTAGE_CRITICAL, MAX_VOLTAGE_CRITICAL);
+    putHeatmap(ROW_HEATMAPS, temperatureColumn, m_latest.cellTemperatures_C, MIN_TEMP_CRITICAL, MAX_TEMP_CRITICAL);
+
+    size_t minVoltageCell = 0, maxVoltageCell = 0, minTempCell = 0, maxTempCell = 0;
+    for (size_t i = 1; i < NUM_CELLS; ++i) {
+        if (m_latest.cellVoltages_V[i] < m_latest.cellVoltages_V[minVoltageCell]) minVoltageCell = i;
+        if (m_latest.cellVoltages_V[i] > m_latest.cellVoltages_V[maxVoltageCell]) maxVoltageCell = i;
+        if (m_latest.cellTemperatures_C[i] < m_latest.cellTemperatures_C[minTempCell]) minTempCell = i;
+        if (m_latest.cellTemperatures_C[i] > m_latest.cellTemperatures_C[maxTempCell]) maxTempCell = i;
+    }
+    std::snprintf(line, sizeof(line), "Voltage: min %.3fV (cell %zu) | max %.3fV (cell %zu)",
+                  m_latest.cellVoltages_V[minVoltageCell], minVoltageCell,
+                  m_latest.cellVoltages_V[maxVoltageCell], maxVoltageCell);
+    putText(ROW_VOLTAGE_RANGE, 0, line);
+    std::snprintf(line, sizeof(line), "Temperature: min %.1fC (cell %zu) | max %.1fC (cell %zu)",
+                  m_latest.cellTemperatures_C[minTempCell], minTempCell,
+                  m_latest.cellTemperatures_C[maxTempCell], maxTempCell);
+    putText(ROW_TEMP_RANGE, 0, line);
+
+    putText(ROW_EVENTS_TITLE, 0, "Recent events:");
+    size_t shown = m_recentEventCount < DASHBOARD_EVENT_LINES ? m_recentEventCount : DASHBOARD_EVENT_LINES;
+    for (size_t i = 0; i < shown; ++i) {
+        size_t index = (m_recentEventCount - shown + i) % DASHBOARD_EVENT_LINES;
+        putText(ROW_EVENTS + i, 2, m_recentEvents[index].c_str());
+    }
+}
+
+/**
+ * @brief Writes the screen cells that changed since the last redraw.
+ * Runs of changed cells are written after a single cursor move, and the background
+ * color is only switched when it changes. Everything goes out in one write.
+ */
+void Dashboard::flushDifferences() {
+    m_output.clear();
+    size_t cursorRow = SCREEN_ROWS;
+    size_t cursorColumn = SCREEN_WIDTH;
+    uint8_t background = 0;
+    char sequence[24];
+
+    for (size_t row = 0; row < SCREEN_ROWS; ++row) {
+        for (size_t column = 0; column < SCREEN_WIDTH; ++column) {
+            size_t index = row * SCREEN_WIDTH + column;
+            const ScreenCell& cell = m_back[index];
+            if (cell == m_front[index]) continue;
+
+            // Short unchanged gaps in the current color are cheaper to rewrite than to skip
+            if (row == cursorRow && column > cursorColumn && column - cursorColumn <= MAX_REWRITTEN_GAP) {
+                size_t gap = cursorColumn;
+                while (gap < column && m_front[row * SCREEN_WIDTH + gap].background == background) {
+                    ++gap;
+                }
+                if (gap == column) {
+                    for (size_t c = cursorColumn; c < column; ++c) {
+                        m_output += m_front[row * SCREEN_WIDTH + c].character;
+                    }
+                    cursorColumn = column;
+                }
+            }
+            if (row != cursorRow || column != cursorColumn) {
+                std::snprintf(sequence, sizeof(sequence), "\x1b[%zu;%zuH", row + 1, column + 1);
+                m_output += sequence;
+            }
+            if (cell.background != background) {
+                if (cell.background == 0) {
+                    m_output += "\x1b[0m";
+                } else {
+                    std::snprintf(sequence, sizeof(sequence), "\x1b[48;5;%um", static_cast<unsigned>(cell.background));
+                    m_output += sequence;
+                }
+                background = cell.background;
+            }
+            m_output += cell.character;
+            cursorRow = row;
+            cursorColumn = column + 1;
+            m_front[index] = cell;
+        }
+    }
+
+    if (m_output.empty()) return;
+    if (background != 0) {
+        m_output += "\x1b[0m";
+    }
+    std::cout.write(m_output.data(), static_cast<std::streamsize>(m_output.size()));
+    std::cout.flush();
+}
+
+/**
+ * @brief Writes text into the frame being composed, clipped to the screen width.
+ * @param row Screen row.
+ * @param column Screen column of the first character.
+ * @param text The text.
+ * @param background Background color of the text.
+ */
+void Dashboard::putText(size_t row, size_t column, const char* text, uint8_t background) {
+    ScreenCell* rowCells = &m_back[row * SCREEN_WIDTH];
+    for (; *text != '\0' && column < SCREEN_WIDTH; ++text, ++column) {
+        rowCells[column] = {*text, background};
+    }
+}
+
+/**
+ * @brief Draws one heatmap of per-cell values.
+ * @param row Screen row of the top of the heatmap.
+ * @param column Screen column of the left of the heatmap.
+ * @param values The per-cell values.
+ * @param minValue Value shown in the coldest color.
+ * @param maxValue Value shown in the hottest color.
+ */
+void Dashboard::putHeatmap(size_t row, size_t column, const std::array<float, NUM_CELLS>& values, float minValue, float maxValue) {
+    for (size_t i = 0; i < NUM_CELLS; ++i) {
+        size_t cellRow = row + i / DASHBOARD_HEATMAP_COLUMNS;
+        size_t cellColumn = column + (i % DASHBOARD_HEATMAP_COLUMNS) * HEATMAP_CELL_WIDTH;
+        uint8_t color = heatColor(values[i], minValue, maxValue);
+        ScreenCell* cells = &m_back[cellRow * SCREEN_WIDTH + cellColumn];
+        for (size_t w = 0; w < HEATMAP_CELL_WIDTH && cellColumn + w < SCREEN_WIDTH; ++w) {
+            cells[w] = {' ', color};
+        }
+    }
+}
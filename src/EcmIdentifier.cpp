@@ -0,0 +1,490 @@
+// src/EcmIdentifier.cpp
+#include "../inc/EcmIdentifier.h"
+#include <algorithm> // For std::min, std::max
+#include <atomic>    // For std::atomic
+#include <cmath>     // For std::exp, std::sqrt
+#include <cstdio>    // For std::fprintf
+#include <cstdlib>   // For std::strtof
+#include <fstream>   // For std::ifstream
+#include <thread>    // For std::thread
+#include "../inc/Constants.h" // For SIM_CELL_OCV_*, ECM_FIT_* parameters
+
+namespace {
+const size_t BLOCK = ECM_FIT_BLOCK_CELLS;
+// Fitted parameters: R0, R1, time constant R1 * C1, capacity, initial SoC
+const size_t PARAMETER_COUNT = 5;
+// Entries of the upper triangle of the 5 x 5 normal matrix
+const size_t TRIANGLE_COUNT = PARAMETER_COUNT * (PARAMETER_COUNT + 1) / 2;
+const double OCV_SLOPE_V = SIM_CELL_OCV_FULL_V - SIM_CELL_OCV_EMPTY_V;
+
+/**
+ * @brief Parameters of the cells of one block, one lane per cell.
+ * The polarization branch is fitted as R1 and its time constant, which are far less
+ * correlated than R1 and C1.
+ */
+struct BlockParameters {
+    double r0_Ohm[BLOCK];
+    double r1_Ohm[BLOCK];
+    double tau_s[BLOCK];
+    double capacity_mAh[BLOCK];
+    double initialSoc[BLOCK];
+};
+
+/**
+ * @brief Per-lane quantities that only change with the parameters, hoisted out of the sample loop.
+ */
+struct BlockCoefficients {
+    double decay[BLOCK];        // exp(-dt / tau): RC voltage kept over one sample
+    double decayPerTau[BLOCK];  // d(decay) / d(tau)
+    double socPerAs[BLOCK];     // SoC change per ampere-second, 1 / capacity
+    double slopePerMAh[BLOCK];  // d(voltage) / d(capacity) per ampere-second of charge
+};
+
+/**
+ * @brief Gauss-Newton normal equations J^T J, J^T r and the cost r^T r of every lane.
+ */
+struct BlockNormalEquations {
+    double jtj[TRIANGLE_COUNT][BLOCK];  // Upper triangle, row by row
+    double jtr[PARAMETER_COUNT][BLOCK];
+    double cost[BLOCK];
+};
+
+/**
+ * @brief Computes the hoisted coefficients of every lane.
+ * @param parameters The parameters.
+ * @param deltaTime_s Sample period.
+ * @param coefficients Output.
+ */
+void computeCoefficients(const BlockParameters& parameters, double deltaTime_s, BlockCoefficients& coefficients) {
+    for (size_t lane = 0; lane < BLOCK; ++lane) {
+        double tau = parameters.tau_s[lane];
+        coefficients.decay[lane] = std::exp(-deltaTime_s / tau);
+        coefficients.decayPerTau[lane] = coefficients.decay[lane] * deltaTime_s / (tau * tau);
+        coefficients.socPerAs[lane] = 1.0 / (parameters.capacity_mAh[lane] * 3.6);
+        coefficients.slopePerMAh[lane] = OCV_SLOPE_V * coefficients.socPerAs[lane] / parameters.capacity_mAh[lane];
+    }
+}
+
+/**
+ * @brief Runs the forward model of a block and sums the squared residuals (the cost).
+ * The model takes the reading before it advances, as the cell bank does: the voltage of
+ * sample t is OCV(SoC_t) + I_t * R0 + V1_t, then SoC and the RC voltage V1 advance
+ * with I_t; the RC branch is discretized exactly for a current held over the sample.
+ * @param trace The recorded trace.
+ * @param measured_V Voltages of the block, sample-major with one lane per cell.
+ * @param parameters The parameters.
+ * @param cost Output, cost of every lane.
+ */
+void computeCost(const EcmTrace& trace, const float* measured_V, const BlockParameters& parameters, double* cost) {
+    BlockCoefficients coefficients;
+    computeCoefficients(parameters, trace.deltaTime_s, coefficients);
+    double rcVoltage[BLOCK] = {};
+    double sum[BLOCK] = {};
+    double charge_As = 0.0;
+    const size_t sampleCount = trace.current_A.size();
+    for (size_t t = 0; t < sampleCount; ++t) {
+        const double current = trace.current_A[t];
+        const float* measured = &measured_V[t * BLOCK];
+        for (size_t lane = 0; lane < BLOCK; ++lane) {
+            double soc = parameters.initialSoc[lane] + charge_As * coefficients.socPerAs[lane];
+            double residual = SIM_CELL_OCV_EMPTY_V + OCV_SLOPE_V * soc + current * parameters.r0_Ohm[lane]
+                            + rcVoltage[lane] - measured[lane];
+            sum[lane] += residual * residual;
+            rcVoltage[lane] = coefficients.decay[lane] * rcVoltage[lane]
+                            + parameters.r1_Ohm[lane] * (1.0 - coefficients.decay[lane]) * current;
+        }
+        charge_As += current * trace.deltaTime_s;
+    }
+    std::copy(sum, sum + BLOCK, cost);
+}
+
+/**
+ * @brief Runs the forward model of a block with its parameter sensitivities and sums the
+ * normal equations. Same model as computeCost(); the sensitivities of the RC voltage to
+ * R1 and tau are propagated through the same recursion.
+ * @param trace The recorded trace.
+ * @param measured_V Voltages of the block, sample-major with one lane per cell.
+ * @param parameters The parameters.
+ * @param equations Output, normal equations of every lane.
+ */
+void computeNormalEquations(const EcmTrace& trace, const float* measured_V, const BlockParameters& parameters,
+                            BlockNormalEquations& equations) {
+    BlockCoefficients coefficients;
+    computeCoefficients(parameters, trace.deltaTime_s, coefficients);
+    double rcVoltage[BLOCK] = {};
+    double rcPerR1[BLOCK] = {};  // d(V1) / d(R1)
+    double rcPerTau[BLOCK] = {}; // d(V1) / d(tau)
+    BlockNormalEquations sums = {}; // Local, so the stores cannot alias the parameters
+    double charge_As = 0.0;
+    const size_t sampleCount = trace.current_A.size();
+    for (size_t t = 0; t < sampleCount; ++t) {
+        const double current = trace.current_A[t];
+        const float* measured = &measured_V[t * BLOCK];
+        for (size_t lane = 0; lane < BLOCK; ++lane) {
+            double soc = parameters.initialSoc[lane] + charge_As * coefficients.socPerAs[lane];
+            double residual = SIM_CELL_OCV_EMPTY_V + OCV_SLOPE_V * soc + current * parameters.r0_Ohm[lane]
+                            + rcVoltage[lane] - measured[lane];
+            // Sensitivities to R0, R1, tau, capacity and initial SoC
+            double j0 = current;
+            double j1 = rcPerR1[lane];
+            double j2 = rcPerTau[lane];
+            double j3 = -coefficients.slopePerMAh[lane] * charge_As;
+            const double j4 = OCV_SLOPE_V;
+            sums.jtj[0][lane] += j0 * j0;
+            sums.jtj[1][lane] += j0 * j1;
+            sums.jtj[2][lane] += j0 * j2;
+            sums.jtj[3][lane] += j0 * j3;
+            sums.jtj[4][lane] += j0 * j4;
+            sums.jtj[5][lane] += j1 * j1;
+            sums.jtj[6][lane] += j1 * j2;
+            sums.jtj[7][lane] += j1 * j3;
+            sums.jtj[8][lane] += j1 * j4;
+            sums.jtj[9][lane] += j2 * j2;
+            sums.jtj[10][lane] += j2 * j3;
+            sums.jtj[11][lane] += j2 * j4;
+            sums.jtj[12][lane] += j3 * j3;
+            sums.jtj[13][lane] += j3 * j4;
+            sums.jtj[14][lane] += j4 * j4;
+            sums.jtr[0][lane] += j0 * residual;
+            sums.jtr[1][lane] += j1 * residual;
+            sums.jtr[2][lane] += j2 * residual;
+            sums.jtr[3][lane] += j3 * residual;
+            sums.jtr[4][lane] += j4 * residual;
+            sums.cost[lane] += residual * residual;
+
+            double decay = coefficients.decay[lane];
+            double r1 = parameters.r1_Ohm[lane];
+            rcPerTau[lane] = decay * rcPerTau[lane] + coefficients.decayPerTau[lane] * (rcVoltage[lane] - r1 * current);
+            rcPerR1[lane] = decay * rcPerR1[lane] + (1.0 - decay) * current;
+            rcVoltage[lane] = decay * rcVoltage[lane] + r1 * (1.0 - decay) * current;
+        }
+        charge_As += current * trace.deltaTime_s;
+    }
+    equations = sums;
+}
+
+/**
+ * @brief Solves the damped normal equations of one lane for the Levenberg-Marquardt step.
+ * (J^T J + lambda * diag(J^T J)) step = -J^T r, by Cholesky decomposition.
+ * @param equations The normal equations.
+ * @param lane The lane.
+ * @param damping Lambda.
+ * @param step Output, the parameter step.
+ * @return True if the damped matrix was positive definite, false otherwise.
+ */
+bool solveStep(const BlockNormalEquations& equations, size_t lane, double damping, double* step) {
+    double matrix[PARAMETER_COUNT][PARAMETER_COUNT];
+    size_t entry = 0;
+    for (size_t i = 0; i < PARAMETER_COUNT; ++i) {
+        for (size_t j = i; j < PARAMETER_COUNT; ++j) {
+            matrix[i][j] = matrix[j][i] = equations.jtj[entry++][lane];
+        }
+    }
+    for (size_t i = 0; i < PARAMETER_COUNT; ++i) {
+        // A floor keeps parameters the data says nothing about (e.g. tau with R1 near zero) from making it singular
+        matrix[i][i] += damping * std::max(matrix[i][i], 1e-12);
+    }
+
+    // Cholesky decomposition in place (lower triangle)
+    for (size_t j = 0; j < PARAMETER_COUNT; ++j) {
+        double diagonal = matrix[j][j];
+        for (size_t k = 0; k < j; ++k) {
+            diagonal -= matrix[j][k] * matrix[j][k];
+        }
+        if (!(diagonal > 0.0)) {
+            return false;
+        }
+        matrix[j][j] = std::sqrt(diagonal);
+        for (size_t i = j + 1; i < PARAMETER_COUNT; ++i) {
+            double value = matrix[i][j];
+            for (size_t k = 0; k < j; ++k) {
+                value -= matrix[i][k] * matrix[j][k];
+            }
+            matrix[i][j] = value / matrix[j][j];
+        }
+    }
+    // Forward and back substitution
+    double y[PARAMETER_COUNT];
+    for (size_t i = 0; i < PARAMETER_COUNT; ++i) {
+        double value = -equations.jtr[i][lane];
+        for (size_t k = 0; k < i; ++k) {
+            value -= matrix[i][k] * y[k];
+        }
+        y[i] = value / matrix[i][i];
+    }
+    for (size_t i = PARAMETER_COUNT; i-- > 0;) {
+        double value = y[i];
+        for (size_t k = i + 1; k < PARAMETER_COUNT; ++k) {
+            value -= matrix[k][i] * step[k];
+        }
+        step[i] = value / matrix[i][i];
+    }
+    return true;
+}
+} // namespace
+
+/**
+ * @brief Constructor for EcmIdentifier.
+ * @param threadCount Worker threads; 0 uses one per hardware thread.
+ */
+EcmIdentifier::EcmIdentifier(size_t threadCount)
+    : m_threadCount(threadCount > 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+/**
+ * @brief Fits the parameters of every cell of a trace.
+ * The blocks of cells are independent; workers take the next unfitted block until all are done.
+ * @param trace The recorded trace.
+ * @param parameters Output, one entry per cell.
+ */
+void EcmIdentifier::fit(const EcmTrace& trace, std::vector<EcmParameters>& parameters) const {
+    parameters.assign(trace.cellCount, EcmParameters{});
+    if (trace.cellCount == 0 || trace.current_A.empty()) {
+        return;
+    }
+    const size_t blockCount = (trace.cellCount + BLOCK - 1) / BLOCK;
+    std::atomic<size_t> nextBlock(0);
+    auto worker = [&]() {
+        for (size_t block = nextBlock++; block < blockCount; block = nextBlock++) {
+            fitBlock(trace, block * BLOCK, parameters);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < std::min(m_threadCount, blockCount); ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Fits one block of up to ECM_FIT_BLOCK_CELLS cells.
+ * Every lane runs its own Levenberg-Marquardt iteration (own damping, own acceptance);
+ * the forward passes are shared, and lanes that converged ride along unchanged. A short
+ * last block repeats its last cell in the unused lanes.
+ * @param trace The recorded trace.
+ * @param firstCell Index of the first cell of the block.
+ * @param parameters Output, entries firstCell onwards are written.
+ */
+void EcmIdentifier::fitBlock(const EcmTrace& trace, size_t firstCell, std::vector<EcmParameters>& parameters) {
+    const size_t laneCount = std::min(BLOCK, trace.cellCount - firstCell);
+    const size_t sampleCount = trace.current_A.size();
+    // The block's voltages side by side, so the lanes load contiguously in every pass
+    std::vector<float> measured_V(sampleCount * BLOCK);
+    for (size_t t = 0; t < sampleCount; ++t) {
+        for (size_t lane = 0; lane < BLOCK; ++lane) {
+            measured_V[t * BLOCK + lane] = trace.cellVoltages_V[t * trace.cellCount + firstCell + std::min(lane, laneCount - 1)];
+        }
+    }
+
+    BlockParameters current;
+    for (size_t lane = 0; lane < BLOCK; ++lane) {
+        // Initial guess: nominal cell, SoC from the first voltage as if the cell were at rest
+        double soc = (measured_V[lane] - SIM_CELL_OCV_EMPTY_V) / OCV_SLOPE_V;
+        current.r0_Ohm[lane] = SIM_CELL_RESISTANCE_OHM;
+        current.r1_Ohm[lane] = ECM_FIT_INITIAL_R1_OHM;
+        current.tau_s[lane] = ECM_FIT_INITIAL_TAU_S;
+        current.capacity_mAh[lane] = NOMINAL_CAPACITY_MAH;
+        current.initialSoc[lane] = std::min(std::max(soc, 0.0), 1.0);
+    }
+
+    BlockNormalEquations equations;
+    computeNormalEquations(trace, measured_V.data(), current, equations);
+    double damping[BLOCK];
+    bool active[BLOCK];
+    std::fill(damping, damping + BLOCK, 1e-3);
+    std::fill(active, active + BLOCK, true);
+
+    for (uint32_t iteration = 0; iteration < ECM_FIT_MAX_ITERATIONS; ++iteration) {
+        BlockParameters trial = current;
+        bool anyActive = false;
+        for (size_t lane = 0; lane < BLOCK; ++lane) {
+            double step[PARAMETER_COUNT];
+            if (!active[lane] || !solveStep(equations, lane, damping[lane], step)) {
+                continue;
+            }
+            anyActive = true;
+            trial.r0_Ohm[lane] = std::max(current.r0_Ohm[lane] + step[0], 0.0);
+            trial.r1_Ohm[lane] = std::max(current.r1_Ohm[lane] + step[1], 1e-6);
+            trial.tau_s[lane] = std::min(std::max(current.tau_s[lane] + step[2], 0.1 * trace.deltaTime_s), 1e5);
+            trial.capacity_mAh[lane] = std::max(current.capacity_mAh[lane] + step[3], 1.0);
+            trial.initialSoc[lane] = current.initialSoc[lane] + step[4];
+        }
+        if (!anyActive) {
+            break;
+        }
+
+        double trialCost[BLOCK];
+        computeCost(trace, measured_V.data(), trial, trialCost);
+        bool anyAccepted = false;
+        for (size_t lane = 0; lane < BLOCK; ++lane) {
+            if (!active[lane]) {
+                continue;
+            }
+            if (trialCost[lane] < equations.cost[lane]) {
+                double improvement = (equations.cost[lane] - trialCost[lane]) / equations.cost[lane];
+                current.r0_Ohm[lane] = trial.r0_Ohm[lane];
+                current.r1_Ohm[lane] = trial.r1_Ohm[lane];
+                current.tau_s[lane] = trial.tau_s[lane];
+                current.capacity_mAh[lane] = trial.capacity_mAh[lane];
+                current.initialSoc[lane] = trial.initialSoc[lane];
+                damping[lane] = std::max(damping[lane] * 0.3, 1e-12);
+                active[lane] = improvement >= ECM_FIT_CONVERGENCE;
+                anyAccepted = true;
+            } else {
+                damping[lane] *= 10.0;
+                active[lane] = damping[lane] < 1e10;
+            }
+        }
+        if (anyAccepted) {
+            computeNormalEquations(trace, measured_V.data(), current, equations);
+        }
+    }
+
+    for (size_t lane = 0; lane < laneCount; ++lane) {
+        EcmParameters& cell = parameters[firstCell + lane];
+        cell.r0_Ohm = static_cast<float>(current.r0_Ohm[lane]);
+        cell.r1_Ohm = static_cast<float>(current.r1_Ohm[lane]);
+        cell.c1_F = static_cast<float>(current.tau_s[lane] / current.r1_Ohm[lane]);
+        cell.capacity_mAh = static_cast<float>(current.capacity_mAh[lane]);
+        cell.initialSoc = static_cast<float>(current.initialSoc[lane]);
+        cell.rmsError_V = static_cast<float>(std::sqrt(equations.cost[lane] / static_cast<double>(sampleCount)));
+    }
+}
+
+/**
+ * @brief Computes the cell voltages the model predicts for the current of a trace.
+ * The same model the fit uses, one cell at a time.
+ * @param trace The trace whose current drives the model.
+ * @param parameters Parameters of every cell of the trace.
+ * @param cellVoltages_V Output, time-major like EcmTrace::cellVoltages_V.
+ */
+void EcmIdentifier::simulate(const EcmTrace& trace, const std::vector<EcmParameters>& parameters,
+                             std::vector<float>& cellVoltages_V) {
+    const size_t sampleCount = trace.current_A.size();
+    cellVoltages_V.resize(sampleCount * trace.cellCount);
+    for (size_t c = 0; c < trace.cellCount && c < parameters.size(); ++c) {
+        const EcmParameters& cell = parameters[c];
+        double decay = std::exp(-trace.deltaTime_s / (static_cast<double>(cell.r1_Ohm) * cell.c1_F));
+        double rcVoltage = 0.0;
+        double soc = cell.initialSoc;
+        for (size_t t = 0; t < sampleCount; ++t) {
+            double current = trace.current_A[t];
+            cellVoltages_V[t * trace.cellCount + c] = static_cast<float>(
+                SIM_CELL_OCV_EMPTY_V + OCV_SLOPE_V * soc + current * cell.r0_Ohm + rcVoltage);
+            rcVoltage = decay * rcVoltage + cell.r1_Ohm * (1.0 - decay) * current;
+            soc += current * trace.deltaTime_s / (cell.capacity_mAh * 3.6);
+        }
+    }
+}
+
+/**
+ * @brief Reads a trace from a CSV file.
+ * @param path The file to read.
+ * @param trace Output trace.
+ * @return True if the file was read completely, false otherwise.
+ */
+bool EcmIdentifier::loadTrace(const std::string& path, EcmTrace& trace) {
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line)) {
+        return false;
+    }
+    char* end = nullptr;
+    trace.deltaTime_s = std::strtof(line.c_str(), &end);
+    if (*end != ',' || !(trace.deltaTime_s > 0.0f)) {
+        return false;
+    }
+    trace.cellCount = std::strtoul(end + 1, nullptr, 10);
+    trace.current_A.clear();
+    trace.cellVoltages_V.clear();
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        const char* cursor = line.c_str();
+        trace.current_A.push_back(std::strtof(cursor, &end));
+        for (size_t c = 0; c < trace.cellCount; ++c) {
+            if (*end != ',') {
+                return false;
+            }
+            cursor = end + 1;
+            trace.cellVoltages_V.push_back(std::strtof(cursor, &end));
+        }
+    }
+    return trace.cellCount > 0 && !trace.current_A.empty();
+}
+
+/**
+ * @brief Writes a trace to a CSV file in the format loadTrace() reads.
+ * @param path The file to write.
+ * @param trace The trace.
+ * @return True if the file was written, false otherwise.
+ */
+bool EcmIdentifier::saveTrace(const std::string& path, const EcmTrace& trace) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "%.7g,%zu\n", trace.deltaTime_s, trace.cellCount);
+    for (size_t t = 0; t < trace.current_A.size(); ++t) {
+        std::fprintf(file, "%.7g", trace.current_A[t]);
+        for (size_t c = 0; c < trace.cellCount; ++c) {
+            std::fprintf(file, ",%.7g", trace.cellVoltages_V[t * trace.cellCount + c]);
+        }
+        std::fputc('\n', file);
+    }
+    return std::fclose(file) == 0;
+}
+
+/**
+ * @brief Writes fitted parameters to a text file, one cell per line.
+ * @param path The file to write.
+ * @param parameters The parameters.
+ * @return True if the file was written, false otherwise.
+ */
+bool EcmIdentifier::saveParameters(const std::string& path, const std::vector<EcmParameters>& parameters) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "# cell r0_Ohm r1_Ohm c1_F capacity_mAh initial_soc rms_error_V\n");
+    for (size_t c = 0; c < parameters.size(); ++c) {
+        const EcmParameters& cell = parameters[c];
+        std::fprintf(file, "%zu %.7g %.7g %.7g %.7g %.7g %.7g\n", c, cell.r0_Ohm, cell.r1_Ohm, cell.c1_F,
+                     cell.capacity_mAh, cell.initialSoc, cell.rmsError_V);
+    }
+    return std::fclose(file) == 0;
+}
+
+/**
+ * @brief Reads parameters written by saveParameters().
+ * Lines starting with '#' are comments; cells must be listed in order.
+ * @param path The file to read.
+ * @param parameters Output, one entry per cell.
+ * @return True if the file was read and holds at least one cell, false otherwise.
+ */
+bool EcmIdentifier::loadParameters(const std::string& path, std::vector<EcmParameters>& parameters) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    parameters.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        EcmParameters cell{};
+        size_t index = 0;
+        if (std::sscanf(line.c_str(), "%zu %f %f %f %f %f %f", &index, &cell.r0_Ohm, &cell.r1_Ohm, &cell.c1_F,
+                        &cell.capacity_mAh, &cell.initialSoc, &cell.rmsError_V) != 7 || index != parameters.size()) {
+            return false;
+        }
+        parameters.push_back(cell);
+    }
+    return !parameters.empty();
+}
@@ -0,0 +1,152 @@
+// src/EventBus.cpp
+#include "../inc/EventBus.h"
+#include <cstring>  // For std::memcpy, std::strlen
+#include <iomanip>  // For std::setprecision
+#include <sstream>  // For std::ostringstream
+
+/**
+ * @brief Copies a message into the event text, truncating it if necessary.
+ * @param message The message to copy.
+ */
+void BmsEvent::setText(const char* message) {
+    size_t length = std::strlen(message);
+    length = length < EVENT_TEXT_LENGTH - 1 ? length : EVENT_TEXT_LENGTH - 1;
+    std::memcpy(text, message, length);
+    text[length] = '\0';
+}
+
+/**
+ * @brief Formats an event as a one-line, human-readable message.
+ * @param event The event to describe.
+ * @return The message (without a trailing newline).
+ */
+std::string describeEvent(const BmsEvent& event) {
+    static const char* const thresholdNames[] = {"SoC full", "SoC empty", "SoH warning", "SoH critical"};
+    std::ostringstream message;
+    switch (event.type) {
+        case EventType::STATE_TRANSITION:
+            message << "BMS STATE TRANSITION: " << toString(event.fromState) << " -> " << toString(event.toState);
+            break;
+        case EventType::FAULT:
+            message << event.text << " - Immediate action required!";
+            break;
+        case EventType::CYCLE_INCREMENT:
+            message << "Charge cycle incremented. Total cycles: " << std::fixed << std::setprecision(1) << event.value;
+            break;
+        case EventType::THRESHOLD_CROSSING:
+            message << (event.rising ? "Rose above " : "Fell below ")
+                    << thresholdNames[static_cast<size_t>(event.threshold)] << " threshold ("
+                    << std::fixed << std::setprecision(1) << event.value << "%)";
+            break;
+        case EventType::LOG:
+            message << event.text;
+            break;
+    }
+    return message.str();
+}
+
+/**
+ * @brief Constructor for EventBus.
+ * The dispatcher thread is not started until start() is called.
+ */
+EventBus::EventBus() : m_running(false), m_dropped(0) {}
+
+/**
+ * @brief Destructor. Stops the dispatcher thread after draining the queue.
+ */
+EventBus::~EventBus() {
+    stop();
+}
+
+/**
+ * @brief Registers a handler for one event type.
+ * Must be called before start().
+ * @param type The event type to subscribe to.
+ * @param handler The handler to invoke.
+ */
+void EventBus::subscribe(EventType type, EventHandler handler) {
+    m_handlers[static_cast<size_t>(type)].push_back(std::move(handler));
+}
+
+/**
+ * @brief Queues an event for dispatch. Lock-free and non-blocking.
+ * Wakes the dispatcher thread if it is sleeping: WakeSignal::notify() orders the push
+ * before its check for a waiter, so either the dispatcher sees the event before it
+ * sleeps, or the publisher sees it asleep and wakes it with a futex call. While the
+ * dispatcher is busy, publishing costs no system call.
+ * @param event The event to publish.
+ * @return True if queued, false if the queue was full and the event was dropped.
+ */
+bool EventBus::publish(const BmsEvent& event) {
+    if (!m_queue.tryPush(event)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    m_wakeUp.notify();
+    return true;
+}
+
+/**
+ * @brief Starts the dispatcher thread.
+ */
+void EventBus::start() {
+    if (m_running.exchange(true)) return;
+    m_dispatcher = std::thread(&EventBus::dispatchLoop, this);
+}
+
+/**
+ * @brief Stops the dispatcher thread after dispatching everything queued.
+ */
+void EventBus::stop() {
+    if (!m_running.exchange(false)) return;
+    m_wakeUp.notify();
+    if (m_dispatcher.joinable()) {
+        m_dispatcher.join();
+    }
+    dispatchPending();
+}
+
+/**
+ * @brief Dispatches all queued events on the calling thread.
+ * For use when no dispatcher thread is running.
+ * @return Number of events dispatched.
+ */
+size_t EventBus::dispatchPending() {
+    size_t count = 0;
+    BmsEvent event;
+    while (m_queue.tryPop(event)) {
+        for (const auto& handler : m_handlers[static_cast<size_t>(event.type)]) {
+            handler(event);
+        }
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * @brief Body of the dispatcher thread.
+ * Drains the queue and sleeps on m_wakeUp whenever it is empty, until publish() or
+ * stop() wakes it up. The queue and the running flag are checked after announcing the
+ * wait, so an event or a stop in between makes the wait return at once.
+ */
+void EventBus::dispatchLoop() {
+    while (m_running.load(std::memory_order_acquire)) {
+        if (dispatchPending() > 0) {
+            continue;
+        }
+        uint32_t token = m_wakeUp.prepareWait();
+        if (m_queue.empty() && m_running.load(std::memory_order_acquire)) {
+            m_wakeUp.wait(token);
+        } else {
+            m_wakeUp.cancelWait();
+        }
+    }
+}
+
+/**
+ * @brief Gets the number of events dropped because the queue was full.
+ * @return Number of dropped events.
+ */
+uint64_t EventBus::getDroppedCount() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
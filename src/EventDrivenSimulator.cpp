@@ -0,0 +1,275 @@
+// src/EventDrivenSimulator.cpp
+#include "../inc/EventDrivenSimulator.h"
+#include <algorithm> // For std::min
+#include <cmath>     // For std::ceil
+#include "../inc/BMS.h" // For the SoC and SoH kernels
+
+namespace {
+/**
+ * @brief Draws a uniformly distributed duration.
+ * @param random The generator.
+ * @param min_s Shortest duration in seconds.
+ * @param max_s Longest duration in seconds.
+ * @param deltaTime_s Length of a time step.
+ * @return Duration in time steps, at least one.
+ */
+uint64_t drawSteps(SplitMix64& random, uint32_t min_s, uint32_t max_s, float deltaTime_s) {
+    uint64_t duration_s = min_s + random() % (static_cast<uint64_t>(max_s - min_s) + 1);
+    return std::max<uint64_t>(static_cast<uint64_t>(duration_s / deltaTime_s), 1);
+}
+
+/**
+ * @brief Draws a uniformly distributed value.
+ * @param random The generator.
+ * @param min Lower bound.
+ * @param max Upper bound.
+ * @return Value between min and max.
+ */
+float drawUniform(SplitMix64& random, float min, float max) {
+    return min + (max - min) * static_cast<float>(random() >> 40) * (1.0f / 16777216.0f);
+}
+} // namespace
+
+/**
+ * @brief Constructor for a lifetime pack.
+ * The pack starts parked for a random time, so the packs do not all drive at once.
+ * @param variability Distributions the cell parameters are drawn from.
+ * @param seed Seed of the cell parameters and the usage schedule.
+ */
+EventDrivenSimulator::LifetimePack::LifetimePack(const CellVariability& variability, uint64_t seed)
+    : cells(NUM_CELLS, variability, static_cast<uint32_t>(seed)),
+      usage(seed >> 32),
+      current_A(0.0f),
+      step(0),
+      phaseEnd(0),
+      accumulatedCharge_mAh(SIM_CELL_INITIAL_SOC * NOMINAL_CAPACITY_MAH),
+      chargeCompensation_mAh(0.0f),
+      estimatedCapacity_mAh(NOMINAL_CAPACITY_MAH),
+      stateOfCharge_percent(SIM_CELL_INITIAL_SOC * 100.0f),
+      stateOfHealth_percent(100.0f),
+      chargeCycles(0.0f),
+      wasFull(0),
+      wasEmpty(0),
+      stepsInState{},
+      entriesIntoState{},
+      evaluatedSteps(0),
+      skippedSteps(0),
+      idleJumps(0)
+{
+}
+
+/**
+ * @brief Constructor for EventDrivenSimulator.
+ * All packs start parked, at SIM_CELL_INITIAL_SOC and ambient temperature.
+ * @param packCount Number of packs to simulate.
+ * @param stepping How the packs are advanced.
+ * @param seed Seed of the cell parameters and the usage schedules.
+ * @param variability Distributions the cell parameters are drawn from.
+ */
+EventDrivenSimulator::EventDrivenSimulator(size_t packCount, SimulationStepping stepping, uint64_t seed,
+                                           const CellVariability& variability)
+    : m_stepping(stepping),
+      m_step(0),
+      m_deltaTime_s(static_cast<float>(BMS_UPDATE_INTERVAL_MS) / 1000.0f)
+{
+    SplitMix64 seeds(seed);
+    m_packs.reserve(packCount);
+    for (size_t i = 0; i < packCount; ++i) {
+        m_packs.emplace_back(variability, seeds());
+        LifetimePack& pack = m_packs.back();
+        pack.phaseEnd = drawSteps(pack.usage, 0, LIFETIME_IDLE_MAX_S, m_deltaTime_s);
+        m_events.push({0, i});
+    }
+}
+
+/**
+ * @brief Advances every pack by a duration of simulated time.
+ * In event-driven mode the earliest event is handled first; packs do not interact, so a
+ * pack may handle its whole active phase in one event without changing any outcome.
+ * @param duration_s Simulated time in seconds.
+ */
+void EventDrivenSimulator::run(uint64_t duration_s) {
+    const uint64_t horizon = m_step + static_cast<uint64_t>(duration_s / m_deltaTime_s);
+    if (m_stepping == SimulationStepping::FIXED_STEP) {
+        for (LifetimePack& pack : m_packs) {
+            while (pack.step < horizon) {
+                stepPack(pack);
+                if (pack.step == pack.phaseEnd) {
+                    startNextPhase(pack);
+                }
+            }
+        }
+    } else {
+        while (!m_events.empty() && m_events.top().step < horizon) {
+            PackEvent event = m_events.top();
+            m_events.pop();
+            LifetimePack& pack = m_packs[event.pack];
+            processEvent(pack, horizon);
+            m_events.push({pack.step, event.pack});
+        }
+    }
+    m_step = horizon;
+}
+
+/**
+ * @brief Handles a pack at its next interesting time step, up to a horizon.
+ * A parked pack jumps over the time steps whose readings keep the current safety state,
+ * then evaluates the time step that changes it. With no current the estimators do not
+ * change either, so the jump skips nothing fixed stepping would have recorded besides
+ * the time spent in the state. An active pack steps through its phase.
+ * @param pack The pack.
+ * @param horizon Time step the current run() ends at.
+ */
+void EventDrivenSimulator::processEvent(LifetimePack& pack, uint64_t horizon) {
+    const uint64_t end = std::min(pack.phaseEnd, horizon);
+    if (pack.current_A == 0.0f) {
+        const SystemState state = pack.safetyManager.getCurrentState();
+        const float soh = pack.stateOfHealth_percent;
+        std::array<BatteryCell, NUM_CELLS> readings;
+        IdleReadingsPredicate keepsState = [&](const float* voltages_V, const float* temperatures_C) {
+            for (size_t i = 0; i < NUM_CELLS; ++i) {
+                readings[i] = BatteryCell(static_cast<uint8_t>(i), voltages_V[i], temperatures_C[i]);
+            }
+            return pack.safetyManager.proposeState(readings, 0.0f, soh) == state;
+        };
+        uint64_t skipped = pack.cells.advanceIdle(end - pack.step, m_deltaTime_s, keepsState);
+        pack.step += skipped;
+        pack.stepsInState[static_cast<size_t>(state)] += skipped;
+        pack.skippedSteps += skipped;
+        pack.idleJumps += skipped > 0;
+        if (skipped > 0) {
+            // The capacity estimator sees the jump as one long rest, read at its end
+            const std::pmr::vector<float>& temperatures_C = pack.cells.getTemperatures_C();
+            for (size_t i = 0; i < NUM_CELLS; ++i) {
+                readings[i] = BatteryCell(static_cast<uint8_t>(i), pack.cells.getOpenCircuitVoltage(i), temperatures_C[i]);
+            }
+            CapacityEstimator::update(pack.capacityEstimator, readings, 0.0f, skipped * m_deltaTime_s,
+                                      pack.estimatedCapacity_mAh);
+        }
+        if (pack.step < end) {
+            stepPack(pack);
+        }
+    } else {
+        while (pack.step < end) {
+            stepPack(pack);
+        }
+    }
+    if (pack.step == pack.phaseEnd) {
+        startNextPhase(pack);
+    }
+}
+
+/**
+ * @brief Evaluates one time step of a pack: readings, physics, estimators, safety.
+ * The order follows BMS::update(): the readings are taken before the cells advance.
+ * @param pack The pack.
+ */
+void EventDrivenSimulator::stepPack(LifetimePack& pack) {
+    std::array<BatteryCell, NUM_CELLS> readings;
+    const std::pmr::vector<float>& temperatures_C = pack.cells.getTemperatures_C();
+    for (size_t i = 0; i < NUM_CELLS; ++i) {
+        readings[i] = BatteryCell(static_cast<uint8_t>(i), pack.cells.getTerminalVoltage(i, pack.current_A), temperatures_C[i]);
+    }
+    pack.cells.advance(pack.current_A, m_deltaTime_s);
+
+    uint8_t cycleCompleted = 0;
+    BMS::integrateStateOfCharge(1, &pack.current_A, m_deltaTime_s, &pack.estimatedCapacity_mAh, &pack.accumulatedCharge_mAh,
+                                &pack.chargeCompensation_mAh, &pack.stateOfCharge_percent);
+    BMS::countChargeCycles(1, &pack.stateOfCharge_percent, &pack.estimatedCapacity_mAh, &pack.wasFull, &pack.wasEmpty,
+                           &pack.chargeCycles, &pack.stateOfHealth_percent, &cycleCompleted);
+    CapacityEstimator::update(pack.capacityEstimator, readings, pack.current_A, m_deltaTime_s, pack.estimatedCapacity_mAh);
+
+    pack.safetyManager.evaluate(readings, pack.current_A, pack.stateOfHealth_percent);
+    const size_t state = static_cast<size_t>(pack.safetyManager.getCurrentState());
+    pack.entriesIntoState[state] += pack.safetyManager.hasStateChanged();
+    ++pack.stepsInState[state];
+    ++pack.evaluatedSteps;
+    ++pack.step;
+}
+
+/**
+ * @brief Starts the next phase of a pack's usage schedule.
+ * A parked pack charges next if its estimated SoC is low, otherwise it drives; a charge
+ * lasts until the Coulomb counter reaches full capacity. Every active phase is followed
+ * by a parked period. The schedule only depends on the estimators, so both stepping
+ * modes draw the same schedule.
+ * @param pack The pack.
+ */
+void EventDrivenSimulator::startNextPhase(LifetimePack& pack) {
+    uint64_t steps;
+    if (pack.current_A != 0.0f) {
+        pack.current_A = 0.0f;
+        steps = drawSteps(pack.usage, LIFETIME_IDLE_MIN_S, LIFETIME_IDLE_MAX_S, m_deltaTime_s);
+    } else if (pack.stateOfCharge_percent < LIFETIME_RECHARGE_SOC_PERCENT) {
+        pack.current_A = LIFETIME_CHARGE_CURRENT_A;
+        float missing_mAh = pack.estimatedCapacity_mAh - pack.accumulatedCharge_mAh;
+        float chargeTime_s = missing_mAh / (LIFETIME_CHARGE_CURRENT_A * 1000.0f * CHARGE_EFFICIENCY) * 3600.0f;
+        steps = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(chargeTime_s / m_deltaTime_s)), 1);
+    } else {
+        pack.current_A = drawUniform(pack.usage, LIFETIME_DRIVE_CURRENT_MIN_A, LIFETIME_DRIVE_CURRENT_MAX_A);
+        steps = drawSteps(pack.usage, LIFETIME_DRIVE_MIN_S, LIFETIME_DRIVE_MAX_S, m_deltaTime_s);
+    }
+    pack.phaseEnd = pack.step + steps;
+}
+
+/**
+ * @brief Gets the simulated time all packs have reached.
+ * @return Simulated time in seconds.
+ */
+uint64_t EventDrivenSimulator::getTime_s() const {
+    return static_cast<uint64_t>(m_step * m_deltaTime_s);
+}
+
+/**
+ * @brief Gets the outcome totals of all packs so far.
+ * @return Statistics summed over all packs.
+ */
+LifetimeStatistics EventDrivenSimulator::getStatistics() const {
+    LifetimeStatistics statistics;
+    for (const LifetimePack& pack : m_packs) {
+        for (size_t state = 0; state < statistics.stepsInState.size(); ++state) {
+            statistics.stepsInState[state] += pack.stepsInState[state];
+            statistics.entriesIntoState[state] += pack.entriesIntoState[state];
+        }
+        statistics.evaluatedSteps += pack.evaluatedSteps;
+        statistics.skippedSteps += pack.skippedSteps;
+        statistics.idleJumps += pack.idleJumps;
+        statistics.chargeCycles += pack.chargeCycles;
+    }
+    return statistics;
+}
+
+/**
+ * @brief Gets the number of packs.
+ * @return Number of packs.
+ */
+size_t EventDrivenSimulator::getPackCount() const {
+    return m_packs.size();
+}
+
+/**
+ * @brief Gets the safety state of a pack.
+ * @param pack Index of the pack.
+ * @return The pack's current SystemState.
+ */
+SystemState EventDrivenSimulator::getPackState(size_t pack) const {
+    return m_packs[pack].safetyManager.getCurrentState();
+}
+
+/**
+ * @brief Gets the estimated State of Health of a pack.
+ * @param pack Index of the pack.
+ * @return SoH in percent.
+ */
+float EventDrivenSimulator::getPackStateOfHealth_percent(size_t pack) const {
+    return m_packs[pack].stateOfHealth_percent;
+}
+
+/**
+ * @brief Gets the online capacity estimate of a pack.
+ * @param pack Index of the pack.
+ * @return Capacity in mAh.
+ */
+float EventDrivenSimulator::getPackCapacity_mAh(size_t pack) const {
+    return m_packs[pack].estimatedCapacity_mAh;
+}
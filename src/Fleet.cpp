@@ -0,0 +1,376 @@
+// src/Fleet.cpp
+#include "../inc/Fleet.h"
+#include <algorithm> // For std::min, std::max
+#include "../inc/CellKernels.h" // For PackCellKernels
+#include <cmath>     // For std::fabs
+#include <new>       // For placement new
+
+/**
+ * @brief Sizes every column for a number of packs.
+ * @param packCount Number of packs.
+ */
+void PackColumns::resize(size_t packCount) {
+    packCurrent_A.resize(packCount);
+    stringOcv_V.resize(packCount * NUM_PARALLEL_STRINGS);
+    stringResistance_Ohm.resize(packCount * NUM_PARALLEL_STRINGS);
+    stringCurrent_A.resize(packCount * NUM_PARALLEL_STRINGS);
+    cellVoltages_V.resize(packCount * NUM_CELLS);
+    cellTemperatures_C.resize(packCount * NUM_CELLS);
+    estimatedCapacity_mAh.resize(packCount);
+    accumulatedCharge_mAh.resize(packCount);
+    chargeCompensation_mAh.resize(packCount);
+    stateOfCharge_percent.resize(packCount);
+    stateOfHealth_percent.resize(packCount);
+    previousSoC_percent.resize(packCount);
+    previousSoH_percent.resize(packCount);
+    chargeCycles.resize(packCount);
+    wasFull.resize(packCount);
+    wasEmpty.resize(packCount);
+    cycleCompleted.resize(packCount);
+    proposedState.resize(packCount);
+}
+
+/**
+ * @brief Constructor for Fleet.
+ * Creates the packs in the fleet arena with console output disabled. The pack objects,
+ * the hot states and the warm states each form one contiguous array; the cell models
+ * the packs allocate while being constructed follow them in the arena.
+ * @param packCount Number of packs in the fleet.
+ * @param shardCount Number of worker shards (0 selects the number of hardware threads).
+ * @param execution How the estimators of the packs are run.
+ */
+Fleet::Fleet(size_t packCount, size_t shardCount, FleetExecution execution)
+    : m_packCount(packCount),
+      m_packs(static_cast<BMS*>(m_arena.allocate(packCount * sizeof(BMS), alignof(BMS)))),
+      m_hotStates(static_cast<PackHotState*>(m_arena.allocate(packCount * sizeof(PackHotState), alignof(PackHotState)))),
+      m_warmStates(static_cast<PackWarmState*>(m_arena.allocate(packCount * sizeof(PackWarmState), alignof(PackWarmState)))),
+      m_shardCount(shardCount),
+      m_execution(execution),
+      m_tick(0),
+      m_snapshot(std::make_shared<FleetSnapshot>()),
+      m_tickGeneration(0),
+      m_pendingShards(0),
+      m_tickDeltaTime_s(0.0f),
+      m_workersRunning(true)
+{
+    if (m_shardCount == 0) {
+        m_shardCount = std::thread::hardware_concurrency();
+    }
+    if (m_shardCount == 0) {
+        m_shardCount = 1;
+    }
+    if (m_shardCount > packCount && packCount > 0) {
+        m_shardCount = packCount;
+    }
+    m_shards.resize(m_shardCount);
+    for (FleetShardState& shardState : m_shards) {
+        shardState.columns.resize(FLEET_PACK_MAJOR_BLOCK_PACKS);
+    }
+
+    for (size_t p = 0; p < packCount; ++p) {
+        m_arena.alignNext(alignof(BMS)); // Cell model of each pack on its own cache lines
+        BMS* pack = new (&m_packs[p]) BMS(&m_hotStates[p], &m_warmStates[p], &m_arena);
+        pack->setConsoleOutput(false);
+    }
+
+    m_workers.reserve(m_shardCount - 1);
+    for (size_t shard = 1; shard < m_shardCount; ++shard) {
+        m_workers.emplace_back(&Fleet::shardLoop, this, shard);
+    }
+}
+
+/**
+ * @brief Destructor for Fleet.
+ * Stops the shard workers and destroys the packs; their memory is released with the arena.
+ */
+Fleet::~Fleet() {
+    {
+        std::lock_guard<std::mutex> lock(m_tickMutex);
+        m_workersRunning = false;
+    }
+    m_tickStarted.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    for (size_t p = 0; p < m_packCount; ++p) {
+        m_packs[p].~BMS();
+    }
+}
+
+/**
+ * @brief Reads the sensors of a block of packs [begin, end) of a shard.
+ * Reads every pack's current and string model into the columns, solves how the current
+ * divides between the strings for the whole block in one call, then reads every pack's
+ * cells under its strings' currents. The same steps BMS::readSensors() takes for one pack.
+ * @param columns The shard's pack-major scalars, sized for FLEET_PACK_MAJOR_BLOCK_PACKS packs.
+ * @param begin Index of the block's first pack.
+ * @param end Index after the block's last pack (at most FLEET_PACK_MAJOR_BLOCK_PACKS after begin).
+ * @param deltaTime_s The time elapsed since the last update in seconds.
+ */
+void Fleet::readSensors(PackColumns& columns, size_t begin, size_t end, float deltaTime_s) {
+    const size_t count = end - begin;
+    for (size_t i = 0; i < count; ++i) {
+        m_packs[begin + i].readPackCurrent(&columns.stringOcv_V[i * NUM_PARALLEL_STRINGS],
+                                           &columns.stringResistance_Ohm[i * NUM_PARALLEL_STRINGS]);
+        columns.packCurrent_A[i] = m_hotStates[begin + i].packCurrent_A;
+    }
+    SensorSimulator::solveStringCurrents(count, columns.packCurrent_A.data(), columns.stringOcv_V.data(),
+                                         columns.stringResistance_Ohm.data(), columns.stringCurrent_A.data(), nullptr);
+    for (size_t i = 0; i < count; ++i) {
+        m_packs[begin + i].readCellSensors(&columns.stringCurrent_A[i * NUM_PARALLEL_STRINGS], deltaTime_s);
+    }
+}
+
+/**
+ * @brief Updates a block of packs [begin, end) of a shard in pack-major mode.
+ * Runs after readSensors(): copies the hot scalars into the columns, runs the SoC,
+ * SoH and safety kernels across all packs of the shard, copies the results back and
+ * completes the update of every pack. Each kernel pass streams a few flat arrays, so the
+ * compiler processes as many packs per instruction as the vector width allows.
+ * @param columns The shard's pack-major scalars, sized for FLEET_PACK_MAJOR_BLOCK_PACKS packs.
+ * @param begin Index of the block's first pack.
+ * @param end Index after the block's last pack (at most FLEET_PACK_MAJOR_BLOCK_PACKS after begin).
+ * @param deltaTime_s The time elapsed since the last update in seconds.
+ */
+void Fleet::updatePackMajor(PackColumns& columns, size_t begin, size_t end, float deltaTime_s) {
+    const size_t count = end - begin;
+    for (size_t i = 0; i < count; ++i) {
+        const PackHotState& hot = m_hotStates[begin + i];
+        const PackWarmState& warm = m_warmStates[begin + i];
+        for (size_t c = 0; c < NUM_CELLS; ++c) {
+            columns.cellVoltages_V[i * NUM_CELLS + c] = hot.cells[c].getVoltage();
+            columns.cellTemperatures_C[i * NUM_CELLS + c] = hot.cells[c].getTemperature();
+        }
+        columns.estimatedCapacity_mAh[i] = hot.estimatedCapacity_mAh;
+        columns.accumulatedCharge_mAh[i] = hot.accumulatedCharge_mAh;
+        columns.chargeCompensation_mAh[i] = hot.chargeCompensation_mAh;
+        columns.previousSoC_percent[i] = hot.stateOfCharge_percent;
+        columns.previousSoH_percent[i] = hot.stateOfHealth_percent;
+        columns.chargeCycles[i] = warm.chargeCycles;
+        columns.wasFull[i] = warm.wasFull;
+        columns.wasEmpty[i] = warm.wasEmpty;
+    }
+
+    BMS::integrateStateOfCharge(count, columns.packCurrent_A.data(), deltaTime_s, columns.estimatedCapacity_mAh.data(),
+                                columns.accumulatedCharge_mAh.data(), columns.chargeCompensation_mAh.data(),
+                                columns.stateOfCharge_percent.data());
+    BMS::countChargeCycles(count, columns.stateOfCharge_percent.data(), columns.estimatedCapacity_mAh.data(),
+                           columns.wasFull.data(), columns.wasEmpty.data(), columns.chargeCycles.data(),
+                           columns.stateOfHealth_percent.data(), columns.cycleCompleted.data());
+    SafetyFrames frames = {count, columns.cellVoltages_V.data(), columns.cellTemperatures_C.data(),
+                           columns.packCurrent_A.data(), columns.stateOfHealth_percent.data()};
+    SafetyManager::proposeStates(frames, columns.proposedState.data());
+
+    for (size_t i = 0; i < count; ++i) {
+        PackHotState& hot = m_hotStates[begin + i];
+        PackWarmState& warm = m_warmStates[begin + i];
+        hot.accumulatedCharge_mAh = columns.accumulatedCharge_mAh[i];
+        hot.chargeCompensation_mAh = columns.chargeCompensation_mAh[i];
+        hot.stateOfCharge_percent = columns.stateOfCharge_percent[i];
+        hot.stateOfHealth_percent = columns.stateOfHealth_percent[i];
+        warm.chargeCycles = columns.chargeCycles[i];
+        warm.wasFull = columns.wasFull[i] != 0;
+        warm.wasEmpty = columns.wasEmpty[i] != 0;
+
+        m_packs[begin + i].completeUpdate(deltaTime_s, columns.previousSoC_percent[i], columns.previousSoH_percent[i],
+                                          columns.cycleCompleted[i] != 0, columns.proposedState[i]);
+    }
+}
+
+/**
+ * @brief Updates the packs of one shard and rebuilds its heaps and sketches.
+ * Runs on the shard's worker thread and only touches the shard's own packs and heaps.
+ * @param shard Index of the shard.
+ * @param deltaTime_s The time elapsed since the last update in seconds.
+ */
+void Fleet::updateShard(size_t shard, float deltaTime_s) {
+    size_t begin = shard * m_packCount / m_shardCount;
+    size_t end = (shard + 1) * m_packCount / m_shardCount;
+
+    auto& heaps = m_shards[shard].heaps;
+    for (auto& heap : heaps) {
+        heap.clear();
+    }
+    auto& sketches = m_shards[shard].sketches;
+    for (auto& sketch : sketches) {
+        sketch.clear();
+    }
+
+    // Packs are updated in blocks, so the pack-major columns stay in cache and each pack is
+    // ranked while its hot state is still in cache
+    for (size_t first = begin; first < end; first += FLEET_PACK_MAJOR_BLOCK_PACKS) {
+        size_t last = std::min(end, first + FLEET_PACK_MAJOR_BLOCK_PACKS);
+        readSensors(m_shards[shard].columns, first, last, deltaTime_s);
+        if (m_execution == FleetExecution::PACK_MAJOR) {
+            updatePackMajor(m_shards[shard].columns, first, last, deltaTime_s);
+        }
+
+        for (size_t p = first; p < last; ++p) {
+            if (m_execution == FleetExecution::PER_PACK) {
+                m_packs[p].updateFromReadings(deltaTime_s);
+            }
+
+            const PackHotState& hot = m_hotStates[p];
+            const auto& cells = hot.cells;
+            std::array<float, NUM_CELLS> voltages;
+            std::array<float, NUM_CELLS> temperatures;
+            PackCellKernels<NUM_CELLS>::gather(cells, voltages.data(), temperatures.data());
+            CellStatistics statistics = PackCellKernels<NUM_CELLS>::statistics(voltages.data(), temperatures.data());
+            float meanVoltage = statistics.sumVoltage_V / NUM_CELLS;
+            float minVoltage = statistics.minVoltage_V;
+            float maxVoltage = statistics.maxVoltage_V;
+
+            sketches[static_cast<size_t>(FleetDistribution::STATE_OF_CHARGE)].add(hot.stateOfCharge_percent);
+            sketches[static_cast<size_t>(FleetDistribution::STATE_OF_HEALTH)].add(hot.stateOfHealth_percent);
+            sketches[static_cast<size_t>(FleetDistribution::IMBALANCE)].add(maxVoltage - minVoltage);
+
+            uint32_t packIndex = static_cast<uint32_t>(p);
+            const float* resistances = m_packs[p].getCellResistances_Ohm().data();
+            for (const auto& cell : cells) {
+                float voltage = cell.getVoltage();
+                float temperature = cell.getTemperature();
+                float deviation = voltage - meanVoltage;
+                heaps[static_cast<size_t>(CellMetric::MAX_TEMPERATURE)].offer({temperature, temperature, packIndex, cell.getId()});
+                heaps[static_cast<size_t>(CellMetric::MIN_VOLTAGE)].offer({-voltage, voltage, packIndex, cell.getId()});
+                heaps[static_cast<size_t>(CellMetric::MAX_DEVIATION)].offer({std::fabs(deviation), deviation, packIndex, cell.getId()});
+                float resistance = resistances[cell.getId()];
+                heaps[static_cast<size_t>(CellMetric::MAX_RESISTANCE)].offer({resistance, resistance, packIndex, cell.getId()});
+                sketches[static_cast<size_t>(FleetDistribution::CELL_TEMPERATURE)].add(temperature);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Body of the worker thread of one shard: updates the shard once per tick.
+ * Sleeps on m_tickStarted until update() hands out a new tick generation, and the last
+ * worker to finish wakes update() up again.
+ * @param shard Index of the shard (1 to m_shardCount - 1).
+ */
+void Fleet::shardLoop(size_t shard) {
+    uint64_t generation = 0;
+    while (true) {
+        float deltaTime_s;
+        {
+            std::unique_lock<std::mutex> lock(m_tickMutex);
+            m_tickStarted.wait(lock, [&] { return m_tickGeneration != generation || !m_workersRunning; });
+            if (!m_workersRunning) {
+                return;
+            }
+            generation = m_tickGeneration;
+            deltaTime_s = m_tickDeltaTime_s;
+        }
+
+        updateShard(shard, deltaTime_s);
+
+        std::lock_guard<std::mutex> lock(m_tickMutex);
+        if (--m_pendingShards == 0) {
+            m_tickFinished.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief Updates every pack once and publishes a new FleetSnapshot.
+ * Shard 0 runs on the calling thread while the persistent workers run the other shards.
+ * The per-shard heaps are merged once all shards are done.
+ * @param deltaTime_s The time elapsed since the last update in seconds.
+ */
+void Fleet::update(float deltaTime_s) {
+    {
+        std::lock_guard<std::mutex> lock(m_tickMutex);
+        m_tickDeltaTime_s = deltaTime_s;
+        m_pendingShards = m_workers.size();
+        ++m_tickGeneration;
+    }
+    m_tickStarted.notify_all();
+    updateShard(0, deltaTime_s);
+    {
+        std::unique_lock<std::mutex> lock(m_tickMutex);
+        m_tickFinished.wait(lock, [&] { return m_pendingShards == 0; });
+    }
+
+    // Merge the shard heaps into the fleet-wide ranking
+    std::array<TopKHeap, CELL_METRIC_COUNT> merged;
+    for (const FleetShardState& shardState : m_shards) {
+        for (uint8_t m = 0; m < CELL_METRIC_COUNT; ++m) {
+            merged[m].merge(shardState.heaps[m]);
+        }
+    }
+
+    // Merge the shard sketches pairwise in a tree; the fleet-wide result ends up in shard 0
+    for (size_t stride = 1; stride < m_shardCount; stride *= 2) {
+        for (size_t shard = 0; shard + stride < m_shardCount; shard += 2 * stride) {
+            for (uint8_t d = 0; d < FLEET_DISTRIBUTION_COUNT; ++d) {
+                m_shards[shard].sketches[d].merge(m_shards[shard + stride].sketches[d]);
+            }
+        }
+    }
+
+    auto snapshot = std::make_shared<FleetSnapshot>();
+    snapshot->tick = ++m_tick;
+    for (uint8_t m = 0; m < CELL_METRIC_COUNT; ++m) {
+        snapshot->worstCellCounts[m] = merged[m].getSorted(snapshot->worstCells[m]);
+    }
+    for (uint8_t d = 0; d < FLEET_DISTRIBUTION_COUNT; ++d) {
+        QuantileSketch& sketch = m_shards[0].sketches[d];
+        sketch.flush();
+        snapshot->percentiles[d] = {sketch.quantile(0.01f), sketch.quantile(0.50f), sketch.quantile(0.99f)};
+    }
+    std::atomic_store(&m_snapshot, std::shared_ptr<const FleetSnapshot>(std::move(snapshot)));
+}
+
+/**
+ * @brief Gets the most recently published snapshot.
+ * Safe to call from any thread while update() is running.
+ * @return Shared pointer to the snapshot (empty rankings before the first update).
+ */
+std::shared_ptr<const FleetSnapshot> Fleet::getSnapshot() const {
+    return std::atomic_load(&m_snapshot);
+}
+
+/**
+ * @brief Fills one EnergyReport per pack.
+ * @param reports Output vector, resized to the number of packs.
+ */
+void Fleet::queryEnergy(std::vector<EnergyReport>& reports) const {
+    BMS::queryFleetEnergy(m_packs, m_packCount, reports);
+}
+
+/**
+ * @brief Adds the residency histograms of all packs into one fleet-wide histogram.
+ * Call between updates; the histograms are read without synchronization.
+ * @param histogram Output histogram; cleared first.
+ */
+void Fleet::mergeResidency(ResidencyHistogram& histogram) const {
+    histogram.clear();
+    for (size_t p = 0; p < m_packCount; ++p) {
+        histogram.merge(m_packs[p].getResidencyHistogram());
+    }
+}
+
+/**
+ * @brief Gets the number of packs in the fleet.
+ * @return Number of packs.
+ */
+size_t Fleet::getPackCount() const {
+    return m_packCount;
+}
+
+/**
+ * @brief Gets one pack of the fleet.
+ * @param packIndex Index of the pack (0 to getPackCount() - 1).
+ * @return Reference to the pack.
+ */
+const BMS& Fleet::getPack(size_t packIndex) const {
+    return m_packs[packIndex];
+}
+
+/**
+ * @brief Gets the memory the fleet's packs occupy.
+ * Covers the pack objects, their hot and warm state and their cell models.
+ * @return Bytes allocated from the fleet arena.
+ */
+size_t Fleet::getPackMemoryBytes() const {
+    return m_arena.getUsedBytes();
+}
@@ -0,0 +1,148 @@
+// src/FleetArena.cpp
+#include "../inc/FleetArena.h"
+#include <algorithm>  // For std::max, std::min
+#include <cstdint>    // For uintptr_t
+#include <new>        // For std::bad_alloc
+#include <sys/mman.h> // For mmap, munmap, madvise
+
+namespace {
+/**
+ * @brief Rounds a size up to a multiple of the arena page size.
+ * @param bytes The size to round.
+ * @return The rounded size.
+ */
+size_t roundToPages(size_t bytes) {
+    return (bytes + FLEET_ARENA_PAGE_BYTES - 1) / FLEET_ARENA_PAGE_BYTES * FLEET_ARENA_PAGE_BYTES;
+}
+} // namespace
+
+/**
+ * @brief Constructor for FleetArena.
+ * No memory is mapped until the first allocation.
+ * @param blockBytes Size of each block; rounded up to FLEET_ARENA_PAGE_BYTES.
+ */
+FleetArena::FleetArena(size_t blockBytes)
+    : m_cursor(nullptr),
+      m_end(nullptr),
+      m_blockBytes(roundToPages(std::max<size_t>(blockBytes, 1))),
+      m_usedBytes(0),
+      m_reservedBytes(0)
+{}
+
+/**
+ * @brief Destructor for FleetArena.
+ * Unmaps all blocks. Objects in the arena must have been destroyed before.
+ */
+FleetArena::~FleetArena() {
+    for (const Block& block : m_blocks) {
+        munmap(block.base, block.size);
+    }
+}
+
+/**
+ * @brief Gets the number of bytes handed out, including alignment padding.
+ * @return Used bytes.
+ */
+size_t FleetArena::getUsedBytes() const {
+    return m_usedBytes;
+}
+
+/**
+ * @brief Gets the number of bytes mapped for all blocks.
+ * @return Reserved bytes.
+ */
+size_t FleetArena::getReservedBytes() const {
+    return m_reservedBytes;
+}
+
+/**
+ * @brief Pads the cursor to an alignment, so the next allocation starts there.
+ * Used to give every group of small allocations (e.g. the cell model of one pack)
+ * its own cache lines, so groups written by different threads share none. A fresh
+ * block is page-aligned already, so nothing is padded before the first allocation
+ * or past the end of the current block.
+ * @param alignment Alignment (power of two).
+ */
+void FleetArena::alignNext(size_t alignment) {
+    if (m_cursor == nullptr) {
+        return;
+    }
+    uintptr_t cursor = reinterpret_cast<uintptr_t>(m_cursor);
+    uintptr_t aligned = (cursor + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    aligned = std::min(aligned, reinterpret_cast<uintptr_t>(m_end));
+    m_usedBytes += aligned - cursor;
+    m_cursor = reinterpret_cast<char*>(aligned);
+}
+
+/**
+ * @brief Allocates from the current block, mapping a new block if it is full.
+ * The rest of a full block is abandoned; with large blocks and small requests that
+ * wastes little.
+ * @param bytes Number of bytes.
+ * @param alignment Alignment (power of two).
+ * @return Pointer to the memory; throws std::bad_alloc if no block can be mapped.
+ */
+void* FleetArena::do_allocate(size_t bytes, size_t alignment) {
+    uintptr_t cursor = reinterpret_cast<uintptr_t>(m_cursor);
+    uintptr_t aligned = (cursor + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    if (m_cursor == nullptr || aligned + bytes > reinterpret_cast<uintptr_t>(m_end)) {
+        if (!addBlock(bytes + alignment)) {
+            throw std::bad_alloc();
+        }
+        cursor = reinterpret_cast<uintptr_t>(m_cursor);
+        aligned = (cursor + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    }
+    m_usedBytes += aligned + bytes - cursor;
+    m_cursor = reinterpret_cast<char*>(aligned + bytes);
+    return reinterpret_cast<void*>(aligned);
+}
+
+/**
+ * @brief Does nothing; memory is released when the arena is destroyed.
+ */
+void FleetArena::do_deallocate(void* /*pointer*/, size_t /*bytes*/, size_t /*alignment*/) {}
+
+/**
+ * @brief Checks whether another resource is this arena.
+ * @param other The other resource.
+ * @return True if memory of one can be deallocated by the other.
+ */
+bool FleetArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+/**
+ * @brief Maps a new block and makes it the current block.
+ * One extra page is mapped and the unaligned head and tail are unmapped again, so the
+ * block starts on a huge page boundary and can be backed by huge pages throughout.
+ * @param minBytes Minimum usable size of the block.
+ * @return True on success, false if the mapping failed.
+ */
+bool FleetArena::addBlock(size_t minBytes) {
+    size_t size = std::max(m_blockBytes, roundToPages(minBytes));
+    size_t mappedSize = size + FLEET_ARENA_PAGE_BYTES;
+    void* mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(mapped);
+    uintptr_t base = (start + FLEET_ARENA_PAGE_BYTES - 1) & ~static_cast<uintptr_t>(FLEET_ARENA_PAGE_BYTES - 1);
+    size_t head = base - start;
+    size_t tail = mappedSize - head - size;
+    if (head > 0) {
+        munmap(mapped, head);
+    }
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(base + size), tail);
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(reinterpret_cast<void*>(base), size, MADV_HUGEPAGE);
+#endif
+
+    m_blocks.push_back({reinterpret_cast<void*>(base), size});
+    m_cursor = reinterpret_cast<char*>(base);
+    m_end = m_cursor + size;
+    m_reservedBytes += size;
+    return true;
+}
@@ -0,0 +1,237 @@
+// src/FlightRecorder.cpp
+#include "../inc/FlightRecorder.h"
+#include <chrono>      // For std::chrono::milliseconds
+#include <cstring>     // For std::memcpy, std::strlen
+#include <fstream>     // For freeze-frame files
+#include <type_traits> // For std::is_trivially_copyable
+
+static_assert(std::is_trivially_copyable<PackHotState>::value, "frames are recorded with memcpy");
+static_assert(std::is_trivially_copyable<FlightRecorderFrame>::value, "frames are written as raw records");
+
+/**
+ * @brief Constructor for FlightRecorder.
+ * The writer thread is not started until start() is called.
+ * @param filePrefix Freeze-frame files are named <filePrefix>_<capture number>.bin.
+ */
+FlightRecorder::FlightRecorder(const std::string& filePrefix)
+    : m_activeRing(0),
+      m_postFramesLeft(0),
+      m_captureCount(0),
+      m_time_s(0.0),
+      m_filePrefix(filePrefix),
+      m_running(false),
+      m_written(0),
+      m_dropped(0)
+{
+}
+
+/**
+ * @brief Destructor. Stops the writer thread after writing every frozen capture.
+ */
+FlightRecorder::~FlightRecorder() {
+    stop();
+    writePending();
+}
+
+/**
+ * @brief Starts the writer thread.
+ */
+void FlightRecorder::start() {
+    if (m_running.exchange(true)) return;
+    m_writer = std::thread(&FlightRecorder::writeLoop, this);
+}
+
+/**
+ * @brief Stops the writer thread after writing every frozen capture.
+ */
+void FlightRecorder::stop() {
+    if (!m_running.exchange(false)) return;
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+    writePending();
+}
+
+/**
+ * @brief Records the frame of one update (control thread).
+ * The hot state is copied into the oldest slot of the active ring with one memcpy. While
+ * both rings wait for the writer, the frame is dropped.
+ * @param hot The pack's hot state after the update.
+ * @param state The safety state after the update.
+ * @param deltaTime_s The time elapsed since the last update in seconds.
+ */
+void FlightRecorder::record(const PackHotState& hot, SystemState state, float deltaTime_s) {
+    m_time_s += deltaTime_s;
+    if (m_activeRing < 0) {
+        for (int r = 0; r < 2 && m_activeRing < 0; ++r) {
+            if (!m_rings[r].frozen.load(std::memory_order_acquire)) {
+                m_activeRing = r;
+                m_rings[r].next = 0;
+                m_rings[r].count = 0;
+            }
+        }
+        if (m_activeRing < 0) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    CaptureRing& ring = m_rings[m_activeRing];
+    FlightRecorderFrame& frame = ring.frames[ring.next];
+    frame.time_s = m_time_s;
+    frame.state = state;
+    std::memcpy(&frame.hot, &hot, sizeof(PackHotState));
+    ring.next = ring.next + 1 < RING_FRAMES ? ring.next + 1 : 0;
+    ring.count += ring.count < RING_FRAMES;
+
+    if (m_postFramesLeft > 0 && --m_postFramesLeft == 0) {
+        freeze();
+    }
+}
+
+/**
+ * @brief Marks the last recorded frame as a fault and starts the post-trigger capture (control thread).
+ * The pre-trigger window is frozen from here on: the ring is overwritten only by the
+ * FLIGHT_RECORDER_POST_FRAMES frames that follow, which replace the frames older than it.
+ * @param reason Description of the fault, stored in the file (truncated to fit).
+ * @return True if a capture started, false if one is already running or no ring is free.
+ */
+bool FlightRecorder::trigger(const char* reason) {
+    if (m_postFramesLeft > 0 || m_activeRing < 0 || m_rings[m_activeRing].count == 0) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    CaptureRing& ring = m_rings[m_activeRing];
+    size_t length = std::strlen(reason);
+    length = length < EVENT_TEXT_LENGTH - 1 ? length : EVENT_TEXT_LENGTH - 1;
+    std::memcpy(ring.reason, reason, length);
+    ring.reason[length] = '\0';
+    m_postFramesLeft = FLIGHT_RECORDER_POST_FRAMES;
+    if (m_postFramesLeft == 0) {
+        freeze();
+    }
+    return true;
+}
+
+/**
+ * @brief Checks whether a post-trigger window is being captured.
+ * @return True while capturing, false otherwise.
+ */
+bool FlightRecorder::isCapturing() const {
+    return m_postFramesLeft > 0;
+}
+
+/**
+ * @brief Hands the active ring to the writer and continues in the other one, if free.
+ */
+void FlightRecorder::freeze() {
+    CaptureRing& ring = m_rings[m_activeRing];
+    ring.captureNumber = m_captureCount++;
+    ring.frozen.store(true, std::memory_order_release);
+
+    int other = 1 - m_activeRing;
+    m_activeRing = -1;
+    if (!m_rings[other].frozen.load(std::memory_order_acquire)) {
+        m_activeRing = other;
+        m_rings[other].next = 0;
+        m_rings[other].count = 0;
+    }
+}
+
+/**
+ * @brief Writes every frozen capture on the calling thread.
+ * For use when no writer thread is running.
+ * @return Number of freeze-frame files written.
+ */
+uint32_t FlightRecorder::writePending() {
+    uint32_t written = 0;
+    for (CaptureRing& ring : m_rings) {
+        if (!ring.frozen.load(std::memory_order_acquire)) {
+            continue;
+        }
+        if (writeRing(ring)) {
+            m_written.fetch_add(1, std::memory_order_relaxed);
+            ++written;
+        }
+        ring.frozen.store(false, std::memory_order_release);
+    }
+    return written;
+}
+
+/**
+ * @brief Writes one frozen ring to its freeze-frame file (writer side).
+ * The frames are written oldest first; the trigger frame is the last of the pre-trigger
+ * window, FLIGHT_RECORDER_POST_FRAMES before the end.
+ * @param ring The ring to write.
+ * @return True on success, false otherwise.
+ */
+bool FlightRecorder::writeRing(const CaptureRing& ring) const {
+    FreezeFrameHeader header{};
+    header.magic = FLIGHT_RECORDER_MAGIC;
+    header.version = FLIGHT_RECORDER_VERSION;
+    header.frameSize = sizeof(FlightRecorderFrame);
+    header.frameCount = ring.count;
+    header.triggerFrame = ring.count - 1 - FLIGHT_RECORDER_POST_FRAMES;
+    header.captureNumber = ring.captureNumber;
+    std::memcpy(header.reason, ring.reason, EVENT_TEXT_LENGTH);
+
+    std::ofstream file(m_filePrefix + "_" + std::to_string(ring.captureNumber) + ".bin", std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint32_t oldest = ring.count < RING_FRAMES ? 0 : ring.next;
+    // The ring in chronological order is the tail from the oldest slot followed by the head
+    file.write(reinterpret_cast<const char*>(&ring.frames[oldest]), sizeof(FlightRecorderFrame) * (ring.count - oldest));
+    file.write(reinterpret_cast<const char*>(&ring.frames[0]), sizeof(FlightRecorderFrame) * oldest);
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief Body of the writer thread.
+ * Writes frozen captures and naps briefly whenever there is none.
+ */
+void FlightRecorder::writeLoop() {
+    while (m_running.load(std::memory_order_acquire)) {
+        if (writePending() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(FLIGHT_RECORDER_WRITER_IDLE_MS));
+        }
+    }
+}
+
+/**
+ * @brief Gets the number of freeze-frame files written.
+ * @return Number of files.
+ */
+uint32_t FlightRecorder::getWrittenCount() const {
+    return m_written.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the number of triggers and frames dropped because both rings waited for the writer.
+ * @return Number of dropped triggers plus dropped frames.
+ */
+uint64_t FlightRecorder::getDroppedCount() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Reads a freeze-frame file.
+ * @param path The file to read.
+ * @param header Receives the header.
+ * @param frames Receives the frames, oldest first.
+ * @return True if a valid file of this layout was read, false otherwise.
+ */
+bool FlightRecorder::readFreezeFrame(const std::string& path, FreezeFrameHeader& header, std::vector<FlightRecorderFrame>& frames) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    if (header.magic != FLIGHT_RECORDER_MAGIC || header.version != FLIGHT_RECORDER_VERSION
+        || header.frameSize != sizeof(FlightRecorderFrame) || header.frameCount > RING_FRAMES
+        || header.triggerFrame >= header.frameCount) {
+        return false;
+    }
+    frames.resize(header.frameCount);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(frames.data()), sizeof(FlightRecorderFrame) * header.frameCount));
+}
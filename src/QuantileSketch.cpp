@@ -0,0 +1,242 @@
+// src/QuantileSketch.cpp
+#include "../inc/QuantileSketch.h"
+#include <algorithm> // For std::sort, std::min, std::max
+#include <cmath>     // For std::asin, std::sin
+#include <cstdint>   // For uint32_t
+#include <cstring>   // For std::memcpy
+#include <limits>    // For std::numeric_limits
+
+namespace {
+const double PI = 3.14159265358979323846;
+
+/**
+ * @brief t-digest scale function k1: maps a quantile to a position on the k scale.
+ * Centroids may span at most one unit of k, which keeps tail centroids small.
+ */
+inline double scaleK(double q) {
+    q = std::min(1.0, std::max(0.0, q));
+    return SKETCH_COMPRESSION / (2.0 * PI) * std::asin(2.0 * q - 1.0);
+}
+
+/**
+ * @brief Inverse of scaleK().
+ */
+inline double scaleKInverse(double k) {
+    double angle = k * 2.0 * PI / SKETCH_COMPRESSION;
+    if (angle >= PI / 2.0) return 1.0;
+    return (std::sin(angle) + 1.0) / 2.0;
+}
+
+/**
+ * @brief Sorts floats ascending with a least-significant-digit radix sort, 8 bits per pass.
+ * The bit patterns are mapped to unsigned keys in the same order (negative values have
+ * all bits flipped, positive ones only the sign bit). Linear in the number of values,
+ * where a comparison sort of a batch of random values spends most of its time on
+ * mispredicted branches. The values must not be NaN.
+ * @param values The values to sort, in place.
+ * @param count Number of values (at most SKETCH_VALUE_BUFFER_SIZE).
+ */
+void radixSort(float* values, size_t count) {
+    std::array<uint32_t, SKETCH_VALUE_BUFFER_SIZE> keys;
+    std::array<uint32_t, SKETCH_VALUE_BUFFER_SIZE> scratch;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        keys[i] = bits ^ ((bits & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u);
+    }
+    uint32_t* source = keys.data();
+    uint32_t* target = scratch.data();
+    for (uint32_t shift = 0; shift < 32; shift += 8) {
+        std::array<size_t, 256> offsets{};
+        for (size_t i = 0; i < count; ++i) {
+            ++offsets[(source[i] >> shift) & 0xFFu];
+        }
+        size_t offset = 0;
+        for (size_t& bucket : offsets) {
+            size_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            target[offsets[(source[i] >> shift) & 0xFFu]++] = source[i];
+        }
+        std::swap(source, target);
+    }
+    for (size_t i = 0; i < count; ++i) { // After an even number of passes the keys are back in keys
+        uint32_t bits = source[i] ^ ((source[i] & 0x80000000u) ? 0x80000000u : 0xFFFFFFFFu);
+        std::memcpy(&values[i], &bits, sizeof(bits));
+    }
+}
+} // namespace
+
+/**
+ * @brief Constructor for QuantileSketch.
+ * Starts empty.
+ */
+QuantileSketch::QuantileSketch() {
+    clear();
+}
+
+/**
+ * @brief Removes all values.
+ */
+void QuantileSketch::clear() {
+    m_centroidCount = 0;
+    m_bufferCount = 0;
+    m_valueCount = 0;
+    m_totalWeight = 0.0;
+    m_min = std::numeric_limits<double>::infinity();
+    m_max = -std::numeric_limits<double>::infinity();
+}
+
+/**
+ * @brief Adds a weighted centroid to the buffer, compressing first if it is full.
+ * @param centroid The centroid to add.
+ */
+void QuantileSketch::addCentroid(const Centroid& centroid) {
+    if (m_bufferCount == SKETCH_BUFFER_SIZE) {
+        flush();
+    }
+    m_buffer[m_bufferCount++] = centroid;
+    m_totalWeight += centroid.weight;
+}
+
+/**
+ * @brief Adds one value to the sketch.
+ * Only stores the value; the extremes are taken from the sorted batch on compression.
+ * @param value The value to add.
+ */
+void QuantileSketch::add(float value) {
+    if (std::isnan(value)) return;
+    if (m_valueCount == SKETCH_VALUE_BUFFER_SIZE) {
+        flush();
+    }
+    m_values[m_valueCount++] = value;
+    m_totalWeight += 1.0;
+}
+
+/**
+ * @brief Merges another sketch into this one.
+ * Feeds the other sketch's centroids and buffered values through the buffer,
+ * so merging costs O(centroids) regardless of how many values they summarise.
+ * @param other The sketch to merge in.
+ */
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.m_totalWeight <= 0.0) return;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    for (size_t i = 0; i < other.m_centroidCount; ++i) {
+        addCentroid(other.m_centroids[i]);
+    }
+    for (size_t i = 0; i < other.m_bufferCount; ++i) {
+        addCentroid(other.m_buffer[i]);
+    }
+    for (size_t i = 0; i < other.m_valueCount; ++i) {
+        add(other.m_values[i]);
+    }
+}
+
+/**
+ * @brief Folds all buffered values into the centroids.
+ * Sorts the buffered values as floats and the merged-in centroids by mean, then walks them
+ * in order together with the (already sorted) centroids and greedily merges neighbours as
+ * long as the merged centroid spans at most one unit of the k1 scale.
+ */
+void QuantileSketch::flush() {
+    if (m_bufferCount == 0 && m_valueCount == 0) return;
+
+    auto byMean = [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; };
+    std::sort(m_buffer.begin(), m_buffer.begin() + m_bufferCount, byMean);
+    std::array<Centroid, MAX_CENTROIDS + SKETCH_BUFFER_SIZE> centroids;
+    size_t centroidCount = std::merge(m_centroids.begin(), m_centroids.begin() + m_centroidCount,
+                                      m_buffer.begin(), m_buffer.begin() + m_bufferCount,
+                                      centroids.begin(), byMean) - centroids.begin();
+    const size_t valueCount = m_valueCount;
+    radixSort(m_values.data(), valueCount);
+    if (valueCount > 0) {
+        m_min = std::min(m_min, static_cast<double>(m_values[0]));
+        m_max = std::max(m_max, static_cast<double>(m_values[valueCount - 1]));
+    }
+
+    m_centroidCount = 0;
+    m_bufferCount = 0;
+    m_valueCount = 0;
+
+    // Takes the next centroid or value in order of mean
+    size_t c = 0;
+    size_t v = 0;
+    auto next = [&]() -> Centroid {
+        if (v == valueCount || (c < centroidCount && centroids[c].mean < m_values[v])) {
+            return centroids[c++];
+        }
+        return {static_cast<double>(m_values[v++]), 1.0};
+    };
+
+    // The open centroid is kept as a weighted sum, and its quantile limit as a weight, so
+    // absorbing an item costs no division
+    Centroid item = next();
+    double sum = item.mean * item.weight;
+    double weight = item.weight;
+    double weightBefore = 0.0;
+    double weightLimit = scaleKInverse(scaleK(0.0) + 1.0) * m_totalWeight;
+    for (size_t i = 1; i < centroidCount + valueCount; ++i) {
+        item = next();
+        if (weightBefore + weight + item.weight <= weightLimit || m_centroidCount == MAX_CENTROIDS - 1) {
+            sum += item.mean * item.weight;
+            weight += item.weight;
+        } else {
+            m_centroids[m_centroidCount++] = {sum / weight, weight};
+            weightBefore += weight;
+            weightLimit = scaleKInverse(scaleK(weightBefore / m_totalWeight) + 1.0) * m_totalWeight;
+            sum = item.mean * item.weight;
+            weight = item.weight;
+        }
+    }
+    m_centroids[m_centroidCount++] = {sum / weight, weight};
+}
+
+/**
+ * @brief Estimates a quantile of all values added so far.
+ * Interpolates linearly between centroid centres, and towards the exact minimum and
+ * maximum beyond the first and last centre.
+ * @param q The quantile (0.0 to 1.0), e.g. 0.99 for p99.
+ * @return The estimated value, or 0.0 if the sketch is empty.
+ */
+float QuantileSketch::quantile(float q) const {
+    if (m_totalWeight <= 0.0) return 0.0f;
+    if (m_bufferCount > 0 || m_valueCount > 0) {
+        QuantileSketch flushed = *this;
+        flushed.flush();
+        return flushed.quantile(q);
+    }
+
+    double target = std::min(1.0, std::max(0.0, static_cast<double>(q))) * m_totalWeight;
+    double cumulative = 0.0;
+    double previousCenter = 0.0;
+    for (size_t i = 0; i < m_centroidCount; ++i) {
+        const Centroid& c = m_centroids[i];
+        double center = cumulative + c.weight / 2.0;
+        if (target < center) {
+            if (i == 0) {
+                return static_cast<float>(m_min + (c.mean - m_min) * (target / center));
+            }
+            const Centroid& prev = m_centroids[i - 1];
+            return static_cast<float>(prev.mean + (c.mean - prev.mean) * (target - previousCenter) / (center - previousCenter));
+        }
+        previousCenter = center;
+        cumulative += c.weight;
+    }
+
+    const Centroid& last = m_centroids[m_centroidCount - 1];
+    double tail = m_totalWeight - previousCenter;
+    if (tail <= 0.0) return static_cast<float>(m_max);
+    return static_cast<float>(last.mean + (m_max - last.mean) * (target - previousCenter) / tail);
+}
+
+/**
+ * @brief Gets the number of values added so far.
+ * @return Number of values.
+ */
+double QuantileSketch::getCount() const {
+    return m_totalWeight;
+}
@@ -0,0 +1,134 @@
+// src/ResidencyHistogram.cpp
+#include "../inc/ResidencyHistogram.h"
+#include <iomanip> // For std::setw, std::setfill
+#include <limits>  // For std::numeric_limits
+
+namespace {
+// Bin widths derived once from the configured ranges
+const float VOLTAGE_BINS_PER_VOLT = RESIDENCY_VOLTAGE_BINS / (RESIDENCY_VOLTAGE_MAX_V - RESIDENCY_VOLTAGE_MIN_V);
+const float TEMP_BINS_PER_DEGREE = RESIDENCY_TEMP_BINS / (RESIDENCY_TEMP_MAX_C - RESIDENCY_TEMP_MIN_C);
+
+/**
+ * @brief Maps a value to a bin index with a direct computation, clamped to the edge bins.
+ * @param value The value to bin.
+ * @param minValue The lower edge of the first bin.
+ * @param binsPerUnit The number of bins per unit of value.
+ * @param binCount The number of bins.
+ * @return The bin index.
+ */
+inline uint32_t binIndex(float value, float minValue, float binsPerUnit, uint8_t binCount) {
+    float position = (value - minValue) * binsPerUnit;
+    if (!(position > 0.0f)) return 0; // Also catches NaN
+    uint32_t index = static_cast<uint32_t>(position);
+    return (index < binCount) ? index : static_cast<uint32_t>(binCount - 1);
+}
+} // namespace
+
+/**
+ * @brief Constructor for ResidencyHistogram.
+ * Starts with all times at zero.
+ */
+ResidencyHistogram::ResidencyHistogram() {
+    clear();
+}
+
+/**
+ * @brief Computes the voltage bin index for a reading.
+ * @param voltage The voltage in Volts.
+ * @return The bin index, clamped to the edge bins.
+ */
+uint32_t ResidencyHistogram::voltageBin(float voltage) {
+    return binIndex(voltage, RESIDENCY_VOLTAGE_MIN_V, VOLTAGE_BINS_PER_VOLT, RESIDENCY_VOLTAGE_BINS);
+}
+
+/**
+ * @brief Computes the temperature bin index for a reading.
+ * @param temperature The temperature in Celsius.
+ * @return The bin index, clamped to the edge bins.
+ */
+uint32_t ResidencyHistogram::temperatureBin(float temperature) {
+    return binIndex(temperature, RESIDENCY_TEMP_MIN_C, TEMP_BINS_PER_DEGREE, RESIDENCY_TEMP_BINS);
+}
+
+/**
+ * @brief Records one update worth of residency for every cell.
+ * Bin offsets for all cells are computed first, then the whole milliseconds of the time
+ * step are added to the bins; all cells share the same step, so one carry serves them all.
+ * @param cells An array of BatteryCell objects holding the latest readings.
+ * @param deltaTime_s The time the readings stand for in seconds.
+ */
+void ResidencyHistogram::record(const std::array<BatteryCell, NUM_CELLS>& cells, float deltaTime_s) {
+    if (!(deltaTime_s > 0.0f)) return; // Also catches NaN
+    double elapsed_ms = m_carry_ms + static_cast<double>(deltaTime_s) * 1000.0;
+    uint64_t step_ms = static_cast<uint64_t>(elapsed_ms);
+    m_carry_ms = elapsed_ms - static_cast<double>(step_ms);
+
+    std::array<uint32_t, NUM_CELLS> offsets;
+    for (uint8_t i = 0; i < NUM_CELLS; ++i) {
+        offsets[i] = i * RESIDENCY_BINS_PER_CELL
+                   + voltageBin(cells[i].getVoltage()) * RESIDENCY_TEMP_BINS
+                   + temperatureBin(cells[i].getTemperature());
+    }
+    for (uint32_t offset : offsets) {
+        uint64_t sum = m_times_ms[offset] + step_ms;
+        m_times_ms[offset] = (sum < step_ms) ? std::numeric_limits<uint64_t>::max() : sum;
+    }
+}
+
+/**
+ * @brief Adds the times of another histogram, e.g. from another pack.
+ * Times saturate instead of wrapping around.
+ * @param other The histogram to merge in.
+ */
+void ResidencyHistogram::merge(const ResidencyHistogram& other) {
+    for (size_t i = 0; i < m_times_ms.size(); ++i) {
+        uint64_t sum = m_times_ms[i] + other.m_times_ms[i];
+        m_times_ms[i] = (sum < m_times_ms[i]) ? std::numeric_limits<uint64_t>::max() : sum;
+    }
+}
+
+/**
+ * @brief Resets all times to zero.
+ */
+void ResidencyHistogram::clear() {
+    m_times_ms.fill(0);
+    m_carry_ms = 0.0;
+}
+
+/**
+ * @brief Gets the time a cell spent in a bin.
+ * @param cellId The ID of the cell.
+ * @param voltageBin The voltage bin index (0 to RESIDENCY_VOLTAGE_BINS - 1).
+ * @param temperatureBin The temperature bin index (0 to RESIDENCY_TEMP_BINS - 1).
+ * @return The time in milliseconds, or 0 for an invalid index.
+ */
+uint64_t ResidencyHistogram::getTime_ms(uint8_t cellId, uint8_t voltageBin, uint8_t temperatureBin) const {
+    if (cellId >= NUM_CELLS || voltageBin >= RESIDENCY_VOLTAGE_BINS || temperatureBin >= RESIDENCY_TEMP_BINS) {
+        return 0;
+    }
+    return m_times_ms[cellId * RESIDENCY_BINS_PER_CELL + voltageBin * RESIDENCY_TEMP_BINS + temperatureBin];
+}
+
+/**
+ * @brief Writes all non-empty bins as CSV.
+ * Columns: cell, voltage bin range, temperature bin range and time in seconds.
+ * @param out The stream to write to.
+ */
+void ResidencyHistogram::exportCsv(std::ostream& out) const {
+    out << "cell,voltage_min_V,voltage_max_V,temp_min_C,temp_max_C,time_s\n";
+    for (uint8_t cell = 0; cell < NUM_CELLS; ++cell) {
+        for (uint8_t v = 0; v < RESIDENCY_VOLTAGE_BINS; ++v) {
+            for (uint8_t t = 0; t < RESIDENCY_TEMP_BINS; ++t) {
+                uint64_t time_ms = getTime_ms(cell, v, t);
+                if (time_ms == 0) continue;
+                out << static_cast<int>(cell) << ','
+                    << RESIDENCY_VOLTAGE_MIN_V + v / VOLTAGE_BINS_PER_VOLT << ','
+                    << RESIDENCY_VOLTAGE_MIN_V + (v + 1) / VOLTAGE_BINS_PER_VOLT << ','
+                    << RESIDENCY_TEMP_MIN_C + t / TEMP_BINS_PER_DEGREE << ','
+                    << RESIDENCY_TEMP_MIN_C + (t + 1) / TEMP_BINS_PER_DEGREE << ','
+                    << time_ms / 1000 << '.' << std::setw(3) << std::setfill('0') << time_ms % 1000
+                    << std::setfill(' ') << '\n';
+            }
+        }
+    }
+}
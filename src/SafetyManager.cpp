@@ -1,87 +1,83 @@
 // src/SafetyManager.cpp
 #include "../inc/SafetyManager.h"
-#include <iostream> // For printing state transitions
+#include "../inc/CellKernels.h" // For PackCellKernels and the SAFETY_FLAG_* classifiers
+#include <algorithm> // For std::min, std::max, std::copy
 
-/**
- * @brief Constructor for SafetyManager.
- * Initializes the system state to NORMAL.
- */
-SafetyManager::SafetyManager() : m_currentState(SystemState::NORMAL) {}
-
-/**
- * @brief Checks if a given voltage is within the normal operating range.
- * @param voltage The voltage to check.
- * @return True if voltage is normal, false otherwise.
- */
-bool SafetyManager::isVoltageNormal(float voltage) const {
-    return voltage >= MIN_VOLTAGE_NORMAL && voltage <= MAX_VOLTAGE_NORMAL;
-}
-
-/**
- * @brief Checks if a given voltage is in the warning range.
- * @param voltage The voltage to check.
- * @return True if voltage is in warning, false otherwise.
- */
-bool SafetyManager::isVoltageWarning(float voltage) const {
-    return (voltage >= MIN_VOLTAGE_WARNING && voltage < MIN_VOLTAGE_NORMAL) ||
-           (voltage > MAX_VOLTAGE_NORMAL && voltage <= MAX_VOLTAGE_WARNING);
-}
+namespace {
+// Proposed state of every combination of condition flags (see CellKernels.h)
+const SystemState STATE_OF_FLAGS[8] = {
+    SystemState::NORMAL,   SystemState::WARNING, SystemState::CRITICAL, SystemState::CRITICAL,
+    SystemState::FAULT,    SystemState::FAULT,   SystemState::FAULT,    SystemState::FAULT
+};
 
 /**
- * @brief Checks if a given voltage is in the critical range.
- * @param voltage The voltage to check.
- * @return True if voltage is critical, false otherwise.
- */
-bool SafetyManager::isVoltageCritical(float voltage) const {
-    return (voltage >= MIN_VOLTAGE_CRITICAL && voltage < MIN_VOLTAGE_WARNING) ||
-           (voltage > MAX_VOLTAGE_WARNING && voltage <= MAX_VOLTAGE_CRITICAL);
-}
-
-/**
- * @brief Checks if a given voltage is in the fault range (e.g., sensor error).
- * @param voltage The voltage to check.
- * @return True if voltage is fault, false otherwise.
- */
-bool SafetyManager::isVoltageFault(float voltage) const {
-    return voltage < MIN_VOLTAGE_FAULT || voltage > MAX_VOLTAGE_FAULT;
-}
-
-/**
- * @brief Checks if a given temperature is within the normal operating range.
- * @param temperature The temperature to check.
- * @return True if temperature is normal, false otherwise.
+ * @brief Classifies the pack current and State of Health of a frame.
+ * @param current The pack current.
+ * @param soh The SoH percentage.
+ * @return Condition flags (0 for normal).
  */
-bool SafetyManager::isTemperatureNormal(float temperature) const {
-    return temperature >= MIN_TEMP_NORMAL && temperature <= MAX_TEMP_NORMAL;
+inline uint32_t packFlags(float current, float soh) {
+    uint32_t charging = current > IDLE_CURRENT_THRESHOLD_A;
+    uint32_t discharging = current < -IDLE_CURRENT_THRESHOLD_A;
+    uint32_t warning = (charging & (current > MAX_CHARGE_CURRENT_NORMAL_A) & (current <= MAX_CHARGE_CURRENT_WARNING_A))
+                 | (discharging & (current < -MAX_DISCHARGE_CURRENT_NORMAL_A) & (current >= -MAX_DISCHARGE_CURRENT_WARNING_A))
+                 | ((soh >= SOH_THRESHOLD_CRITICAL) & (soh < SOH_THRESHOLD_WARNING));
+    uint32_t critical = (charging & (current > MAX_CHARGE_CURRENT_WARNING_A) & (current <= MAX_CHARGE_CURRENT_CRITICAL_A))
+                  | (discharging & (current < -MAX_DISCHARGE_CURRENT_WARNING_A) & (current >= -MAX_DISCHARGE_CURRENT_CRITICAL_A))
+                  | (soh < SOH_THRESHOLD_CRITICAL);
+    return warning * SAFETY_FLAG_WARNING | critical * SAFETY_FLAG_CRITICAL;
 }
 
 /**
- * @brief Checks if a given temperature is in the warning range.
- * @param temperature The temperature to check.
- * @return True if temperature is in warning, false otherwise.
+ * @brief Input frames of one batch block, used to pad the last, partial block.
  */
-bool SafetyManager::isTemperatureWarning(float temperature) const {
-    return (temperature >= MIN_TEMP_WARNING && temperature < MIN_TEMP_NORMAL) ||
-           (temperature > MAX_TEMP_NORMAL && temperature <= MAX_TEMP_WARNING);
-}
+struct BatchBlock {
+    std::array<float, SAFETY_BATCH_BLOCK_FRAMES * NUM_CELLS> voltages;
+    std::array<float, SAFETY_BATCH_BLOCK_FRAMES * NUM_CELLS> temperatures;
+    std::array<float, SAFETY_BATCH_BLOCK_FRAMES> currents;
+    std::array<float, SAFETY_BATCH_BLOCK_FRAMES> soh;
+};
 
 /**
- * @brief Checks if a given temperature is in the critical range.
- * @param temperature The temperature to check.
- * @return True if temperature is critical, false otherwise.
+ * @brief Computes the condition flags of every frame of one full block.
+ * All loops have a fixed trip count and no branches, so the compiler vectorizes them.
+ * @param voltages SAFETY_BATCH_BLOCK_FRAMES x NUM_CELLS cell voltages, frame-major.
+ * @param temperatures SAFETY_BATCH_BLOCK_FRAMES x NUM_CELLS cell temperatures, frame-major.
+ * @param currents SAFETY_BATCH_BLOCK_FRAMES pack currents.
+ * @param soh SAFETY_BATCH_BLOCK_FRAMES SoH values.
+ * @param frameFlags Output, the condition flags of every frame.
  */
-bool SafetyManager::isTemperatureCritical(float temperature) const {
-    return (temperature >= MIN_TEMP_CRITICAL && temperature < MIN_TEMP_WARNING) ||
-           (temperature > MAX_TEMP_WARNING && temperature <= MAX_TEMP_CRITICAL);
+void classifyBlock(const float* voltages, const float* temperatures, const float* currents, const float* soh,
+                   std::array<uint8_t, SAFETY_BATCH_BLOCK_FRAMES>& frameFlags) {
+    std::array<uint32_t, SAFETY_BATCH_BLOCK_FRAMES * NUM_CELLS> cellFlags;
+    for (size_t i = 0; i < cellFlags.size(); ++i) {
+        cellFlags[i] = cellVoltageFlags(voltages[i]) | cellTemperatureFlags(temperatures[i]);
+    }
+    std::array<uint32_t, SAFETY_BATCH_BLOCK_FRAMES> packFlagsOfFrame;
+    for (size_t t = 0; t < SAFETY_BATCH_BLOCK_FRAMES; ++t) {
+        packFlagsOfFrame[t] = packFlags(currents[t], soh[t]);
+    }
+    for (size_t t = 0; t < SAFETY_BATCH_BLOCK_FRAMES; ++t) {
+        uint32_t flags = packFlagsOfFrame[t];
+        for (size_t c = 0; c < NUM_CELLS; ++c) {
+            flags |= cellFlags[t * NUM_CELLS + c];
+        }
+        frameFlags[t] = static_cast<uint8_t>(flags);
+    }
 }
+} // namespace
 
 /**
- * @brief Checks if a given temperature is in the fault range.
- * @param temperature The temperature to check.
- * @return True if temperature is fault, false otherwise.
+ * @brief Constructor for SafetyManager.
+ * Initializes the system state to NORMAL.
  */
-bool SafetyManager::isTemperatureFault(float temperature) const {
-    return temperature < MIN_TEMP_FAULT || temperature > MAX_TEMP_FAULT;
+SafetyManager::SafetyManager()
+    : m_currentState(SystemState::NORMAL),
+      m_previousState(SystemState::NORMAL),
+      m_overloadIntegral_A2s(0.0f),
+      m_overloadTripped(false),
+      m_bandTable(nullptr)
+{
 }
 
 /**
@@ -156,71 +152,243 @@ bool SafetyManager::isSoHCritical(float soh) const {
 
 /**
  * @brief Evaluates the current state of the battery cells and pack current and updates the system state.
- * This is the core logic for determining the BMS's safety status.
  * @param cells An array of BatteryCell objects representing the current battery pack data.
  * @param packCurrent The total current flowing through the battery pack (Amperes).
  * @param stateOfHealth_percent The current estimated State of Health of the battery pack (%).
  */
 void SafetyManager::evaluate(const std::array<BatteryCell, NUM_CELLS>& cells, float packCurrent, float stateOfHealth_percent) {
-    SystemState proposedState = SystemState::NORMAL;
+    applyState(proposeState(cells, packCurrent, stateOfHealth_percent));
+}
+
+/**
+ * @brief Computes the state the given readings call for, without changing the system state.
+ * This is the core logic for determining the BMS's safety status. The cell readings are
+ * classified with the cell-count-specific kernels of CellKernels.h; the most severe
+ * condition of cells, current and SoH wins, as in the FAULT / CRITICAL / WARNING cascade.
+ * @param cells An array of BatteryCell objects representing the current battery pack data.
+ * @param packCurrent The total current flowing through the battery pack (Amperes).
+ * @param stateOfHealth_percent The current estimated State of Health of the battery pack (%).
+ * @return The proposed SystemState, i.e. the most severe condition found.
+ */
+SystemState SafetyManager::proposeState(const std::array<BatteryCell, NUM_CELLS>& cells, float packCurrent, float stateOfHealth_percent) const {
+    std::array<float, NUM_CELLS> voltages;
+    std::array<float, NUM_CELLS> temperatures;
+    PackCellKernels<NUM_CELLS>::gather(cells, voltages.data(), temperatures.data());
+    const uint32_t cellFlags = PackCellKernels<NUM_CELLS>::safetyFlags(voltages.data(), temperatures.data());
 
     // Check for FAULT conditions first (most severe)
-    for (const auto& cell : cells) {
-        if (isVoltageFault(cell.getVoltage()) || isTemperatureFault(cell.getTemperature())) {
-            proposedState = SystemState::FAULT;
-            break; // Immediate FAULT, no need to check further
-        }
+    if (cellFlags & SAFETY_FLAG_FAULT) {
+        return SystemState::FAULT;
     }
+    // Check for CRITICAL conditions
+    if (isCurrentCritical(packCurrent) || isSoHCritical(stateOfHealth_percent) || (cellFlags & SAFETY_FLAG_CRITICAL)) {
+        return SystemState::CRITICAL;
+    }
+    // Check for WARNING conditions
+    if (isCurrentWarning(packCurrent) || isSoHWarning(stateOfHealth_percent) || (cellFlags & SAFETY_FLAG_WARNING)) {
+        return SystemState::WARNING;
+    }
+    return SystemState::NORMAL;
+}
+
+/**
+ * @brief Makes a proposed state the current state, as the end of evaluate() does.
+ * The caller reports transitions (see hasStateChanged()).
+ * @param proposedState The new state.
+ */
+void SafetyManager::applyState(SystemState proposedState) {
+    m_previousState = m_currentState;
+    m_currentState = proposedState;
+}
+
+/**
+ * @brief Computes the proposed state of many frames (or packs) at once with vectorized loops.
+ * The proposed state of a frame is its most severe condition, which is what the
+ * FAULT / CRITICAL / WARNING cascade of proposeState() computes. Frames are classified in
+ * blocks of SAFETY_BATCH_BLOCK_FRAMES (see classifyBlock()); the last, partial block is
+ * padded.
+ * @param frames The frames to classify.
+ * @param proposedStates Output array of frames.frameCount states.
+ */
+void SafetyManager::proposeStates(const SafetyFrames& frames, SystemState* proposedStates) {
+    std::array<uint8_t, SAFETY_BATCH_BLOCK_FRAMES> frameFlags;
+    for (size_t first = 0; first < frames.frameCount; first += SAFETY_BATCH_BLOCK_FRAMES) {
+        const size_t count = std::min<size_t>(SAFETY_BATCH_BLOCK_FRAMES, frames.frameCount - first);
+        const float* voltages = frames.cellVoltages + first * NUM_CELLS;
+        const float* temperatures = frames.cellTemperatures + first * NUM_CELLS;
+        const float* currents = frames.packCurrents + first;
+        const float* soh = frames.stateOfHealth_percent + first;
 
-    if (proposedState != SystemState::FAULT) {
-        // Check for CRITICAL conditions
-        if (isCurrentCritical(packCurrent) || isSoHCritical(stateOfHealth_percent)) {
-            proposedState = SystemState::CRITICAL;
+        if (count == SAFETY_BATCH_BLOCK_FRAMES) {
+            classifyBlock(voltages, temperatures, currents, soh, frameFlags);
         } else {
-            for (const auto& cell : cells) {
-                if (isVoltageCritical(cell.getVoltage()) || isTemperatureCritical(cell.getTemperature())) {
-                    proposedState = SystemState::CRITICAL;
-                    break;
-                }
-            }
+            // Copy the last, partial block into a zero-padded full block; the padding frames are ignored
+            BatchBlock tail = {};
+            std::copy(voltages, voltages + count * NUM_CELLS, tail.voltages.begin());
+            std::copy(temperatures, temperatures + count * NUM_CELLS, tail.temperatures.begin());
+            std::copy(currents, currents + count, tail.currents.begin());
+            std::copy(soh, soh + count, tail.soh.begin());
+            classifyBlock(tail.voltages.data(), tail.temperatures.data(), tail.currents.data(), tail.soh.data(), frameFlags);
+        }
+
+        for (size_t t = 0; t < count; ++t) {
+            proposedStates[first + t] = STATE_OF_FLAGS[frameFlags[t]];
         }
     }
+}
 
-    if (proposedState == SystemState::NORMAL) { // Only check for WARNING if not already CRITICAL or FAULT
-        // Check for WARNING conditions
-        if (isCurrentWarning(packCurrent) || isSoHWarning(stateOfHealth_percent)) {
-            proposedState = SystemState::WARNING;
-        } else {
-            for (const auto& cell : cells) {
-                if (isVoltageWarning(cell.getVoltage()) || isTemperatureWarning(cell.getTemperature())) {
-                    proposedState = SystemState::WARNING;
-                    break;
-                }
+/**
+ * @brief Evaluates a series of recorded frames in one call, e.g. to replay logged data.
+ * Equivalent to calling evaluate() once per frame in order: states[t] is the state after
+ * frame t, and the manager is left in the state the last evaluate() call would leave it.
+ * The frames are classified with proposeStates() and the state series is then folded in
+ * order (see foldStates()).
+ * @param frames The recorded frames.
+ * @param states Output state series, resized to frames.frameCount.
+ * @return Number of state transitions in the series, counting one from the state before the batch.
+ */
+size_t SafetyManager::evaluateBatch(const SafetyFrames& frames, std::vector<SystemState>& states) {
+    states.resize(frames.frameCount);
+    if (frames.frameCount == 0) {
+        return 0;
+    }
+    proposeStates(frames, states.data());
+    return foldStates(states);
+}
+
+/**
+ * @brief Computes the proposed state of many frames of ADC codes at once.
+ * The lookup table gives the most severe band of a frame's cells directly (the bands are
+ * ordered like SystemState), which is combined with the band of the pack current and SoH.
+ * Without a table every block is converted to physical values, exactly as the table was
+ * built, and classified with the vectorized compare kernels of proposeStates().
+ * @param frames The frames to classify.
+ * @param table The band lookup table, or nullptr for the compare kernels.
+ * @param proposedStates Output array of frames.frameCount states.
+ */
+void SafetyManager::proposeStates(const SafetyCodeFrames& frames, const BandLookupTable* table, SystemState* proposedStates) {
+    if (table != nullptr) {
+        for (size_t t = 0; t < frames.frameCount; ++t) {
+            SystemState band = STATE_OF_FLAGS[packFlags(frames.packCurrents[t], frames.stateOfHealth_percent[t])];
+            for (size_t c = 0; c < NUM_CELLS; ++c) {
+                band = std::max(band, table->classifyVoltage(frames.cellVoltageCodes[t * NUM_CELLS + c]));
+                band = std::max(band, table->classifyTemperature(frames.cellTemperatureCodes[t * NUM_CELLS + c]));
             }
+            proposedStates[t] = band;
         }
+        return;
     }
 
-    // Update state and print transition if changed
-    if (proposedState != m_currentState) {
-        std::cout << "--- BMS STATE TRANSITION: ";
-        switch (m_currentState) {
-            case SystemState::NORMAL: std::cout << "NORMAL"; break;
-            case SystemState::WARNING: std::cout << "WARNING"; break;
-            case SystemState::CRITICAL: std::cout << "CRITICAL"; break;
-            case SystemState::FAULT: std::cout << "FAULT"; break;
+    // Entries of a last, partial block beyond its frames are left over from earlier blocks and ignored
+    BatchBlock block = {};
+    std::array<uint8_t, SAFETY_BATCH_BLOCK_FRAMES> frameFlags;
+    for (size_t first = 0; first < frames.frameCount; first += SAFETY_BATCH_BLOCK_FRAMES) {
+        const size_t count = std::min<size_t>(SAFETY_BATCH_BLOCK_FRAMES, frames.frameCount - first);
+        for (size_t i = 0; i < count * NUM_CELLS; ++i) {
+            block.voltages[i] = static_cast<float>(frames.cellVoltageCodes[first * NUM_CELLS + i]) * ADC_VOLTAGE_LSB_V;
+            block.temperatures[i] = static_cast<float>(frames.cellTemperatureCodes[first * NUM_CELLS + i]) * ADC_TEMPERATURE_LSB_C;
         }
-        std::cout << " -> ";
-        switch (proposedState) {
-            case SystemState::NORMAL: std::cout << "NORMAL"; break;
-            case SystemState::WARNING: std::cout << "WARNING"; break;
-            case SystemState::CRITICAL: std::cout << "CRITICAL"; break;
-            case SystemState::FAULT: std::cout << "FAULT"; break;
+        std::copy(frames.packCurrents + first, frames.packCurrents + first + count, block.currents.begin());
+        std::copy(frames.stateOfHealth_percent + first, frames.stateOfHealth_percent + first + count, block.soh.begin());
+        classifyBlock(block.voltages.data(), block.temperatures.data(), block.currents.data(), block.soh.data(), frameFlags);
+
+        for (size_t t = 0; t < count; ++t) {
+            proposedStates[first + t] = STATE_OF_FLAGS[frameFlags[t]];
         }
-        std::cout << " ---" << std::endl;
-        m_currentState = proposedState;
     }
 }
 
+/**
+ * @brief Evaluates a series of recorded frames of ADC codes in one call.
+ * As evaluateBatch() for physical values; classifies with the attached lookup table, if any.
+ * @param frames The recorded frames.
+ * @param states Output state series, resized to frames.frameCount.
+ * @return Number of state transitions in the series, counting one from the state before the batch.
+ */
+size_t SafetyManager::evaluateBatch(const SafetyCodeFrames& frames, std::vector<SystemState>& states) {
+    states.resize(frames.frameCount);
+    if (frames.frameCount == 0) {
+        return 0;
+    }
+    proposeStates(frames, m_bandTable, states.data());
+    return foldStates(states);
+}
+
+/**
+ * @brief Attaches an optional lookup table that classifies ADC codes in evaluateBatch().
+ * The table is used in place, so rebuilding it after the limits are reloaded takes
+ * effect with the next batch.
+ * @param table The table (not owned, may be null to classify with the compare kernels).
+ */
+void SafetyManager::setBandLookupTable(const BandLookupTable* table) {
+    m_bandTable = table;
+}
+
+/**
+ * @brief Folds a series of proposed states in order, as evaluate() once per frame would.
+ * evaluate() has no debounce or hysteresis, so the fold only tracks the previous state
+ * and counts transitions.
+ * @param states The proposed state of every frame (at least one).
+ * @return Number of state transitions in the series, counting one from the state before the batch.
+ */
+size_t SafetyManager::foldStates(const std::vector<SystemState>& states) {
+    SystemState previous = m_currentState;
+    size_t transitions = 0;
+    for (SystemState state : states) {
+        transitions += state != previous;
+        previous = state;
+    }
+
+    m_previousState = states.size() > 1 ? states[states.size() - 2] : m_currentState;
+    m_currentState = states.back();
+    return transitions;
+}
+
+/**
+ * @brief Advances the I2t overload integrator and computes the state it calls for.
+ * Fuse-like thermal model: the squared current above I2T_RATED_CURRENT_A heats the
+ * integrator, current below it cools it at the same rate, and it stays between zero and
+ * the trip level, so the cooling time after a trip does not grow with the overload.
+ * Short, large overloads and long, moderate ones trip at the same energy, which the
+ * instantaneous current limits cannot express. A trip holds until the integrator has
+ * cooled below I2T_WARNING_FRACTION of the trip level.
+ * @param meanSquareCurrent_A2 Mean of the squared pack current over the interval (A^2).
+ * @param deltaTime_s Length of the interval in seconds.
+ * @return FAULT while tripped, WARNING above I2T_WARNING_FRACTION of the trip level, NORMAL otherwise.
+ */
+SystemState SafetyManager::integrateOverload(float meanSquareCurrent_A2, float deltaTime_s) {
+    const float warningLevel_A2s = I2T_WARNING_FRACTION * I2T_TRIP_A2S;
+    float integral_A2s = m_overloadIntegral_A2s
+                       + (meanSquareCurrent_A2 - I2T_RATED_CURRENT_A * I2T_RATED_CURRENT_A) * deltaTime_s;
+    integral_A2s = integral_A2s < I2T_TRIP_A2S ? integral_A2s : I2T_TRIP_A2S;
+    m_overloadIntegral_A2s = integral_A2s > 0.0f ? integral_A2s : 0.0f;
+    if (m_overloadIntegral_A2s >= I2T_TRIP_A2S) {
+        m_overloadTripped = true;
+    } else if (m_overloadIntegral_A2s < warningLevel_A2s) {
+        m_overloadTripped = false;
+    }
+    if (m_overloadTripped) {
+        return SystemState::FAULT;
+    }
+    return m_overloadIntegral_A2s >= warningLevel_A2s ? SystemState::WARNING : SystemState::NORMAL;
+}
+
+/**
+ * @brief Gets the accumulated I2t of the overload integrator.
+ * @return Accumulated I2t in A^2 s.
+ */
+float SafetyManager::getOverloadIntegral_A2s() const {
+    return m_overloadIntegral_A2s;
+}
+
+/**
+ * @brief Checks whether the overload protection has tripped and not yet cleared.
+ * @return True if tripped, false otherwise.
+ */
+bool SafetyManager::isOverloadTripped() const {
+    return m_overloadTripped;
+}
+
 /**
  * @brief Gets the current safety state of the BMS.
  * @return The current SystemState.
@@ -228,3 +396,19 @@ void SafetyManager::evaluate(const std::array<BatteryCell, NUM_CELLS>& cells, fl
 SystemState SafetyManager::getCurrentState() const {
     return m_currentState;
 }
+
+/**
+ * @brief Gets the safety state before the last evaluation.
+ * @return The previous SystemState.
+ */
+SystemState SafetyManager::getPreviousState() const {
+    return m_previousState;
+}
+
+/**
+ * @brief Checks whether the last evaluation changed the state.
+ * @return True if the state changed, false otherwise.
+ */
+bool SafetyManager::hasStateChanged() const {
+    return m_currentState != m_previousState;
+}
@@ -0,0 +1,120 @@
+// src/SensorDiagnostics.cpp
+#include "../inc/SensorDiagnostics.h"
+#include <cmath> // For std::fabs
+#include "../inc/CellKernels.h" // For PackCellKernels
+
+/**
+ * @brief Constructor for SensorDiagnostics.
+ * Clears all per-cell history and flags.
+ */
+SensorDiagnostics::SensorDiagnostics()
+    : m_packSumMismatch(false),
+      m_hasHistory(false)
+{
+    m_lastVoltage.fill(0.0f);
+    m_lastTemperature.fill(0.0f);
+    m_voltageUnchanged.fill(0);
+    m_temperatureUnchanged.fill(0);
+    m_flags.fill(SENSOR_DIAG_OK);
+    m_raisedFlags.fill(SENSOR_DIAG_OK);
+}
+
+/**
+ * @brief Updates the diagnostic state with the latest readings.
+ * A reading that stays within its epsilon for DIAG_STUCK_WINDOW_TICKS consecutive
+ * updates has zero variance over the window and is flagged as stuck. The strings are in
+ * parallel, so the pack-voltage channel measures the mean of the string sums; it is checked
+ * against the mean of the cell taps' string sums, which a genuine cell condition moves just
+ * like the pack channel, while a single wrong tap moves only the taps' side. An
+ * out-of-range voltage is attributed to an open sense wire only if that check fails;
+ * otherwise it is treated as a genuine cell condition.
+ * @param cells An array of BatteryCell objects holding the latest readings.
+ * @param packVoltage The reading of the independent pack-voltage channel (Volts).
+ */
+void SensorDiagnostics::update(const std::array<BatteryCell, NUM_CELLS>& cells, float packVoltage) {
+    typedef PackCellKernels<NUM_CELLS> Kernels;
+    std::array<float, NUM_CELLS> voltages;
+    std::array<float, NUM_CELLS> temperatures;
+    Kernels::gather(cells, voltages.data(), temperatures.data());
+
+    // Pack-sum plausibility: the mean string sum of the cell taps and the pack channel must agree
+    float voltageSum_V = 0.0f;
+    for (uint8_t i = 0; i < NUM_CELLS; ++i) {
+        voltageSum_V += voltages[i];
+    }
+    float meanStringSum_V = voltageSum_V / NUM_PARALLEL_STRINGS;
+    m_packSumMismatch = std::fabs(meanStringSum_V - packVoltage) > DIAG_PACK_SUM_TOLERANCE_V;
+
+    // Incremental zero-variance check: count consecutive unchanged readings
+    Kernels::persistenceFilter(voltages.data(), m_lastVoltage.data(), m_voltageUnchanged.data(),
+                               DIAG_STUCK_VOLTAGE_EPSILON_V, DIAG_STUCK_WINDOW_TICKS, m_hasHistory);
+    Kernels::persistenceFilter(temperatures.data(), m_lastTemperature.data(), m_temperatureUnchanged.data(),
+                               DIAG_STUCK_TEMP_EPSILON_C, DIAG_STUCK_WINDOW_TICKS, m_hasHistory);
+
+    for (uint8_t i = 0; i < NUM_CELLS; ++i) {
+        float voltage = voltages[i];
+        float temperature = temperatures[i];
+
+        uint8_t flags = SENSOR_DIAG_OK;
+        if (m_voltageUnchanged[i] >= DIAG_STUCK_WINDOW_TICKS) {
+            flags |= SENSOR_DIAG_VOLTAGE_STUCK;
+        }
+        if (m_temperatureUnchanged[i] >= DIAG_STUCK_WINDOW_TICKS) {
+            flags |= SENSOR_DIAG_TEMPERATURE_STUCK;
+        }
+        // Open sense wire: tap reads at a rail while the pack channel says otherwise
+        if (m_packSumMismatch && (voltage < MIN_VOLTAGE_FAULT || voltage > MAX_VOLTAGE_FAULT)) {
+            flags |= SENSOR_DIAG_VOLTAGE_OPEN_WIRE;
+        }
+        // Open thermistor: reading pinned at the cold end of the measurement range
+        if (temperature < DIAG_THERMISTOR_OPEN_TEMP_C) {
+            flags |= SENSOR_DIAG_THERMISTOR_OPEN;
+        }
+
+        m_raisedFlags[i] = flags & static_cast<uint8_t>(~m_flags[i]);
+        m_flags[i] = flags;
+    }
+    m_hasHistory = true;
+}
+
+/**
+ * @brief Gets the diagnostic flags currently active for a cell.
+ * @param cellId The ID of the cell.
+ * @return Bit mask of SENSOR_DIAG_* flags.
+ */
+uint8_t SensorDiagnostics::getCellFlags(uint8_t cellId) const {
+    return (cellId < NUM_CELLS) ? m_flags[cellId] : SENSOR_DIAG_OK;
+}
+
+/**
+ * @brief Gets the diagnostic flags of a cell that were raised by the last update.
+ * @param cellId The ID of the cell.
+ * @return Bit mask of SENSOR_DIAG_* flags that were not active before the last update.
+ */
+uint8_t SensorDiagnostics::getRaisedFlags(uint8_t cellId) const {
+    return (cellId < NUM_CELLS) ? m_raisedFlags[cellId] : SENSOR_DIAG_OK;
+}
+
+/**
+ * @brief Checks whether the mean string sum of the cell voltages disagrees with the pack-voltage channel.
+ * @return True if the mismatch exceeds DIAG_PACK_SUM_TOLERANCE_V, false otherwise.
+ */
+bool SensorDiagnostics::isPackSumMismatch() const {
+    return m_packSumMismatch;
+}
+
+/**
+ * @brief Checks whether any sensor fault is currently active.
+ * @return True if any cell has a flag set or the pack sum mismatches, false otherwise.
+ */
+bool SensorDiagnostics::hasSensorFault() const {
+    if (m_packSumMismatch) {
+        return true;
+    }
+    for (uint8_t flags : m_flags) {
+        if (flags != SENSOR_DIAG_OK) {
+            return true;
+        }
+    }
+    return false;
+}
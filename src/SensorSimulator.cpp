@@ -3,64 +3,96 @@
 #include <chrono>   // For seeding the random number generator
 #include <iostream> // For printing simulation messages
 
+namespace {
+/**
+ * @brief Spread of the simulated cells of a pack.
+ * The strings share the pack's capacity, so each cell holds 1 / NUM_PARALLEL_STRINGS of it.
+ * @return The default CellVariability with the capacity divided between the strings.
+ */
+CellVariability stringCellVariability() {
+    CellVariability variability;
+    variability.capacity_mAh.mean /= NUM_PARALLEL_STRINGS;
+    variability.capacity_mAh.stddev /= NUM_PARALLEL_STRINGS;
+    return variability;
+}
+} // namespace
+
 /**
  * @brief Constructor for SensorSimulator.
  * Initializes the random number generator with a time-based seed.
+ * @param memory Memory resource the cell model is allocated from.
  */
-SensorSimulator::SensorSimulator()
+SensorSimulator::SensorSimulator(std::pmr::memory_resource* memory)
     : m_rng(std::chrono::high_resolution_clock::now().time_since_epoch().count()),
-      m_voltageDist(SIM_VOLTAGE_MIN, SIM_VOLTAGE_MAX),
-      m_tempDist(SIM_TEMP_MIN, SIM_TEMP_MAX),
+      m_noiseDist(0.0f, 1.0f),
       m_currentDist(SIM_CURRENT_MIN, SIM_CURRENT_MAX),
-      m_faultDist(0.0f, 1.0f) {}
+      m_faultDist(0.0f, 1.0f),
+      m_cellBank(NUM_CELLS, stringCellVariability(), static_cast<uint32_t>(m_rng()), memory),
+      m_consoleOutput(true),
+      m_faultInjection(true)
+{
+    m_cellVoltages.fill(0.0f);
+    m_stringCurrents.fill(0.0f);
+}
 
 /**
  * @brief Reads a simulated voltage for a given cell ID.
+ * The terminal voltage of the modelled cell under its string's current, plus noise.
  * Introduces occasional out-of-bounds readings for fault simulation.
  * @param cellId The ID of the cell to read voltage for.
  * @return Simulated voltage in Volts.
  */
 float SensorSimulator::readVoltage(uint8_t cellId) {
-    float voltage = m_voltageDist(m_rng);
+    float voltage = (cellId < NUM_CELLS) ? m_cellBank.getTerminalVoltage(cellId, m_stringCurrents[cellId / CELLS_PER_STRING]) : 0.0f;
+    voltage += m_noiseDist(m_rng) * SIM_CELL_VOLTAGE_NOISE_V;
+    float cellVoltage = voltage; // What the cell really holds, as seen by the pack channel
 
     // Introduce a fault sometimes
-    if (m_faultDist(m_rng) < SIM_FAULT_PROBABILITY) {
+    if (m_faultInjection && m_faultDist(m_rng) < SIM_FAULT_PROBABILITY) {
         float fault_val = m_faultDist(m_rng);
         if (fault_val < 0.33f) { // Low critical
             voltage = MIN_VOLTAGE_CRITICAL - (m_faultDist(m_rng) * 0.2f);
-            std::cout << "[SIM] Cell " << (int)cellId << " - Low Voltage Fault Injected (Critical)!" << std::endl;
+            if (m_consoleOutput) std::cout << "[SIM] Cell " << (int)cellId << " - Low Voltage Fault Injected (Critical)!" << std::endl;
         } else if (fault_val < 0.66f) { // High critical
             voltage = MAX_VOLTAGE_CRITICAL + (m_faultDist(m_rng) * 0.2f);
-            std::cout << "[SIM] Cell " << (int)cellId << " - High Voltage Fault Injected (Critical)!" << std::endl;
+            if (m_consoleOutput) std::cout << "[SIM] Cell " << (int)cellId << " - High Voltage Fault Injected (Critical)!" << std::endl;
         } else { // Extreme fault (e.g., sensor disconnect)
             voltage = (m_faultDist(m_rng) < 0.5f) ? MIN_VOLTAGE_FAULT - 0.1f : MAX_VOLTAGE_FAULT + 0.1f;
-            std::cout << "[SIM] Cell " << (int)cellId << " - Extreme Voltage Fault Injected (Sensor Error)!" << std::endl;
+            if (m_consoleOutput) std::cout << "[SIM] Cell " << (int)cellId << " - Extreme Voltage Fault Injected (Sensor Error)!" << std::endl;
         }
+        if (fault_val < 0.66f) { // Critical faults are real cell conditions
+            cellVoltage = voltage;
+        }
+    }
+    if (cellId < NUM_CELLS) {
+        m_cellVoltages[cellId] = cellVoltage;
     }
     return voltage;
 }
 
 /**
  * @brief Reads a simulated temperature for a given cell ID.
+ * The temperature of the modelled cell, plus noise.
  * Introduces occasional out-of-bounds readings for fault simulation.
  * @param cellId The ID of the cell to read temperature for.
  * @return Simulated temperature in Celsius.
  */
 float SensorSimulator::readTemperature(uint8_t cellId) {
-    float temperature = m_tempDist(m_rng);
+    float temperature = (cellId < NUM_CELLS) ? m_cellBank.getTemperatures_C()[cellId] : SIM_AMBIENT_TEMP_C;
+    temperature += m_noiseDist(m_rng) * SIM_CELL_TEMP_NOISE_C;
 
     // Introduce a fault sometimes
-    if (m_faultDist(m_rng) < SIM_FAULT_PROBABILITY) {
+    if (m_faultInjection && m_faultDist(m_rng) < SIM_FAULT_PROBABILITY) {
         float fault_val = m_faultDist(m_rng);
         if (fault_val < 0.33f) { // Low critical
             temperature = MIN_TEMP_CRITICAL - (m_faultDist(m_rng) * 5.0f);
-            std::cout << "[SIM] Cell " << (int)cellId << " - Low Temperature Fault Injected (Critical)!" << std::endl;
+            if (m_consoleOutput) std::cout << "[SIM] Cell " << (int)cellId << " - Low Temperature Fault Injected (Critical)!" << std::endl;
         } else if (fault_val < 0.66f) { // High critical
             temperature = MAX_TEMP_CRITICAL + (m_faultDist(m_rng) * 5.0f);
-            std::cout << "[SIM] Cell " << (int)cellId << " - High Temperature Fault Injected (Critical)!" << std::endl;
+            if (m_consoleOutput) std::cout << "[SIM] Cell " << (int)cellId << " - High Temperature Fault Injected (Critical)!" << std::endl;
         } else { // Extreme fault
             temperature = (m_faultDist(m_rng) < 0.5f) ? MIN_TEMP_FAULT - 1.0f : MAX_TEMP_FAULT + 1.0f;
-            std::cout << "[SIM] Cell " << (int)cellId << " - Extreme Temperature Fault Injected (Sensor Error)!" << std::endl;
+            if (m_consoleOutput) std::cout << "[SIM] Cell " << (int)cellId << " - Extreme Temperature Fault Injected (Sensor Error)!" << std::endl;
         }
     }
     return temperature;
@@ -75,18 +107,184 @@ float SensorSimulator::readCurrent() {
     float current = m_currentDist(m_rng);
 
     // Introduce a fault sometimes
-    if (m_faultDist(m_rng) < SIM_FAULT_PROBABILITY) {
+    if (m_faultInjection && m_faultDist(m_rng) < SIM_FAULT_PROBABILITY) {
         float fault_val = m_faultDist(m_rng);
         if (fault_val < 0.33f) { // High discharge critical
             current = -(MAX_DISCHARGE_CURRENT_CRITICAL_A + (m_faultDist(m_rng) * 5.0f));
-            std::cout << "[SIM] Pack - High Discharge Current Fault Injected (Critical)!" << std::endl;
+            if (m_consoleOutput) std::cout << "[SIM] Pack - High Discharge Current Fault Injected (Critical)!" << std::endl;
         } else if (fault_val < 0.66f) { // High charge critical
             current = MAX_CHARGE_CURRENT_CRITICAL_A + (m_faultDist(m_rng) * 1.0f);
-            std::cout << "[SIM] Pack - High Charge Current Fault Injected (Critical)!" << std::endl;
+            if (m_consoleOutput) std::cout << "[SIM] Pack - High Charge Current Fault Injected (Critical)!" << std::endl;
         } else { // Extreme current (e.g., sensor error)
             current = (m_faultDist(m_rng) < 0.5f) ? -50.0f : 10.0f; // Very large positive/negative
-            std::cout << "[SIM] Pack - Extreme Current Fault Injected (Sensor Error)!" << std::endl;
+            if (m_consoleOutput) std::cout << "[SIM] Pack - Extreme Current Fault Injected (Sensor Error)!" << std::endl;
         }
     }
     return current;
 }
+
+/**
+ * @brief Gets the open-circuit voltage and resistance of every string from its cells.
+ * A string's open-circuit voltage is the sum of its cells' and its resistance the sum
+ * of their R0, so the strings drift apart as their cells age and self-discharge differently.
+ * @param stringOcv_V Receives the open-circuit voltage per string (NUM_PARALLEL_STRINGS entries).
+ * @param stringResistance_Ohm Receives the resistance per string (NUM_PARALLEL_STRINGS entries).
+ */
+void SensorSimulator::getStringModel(float* stringOcv_V, float* stringResistance_Ohm) const {
+    const float* resistances = m_cellBank.getResistances_Ohm().data();
+    for (uint8_t k = 0; k < NUM_PARALLEL_STRINGS; ++k) {
+        float ocv = 0.0f;
+        float resistance = 0.0f;
+        for (uint8_t c = k * CELLS_PER_STRING; c < (k + 1) * CELLS_PER_STRING; ++c) {
+            ocv += m_cellBank.getOpenCircuitVoltage(c);
+            resistance += resistances[c];
+        }
+        stringOcv_V[k] = ocv;
+        stringResistance_Ohm[k] = resistance;
+    }
+}
+
+/**
+ * @brief Sets the string currents solved for the present step.
+ * They load the cells in the following readVoltage() calls and drive them in step().
+ * @param stringCurrent_A Current per string (NUM_PARALLEL_STRINGS entries, positive for charge).
+ */
+void SensorSimulator::setStringCurrents(const float* stringCurrent_A) {
+    for (uint8_t k = 0; k < NUM_PARALLEL_STRINGS; ++k) {
+        m_stringCurrents[k] = stringCurrent_A[k];
+    }
+}
+
+/**
+ * @brief Reads a simulated pack voltage from a channel independent of the cell taps.
+ * Every string's cells add up to the shared terminal voltage, so the channel reads the
+ * mean over the strings of their real cell voltage sums, plus a small amount of noise.
+ * @return Simulated pack voltage in Volts.
+ */
+float SensorSimulator::readPackVoltage() {
+    float cellVoltageSum = 0.0f;
+    for (float cellVoltage : m_cellVoltages) {
+        cellVoltageSum += cellVoltage;
+    }
+    return cellVoltageSum / NUM_PARALLEL_STRINGS + (m_faultDist(m_rng) - 0.5f) * 2.0f * SIM_PACK_VOLTAGE_NOISE_V;
+}
+
+/**
+ * @brief Advances the cells by one step, each with the current of its string.
+ * The string currents come from setStringCurrents(); strings whose cells sit at different
+ * SoC exchange a circulating current even at zero load, which moves their SoC together.
+ * Steps longer than SIM_EULER_MAX_STEP_S, as accelerated runs take, advance the cells with
+ * the adaptive integrator.
+ * @param deltaTime_s The time step in seconds.
+ */
+void SensorSimulator::step(float deltaTime_s) {
+    std::array<float, NUM_CELLS> cellCurrents;
+    for (uint8_t c = 0; c < NUM_CELLS; ++c) {
+        cellCurrents[c] = m_stringCurrents[c / CELLS_PER_STRING];
+    }
+    if (deltaTime_s > SIM_EULER_MAX_STEP_S) {
+        m_cellBank.advanceAdaptive(cellCurrents.data(), deltaTime_s);
+    } else {
+        m_cellBank.advance(cellCurrents.data(), deltaTime_s);
+    }
+}
+
+/**
+ * @brief Reads the simulated current sensor of one parallel string.
+ * Reports the current set by setStringCurrents().
+ * @param stringIndex The index of the string (0 to NUM_PARALLEL_STRINGS - 1).
+ * @return String current in Amperes (positive for charge, negative for discharge).
+ */
+float SensorSimulator::readStringCurrent(uint8_t stringIndex) const {
+    return stringIndex < NUM_PARALLEL_STRINGS ? m_stringCurrents[stringIndex] : 0.0f;
+}
+
+/**
+ * @brief Applies the thermal actuator commands to the simulated coolant loop.
+ * @param coolingDuty Pump and radiator fan duty (0.0 to 1.0).
+ * @param heaterDuty Coolant heater duty (0.0 to 1.0).
+ */
+void SensorSimulator::setThermalActuators(float coolingDuty, float heaterDuty) {
+    m_cellBank.setThermalActuators(coolingDuty, heaterDuty);
+}
+
+/**
+ * @brief Replaces the parameters of a simulated cell.
+ * @param cellId ID of the cell.
+ * @param capacity_mAh Capacity.
+ * @param resistance_Ohm Internal resistance.
+ */
+void SensorSimulator::setCellParameters(uint8_t cellId, float capacity_mAh, float resistance_Ohm) {
+    m_cellBank.setCellParameters(cellId, capacity_mAh, resistance_Ohm);
+}
+
+/**
+ * @brief Reads the simulated coolant temperature sensor.
+ * @return Coolant temperature in Celsius.
+ */
+float SensorSimulator::readCoolantTemperature() const {
+    return m_cellBank.getCoolantTemperature_C();
+}
+
+/**
+ * @brief Solves how the pack current divides between parallel strings, for many packs at once.
+ * All strings of a pack share one terminal voltage V, and string k carries
+ * I_k = (V - OCV_k) / R_k. Requiring the string currents to add up to the pack current
+ * gives V = (I + sum(OCV_k / R_k)) / sum(1 / R_k) in closed form, so the per-pack linear
+ * solve needs no iteration or pivoting. The loop over packs has no branches and no
+ * dependencies between packs, so the compiler can vectorize it across packs.
+ * @param packCount Number of packs.
+ * @param packCurrent_A Pack current per pack (positive for charge).
+ * @param stringOcv_V Open-circuit voltage per string, pack-major.
+ * @param stringResistance_Ohm Resistance per string, pack-major.
+ * @param stringCurrent_A Receives the current per string, pack-major.
+ * @param terminalVoltage_V Receives the terminal voltage per pack (may be nullptr).
+ */
+void SensorSimulator::solveStringCurrents(size_t packCount, const float* packCurrent_A, const float* stringOcv_V,
+                                          const float* stringResistance_Ohm, float* stringCurrent_A, float* terminalVoltage_V) {
+    for (size_t p = 0; p < packCount; ++p) {
+        const float* ocv = stringOcv_V + p * NUM_PARALLEL_STRINGS;
+        const float* resistance = stringResistance_Ohm + p * NUM_PARALLEL_STRINGS;
+        float* current = stringCurrent_A + p * NUM_PARALLEL_STRINGS;
+
+        float conductanceSum = 0.0f;
+        float weightedOcvSum = 0.0f;
+        for (uint8_t k = 0; k < NUM_PARALLEL_STRINGS; ++k) {
+            float conductance = 1.0f / resistance[k];
+            conductanceSum += conductance;
+            weightedOcvSum += ocv[k] * conductance;
+        }
+        float voltage = (packCurrent_A[p] + weightedOcvSum) / conductanceSum;
+        for (uint8_t k = 0; k < NUM_PARALLEL_STRINGS; ++k) {
+            current[k] = (voltage - ocv[k]) / resistance[k];
+        }
+        if (terminalVoltage_V != nullptr) {
+            terminalVoltage_V[p] = voltage;
+        }
+    }
+}
+
+/**
+ * @brief Enables or disables console messages about injected faults.
+ * @param enabled True to print messages (default), false to stay silent.
+ */
+void SensorSimulator::setConsoleOutput(bool enabled) {
+    m_consoleOutput = enabled;
+}
+
+/**
+ * @brief Enables or disables the injection of out-of-bounds readings.
+ * @param enabled True to inject faults at SIM_FAULT_PROBABILITY (default), false for
+ *        readings with measurement noise only.
+ */
+void SensorSimulator::setFaultInjection(bool enabled) {
+    m_faultInjection = enabled;
+}
+
+/**
+ * @brief Gets the cell model behind the cell readings.
+ * @return Reference to the SimulatedCellBank.
+ */
+const SimulatedCellBank& SensorSimulator::getCellBank() const {
+    return m_cellBank;
+}
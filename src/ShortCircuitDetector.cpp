@@ -0,0 +1,110 @@
+// src/ShortCircuitDetector.cpp
+#include "../inc/ShortCircuitDetector.h"
+#include <cmath>   // For std::fabs
+#include <utility> // For std::move
+
+/**
+ * @brief Constructor for ShortCircuitDetector.
+ * @param threshold_A Current magnitude at which a sample counts as a short circuit.
+ * @param debounceSamples Consecutive samples at the threshold needed to trip.
+ */
+ShortCircuitDetector::ShortCircuitDetector(float threshold_A, uint32_t debounceSamples)
+    : m_threshold_A(threshold_A),
+      m_debounceSamples(debounceSamples > 0 ? debounceSamples : 1),
+      m_runSamples(0),
+      m_tripCurrent_A(0.0f),
+      m_tripLatency_samples(0),
+      m_tripped(false)
+{
+}
+
+/**
+ * @brief Sets the function called on the acquisition thread when the detector trips.
+ * Must be set before the acquisition starts; the handler must not block.
+ * @param handler The trip handler, or an empty function for none.
+ */
+void ShortCircuitDetector::setTripHandler(std::function<void()> handler) {
+    m_tripHandler = std::move(handler);
+}
+
+/**
+ * @brief Checks the next samples, e.g. one chunk or one block (acquisition thread).
+ * The screen keeps CURRENT_KERNEL_LANES independent running peaks, so it vectorizes like
+ * the decimation kernel; samples whose peak stays below the threshold end any run of
+ * short-circuit samples. Otherwise they are scanned in order to continue the run.
+ * @param samples The samples, oldest first.
+ * @param sampleCount Number of samples; a multiple of CURRENT_KERNEL_LANES.
+ * @return True if the detector tripped in these samples, false otherwise (also if already tripped).
+ */
+bool ShortCircuitDetector::checkBlock(const float* __restrict samples, uint32_t sampleCount) {
+    if (m_tripped.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    float peak[CURRENT_KERNEL_LANES] = {};
+    for (uint32_t i = 0; i < sampleCount; i += CURRENT_KERNEL_LANES) {
+        const float* chunk = samples + i; // Contiguous loads; a wrapping 32-bit index would force gathers
+        for (uint32_t lane = 0; lane < CURRENT_KERNEL_LANES; ++lane) {
+            float magnitude = std::fabs(chunk[lane]);
+            peak[lane] = magnitude > peak[lane] ? magnitude : peak[lane];
+        }
+    }
+    float blockPeak_A = peak[0];
+    for (uint32_t lane = 1; lane < CURRENT_KERNEL_LANES; ++lane) {
+        blockPeak_A = peak[lane] > blockPeak_A ? peak[lane] : blockPeak_A;
+    }
+    if (blockPeak_A < m_threshold_A) {
+        m_runSamples = 0;
+        return false;
+    }
+
+    for (uint32_t i = 0; i < sampleCount; ++i) {
+        m_runSamples = std::fabs(samples[i]) >= m_threshold_A ? m_runSamples + 1 : 0;
+        if (m_runSamples >= m_debounceSamples) {
+            m_tripCurrent_A = blockPeak_A;
+            m_tripLatency_samples = m_runSamples + (sampleCount - 1 - i);
+            m_tripped.store(true, std::memory_order_release);
+            if (m_tripHandler) {
+                m_tripHandler();
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Checks whether the detector has tripped since the last reset (any thread).
+ * @return True if tripped, false otherwise.
+ */
+bool ShortCircuitDetector::isTripped() const {
+    return m_tripped.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Gets the peak current magnitude of the samples that tripped the detector.
+ * @return Peak current in Amperes, valid once isTripped() returned true.
+ */
+float ShortCircuitDetector::getTripCurrent_A() const {
+    return m_tripCurrent_A;
+}
+
+/**
+ * @brief Gets the trip latency in samples.
+ * Counted from the first sample of the tripping run to the last sample checked with
+ * it, i.e. the samples that had arrived before the trip could act.
+ * @return Latency in samples, valid once isTripped() returned true.
+ */
+uint32_t ShortCircuitDetector::getTripLatency_samples() const {
+    return m_tripLatency_samples;
+}
+
+/**
+ * @brief Clears a trip, e.g. after the fault was inspected and the contactor closed again.
+ * Must not run concurrently with checkBlock().
+ */
+void ShortCircuitDetector::reset() {
+    m_runSamples = 0;
+    m_tripCurrent_A = 0.0f;
+    m_tripLatency_samples = 0;
+    m_tripped.store(false, std::memory_order_release);
+}
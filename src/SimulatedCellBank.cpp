@@ -0,0 +1,567 @@
+// src/SimulatedCellBank.cpp
+#include "../inc/SimulatedCellBank.h"
+#include <algorithm> // For std::min, std::max, std::fill
+#include <cmath>     // For std::cbrt, std::fabs
+#include <vector>    // For std::vector
+#include "../inc/SplitMix64.h" // For SplitMix64 class
+
+namespace {
+/**
+ * @brief Small, fast generator of approximately standard normal samples.
+ * std::mt19937 with std::normal_distribution (or Box-Muller) is too slow to sample tens
+ * of millions of cells per second. This sums the four 16-bit quarters of each splitmix64
+ * output (Irwin-Hall, n = 4), which is close to normal within the +/- 3 sigma the samples
+ * are truncated to anyway.
+ */
+class FastNormal {
+public:
+    explicit FastNormal(uint64_t seed) : m_random(seed) {}
+
+    float operator()() {
+        uint64_t z = m_random();
+        uint32_t sum = static_cast<uint32_t>(z & 0xFFFF) + static_cast<uint32_t>((z >> 16) & 0xFFFF)
+                     + static_cast<uint32_t>((z >> 32) & 0xFFFF) + static_cast<uint32_t>(z >> 48);
+        // Sum of four uniforms: mean 2, variance 1/3
+        return (static_cast<float>(sum) * (1.0f / 65536.0f) - 2.0f) * 1.7320508f;
+    }
+
+private:
+    SplitMix64 m_random;
+};
+
+/**
+ * @brief Fills an array with samples of a truncated normal distribution.
+ * Samples are limited to mean +/- 3 standard deviations and to at least 1% of the mean.
+ * @param values Output array, already sized.
+ * @param distribution The distribution to sample.
+ * @param normal The standard normal generator.
+ */
+void sample(std::pmr::vector<float>& values, const ParameterDistribution& distribution, FastNormal& normal) {
+    float low = std::max(distribution.mean - 3.0f * distribution.stddev, 0.01f * distribution.mean);
+    float high = distribution.mean + 3.0f * distribution.stddev;
+    for (auto& value : values) {
+        value = std::min(std::max(distribution.mean + distribution.stddev * normal(), low), high);
+    }
+}
+
+/**
+ * @brief Adds a SoC change with Kahan compensation and clamps the SoC to 0..1.
+ * One second of self-discharge (about 1e-9) is far below half an ulp of a SoC near 0.5
+ * (about 3e-8), so plain float addition would round it away on every 1 s step; the
+ * compensation keeps what each addition rounded away and feeds it into the next one.
+ * @param change Change of the SoC over the step.
+ * @param soc State of charge, updated.
+ * @param compensation Rounding compensation of the SoC, updated.
+ */
+inline void addStateOfCharge(float change, float& soc, float& compensation) {
+    float addend = change - compensation;
+    float newSoc = soc + addend;
+    compensation = (newSoc - soc) - addend;
+    // A clamped SoC discards its rounding error along with the excess charge
+    if (newSoc < 0.0f || newSoc > 1.0f) {
+        compensation = 0.0f;
+    }
+    soc = std::min(std::max(newSoc, 0.0f), 1.0f);
+}
+
+/**
+ * @brief Advances one cell by one time step.
+ * Shared by both advance() variants so they stay identical.
+ * @return Heat the cell gave to the coolant (W).
+ */
+inline float advanceCell(float current_A, float deltaTime_s, float coolantTemperature_C, float heatTransfer_WPerK,
+                         float chargePerAmpereSecond, float resistance_Ohm, float selfDischarge_per_s,
+                         float inverseThermalMass, float& soc, float& socCompensation, float& temperature_C) {
+    float toCoolant_W = heatTransfer_WPerK * (temperature_C - coolantTemperature_C);
+    float heat_W = current_A * current_A * resistance_Ohm - toCoolant_W;
+    temperature_C += heat_W * inverseThermalMass * deltaTime_s;
+    addStateOfCharge((current_A * chargePerAmpereSecond - selfDischarge_per_s) * deltaTime_s, soc, socCompensation);
+    return toCoolant_W;
+}
+
+/**
+ * @brief Multiplies two square row-major matrices.
+ * @param a Left factor.
+ * @param b Right factor.
+ * @param size Number of rows and columns.
+ * @param product Output, a * b; must not alias a or b.
+ */
+void multiply(const double* a, const double* b, size_t size, double* product) {
+    for (size_t row = 0; row < size; ++row) {
+        for (size_t column = 0; column < size; ++column) {
+            double sum = 0.0;
+            for (size_t k = 0; k < size; ++k) {
+                sum += a[row * size + k] * b[k * size + column];
+            }
+            product[row * size + column] = sum;
+        }
+    }
+}
+
+/**
+ * @brief Applies a square row-major matrix to a vector.
+ * @param map The matrix.
+ * @param vector The vector.
+ * @param size Number of rows and columns.
+ * @param result Output, map * vector; must not alias vector.
+ */
+void apply(const double* map, const double* vector, size_t size, double* result) {
+    for (size_t row = 0; row < size; ++row) {
+        double sum = 0.0;
+        for (size_t k = 0; k < size; ++k) {
+            sum += map[row * size + k] * vector[k];
+        }
+        result[row] = sum;
+    }
+}
+} // namespace
+
+/**
+ * @brief Constructor for SimulatedCellBank.
+ * Samples the parameters of every cell; all cells start at SIM_CELL_INITIAL_SOC and ambient temperature.
+ * Each parameter is sampled in its own pass so every pass is a simple loop over one array.
+ * @param cellCount Number of cells.
+ * @param variability Distributions the cell parameters are drawn from.
+ * @param seed Seed of the parameter sampling.
+ * @param memory Memory resource the per-cell arrays are allocated from.
+ */
+SimulatedCellBank::SimulatedCellBank(size_t cellCount, const CellVariability& variability, uint32_t seed,
+                                     std::pmr::memory_resource* memory)
+    : m_capacity_mAh(cellCount, memory),
+      m_chargePerAmpereSecond(cellCount, memory),
+      m_resistance_Ohm(cellCount, memory),
+      m_selfDischarge_per_s(cellCount, memory),
+      m_inverseThermalMass(cellCount, memory),
+      m_soc(cellCount, SIM_CELL_INITIAL_SOC, memory),
+      m_socCompensation(cellCount, 0.0f, memory),
+      m_temperature_C(cellCount, SIM_AMBIENT_TEMP_C, memory),
+      m_ambientTemperature_C(SIM_AMBIENT_TEMP_C),
+      m_coolantTemperature_C(SIM_AMBIENT_TEMP_C),
+      m_coolingDuty(0.0f),
+      m_heaterDuty(0.0f),
+      m_adaptiveStep_s(SIM_EULER_MAX_STEP_S)
+{
+    FastNormal normal(seed);
+    sample(m_capacity_mAh, variability.capacity_mAh, normal);
+    sample(m_resistance_Ohm, variability.resistance_Ohm, normal);
+    sample(m_selfDischarge_per_s, variability.selfDischarge_percentPerDay, normal);
+    sample(m_inverseThermalMass, variability.thermalMass_JPerK, normal);
+
+    for (size_t i = 0; i < cellCount; ++i) {
+        m_chargePerAmpereSecond[i] = 1.0f / (m_capacity_mAh[i] * 3.6f); // mAh -> As
+        m_selfDischarge_per_s[i] *= 0.01f / 86400.0f;                    // %/day -> fraction/s
+        m_inverseThermalMass[i] = 1.0f / m_inverseThermalMass[i];
+    }
+}
+
+/**
+ * @brief Advances all cells by one time step with a common (series) current.
+ * Integrates SoC (charge throughput and self-discharge, summed with Kahan compensation so
+ * the tiny per-step self-discharge is not rounded away) and temperature (Joule heating
+ * in R0 against heat transfer to the coolant) with a forward Euler step, then the coolant.
+ * @param current_A Current through every cell in Amperes (positive for charge).
+ * @param deltaTime_s The time step in seconds.
+ */
+void SimulatedCellBank::advance(float current_A, float deltaTime_s) {
+    const size_t count = m_soc.size();
+    const float heatTransfer = getCellHeatTransfer_WPerK();
+    float heatToCoolant_W = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        heatToCoolant_W += advanceCell(current_A, deltaTime_s, m_coolantTemperature_C, heatTransfer,
+                                       m_chargePerAmpereSecond[i], m_resistance_Ohm[i], m_selfDischarge_per_s[i],
+                                       m_inverseThermalMass[i], m_soc[i], m_socCompensation[i], m_temperature_C[i]);
+    }
+    advanceCoolant(heatToCoolant_W, deltaTime_s);
+}
+
+/**
+ * @brief Advances all cells by one time step with an individual current per cell.
+ * @param cellCurrent_A Current through each cell in Amperes (positive for charge).
+ * @param deltaTime_s The time step in seconds.
+ */
+void SimulatedCellBank::advance(const float* cellCurrent_A, float deltaTime_s) {
+    const size_t count = m_soc.size();
+    const float heatTransfer = getCellHeatTransfer_WPerK();
+    float heatToCoolant_W = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        heatToCoolant_W += advanceCell(cellCurrent_A[i], deltaTime_s, m_coolantTemperature_C, heatTransfer,
+                                       m_chargePerAmpereSecond[i], m_resistance_Ohm[i], m_selfDischarge_per_s[i],
+                                       m_inverseThermalMass[i], m_soc[i], m_socCompensation[i], m_temperature_C[i]);
+    }
+    advanceCoolant(heatToCoolant_W, deltaTime_s);
+}
+
+/**
+ * @brief Advances all cells by a time step of any length with a common (series) current.
+ * Forward Euler is only accurate, and for long steps only stable, for steps well below the
+ * thermal time constants (tens of seconds with the pump running), so accelerated runs with
+ * long steps integrate the cell and coolant temperatures with the embedded Bogacki-Shampine
+ * 3(2) pair instead: each substep is accepted when the difference between the third- and
+ * second-order solutions stays within SIM_ADAPTIVE_TOLERANCE_C, and the next substep is
+ * scaled from the error. The substep carries over between calls. With a constant current
+ * the SoC rate is constant, so SoC is advanced exactly in one update.
+ * @param current_A Current through every cell in Amperes (positive for charge).
+ * @param deltaTime_s The time step in seconds.
+ * @return Number of substeps taken.
+ */
+uint32_t SimulatedCellBank::advanceAdaptive(float current_A, float deltaTime_s) {
+    return integrateAdaptive(&current_A, 0, deltaTime_s);
+}
+
+/**
+ * @brief Advances all cells by a time step of any length with an individual current per cell.
+ * The same integration as the common-current variant; each cell's Joule heat and SoC rate
+ * follow its own current, which is held constant over the step.
+ * @param cellCurrent_A Current through each cell in Amperes (positive for charge).
+ * @param deltaTime_s The time step in seconds.
+ * @return Number of substeps taken.
+ */
+uint32_t SimulatedCellBank::advanceAdaptive(const float* cellCurrent_A, float deltaTime_s) {
+    return integrateAdaptive(cellCurrent_A, 1, deltaTime_s);
+}
+
+/**
+ * @brief Shared body of both advanceAdaptive() variants.
+ * A stride lets one loop serve a common current (stride 0) and per-cell currents (stride 1).
+ * @param current_A Current of the first cell; cell i carries current_A[i * currentStride].
+ * @param currentStride 0 for a common current, 1 for one current per cell.
+ * @param deltaTime_s The time step in seconds.
+ * @return Number of substeps taken.
+ */
+uint32_t SimulatedCellBank::integrateAdaptive(const float* current_A, size_t currentStride, float deltaTime_s) {
+    const size_t count = m_soc.size();
+    const size_t size = count + 1;
+    m_integratorScratch.resize(7 * size);
+    double* heat = m_integratorScratch.data();
+    double* state = heat + size;
+    double* stage = state + size;
+    double* k1 = stage + size;
+    double* k2 = k1 + size;
+    double* k3 = k2 + size;
+    double* k4 = k3 + size;
+
+    for (size_t i = 0; i < count; ++i) {
+        const float current = current_A[i * currentStride];
+        heat[i] = static_cast<double>(current) * current * m_resistance_Ohm[i];
+        state[i] = m_temperature_C[i];
+        addStateOfCharge((current * m_chargePerAmpereSecond[i] - m_selfDischarge_per_s[i]) * deltaTime_s,
+                         m_soc[i], m_socCompensation[i]);
+    }
+    state[count] = m_coolantTemperature_C;
+
+    uint32_t substeps = 0;
+    double remaining = deltaTime_s;
+    double step = m_adaptiveStep_s;
+    temperatureDerivatives(heat, state, k1);
+    while (remaining > 0.0) {
+        const double h = std::min(step, remaining);
+        for (size_t j = 0; j < size; ++j) {
+            stage[j] = state[j] + 0.5 * h * k1[j];
+        }
+        temperatureDerivatives(heat, stage, k2);
+        for (size_t j = 0; j < size; ++j) {
+            stage[j] = state[j] + 0.75 * h * k2[j];
+        }
+        temperatureDerivatives(heat, stage, k3);
+        for (size_t j = 0; j < size; ++j) {
+            stage[j] = state[j] + h * (2.0 / 9.0 * k1[j] + 1.0 / 3.0 * k2[j] + 4.0 / 9.0 * k3[j]);
+        }
+        temperatureDerivatives(heat, stage, k4);
+
+        // Difference to the embedded second-order solution
+        double error = 0.0;
+        for (size_t j = 0; j < size; ++j) {
+            double e = h * (-5.0 / 72.0 * k1[j] + 1.0 / 12.0 * k2[j] + 1.0 / 9.0 * k3[j] - 1.0 / 8.0 * k4[j]);
+            error = std::max(error, std::fabs(e));
+        }
+
+        // Accept within tolerance; the smallest substep is always accepted so the loop ends
+        bool accepted = error <= SIM_ADAPTIVE_TOLERANCE_C || h <= SIM_ADAPTIVE_MIN_STEP_S;
+        if (accepted) {
+            // The last stage is the derivative at the new state (first same as last)
+            std::copy(stage, stage + size, state);
+            std::copy(k4, k4 + size, k1);
+            remaining -= h;
+            ++substeps;
+        }
+        double factor = error > 0.0 ? 0.9 * std::cbrt(SIM_ADAPTIVE_TOLERANCE_C / error) : 5.0;
+        double next = std::max(h * std::min(std::max(factor, 0.2), 5.0), static_cast<double>(SIM_ADAPTIVE_MIN_STEP_S));
+        // A substep shortened to end on the time step says nothing against the longer one
+        step = accepted && h < step ? std::max(step, next) : next;
+    }
+    m_adaptiveStep_s = static_cast<float>(step);
+
+    for (size_t i = 0; i < count; ++i) {
+        m_temperature_C[i] = static_cast<float>(state[i]);
+    }
+    m_coolantTemperature_C = static_cast<float>(state[count]);
+    return substeps;
+}
+
+/**
+ * @brief Jumps over idle time steps (no current, thermal actuators unchanged) at once.
+ * With no current, one step of advance() is an affine map of the cell and coolant
+ * temperatures, and self-discharge lowers each SoC linearly until it reaches zero. The
+ * map is raised to powers of two by repeated squaring, and the longest accepted jump is
+ * found by trying the largest power first (binary lifting), so jumping k steps costs
+ * O(log k) small matrix products instead of k steps. Because the predicate accepts a
+ * prefix of the trajectory, the readings of every skipped step are accepted, not just
+ * those at the powers of two tried.
+ * The jump applies the exact self-discharge over the skipped time, in double, and folds
+ * in the pending rounding compensation of the stepped SoC.
+ * @param maxSteps Maximum number of time steps to skip.
+ * @param deltaTime_s The time step in seconds.
+ * @param accept Predicate on the readings; it must accept a prefix of the idle trajectory.
+ * @return Number of time steps skipped (0 if the current readings are not accepted).
+ */
+uint64_t SimulatedCellBank::advanceIdle(uint64_t maxSteps, float deltaTime_s, const IdleReadingsPredicate& accept) {
+    const size_t count = m_soc.size();
+    std::vector<float> voltages_V(count);
+    std::vector<float> temperatures_C(m_temperature_C.begin(), m_temperature_C.end());
+    for (size_t i = 0; i < count; ++i) {
+        voltages_V[i] = getOpenCircuitVoltage(i);
+    }
+    if (maxSteps == 0 || !accept(voltages_V.data(), temperatures_C.data())) {
+        return 0;
+    }
+
+    // powers[j] is the step map raised to 2^j, for every 2^j below maxSteps
+    const size_t size = count + 2;
+    size_t levels = 1;
+    while (levels < 64 && (uint64_t(1) << levels) < maxSteps) {
+        ++levels;
+    }
+    std::vector<double> powers(levels * size * size);
+    std::vector<double> stepMap;
+    buildIdleStepMap(deltaTime_s, stepMap);
+    std::copy(stepMap.begin(), stepMap.end(), powers.begin());
+    for (size_t j = 1; j < levels; ++j) {
+        multiply(&powers[(j - 1) * size * size], &powers[(j - 1) * size * size], size, &powers[j * size * size]);
+    }
+
+    // State vector: cell temperatures, coolant temperature, 1
+    std::vector<double> state(size);
+    std::vector<double> candidate(size);
+    std::copy(m_temperature_C.begin(), m_temperature_C.end(), state.begin());
+    state[count] = m_coolantTemperature_C;
+    state[count + 1] = 1.0;
+
+    // Find the last accepted step before maxSteps, then take one more step past it
+    uint64_t accepted = 0;
+    for (size_t j = levels; j-- > 0;) {
+        uint64_t steps = uint64_t(1) << j;
+        if (accepted + steps >= maxSteps) {
+            continue;
+        }
+        apply(&powers[j * size * size], state.data(), size, candidate.data());
+        double elapsed_s = static_cast<double>(accepted + steps) * deltaTime_s;
+        for (size_t i = 0; i < count; ++i) {
+            double soc = std::max(static_cast<double>(m_soc[i]) - m_socCompensation[i] - m_selfDischarge_per_s[i] * elapsed_s, 0.0);
+            voltages_V[i] = SIM_CELL_OCV_EMPTY_V + (SIM_CELL_OCV_FULL_V - SIM_CELL_OCV_EMPTY_V) * static_cast<float>(soc);
+            temperatures_C[i] = static_cast<float>(candidate[i]);
+        }
+        if (accept(voltages_V.data(), temperatures_C.data())) {
+            state.swap(candidate);
+            accepted += steps;
+        }
+    }
+    apply(stepMap.data(), state.data(), size, candidate.data());
+    const uint64_t skipped = accepted + 1;
+
+    double elapsed_s = static_cast<double>(skipped) * deltaTime_s;
+    for (size_t i = 0; i < count; ++i) {
+        double soc = static_cast<double>(m_soc[i]) - m_socCompensation[i] - m_selfDischarge_per_s[i] * elapsed_s;
+        m_soc[i] = static_cast<float>(std::max(soc, 0.0));
+        m_socCompensation[i] = 0.0f;
+        m_temperature_C[i] = static_cast<float>(candidate[i]);
+    }
+    m_coolantTemperature_C = static_cast<float>(candidate[count]);
+    return skipped;
+}
+
+/**
+ * @brief Sets the thermal actuators acting on the coolant loop.
+ * The pump raises the cell-to-coolant heat transfer and the fan the radiator
+ * conductance; both follow the cooling duty.
+ * @param coolingDuty Pump and radiator fan duty (0.0 to 1.0).
+ * @param heaterDuty Coolant heater duty (0.0 to 1.0).
+ */
+void SimulatedCellBank::setThermalActuators(float coolingDuty, float heaterDuty) {
+    m_coolingDuty = std::min(std::max(coolingDuty, 0.0f), 1.0f);
+    m_heaterDuty = std::min(std::max(heaterDuty, 0.0f), 1.0f);
+}
+
+/**
+ * @brief Sets the ambient temperature and soaks the cells and coolant to it.
+ * @param ambient_C Ambient temperature in Celsius.
+ */
+void SimulatedCellBank::setAmbientTemperature_C(float ambient_C) {
+    m_ambientTemperature_C = ambient_C;
+    m_coolantTemperature_C = ambient_C;
+    std::fill(m_temperature_C.begin(), m_temperature_C.end(), ambient_C);
+}
+
+/**
+ * @brief Replaces the sampled parameters of a cell, e.g. with identified ones.
+ * The SoC is kept, so the cell's stored charge scales with the new capacity.
+ * @param cell Index of the cell.
+ * @param capacity_mAh Capacity.
+ * @param resistance_Ohm Internal resistance R0.
+ */
+void SimulatedCellBank::setCellParameters(size_t cell, float capacity_mAh, float resistance_Ohm) {
+    m_capacity_mAh[cell] = capacity_mAh;
+    m_chargePerAmpereSecond[cell] = 1.0f / (capacity_mAh * 3.6f); // mAh -> As
+    m_resistance_Ohm[cell] = resistance_Ohm;
+}
+
+/**
+ * @brief Gets the coolant temperature.
+ * @return Coolant temperature in Celsius.
+ */
+float SimulatedCellBank::getCoolantTemperature_C() const {
+    return m_coolantTemperature_C;
+}
+
+/**
+ * @brief Advances the coolant loop by one time step.
+ * The coolant takes the heat of the cells and the heater and loses heat to ambient
+ * through the radiator. Its thermal mass and radiator scale with the number of cells.
+ * @param heatFromCells_W Heat the cells gave to the coolant during the step.
+ * @param deltaTime_s The time step in seconds.
+ */
+void SimulatedCellBank::advanceCoolant(float heatFromCells_W, float deltaTime_s) {
+    const float cellCount = static_cast<float>(m_soc.size());
+    // The radiator is bypassed in proportion to the heater duty so heating is not radiated away
+    float radiator_WPerK = cellCount * (SIM_RADIATOR_W_PER_K * (1.0f - m_heaterDuty) + SIM_FAN_W_PER_K * m_coolingDuty);
+    float heat_W = heatFromCells_W + cellCount * SIM_HEATER_POWER_W * m_heaterDuty
+                 - radiator_WPerK * (m_coolantTemperature_C - m_ambientTemperature_C);
+    m_coolantTemperature_C += heat_W / (cellCount * SIM_COOLANT_THERMAL_MASS_J_PER_K) * deltaTime_s;
+}
+
+/**
+ * @brief Gets the cell-to-coolant heat transfer at the current pump duty.
+ * @return Heat transfer per cell (W/K).
+ */
+float SimulatedCellBank::getCellHeatTransfer_WPerK() const {
+    return SIM_CELL_HEAT_TRANSFER_W_PER_K * (1.0f + SIM_PUMP_TRANSFER_GAIN * m_coolingDuty);
+}
+
+/**
+ * @brief Computes the temperature derivatives for the adaptive integrator.
+ * The same heat balance as advance() and advanceCoolant(), in continuous time.
+ * @param heat_W Joule heat of every cell (W).
+ * @param temperatures_C Cell temperatures followed by the coolant temperature.
+ * @param derivatives_KPerS Output, derivative of each temperature (K/s).
+ */
+void SimulatedCellBank::temperatureDerivatives(const double* heat_W, const double* temperatures_C,
+                                               double* derivatives_KPerS) const {
+    const size_t count = m_soc.size();
+    const double heatTransfer = getCellHeatTransfer_WPerK();
+    const double coolant_C = temperatures_C[count];
+    double heatToCoolant_W = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double toCoolant_W = heatTransfer * (temperatures_C[i] - coolant_C);
+        derivatives_KPerS[i] = (heat_W[i] - toCoolant_W) * m_inverseThermalMass[i];
+        heatToCoolant_W += toCoolant_W;
+    }
+    const double cellCount = static_cast<double>(count);
+    const double radiator_WPerK = cellCount * (SIM_RADIATOR_W_PER_K * (1.0 - m_heaterDuty) + SIM_FAN_W_PER_K * m_coolingDuty);
+    double coolantHeat_W = heatToCoolant_W + cellCount * SIM_HEATER_POWER_W * m_heaterDuty
+                         - radiator_WPerK * (coolant_C - m_ambientTemperature_C);
+    derivatives_KPerS[count] = coolantHeat_W / (cellCount * SIM_COOLANT_THERMAL_MASS_J_PER_K);
+}
+
+/**
+ * @brief Builds the affine map one idle time step applies to the temperatures.
+ * The state vector is (cell temperatures..., coolant temperature, 1); the rows are the
+ * forward Euler updates of advance() and advanceCoolant() with no current.
+ * @param deltaTime_s The time step in seconds.
+ * @param map Output, row-major (n + 2) x (n + 2) matrix.
+ */
+void SimulatedCellBank::buildIdleStepMap(float deltaTime_s, std::vector<double>& map) const {
+    const size_t count = m_soc.size();
+    const size_t size = count + 2;
+    const size_t coolant = count;
+    const size_t constant = count + 1;
+    const double dt = deltaTime_s;
+    const double heatTransfer = getCellHeatTransfer_WPerK();
+    map.assign(size * size, 0.0);
+
+    // Cells exchange heat with the coolant only
+    for (size_t i = 0; i < count; ++i) {
+        double rate = heatTransfer * m_inverseThermalMass[i] * dt;
+        map[i * size + i] = 1.0 - rate;
+        map[i * size + coolant] = rate;
+    }
+
+    // The coolant takes the heat of the cells and the heater and loses heat through the radiator
+    const double cellCount = static_cast<double>(count);
+    const double radiator_WPerK = cellCount * (SIM_RADIATOR_W_PER_K * (1.0 - m_heaterDuty) + SIM_FAN_W_PER_K * m_coolingDuty);
+    const double rate = dt / (cellCount * SIM_COOLANT_THERMAL_MASS_J_PER_K);
+    for (size_t i = 0; i < count; ++i) {
+        map[coolant * size + i] = heatTransfer * rate;
+    }
+    map[coolant * size + coolant] = 1.0 - (cellCount * heatTransfer + radiator_WPerK) * rate;
+    map[coolant * size + constant] = (cellCount * SIM_HEATER_POWER_W * m_heaterDuty + radiator_WPerK * m_ambientTemperature_C) * rate;
+    map[constant * size + constant] = 1.0;
+}
+
+/**
+ * @brief Gets the open-circuit voltage of a cell.
+ * Linear in SoC between SIM_CELL_OCV_EMPTY_V and SIM_CELL_OCV_FULL_V.
+ * @param cell Index of the cell.
+ * @return Open-circuit voltage in Volts.
+ */
+float SimulatedCellBank::getOpenCircuitVoltage(size_t cell) const {
+    return SIM_CELL_OCV_EMPTY_V + (SIM_CELL_OCV_FULL_V - SIM_CELL_OCV_EMPTY_V) * m_soc[cell];
+}
+
+/**
+ * @brief Gets the terminal voltage of a cell under load.
+ * @param cell Index of the cell.
+ * @param current_A Current through the cell in Amperes (positive for charge).
+ * @return Terminal voltage in Volts.
+ */
+float SimulatedCellBank::getTerminalVoltage(size_t cell, float current_A) const {
+    return getOpenCircuitVoltage(cell) + current_A * m_resistance_Ohm[cell];
+}
+
+/**
+ * @brief Gets the number of cells.
+ * @return Number of cells.
+ */
+size_t SimulatedCellBank::getCellCount() const {
+    return m_soc.size();
+}
+
+/**
+ * @brief Gets the sampled capacity of every cell.
+ * @return Capacities in mAh, one per cell.
+ */
+const std::pmr::vector<float>& SimulatedCellBank::getCapacities_mAh() const {
+    return m_capacity_mAh;
+}
+
+/**
+ * @brief Gets the sampled internal resistance of every cell.
+ * @return Resistances in Ohms, one per cell.
+ */
+const std::pmr::vector<float>& SimulatedCellBank::getResistances_Ohm() const {
+    return m_resistance_Ohm;
+}
+
+/**
+ * @brief Gets the state of charge of every cell.
+ * @return SoC (0.0 to 1.0), one per cell.
+ */
+const std::pmr::vector<float>& SimulatedCellBank::getStatesOfCharge() const {
+    return m_soc;
+}
+
+/**
+ * @brief Gets the temperature of every cell.
+ * @return Temperatures in Celsius, one per cell.
+ */
+const std::pmr::vector<float>& SimulatedCellBank::getTemperatures_C() const {
+    return m_temperature_C;
+}
@@ -0,0 +1,166 @@
+// src/Telemetry.cpp
+#include "../inc/Telemetry.h"
+#include <cmath>   // For std::fabs
+#include <cstring> // For std::memcpy, std::memset
+
+namespace {
+/**
+ * @brief Writes the frame header.
+ * @param buffer Output buffer.
+ * @param flags Frame flags.
+ * @param sequence Frame sequence number.
+ */
+inline void writeHeader(uint8_t* buffer, uint8_t flags, uint16_t sequence) {
+    buffer[0] = flags;
+    buffer[1] = static_cast<uint8_t>(sequence & 0xFF);
+    buffer[2] = static_cast<uint8_t>(sequence >> 8);
+}
+} // namespace
+
+/**
+ * @brief Constructor for TelemetryEncoder.
+ * Deadbands default to the TELEMETRY_* constants.
+ * @param keyframeInterval A keyframe is sent every this many frames.
+ */
+TelemetryEncoder::TelemetryEncoder(uint16_t keyframeInterval)
+    : m_keyframeInterval(keyframeInterval > 0 ? keyframeInterval : 1),
+      m_framesSinceKeyframe(0),
+      m_sequence(0),
+      m_keyframePending(true)
+{
+    m_published.fill(0.0f);
+    for (uint8_t i = 0; i < NUM_CELLS; ++i) {
+        m_deadband[TELEMETRY_CHANNEL_VOLTAGE_BASE + i] = TELEMETRY_VOLTAGE_DEADBAND_V;
+        m_deadband[TELEMETRY_CHANNEL_TEMP_BASE + i] = TELEMETRY_TEMP_DEADBAND_C;
+    }
+    m_deadband[TELEMETRY_CHANNEL_PACK_CURRENT] = TELEMETRY_CURRENT_DEADBAND_A;
+    m_deadband[TELEMETRY_CHANNEL_PACK_VOLTAGE] = TELEMETRY_PACK_VOLTAGE_DEADBAND_V;
+    m_deadband[TELEMETRY_CHANNEL_SOC] = TELEMETRY_SOC_DEADBAND_PERCENT;
+}
+
+/**
+ * @brief Sets the deadband of one channel.
+ * @param channel The channel index.
+ * @param deadband The change required before the channel is re-sent (0 sends every change).
+ */
+void TelemetryEncoder::setDeadband(uint16_t channel, float deadband) {
+    if (channel < TELEMETRY_CHANNEL_COUNT) {
+        m_deadband[channel] = deadband;
+    }
+}
+
+/**
+ * @brief Encodes one sample into a keyframe or delta frame.
+ * Change detection runs as one branch-free pass over all channels so the compiler can
+ * vectorize it; a NaN always counts as changed.
+ * @param channels The current channel values.
+ * @param buffer Output buffer of at least TELEMETRY_MAX_FRAME_BYTES bytes.
+ * @return Number of bytes written.
+ */
+size_t TelemetryEncoder::encode(const TelemetryChannels& channels, uint8_t* buffer) {
+    uint16_t sequence = m_sequence++;
+
+    if (m_keyframePending || ++m_framesSinceKeyframe >= m_keyframeInterval) {
+        m_keyframePending = false;
+        m_framesSinceKeyframe = 0;
+        m_published = channels;
+        writeHeader(buffer, TELEMETRY_FLAG_KEYFRAME, sequence);
+        std::memcpy(buffer + TELEMETRY_HEADER_BYTES, channels.data(), sizeof(float) * TELEMETRY_CHANNEL_COUNT);
+        return TELEMETRY_HEADER_BYTES + sizeof(float) * TELEMETRY_CHANNEL_COUNT;
+    }
+
+    std::array<uint8_t, TELEMETRY_CHANNEL_COUNT> changed;
+    uint8_t anyChanged = 0;
+    for (uint16_t i = 0; i < TELEMETRY_CHANNEL_COUNT; ++i) {
+        changed[i] = !(std::fabs(channels[i] - m_published[i]) <= m_deadband[i]);
+        anyChanged |= changed[i];
+    }
+
+    if (!anyChanged) {
+        writeHeader(buffer, 0, sequence);
+        return TELEMETRY_HEADER_BYTES;
+    }
+
+    uint8_t* mask = buffer + TELEMETRY_HEADER_BYTES;
+    std::memset(mask, 0, TELEMETRY_MASK_BYTES);
+    for (uint16_t i = 0; i < TELEMETRY_CHANNEL_COUNT; ++i) {
+        mask[i >> 3] |= static_cast<uint8_t>(changed[i] << (i & 7));
+    }
+
+    uint8_t* out = mask + TELEMETRY_MASK_BYTES;
+    for (uint16_t i = 0; i < TELEMETRY_CHANNEL_COUNT; ++i) {
+        if (changed[i]) {
+            m_published[i] = channels[i];
+            std::memcpy(out, &channels[i], sizeof(float));
+            out += sizeof(float);
+        }
+    }
+    writeHeader(buffer, TELEMETRY_FLAG_DELTA, sequence);
+    return static_cast<size_t>(out - buffer);
+}
+
+/**
+ * @brief Forces the next frame to be a keyframe (e.g. after a receiver reconnects).
+ */
+void TelemetryEncoder::requestKeyframe() {
+    m_keyframePending = true;
+}
+
+/**
+ * @brief Constructor for TelemetryDecoder.
+ * Waits for a keyframe before accepting deltas.
+ */
+TelemetryDecoder::TelemetryDecoder() : m_nextSequence(0), m_synchronized(false) {
+    m_channels.fill(0.0f);
+}
+
+/**
+ * @brief Decodes one frame and updates the reconstructed channel values.
+ * Channels absent from a delta frame keep their previous value, which is within the
+ * encoder's deadband of the true value.
+ * @param buffer The encoded frame.
+ * @param size The size of the frame in bytes.
+ * @param channels Receives the reconstructed values of all channels.
+ * @return True if decoded, false if malformed or not decodable without a keyframe.
+ */
+bool TelemetryDecoder::decode(const uint8_t* buffer, size_t size, TelemetryChannels& channels) {
+    if (size < TELEMETRY_HEADER_BYTES) return false;
+    uint8_t flags = buffer[0];
+    uint16_t sequence = static_cast<uint16_t>(buffer[1] | (buffer[2] << 8));
+    const uint8_t* payload = buffer + TELEMETRY_HEADER_BYTES;
+    size_t payloadSize = size - TELEMETRY_HEADER_BYTES;
+
+    if (flags & TELEMETRY_FLAG_KEYFRAME) {
+        if (payloadSize != sizeof(float) * TELEMETRY_CHANNEL_COUNT) return false;
+        std::memcpy(m_channels.data(), payload, payloadSize);
+        m_synchronized = true;
+    } else {
+        // A lost frame may have carried changes; wait for the next keyframe
+        if (!m_synchronized || sequence != m_nextSequence) {
+            m_synchronized = false;
+            return false;
+        }
+        if (flags & TELEMETRY_FLAG_DELTA) {
+            if (payloadSize < TELEMETRY_MASK_BYTES) return false;
+            const uint8_t* mask = payload;
+            const uint8_t* in = payload + TELEMETRY_MASK_BYTES;
+            const uint8_t* end = payload + payloadSize;
+            TelemetryChannels updated = m_channels;
+            for (uint16_t i = 0; i < TELEMETRY_CHANNEL_COUNT; ++i) {
+                if (mask[i >> 3] & (1u << (i & 7))) {
+                    if (in + sizeof(float) > end) return false;
+                    std::memcpy(&updated[i], in, sizeof(float));
+                    in += sizeof(float);
+                }
+            }
+            if (in != end) return false;
+            m_channels = updated;
+        } else if (payloadSize != 0) {
+            return false;
+        }
+    }
+
+    m_nextSequence = static_cast<uint16_t>(sequence + 1);
+    channels = m_channels;
+    return true;
+}
@@ -0,0 +1,118 @@
+// src/ThermalManager.cpp
+#include "../inc/ThermalManager.h"
+#include <algorithm> // For std::min, std::max
+#include "../inc/CellKernels.h" // For PackCellKernels
+
+/**
+ * @brief Runs one controller step.
+ * @param error Setpoint deviation; positive asks for more output.
+ * @param deltaTime_s The time since the previous step in seconds.
+ * @return The new output (0.0 to 1.0).
+ */
+float PiController::step(float error, float deltaTime_s) {
+    integral = std::min(std::max(integral + ki * error * deltaTime_s, 0.0f), 1.0f);
+    output = std::min(std::max(kp * error + integral, 0.0f), 1.0f);
+    return output;
+}
+
+/**
+ * @brief Constructor for ThermalManager.
+ * Starts with all actuators off and preconditioning disabled.
+ */
+ThermalManager::ThermalManager()
+    : m_cooling{THERMAL_COOLING_KP, THERMAL_COOLING_KI},
+      m_heating{THERMAL_HEATING_KP, THERMAL_HEATING_KI},
+      m_preconditioning(false),
+      m_minTemperature_C(0.0f),
+      m_maxTemperature_C(0.0f),
+      m_pendingTime_s(0.0f),
+      m_timeAboveWarning_s(0.0),
+      m_monitoredTime_s(0.0)
+{}
+
+/**
+ * @brief Feeds the latest cell temperatures and runs the controllers when their period has elapsed.
+ * Calls faster than THERMAL_CONTROL_PERIOD_S only refresh the measurements; a call
+ * covering several periods runs one step per period.
+ * @param cells The latest cell readings.
+ * @param deltaTime_s The time elapsed since the last call in seconds.
+ */
+void ThermalManager::update(const std::array<BatteryCell, NUM_CELLS>& cells, float deltaTime_s) {
+    std::array<float, NUM_CELLS> voltages;
+    std::array<float, NUM_CELLS> temperatures;
+    PackCellKernels<NUM_CELLS>::gather(cells, voltages.data(), temperatures.data());
+    CellStatistics statistics = PackCellKernels<NUM_CELLS>::statistics(voltages.data(), temperatures.data());
+    m_minTemperature_C = statistics.minTemperature_C;
+    m_maxTemperature_C = statistics.maxTemperature_C;
+
+    m_monitoredTime_s += deltaTime_s;
+    if (m_maxTemperature_C > MAX_TEMP_WARNING) {
+        m_timeAboveWarning_s += deltaTime_s;
+    }
+
+    float coolingSetpoint = m_preconditioning ? THERMAL_PRECONDITION_MAX_C : THERMAL_COOLING_SETPOINT_C;
+    float heatingSetpoint = m_preconditioning ? THERMAL_PRECONDITION_MIN_C : THERMAL_HEATING_SETPOINT_C;
+
+    m_pendingTime_s += deltaTime_s;
+    while (m_pendingTime_s >= THERMAL_CONTROL_PERIOD_S) {
+        m_pendingTime_s -= THERMAL_CONTROL_PERIOD_S;
+        m_cooling.step(m_maxTemperature_C - coolingSetpoint, THERMAL_CONTROL_PERIOD_S);
+        m_heating.step(heatingSetpoint - m_minTemperature_C, THERMAL_CONTROL_PERIOD_S);
+    }
+}
+
+/**
+ * @brief Enables or disables preconditioning for an upcoming charge.
+ * @param enabled True to bring the cells into the charging window.
+ */
+void ThermalManager::setPreconditioning(bool enabled) {
+    m_preconditioning = enabled;
+}
+
+/**
+ * @brief Checks whether preconditioning is enabled.
+ * @return True if enabled.
+ */
+bool ThermalManager::isPreconditioning() const {
+    return m_preconditioning;
+}
+
+/**
+ * @brief Checks whether all cells are inside the charging window.
+ * @return True if the minimum and maximum cell temperatures are within the window.
+ */
+bool ThermalManager::isInChargingWindow() const {
+    return m_minTemperature_C >= THERMAL_PRECONDITION_MIN_C && m_maxTemperature_C <= THERMAL_PRECONDITION_MAX_C;
+}
+
+/**
+ * @brief Gets the pump and radiator fan duty.
+ * @return Duty (0.0 to 1.0).
+ */
+float ThermalManager::getCoolingDuty() const {
+    return m_cooling.output;
+}
+
+/**
+ * @brief Gets the coolant heater duty.
+ * @return Duty (0.0 to 1.0).
+ */
+float ThermalManager::getHeaterDuty() const {
+    return m_heating.output;
+}
+
+/**
+ * @brief Gets the time the maximum cell temperature spent above MAX_TEMP_WARNING.
+ * @return Time in seconds.
+ */
+double ThermalManager::getTimeAboveWarning_s() const {
+    return m_timeAboveWarning_s;
+}
+
+/**
+ * @brief Gets the total time covered by update() calls.
+ * @return Time in seconds.
+ */
+double ThermalManager::getMonitoredTime_s() const {
+    return m_monitoredTime_s;
+}
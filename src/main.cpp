@@ -1,29 +1,244 @@
 // src/main.cpp
 #include "../inc/BMS.h"
+#include "../inc/AsyncFileSink.h" // For the telemetry file and the event journal
+#include "../inc/Fleet.h"     // For fleet simulation mode
+#include "../inc/EventDrivenSimulator.h" // For lifetime simulation mode
+#include "../inc/EcmIdentifier.h" // For ECM parameter identification mode
+#include "../inc/CurrentAcquisition.h" // For high-rate current sampling
+#include "../inc/FlightRecorder.h" // For freeze-frame capture around faults
+#include "../inc/CellKernels.h" // For the cell kernel benchmark
+#include "../inc/BandLookupTable.h" // For the band classifier benchmark
+#include "../inc/SimulatedCellBank.h" // For the thermal benchmark
+#include "../inc/ThermalManager.h" // For the thermal benchmark
+#include "../inc/SplitMix64.h" // For benchmark readings
+#include "../inc/EventBus.h"  // For EventBus class
+#include "../inc/Telemetry.h" // For TelemetryEncoder class
+#include "../inc/QuantileSketch.h" // For benchmark latency percentiles
+#include "../inc/Dashboard.h" // For dashboard mode
 #include "../inc/Constants.h" // For BMS_UPDATE_INTERVAL_MS
+#include <csignal> // For std::signal
+#include <algorithm> // For std::max
+#include <cmath>   // For std::fabs, std::isfinite, std::lround
+#include <cstdlib> // For std::strtoul
+#include <cstdio>  // For std::remove
+#include <cstring> // For std::strcmp, std::memcpy
+#include <fstream> // For std::ofstream
 #include <iostream>
+#include <memory>  // For std::shared_ptr
+#include <mutex>   // For std::mutex
+#include <iomanip> // For formatting output
+#include <limits>  // For std::numeric_limits
+#include <random>  // For std::uniform_real_distribution
+#include <vector>  // For benchmark readings
 #include <thread>  // For std::this_thread::sleep_for
 #include <chrono>  // For std::chrono::milliseconds
 
+// Set by the SIGINT handler to leave the single-pack and dashboard loops cleanly
+static volatile std::sig_atomic_t g_stopRequested = 0;
+
+// Receives benchmark results, so the timed loops cannot be optimized away
+static volatile float g_benchmarkSink = 0.0f;
+
 /**
- * @brief Main entry point of the BMS prototype application.
- * Initializes the BMS and runs its update loop.
+ * @brief SIGINT handler requesting a clean shutdown.
+ * @param signal The signal number (unused).
+ */
+static void requestStop(int) {
+    g_stopRequested = 1;
+}
+
+/**
+ * @brief Subscribes console loggers for every BMS event type.
+ * Each line is built first and written at once so it does not interleave with
+ * the status output of the control thread.
+ * @param eventBus The bus to subscribe to.
+ */
+static void subscribeConsoleLogging(EventBus& eventBus) {
+    auto logLine = [](const BmsEvent& event) {
+        std::cout << "[LOG] " + describeEvent(event) + "\n" << std::flush;
+    };
+    eventBus.subscribe(EventType::LOG, logLine);
+    eventBus.subscribe(EventType::CYCLE_INCREMENT, logLine);
+    eventBus.subscribe(EventType::THRESHOLD_CROSSING, logLine);
+    eventBus.subscribe(EventType::FAULT, [](const BmsEvent& event) {
+        std::cerr << "[FAULT] " + describeEvent(event) + "\n" << std::flush;
+    });
+    eventBus.subscribe(EventType::STATE_TRANSITION, [](const BmsEvent& event) {
+        std::cout << "--- " + describeEvent(event) + " ---\n" << std::flush;
+    });
+}
+
+/**
+ * @brief Flush state of an event journal, shared by its subscriptions and the control loop.
+ */
+struct EventJournalState {
+    explicit EventJournalState(AsyncFileSink& sink) : journal(sink) {}
+
+    AsyncFileSink& journal;   // The open sink of the journal
+    std::mutex mutex;         // Makes the dispatcher thread and the control loop take turns as the sink's producer
+    size_t pendingBytes = 0;  // Bytes written since the last flush
+    std::chrono::steady_clock::time_point lastFlush = std::chrono::steady_clock::now();
+};
+
+/**
+ * @brief Starts writing the pending lines of an event journal. Call with its mutex held.
+ * @param state The journal.
+ * @param now The current time.
+ */
+static void flushEventJournalLocked(EventJournalState& state, std::chrono::steady_clock::time_point now) {
+    state.journal.flush();
+    state.pendingBytes = 0;
+    state.lastFlush = now;
+}
+
+/**
+ * @brief Subscribes an event journal for every BMS event type: each event is appended as one line.
+ * The dispatcher thread flushes it once EVENT_JOURNAL_FLUSH_BYTES are pending and right after
+ * a FAULT event, so bursts of events share a write and the lead-up to a fault still reaches
+ * the file; flushEventJournalIfDue() in the control loop flushes lines that have waited
+ * EVENT_JOURNAL_FLUSH_INTERVAL_MS, also while the bus is quiet. Closing the sink writes the rest.
+ * @param eventBus The bus to subscribe to.
+ * @param journal The open sink of the journal; must outlive the dispatcher thread.
+ * @return The journal's flush state, for flushEventJournalIfDue().
+ */
+static std::shared_ptr<EventJournalState> subscribeEventJournal(EventBus& eventBus, AsyncFileSink& journal) {
+    auto state = std::make_shared<EventJournalState>(journal); // Shared by the subscriptions of all event types
+    auto appendLine = [state](const BmsEvent& event) {
+        std::string line = describeEvent(event) + "\n";
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->journal.write(line.data(), line.size());
+        state->pendingBytes += line.size();
+        if (state->pendingBytes >= EVENT_JOURNAL_FLUSH_BYTES || event.type == EventType::FAULT) {
+            flushEventJournalLocked(*state, std::chrono::steady_clock::now());
+        }
+    };
+    for (uint8_t type = 0; type < EVENT_TYPE_COUNT; ++type) {
+        eventBus.subscribe(static_cast<EventType>(type), appendLine);
+    }
+    return state;
+}
+
+/**
+ * @brief Flushes an event journal whose pending lines have waited EVENT_JOURNAL_FLUSH_INTERVAL_MS.
+ * Called by the control loop after every update.
+ * @param state The journal, null if it is not open.
+ */
+static void flushEventJournalIfDue(EventJournalState* state) {
+    if (state == nullptr) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->pendingBytes > 0 && now - state->lastFlush >= std::chrono::milliseconds(EVENT_JOURNAL_FLUSH_INTERVAL_MS)) {
+        flushEventJournalLocked(*state, now);
+    }
+}
+
+/**
+ * @brief Writes residency histograms as CSV, replacing the file.
+ * @param histogram The histograms to export.
+ * @param path The file to write.
+ * @return True if the file was written, false otherwise.
  */
-int main() {
+static bool exportResidency(const ResidencyHistogram& histogram, const char* path) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    histogram.exportCsv(file);
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief Runs a single BMS in real time, printing its status every update.
+ * Events are printed by console subscribers on the event bus dispatcher thread and
+ * appended to the event journal; the telemetry frames are appended to the telemetry file.
+ * Ctrl+C stops the loop: the telemetry file is closed, the flight recorder, the current
+ * acquisition and the event bus are stopped, and the event journal is closed once the
+ * dispatcher thread, its writer, has stopped.
+ * @return Process exit code.
+ */
+static int runSinglePack() {
+    // Journal and telemetry files, written without blocking the control loop
+    AsyncFileSink eventJournal(EVENT_JOURNAL_FILE_PATH);
+    AsyncFileSink telemetryFile(TELEMETRY_FILE_PATH);
+    if (!eventJournal.open() || !telemetryFile.open()) {
+        std::cerr << "[ERROR] Could not open " << EVENT_JOURNAL_FILE_PATH << " or " << TELEMETRY_FILE_PATH << std::endl;
+    }
+
+    // Create the event bus with console subscribers and attach the BMS to it
+    EventBus eventBus;
+    subscribeConsoleLogging(eventBus);
+    std::shared_ptr<EventJournalState> journalState;
+    if (eventJournal.isOpen()) {
+        journalState = subscribeEventJournal(eventBus, eventJournal);
+    }
+    eventBus.start();
+
+    // Sample the pack current at high rate for the Coulomb counter and short-circuit protection
+    ShortCircuitDetector shortCircuitDetector;
+    CurrentAcquisition currentAcquisition;
+    currentAcquisition.attachShortCircuitDetector(&shortCircuitDetector);
+    currentAcquisition.start();
+
+    // Record the updates around faults to freeze-frame files
+    FlightRecorder flightRecorder;
+    flightRecorder.start();
+
     // Create an instance of the BMS
     BMS myBMS;
+    myBMS.attachEventBus(&eventBus);
+    myBMS.attachCurrentAcquisition(&currentAcquisition);
+    myBMS.attachFlightRecorder(&flightRecorder);
+
+    std::signal(SIGINT, requestStop);
 
-    // Initialize the BMS
+    // Initialize the BMS, resuming SoC/SoH and energy counters from the last checkpoint
     myBMS.init();
+    if (myBMS.loadCheckpoint(CHECKPOINT_FILE_PATH)) {
+        std::cout << "[LOG] Restored estimator state from " << CHECKPOINT_FILE_PATH << std::endl;
+    }
+    if (myBMS.loadCellParameters(ECM_PARAMETER_FILE_PATH)) {
+        std::cout << "[LOG] Applied identified cell parameters from " << ECM_PARAMETER_FILE_PATH << std::endl;
+    }
 
     // Calculate delta time in seconds for SoC updates
     float deltaTime_s = static_cast<float>(BMS_UPDATE_INTERVAL_MS) / 1000.0f;
 
+    // Telemetry encoder and volume counters (frames would also go to the comms bus); every
+    // frame is recorded after its 16-bit length
+    TelemetryEncoder telemetryEncoder;
+    TelemetryChannels telemetryChannels;
+    uint8_t telemetryRecord[sizeof(uint16_t) + TELEMETRY_MAX_FRAME_BYTES];
+    uint8_t* telemetryFrame = telemetryRecord + sizeof(uint16_t);
+    uint64_t telemetryBytes = 0;
+    uint64_t telemetryFullBytes = 0;
+
     // Main application loop
-    while (true) {
+    uint32_t updateCount = 0;
+    while (!g_stopRequested) {
         // Update the BMS state (read sensors, evaluate safety, etc.)
         myBMS.update(deltaTime_s);
 
+        // Encode the telemetry frame for this update
+        myBMS.getTelemetryChannels(telemetryChannels);
+        uint16_t frameBytes = static_cast<uint16_t>(telemetryEncoder.encode(telemetryChannels, telemetryFrame));
+        std::memcpy(telemetryRecord, &frameBytes, sizeof(frameBytes));
+        telemetryFile.write(telemetryRecord, sizeof(frameBytes) + frameBytes);
+        telemetryBytes += frameBytes;
+        telemetryFullBytes += TELEMETRY_HEADER_BYTES + sizeof(float) * TELEMETRY_CHANNEL_COUNT;
+        flushEventJournalIfDue(journalState.get());
+
+        // Periodically persist the estimator state and the residency histograms, flush the
+        // telemetry file and report the telemetry volume
+        if (++updateCount % CHECKPOINT_INTERVAL_UPDATES == 0) {
+            myBMS.saveCheckpoint(CHECKPOINT_FILE_PATH);
+            exportResidency(myBMS.getResidencyHistogram(), RESIDENCY_FILE_PATH);
+            telemetryFile.flush();
+            std::cout << "[LOG] Telemetry: " << telemetryBytes << " bytes sent, "
+                      << telemetryFullBytes << " bytes as full frames." << std::endl;
+        }
+
         // In a real embedded system, this would be a hardware-specific delay
         // or a task scheduler. For simulation, we use std::this_thread::sleep_for.
         std::this_thread::sleep_for(std::chrono::milliseconds(BMS_UPDATE_INTERVAL_MS));
@@ -36,5 +251,1447 @@ int main() {
         }
     }
 
+    // Shut down: the journal is written by the dispatcher thread, so it closes after the bus stops
+    std::cout << "[LOG] Stopping after " << updateCount << " updates." << std::endl;
+    telemetryFile.close();
+    flightRecorder.stop();
+    currentAcquisition.stop();
+    eventBus.stop();
+    eventJournal.close();
+    myBMS.saveCheckpoint(CHECKPOINT_FILE_PATH);
+    exportResidency(myBMS.getResidencyHistogram(), RESIDENCY_FILE_PATH);
+    return 0;
+}
+
+/**
+ * @brief Runs a single BMS in real time with the live terminal dashboard instead of
+ * the scrolling console output. Ctrl+C restores the terminal and exits. Events are also
+ * appended to the event journal.
+ * @return Process exit code.
+ */
+static int runDashboard() {
+    AsyncFileSink eventJournal(EVENT_JOURNAL_FILE_PATH);
+    EventBus eventBus;
+    std::shared_ptr<EventJournalState> journalState;
+    if (eventJournal.open()) {
+        journalState = subscribeEventJournal(eventBus, eventJournal);
+    }
+    Seqlock<BmsSnapshot> snapshot;
+    Dashboard dashboard(snapshot, eventBus);
+    ShortCircuitDetector shortCircuitDetector;
+    CurrentAcquisition currentAcquisition;
+    currentAcquisition.attachShortCircuitDetector(&shortCircuitDetector);
+    FlightRecorder flightRecorder;
+
+    BMS myBMS;
+    myBMS.setConsoleOutput(false);
+    myBMS.attachEventBus(&eventBus);
+    myBMS.attachSnapshot(&snapshot);
+    myBMS.attachCurrentAcquisition(&currentAcquisition);
+    myBMS.attachFlightRecorder(&flightRecorder);
+
+    std::signal(SIGINT, requestStop);
+    eventBus.start();
+    dashboard.start();
+    currentAcquisition.start();
+    flightRecorder.start();
+
+    myBMS.init();
+    myBMS.loadCheckpoint(CHECKPOINT_FILE_PATH);
+    myBMS.loadCellParameters(ECM_PARAMETER_FILE_PATH);
+
+    float deltaTime_s = static_cast<float>(BMS_UPDATE_INTERVAL_MS) / 1000.0f;
+    uint32_t updateCount = 0;
+    while (!g_stopRequested) {
+        myBMS.update(deltaTime_s);
+        flushEventJournalIfDue(journalState.get());
+        if (++updateCount % CHECKPOINT_INTERVAL_UPDATES == 0) {
+            myBMS.saveCheckpoint(CHECKPOINT_FILE_PATH);
+            exportResidency(myBMS.getResidencyHistogram(), RESIDENCY_FILE_PATH);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(BMS_UPDATE_INTERVAL_MS));
+    }
+
+    currentAcquisition.stop();
+    flightRecorder.stop();
+    dashboard.stop();
+    eventBus.stop();
+    myBMS.saveCheckpoint(CHECKPOINT_FILE_PATH);
+    exportResidency(myBMS.getResidencyHistogram(), RESIDENCY_FILE_PATH);
+    return 0;
+}
+
+/**
+ * @brief Runs a fleet of packs as fast as possible, printing the fleet-wide worst cells.
+ * @param packCount Number of packs to simulate.
+ * @param execution How the fleet runs the estimators of its packs.
+ * @return Process exit code.
+ */
+static int runFleet(size_t packCount, FleetExecution execution) {
+    auto constructionStart = std::chrono::steady_clock::now();
+    Fleet fleet(packCount, 0, execution);
+    auto construction = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - constructionStart);
+    float deltaTime_s = static_cast<float>(BMS_UPDATE_INTERVAL_MS) / 1000.0f;
+    std::cout << "[LOG] Fleet simulation with " << packCount << " packs"
+              << (execution == FleetExecution::PACK_MAJOR ? ", pack-major" : "") << " (constructed in "
+              << std::fixed << std::setprecision(1) << construction.count() << "ms, "
+              << (packCount > 0 ? fleet.getPackMemoryBytes() / packCount : 0) << " bytes per pack)." << std::endl;
+
+    std::vector<EnergyReport> energyReports; // Reused across ticks
+    ResidencyHistogram fleetResidency;       // Reused across exports
+    while (true) {
+        auto start = std::chrono::steady_clock::now();
+        fleet.update(deltaTime_s);
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+        auto snapshot = fleet.getSnapshot();
+        const RankedCell& hottest = snapshot->worstCells[static_cast<size_t>(CellMetric::MAX_TEMPERATURE)][0];
+        const RankedCell& lowest = snapshot->worstCells[static_cast<size_t>(CellMetric::MIN_VOLTAGE)][0];
+        const RankedCell& deviating = snapshot->worstCells[static_cast<size_t>(CellMetric::MAX_DEVIATION)][0];
+        const RankedCell& resistive = snapshot->worstCells[static_cast<size_t>(CellMetric::MAX_RESISTANCE)][0];
+        std::cout << "Tick " << snapshot->tick << " (" << std::fixed << std::setprecision(1) << elapsed.count() << "ms)"
+                  << " | Hottest: pack " << hottest.packIndex << " cell " << (int)hottest.cellId << " " << hottest.value << "C"
+                  << " | Lowest: pack " << lowest.packIndex << " cell " << (int)lowest.cellId
+                  << " " << std::setprecision(3) << lowest.value << "V"
+                  << " | Largest deviation: pack " << deviating.packIndex << " cell " << (int)deviating.cellId
+                  << " " << deviating.value << "V"
+                  << " | Highest R0: pack " << resistive.packIndex << " cell " << (int)resistive.cellId
+                  << " " << std::setprecision(1) << resistive.value * 1000.0f << "mOhm" << std::endl;
+
+        const FleetPercentiles& soc = snapshot->percentiles[static_cast<size_t>(FleetDistribution::STATE_OF_CHARGE)];
+        const FleetPercentiles& soh = snapshot->percentiles[static_cast<size_t>(FleetDistribution::STATE_OF_HEALTH)];
+        const FleetPercentiles& temp = snapshot->percentiles[static_cast<size_t>(FleetDistribution::CELL_TEMPERATURE)];
+        const FleetPercentiles& imbalance = snapshot->percentiles[static_cast<size_t>(FleetDistribution::IMBALANCE)];
+        std::cout << "  p1/p50/p99"
+                  << " | SoC: " << std::setprecision(1) << soc.p1 << "/" << soc.p50 << "/" << soc.p99 << "%"
+                  << " | SoH: " << soh.p1 << "/" << soh.p50 << "/" << soh.p99 << "%"
+                  << " | Temp: " << temp.p1 << "/" << temp.p50 << "/" << temp.p99 << "C"
+                  << " | Imbalance: " << std::setprecision(3) << imbalance.p1 << "/" << imbalance.p50 << "/" << imbalance.p99 << "V"
+                  << std::endl;
+
+        fleet.queryEnergy(energyReports);
+        double energyIn_Wh = 0.0;
+        double energyOut_Wh = 0.0;
+        for (const EnergyReport& report : energyReports) {
+            energyIn_Wh += report.energyIn_Wh;
+            energyOut_Wh += report.energyOut_Wh;
+        }
+        std::cout << "  Fleet energy | In: " << std::setprecision(3) << energyIn_Wh / 1000.0 << "kWh"
+                  << " | Out: " << energyOut_Wh / 1000.0 << "kWh" << std::endl;
+
+        // Aggregate the warranty data of the whole fleet
+        if (snapshot->tick % FLEET_RESIDENCY_EXPORT_TICKS == 0) {
+            fleet.mergeResidency(fleetResidency);
+            exportResidency(fleetResidency, FLEET_RESIDENCY_FILE_PATH);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Simulates the usage of a fleet of packs over days to years and prints the safety outcomes.
+ * @param packCount Number of packs to simulate.
+ * @param days Simulated time in days.
+ * @param stepping How the packs are advanced.
+ * @return Process exit code.
+ */
+static int runLifetime(size_t packCount, uint64_t days, SimulationStepping stepping) {
+    EventDrivenSimulator simulator(packCount, stepping, 1);
+    auto start = std::chrono::steady_clock::now();
+    simulator.run(days * 86400);
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    LifetimeStatistics statistics = simulator.getStatistics();
+    uint64_t totalSteps = statistics.evaluatedSteps + statistics.skippedSteps;
+    std::cout << "[LOG] Lifetime simulation of " << packCount << " packs over " << days << " days ("
+              << (stepping == SimulationStepping::EVENT_DRIVEN ? "event-driven" : "fixed-step") << ") in "
+              << std::fixed << std::setprecision(1) << elapsed.count() << "ms." << std::endl;
+    std::cout << "Evaluated " << statistics.evaluatedSteps << " of " << totalSteps << " pack time steps, "
+              << statistics.idleJumps << " idle jumps, " << statistics.chargeCycles << " charge cycles." << std::endl;
+    for (size_t state = 0; state < statistics.stepsInState.size(); ++state) {
+        double share = totalSteps > 0 ? 100.0 * statistics.stepsInState[state] / totalSteps : 0.0;
+        std::cout << std::left << std::setw(9) << toString(static_cast<SystemState>(state)) << std::right
+                  << std::setprecision(3) << share << "% of the time, entered " << statistics.entriesIntoState[state]
+                  << " times" << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * @brief Simulates a fleet with event-driven and with fixed stepping and checks that the outcomes agree.
+ * The time in and the entries into every safety state must match exactly, as must each
+ * pack's final state and the charge cycles; each pack's SoH may differ by rounding up
+ * to LIFETIME_COMPARE_SOH_TOLERANCE_PERCENT, since idle jumps sum self-discharge in one go.
+ * @param packCount Number of packs to simulate.
+ * @param days Simulated time in days.
+ * @return Process exit code: 0 if the outcomes agree, 1 otherwise.
+ */
+static int runLifetimeComparison(size_t packCount, uint64_t days) {
+    EventDrivenSimulator eventDriven(packCount, SimulationStepping::EVENT_DRIVEN, 1);
+    EventDrivenSimulator fixedStep(packCount, SimulationStepping::FIXED_STEP, 1);
+    eventDriven.run(days * 86400);
+    fixedStep.run(days * 86400);
+
+    LifetimeStatistics event = eventDriven.getStatistics();
+    LifetimeStatistics fixed = fixedStep.getStatistics();
+    bool agree = event.chargeCycles == fixed.chargeCycles;
+    for (size_t state = 0; state < event.stepsInState.size(); ++state) {
+        std::cout << std::left << std::setw(9) << toString(static_cast<SystemState>(state)) << std::right
+                  << " event-driven " << event.stepsInState[state] << " steps, entered " << event.entriesIntoState[state]
+                  << " times | fixed-step " << fixed.stepsInState[state] << " steps, entered "
+                  << fixed.entriesIntoState[state] << " times" << std::endl;
+        agree = agree && event.stepsInState[state] == fixed.stepsInState[state]
+                && event.entriesIntoState[state] == fixed.entriesIntoState[state];
+    }
+
+    size_t stateMismatches = 0;
+    float worstSohDifference_percent = 0.0f;
+    for (size_t pack = 0; pack < packCount; ++pack) {
+        if (eventDriven.getPackState(pack) != fixedStep.getPackState(pack)) {
+            ++stateMismatches;
+        }
+        worstSohDifference_percent = std::max(worstSohDifference_percent,
+            std::fabs(eventDriven.getPackStateOfHealth_percent(pack) - fixedStep.getPackStateOfHealth_percent(pack)));
+    }
+    agree = agree && stateMismatches == 0 && worstSohDifference_percent <= LIFETIME_COMPARE_SOH_TOLERANCE_PERCENT;
+    std::cout << "Charge cycles " << std::fixed << std::setprecision(1) << event.chargeCycles << " vs " << fixed.chargeCycles
+              << ", " << stateMismatches << " packs in a different final state, largest SoH difference "
+              << std::setprecision(6) << worstSohDifference_percent << "%." << std::endl;
+    std::cout << (agree ? "[LOG] Event-driven and fixed stepping agree." : "[ERROR] Event-driven and fixed stepping differ.")
+              << std::endl;
+    return agree ? 0 : 1;
+}
+
+/**
+ * @brief Identifies the ECM parameters of every cell of a recorded trace and writes them to a file.
+ * @param tracePath The recorded trace (see EcmIdentifier::loadTrace()).
+ * @param outputPath The parameter file to write.
+ * @return Process exit code.
+ */
+static int runEcmFit(const char* tracePath, const char* outputPath) {
+    EcmTrace trace;
+    if (!EcmIdentifier::loadTrace(tracePath, trace)) {
+        std::cerr << "[ERROR] Could not read trace " << tracePath << std::endl;
+        return 1;
+    }
+    EcmIdentifier identifier;
+    std::vector<EcmParameters> parameters;
+    auto start = std::chrono::steady_clock::now();
+    identifier.fit(trace, parameters);
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    float worstError_V = 0.0f;
+    for (const EcmParameters& cell : parameters) {
+        worstError_V = std::max(worstError_V, cell.rmsError_V);
+    }
+    std::cout << "[LOG] Fitted " << trace.cellCount << " cells over " << trace.current_A.size() << " samples in "
+              << std::fixed << std::setprecision(1) << elapsed.count() << "ms, worst RMS error "
+              << std::setprecision(2) << worstError_V * 1000.0f << "mV." << std::endl;
+    if (!EcmIdentifier::saveParameters(outputPath, parameters)) {
+        std::cerr << "[ERROR] Could not write " << outputPath << std::endl;
+        return 1;
+    }
+    std::cout << "[LOG] Wrote parameters to " << outputPath << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Measures the fleet quantile sketches on one distribution against exact quantiles and prints a row.
+ * The values are added round-robin to SKETCH_BENCH_SHARDS shard sketches, which are merged
+ * pairwise in a tree as in Fleet::update(). The exact quantiles are selected with
+ * std::nth_element from a copy of all values, i.e. what collecting the values every tick
+ * would cost. Errors are rank errors: how far the share of values below the estimate is
+ * from the quantile asked for.
+ * @param name Name of the distribution.
+ * @param values The values.
+ */
+static void benchSketchAccuracy(const char* name, const std::vector<float>& values) {
+    const float quantiles[3] = {0.01f, 0.50f, 0.99f};
+    float estimates[3];
+    auto start = std::chrono::steady_clock::now();
+    std::vector<QuantileSketch> shards(SKETCH_BENCH_SHARDS);
+    for (size_t i = 0; i < values.size(); ++i) {
+        shards[i % SKETCH_BENCH_SHARDS].add(values[i]);
+    }
+    for (size_t stride = 1; stride < shards.size(); stride *= 2) {
+        for (size_t shard = 0; shard + stride < shards.size(); shard += 2 * stride) {
+            shards[shard].merge(shards[shard + stride]);
+        }
+    }
+    shards[0].flush();
+    for (int k = 0; k < 3; ++k) {
+        estimates[k] = shards[0].quantile(quantiles[k]);
+    }
+    auto sketchTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    float exact[3];
+    start = std::chrono::steady_clock::now();
+    std::vector<float> selected(values);
+    for (int k = 0; k < 3; ++k) {
+        auto nth = selected.begin() + static_cast<size_t>(quantiles[k] * (selected.size() - 1));
+        std::nth_element(selected.begin(), nth, selected.end());
+        exact[k] = *nth;
+    }
+    auto exactTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    std::vector<float> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed;
+    const char* labels[3] = {"p1", "p50", "p99"};
+    for (int k = 0; k < 3; ++k) {
+        size_t rank = std::lower_bound(sorted.begin(), sorted.end(), estimates[k]) - sorted.begin();
+        double rankError = static_cast<double>(rank) / sorted.size() - quantiles[k];
+        std::cout << " | " << labels[k] << " " << std::setprecision(3) << estimates[k] << "/" << exact[k]
+                  << " (" << std::showpos << std::setprecision(3) << 100.0 * rankError << std::noshowpos << "%)";
+    }
+    std::cout << " | sketch add+merge " << std::setprecision(1) << sketchTime.count() << "ms, collect+select " << exactTime.count()
+              << "ms" << std::endl;
+}
+
+/**
+ * @brief Times the tree merge of a number of filled shard sketches and prints a row.
+ * Each shard sketch summarises SKETCH_BENCH_VALUES / SKETCH_BENCH_MAX_SHARDS values; the
+ * merge is repeated on fresh copies until it has run for long enough to time.
+ * @param shardCount Number of shard sketches.
+ * @param filled SKETCH_BENCH_MAX_SHARDS filled and flushed sketches.
+ */
+static void benchSketchMerge(size_t shardCount, const std::vector<QuantileSketch>& filled) {
+    std::vector<QuantileSketch> shards(shardCount);
+    double elapsed_ns = 0.0;
+    uint32_t repetitions = 0;
+    float checksum = 0.0f;
+    while (elapsed_ns < 2e8 || repetitions < 3) {
+        std::copy(filled.begin(), filled.begin() + shardCount, shards.begin());
+        auto start = std::chrono::steady_clock::now();
+        for (size_t stride = 1; stride < shardCount; stride *= 2) {
+            for (size_t shard = 0; shard + stride < shardCount; shard += 2 * stride) {
+                shards[shard].merge(shards[shard + stride]);
+            }
+        }
+        shards[0].flush();
+        elapsed_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        checksum += shards[0].quantile(0.5f);
+        ++repetitions;
+    }
+    g_benchmarkSink = checksum;
+    double perTree_us = elapsed_ns / repetitions / 1000.0;
+    std::cout << std::setw(5) << shardCount << " shards | tree merge " << std::fixed << std::setprecision(1)
+              << perTree_us << "us, " << std::setprecision(0)
+              << (shardCount > 1 ? elapsed_ns / repetitions / (shardCount - 1) : 0.0) << "ns per merge" << std::endl;
+}
+
+/**
+ * @brief Benchmarks the accuracy and merge cost of the fleet quantile sketches.
+ * Accuracy is measured on distributions like the fleet's: roughly normal cell temperatures,
+ * SoC spread over the whole range and a long-tailed imbalance.
+ * @return Process exit code.
+ */
+static int runSketchBenchmark() {
+    SplitMix64 random(SKETCH_BENCH_VALUES);
+    std::normal_distribution<float> temperature(25.0f, 8.0f);
+    std::uniform_real_distribution<float> soc(0.0f, 100.0f);
+    std::lognormal_distribution<float> imbalance(-3.5f, 0.8f);
+    std::vector<float> temperatures(SKETCH_BENCH_VALUES);
+    std::vector<float> socs(SKETCH_BENCH_VALUES);
+    std::vector<float> imbalances(SKETCH_BENCH_VALUES);
+    for (uint32_t i = 0; i < SKETCH_BENCH_VALUES; ++i) {
+        temperatures[i] = temperature(random);
+        socs[i] = soc(random);
+        imbalances[i] = imbalance(random);
+    }
+
+    std::cout << "[LOG] Quantile sketches (" << sizeof(QuantileSketch) << " bytes each), " << SKETCH_BENCH_VALUES
+              << " values over " << SKETCH_BENCH_SHARDS << " shards, estimate/exact (rank error):" << std::endl;
+    benchSketchAccuracy("normal temperature C", temperatures);
+    benchSketchAccuracy("uniform SoC %", socs);
+    benchSketchAccuracy("lognormal imbalance V", imbalances);
+
+    std::vector<QuantileSketch> filled(SKETCH_BENCH_MAX_SHARDS);
+    for (uint32_t i = 0; i < SKETCH_BENCH_VALUES; ++i) {
+        filled[i % SKETCH_BENCH_MAX_SHARDS].add(temperatures[i]);
+    }
+    for (QuantileSketch& sketch : filled) {
+        sketch.flush();
+    }
+    std::cout << "[LOG] Merge cost of the shard sketches:" << std::endl;
+    for (size_t shardCount = 2; shardCount <= SKETCH_BENCH_MAX_SHARDS; shardCount *= 8) {
+        benchSketchMerge(shardCount, filled);
+    }
+    return 0;
+}
+
+/**
+ * @brief Times a kernel over every pack of the benchmark readings.
+ * @param rounds Number of passes over the packs.
+ * @param kernel Called with the index of a pack.
+ * @return Average time per call in nanoseconds.
+ */
+template <typename Kernel>
+static double timeCellKernel(uint32_t rounds, Kernel kernel) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < rounds; ++round) {
+        for (size_t pack = 0; pack < CELL_KERNEL_BENCH_PACKS; ++pack) {
+            kernel(pack);
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() / (static_cast<double>(rounds) * CELL_KERNEL_BENCH_PACKS);
+}
+
+/**
+ * @brief Times the compiled kernels of one pack size against the generic loops and prints a row.
+ * The generic loops get the cell count through a volatile, so they run as they would for a
+ * pack size without compiled kernels rather than being specialized by the compiler.
+ * @tparam N Number of cells.
+ */
+template <size_t N>
+static void benchCellKernels() {
+    const uint32_t rounds = std::max<uint32_t>(CELL_KERNEL_BENCH_ROUNDS * 4 / N, 1);
+    std::vector<float> voltages(CELL_KERNEL_BENCH_PACKS * N);
+    std::vector<float> temperatures(CELL_KERNEL_BENCH_PACKS * N);
+    SplitMix64 random(N);
+    std::uniform_real_distribution<float> voltage(MIN_VOLTAGE_NORMAL, MAX_VOLTAGE_NORMAL);
+    std::uniform_real_distribution<float> temperature(MIN_TEMP_NORMAL, MAX_TEMP_NORMAL);
+    for (size_t i = 0; i < voltages.size(); ++i) {
+        voltages[i] = voltage(random);
+        temperatures[i] = temperature(random);
+    }
+    std::vector<float> last(N, 0.0f);
+    std::vector<uint16_t> unchanged(N, 0);
+    volatile size_t runtimeCellCount = N;
+    const size_t cellCount = runtimeCellCount;
+
+    uint32_t flags = 0;
+    float checksum = 0.0f;
+    double compiled[3];
+    double generic[3];
+    compiled[0] = timeCellKernel(rounds, [&](size_t pack) {
+        flags |= CellKernels<N>::safetyFlags(&voltages[pack * N], &temperatures[pack * N]);
+    });
+    generic[0] = timeCellKernel(rounds, [&](size_t pack) {
+        flags |= GenericCellKernels::safetyFlags(cellCount, &voltages[pack * N], &temperatures[pack * N]);
+    });
+    compiled[1] = timeCellKernel(rounds, [&](size_t pack) {
+        CellStatistics statistics = CellKernels<N>::statistics(&voltages[pack * N], &temperatures[pack * N]);
+        checksum += statistics.minVoltage_V + statistics.maxVoltage_V + statistics.sumVoltage_V
+                  + statistics.minTemperature_C + statistics.maxTemperature_C;
+    });
+    generic[1] = timeCellKernel(rounds, [&](size_t pack) {
+        CellStatistics statistics = GenericCellKernels::statistics(cellCount, &voltages[pack * N], &temperatures[pack * N]);
+        checksum += statistics.minVoltage_V + statistics.maxVoltage_V + statistics.sumVoltage_V
+                  + statistics.minTemperature_C + statistics.maxTemperature_C;
+    });
+    compiled[2] = timeCellKernel(rounds, [&](size_t pack) {
+        CellKernels<N>::persistenceFilter(&voltages[pack * N], last.data(), unchanged.data(),
+                                          DIAG_STUCK_VOLTAGE_EPSILON_V, DIAG_STUCK_WINDOW_TICKS, true);
+    });
+    generic[2] = timeCellKernel(rounds, [&](size_t pack) {
+        GenericCellKernels::persistenceFilter(cellCount, &voltages[pack * N], last.data(), unchanged.data(),
+                                              DIAG_STUCK_VOLTAGE_EPSILON_V, DIAG_STUCK_WINDOW_TICKS, true);
+    });
+
+    std::cout << std::setw(5) << N << " cells (" << CellKernels<N>::LANES << " lanes)" << std::fixed << std::setprecision(1);
+    const char* names[3] = {"flags", "statistics", "filter"};
+    for (int k = 0; k < 3; ++k) {
+        std::cout << " | " << names[k] << " " << compiled[k] << "/" << generic[k] << "ns ("
+                  << std::setprecision(2) << generic[k] / compiled[k] << "x)" << std::setprecision(1);
+    }
+    std::cout << std::endl;
+    g_benchmarkSink = checksum + static_cast<float>(flags) + unchanged[0];
+}
+
+/**
+ * @brief Benchmarks the compiled cell kernels of every supported pack size against the generic loops.
+ * @return Process exit code.
+ */
+static int runCellKernelBenchmark() {
+    std::cout << "[LOG] Cell kernels, compiled/generic time per pack:" << std::endl;
+    benchCellKernels<4>();
+    benchCellKernels<12>();
+    benchCellKernels<16>();
+    benchCellKernels<96>();
+    benchCellKernels<108>();
+    return 0;
+}
+
+/**
+ * @brief Times a band classifier over the benchmark frames.
+ * @param classify Called once per round; classifies every frame.
+ * @return Average time per cell reading in nanoseconds.
+ */
+template <typename Classifier>
+static double timeBandClassifier(Classifier classify) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < BAND_BENCH_ROUNDS; ++round) {
+        classify();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() / (static_cast<double>(BAND_BENCH_ROUNDS) * BAND_BENCH_FRAMES * NUM_CELLS);
+}
+
+/**
+ * @brief Times the three ways to classify frames of ADC codes on one mix of readings and prints a row.
+ * The per-pack kernels are what BMS::update() runs: the codes of a frame are converted to
+ * cells and classified with SafetyManager::proposeState(). The compare kernels convert
+ * whole blocks and classify them with the vectorized compares of proposeStates(), and the
+ * lookup table classifies every reading with one load. All three must agree.
+ * @param name Name of the mix.
+ * @param voltageCodes Voltage codes are drawn uniformly from this range.
+ * @param temperatureCodes Temperature codes are drawn uniformly from this range.
+ * @param table The band lookup table.
+ */
+static void benchBandClassifiers(const char* name, std::uniform_int_distribution<int> voltageCodes,
+                                 std::uniform_int_distribution<int> temperatureCodes, const BandLookupTable& table) {
+    std::vector<uint16_t> voltages(BAND_BENCH_FRAMES * NUM_CELLS);
+    std::vector<int16_t> temperatures(BAND_BENCH_FRAMES * NUM_CELLS);
+    std::vector<float> currents(BAND_BENCH_FRAMES, 0.0f);
+    std::vector<float> soh(BAND_BENCH_FRAMES, 100.0f);
+    SplitMix64 random(BAND_BENCH_FRAMES);
+    for (size_t i = 0; i < voltages.size(); ++i) {
+        voltages[i] = static_cast<uint16_t>(voltageCodes(random));
+        temperatures[i] = static_cast<int16_t>(temperatureCodes(random));
+    }
+    SafetyCodeFrames frames = {BAND_BENCH_FRAMES, voltages.data(), temperatures.data(), currents.data(), soh.data()};
+
+    std::vector<SystemState> perPack(BAND_BENCH_FRAMES);
+    std::vector<SystemState> compared(BAND_BENCH_FRAMES);
+    std::vector<SystemState> lookedUp(BAND_BENCH_FRAMES);
+    SafetyManager safetyManager;
+    std::array<BatteryCell, NUM_CELLS> cells;
+    for (uint8_t i = 0; i < NUM_CELLS; ++i) {
+        cells[i] = BatteryCell(i, 0.0f, 0.0f);
+    }
+    double perPack_ns = timeBandClassifier([&]() {
+        for (size_t t = 0; t < BAND_BENCH_FRAMES; ++t) {
+            for (size_t c = 0; c < NUM_CELLS; ++c) {
+                cells[c].setVoltage(static_cast<float>(voltages[t * NUM_CELLS + c]) * ADC_VOLTAGE_LSB_V);
+                cells[c].setTemperature(static_cast<float>(temperatures[t * NUM_CELLS + c]) * ADC_TEMPERATURE_LSB_C);
+            }
+            perPack[t] = safetyManager.proposeState(cells, currents[t], soh[t]);
+        }
+    });
+    double compared_ns = timeBandClassifier([&]() { SafetyManager::proposeStates(frames, nullptr, compared.data()); });
+    double lookedUp_ns = timeBandClassifier([&]() { SafetyManager::proposeStates(frames, &table, lookedUp.data()); });
+
+    size_t mismatches = 0;
+    uint32_t nonNormal = 0;
+    for (size_t t = 0; t < BAND_BENCH_FRAMES; ++t) {
+        mismatches += (perPack[t] != lookedUp[t]) + (compared[t] != lookedUp[t]);
+        nonNormal += lookedUp[t] != SystemState::NORMAL;
+    }
+    g_benchmarkSink = static_cast<float>(nonNormal);
+    std::cout << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(2)
+              << " | per-pack kernels " << perPack_ns << "ns | compare kernels " << compared_ns
+              << "ns | lookup table " << lookedUp_ns << "ns (" << std::setprecision(1) << perPack_ns / lookedUp_ns << "x, "
+              << compared_ns / lookedUp_ns << "x) | " << std::setprecision(0) << 100.0 * nonNormal / BAND_BENCH_FRAMES
+              << "% frames not NORMAL, " << mismatches << " mismatches" << std::endl;
+}
+
+/**
+ * @brief Benchmarks the band lookup table against the compare kernels on frames of ADC codes.
+ * Also times a rebuild of the tables, which a reload of the limits costs.
+ * @return Process exit code.
+ */
+static int runBandBenchmark() {
+    auto start = std::chrono::steady_clock::now();
+    BandLookupTable table;
+    auto build = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << "[LOG] Band classifiers, " << BAND_BENCH_FRAMES << " frames of " << static_cast<int>(NUM_CELLS)
+              << " cells, time per cell reading:" << std::endl;
+    std::uniform_int_distribution<int> normalVoltages(static_cast<int>(MIN_VOLTAGE_NORMAL / ADC_VOLTAGE_LSB_V),
+                                                      static_cast<int>(MAX_VOLTAGE_NORMAL / ADC_VOLTAGE_LSB_V));
+    std::uniform_int_distribution<int> normalTemperatures(static_cast<int>(MIN_TEMP_NORMAL / ADC_TEMPERATURE_LSB_C),
+                                                          static_cast<int>(MAX_TEMP_NORMAL / ADC_TEMPERATURE_LSB_C));
+    benchBandClassifiers("mostly normal", normalVoltages, normalTemperatures, table);
+    std::uniform_int_distribution<int> mixedVoltages(static_cast<int>(0.5f / ADC_VOLTAGE_LSB_V),
+                                                     static_cast<int>(5.0f / ADC_VOLTAGE_LSB_V));
+    std::uniform_int_distribution<int> mixedTemperatures(static_cast<int>(-25.0f / ADC_TEMPERATURE_LSB_C),
+                                                         static_cast<int>(75.0f / ADC_TEMPERATURE_LSB_C));
+    benchBandClassifiers("all bands", mixedVoltages, mixedTemperatures, table);
+
+    start = std::chrono::steady_clock::now();
+    table.rebuild(BandThresholds());
+    auto rebuild = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << "[LOG] Table build " << std::setprecision(2) << build.count() << "ms, rebuild after a reload "
+              << rebuild.count() << "ms" << std::endl;
     return 0;
 }
+
+/**
+ * @brief Measures the sustained write rate of one sink configuration with many packs recording at once.
+ * Every pack encodes the telemetry frame of a random walk per update and appends it,
+ * after its pack index and length, to one shared sink for ASYNC_SINK_BENCH_SECONDS. The
+ * producer never waits, so the bytes written rather than dropped, up to the end of
+ * close(), measure the sustained rate of the configuration.
+ * @param packCount Number of recording packs.
+ * @param backend The backend to request.
+ * @param options The ASYNC_SINK_* options to request.
+ */
+static void benchSink(size_t packCount, SinkBackend backend, uint8_t options) {
+    AsyncFileSink sink(ASYNC_SINK_BENCH_FILE_PATH, backend, options);
+    if (!sink.open()) {
+        std::cerr << "[ERROR] Could not open " << ASYNC_SINK_BENCH_FILE_PATH << std::endl;
+        return;
+    }
+    std::vector<TelemetryEncoder> encoders(packCount);
+    std::vector<TelemetryChannels> channels(packCount);
+    for (TelemetryChannels& pack : channels) {
+        pack.fill(1.0f);
+    }
+    SplitMix64 random(packCount);
+    std::uniform_real_distribution<float> step(-0.05f, 0.05f);
+    const uint32_t headerBytes = sizeof(uint32_t) + sizeof(uint16_t);
+    uint8_t record[headerBytes + TELEMETRY_MAX_FRAME_BYTES];
+    QuantileSketch latency_ns;
+    float maxLatency_ns = 0.0f;
+    uint64_t records = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::seconds(ASYNC_SINK_BENCH_SECONDS);
+    while (std::chrono::steady_clock::now() < end) {
+        for (size_t pack = 0; pack < packCount; ++pack) {
+            for (float& channel : channels[pack]) {
+                channel += step(random);
+            }
+            uint32_t packIndex = static_cast<uint32_t>(pack);
+            uint16_t frameBytes = static_cast<uint16_t>(encoders[pack].encode(channels[pack], record + headerBytes));
+            std::memcpy(record, &packIndex, sizeof(packIndex));
+            std::memcpy(record + sizeof(packIndex), &frameBytes, sizeof(frameBytes));
+            // Every 16th call is timed, to keep the clock reads from dominating the loop
+            if (++records % 16 == 0) {
+                auto writeStart = std::chrono::steady_clock::now();
+                sink.write(record, headerBytes + frameBytes);
+                float elapsed_ns = std::chrono::duration<float, std::nano>(std::chrono::steady_clock::now() - writeStart).count();
+                latency_ns.add(elapsed_ns);
+                maxLatency_ns = std::max(maxLatency_ns, elapsed_ns);
+            } else {
+                sink.write(record, headerBytes + frameBytes);
+            }
+        }
+    }
+    SinkBackend usedBackend = sink.getBackend();
+    uint8_t usedOptions = sink.getOptions();
+    uint64_t offeredBytes = sink.getAcceptedBytes() + sink.getDroppedBytes();
+    sink.close();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    std::remove(ASYNC_SINK_BENCH_FILE_PATH);
+
+    std::string label = toString(usedBackend);
+    label += (usedOptions & ASYNC_SINK_DIRECT_IO) ? ", O_DIRECT" : ", buffered";
+    label += (usedOptions & ASYNC_SINK_REGISTERED_BUFFERS) ? ", registered buffers" : "";
+    std::cout << std::left << std::setw(44) << label << std::right << std::fixed << std::setprecision(1)
+              << static_cast<double>(sink.getWrittenBytes()) / elapsed.count() / 1e6 << " MB/s written, "
+              << records / elapsed.count() / 1e6 << "M records/s offered, "
+              << (offeredBytes > 0 ? 100.0 * sink.getDroppedBytes() / offeredBytes : 0.0) << "% dropped, "
+              << sink.getErrorCount() << " errors | write() p50 " << std::setprecision(0) << latency_ns.quantile(0.5f)
+              << "ns p99 " << latency_ns.quantile(0.99f) << "ns max " << maxLatency_ns / 1000.0f << "us" << std::endl;
+}
+
+/**
+ * @brief Benchmarks the file sink backends with many packs recording telemetry at once.
+ * @param packCount Number of recording packs.
+ * @return Process exit code.
+ */
+static int runSinkBenchmark(size_t packCount) {
+    if (packCount == 0) {
+        std::cerr << "[ERROR] The sink benchmark needs at least one pack" << std::endl;
+        return 1;
+    }
+    std::cout << "[LOG] File sink, " << packCount << " packs recording telemetry for "
+              << ASYNC_SINK_BENCH_SECONDS << "s per configuration:" << std::endl;
+    benchSink(packCount, SinkBackend::IO_URING, 0);
+    benchSink(packCount, SinkBackend::IO_URING, ASYNC_SINK_DIRECT_IO | ASYNC_SINK_REGISTERED_BUFFERS);
+    benchSink(packCount, SinkBackend::THREAD_POOL, 0);
+    benchSink(packCount, SinkBackend::THREAD_POOL, ASYNC_SINK_DIRECT_IO);
+    return 0;
+}
+
+/**
+ * @brief Runs the thermal model through the benchmark drive cycle and prints a row.
+ * Every second the cells are read under the cycle's current, the thermal manager is
+ * updated and, when controlled, its duties drive the coolant loop; the uncontrolled run
+ * leaves the pump, fan and heater off. Every cell carries the cycle current, as one
+ * series string does.
+ * @param ambient_C Ambient temperature in Celsius.
+ * @param controlled True to apply the thermal manager's duties to the coolant loop.
+ * @return Time the hottest cell spent above MAX_TEMP_WARNING (seconds).
+ */
+static double benchThermal(float ambient_C, bool controlled) {
+    SimulatedCellBank bank(NUM_CELLS, CellVariability(), THERMAL_BENCH_SECONDS);
+    bank.setAmbientTemperature_C(ambient_C);
+    ThermalManager thermalManager;
+    std::array<BatteryCell, NUM_CELLS> cells;
+    const uint32_t cycle_s = THERMAL_BENCH_ACCELERATION_S + THERMAL_BENCH_CRUISE_S + THERMAL_BENCH_REGENERATION_S;
+    float maxTemperature_C = ambient_C;
+    for (uint32_t t = 0; t < THERMAL_BENCH_SECONDS; ++t) {
+        uint32_t phase_s = t % cycle_s;
+        float current_A = phase_s < THERMAL_BENCH_ACCELERATION_S ? THERMAL_BENCH_ACCELERATION_A
+                        : phase_s < THERMAL_BENCH_ACCELERATION_S + THERMAL_BENCH_CRUISE_S ? THERMAL_BENCH_CRUISE_A
+                        : THERMAL_BENCH_REGENERATION_A;
+        for (uint8_t i = 0; i < NUM_CELLS; ++i) {
+            cells[i] = BatteryCell(i, bank.getTerminalVoltage(i, current_A), bank.getTemperatures_C()[i]);
+            maxTemperature_C = std::max(maxTemperature_C, bank.getTemperatures_C()[i]);
+        }
+        thermalManager.update(cells, 1.0f);
+        if (controlled) {
+            bank.setThermalActuators(thermalManager.getCoolingDuty(), thermalManager.getHeaterDuty());
+        }
+        bank.advance(current_A, 1.0f);
+    }
+    double above_s = thermalManager.getTimeAboveWarning_s();
+    std::cout << std::setw(5) << std::fixed << std::setprecision(0) << ambient_C << "C ambient, "
+              << std::left << std::setw(12) << (controlled ? "controlled" : "uncontrolled") << std::right
+              << " | above " << MAX_TEMP_WARNING << "C for " << above_s << "s of " << thermalManager.getMonitoredTime_s()
+              << "s (" << std::setprecision(1) << 100.0 * above_s / thermalManager.getMonitoredTime_s()
+              << "%) | hottest cell " << maxTemperature_C << "C" << std::endl;
+    return above_s;
+}
+
+/**
+ * @brief Measures how long preconditioning takes to bring cold cells into the charging window and prints a row.
+ * @param ambient_C Ambient temperature in Celsius.
+ */
+static void benchPreconditioning(float ambient_C) {
+    SimulatedCellBank bank(NUM_CELLS, CellVariability(), THERMAL_BENCH_SECONDS);
+    bank.setAmbientTemperature_C(ambient_C);
+    ThermalManager thermalManager;
+    thermalManager.setPreconditioning(true);
+    std::array<BatteryCell, NUM_CELLS> cells;
+    uint32_t t = 0;
+    for (; t < THERMAL_BENCH_SECONDS && !thermalManager.isInChargingWindow(); ++t) {
+        for (uint8_t i = 0; i < NUM_CELLS; ++i) {
+            cells[i] = BatteryCell(i, bank.getOpenCircuitVoltage(i), bank.getTemperatures_C()[i]);
+        }
+        thermalManager.update(cells, 1.0f);
+        bank.setThermalActuators(thermalManager.getCoolingDuty(), thermalManager.getHeaterDuty());
+        bank.advance(0.0f, 1.0f);
+    }
+    std::cout << std::setw(5) << std::fixed << std::setprecision(0) << ambient_C << "C ambient, preconditioning | ";
+    if (thermalManager.isInChargingWindow()) {
+        std::cout << "in the charging window after " << t << "s" << std::endl;
+    } else {
+        std::cout << "not in the charging window after " << t << "s" << std::endl;
+    }
+}
+
+/**
+ * @brief Benchmarks the thermal manager against an uncontrolled coolant loop under aggressive drive cycles.
+ * @return Process exit code.
+ */
+static int runThermalBenchmark() {
+    std::cout << "[LOG] Thermal management, " << THERMAL_BENCH_SECONDS << "s of drive cycles ("
+              << THERMAL_BENCH_ACCELERATION_S << "s at " << THERMAL_BENCH_ACCELERATION_A << "A, "
+              << THERMAL_BENCH_CRUISE_S << "s at " << THERMAL_BENCH_CRUISE_A << "A, "
+              << THERMAL_BENCH_REGENERATION_S << "s at " << THERMAL_BENCH_REGENERATION_A << "A per cell):" << std::endl;
+    const float ambients_C[2] = {25.0f, 35.0f};
+    for (float ambient_C : ambients_C) {
+        double uncontrolled_s = benchThermal(ambient_C, false);
+        double controlled_s = benchThermal(ambient_C, true);
+        std::cout << "       control avoids " << std::setprecision(0) << uncontrolled_s - controlled_s
+                  << "s above the warning temperature" << std::endl;
+    }
+    benchPreconditioning(-10.0f);
+    return 0;
+}
+
+/**
+ * @brief Temperatures of the integrator benchmark's reference solution.
+ */
+struct ReferenceTemperatures {
+    std::array<double, NUM_CELLS> cells_C; // Cell temperatures
+    double coolant_C;                      // Coolant temperature
+};
+
+/**
+ * @brief Computes the temperature derivatives of a bank of mean-parameter cells.
+ * The same heat balance as SimulatedCellBank with the pump and fan at full duty and the
+ * heater off, in double precision.
+ * @param state The temperatures.
+ * @param current_A Current through every cell in Amperes.
+ * @param derivatives Output, derivative of each temperature (K/s).
+ */
+static void referenceDerivatives(const ReferenceTemperatures& state, double current_A, ReferenceTemperatures& derivatives) {
+    const double heatTransfer_WPerK = SIM_CELL_HEAT_TRANSFER_W_PER_K * (1.0 + SIM_PUMP_TRANSFER_GAIN);
+    double heatToCoolant_W = 0.0;
+    for (size_t i = 0; i < NUM_CELLS; ++i) {
+        double toCoolant_W = heatTransfer_WPerK * (state.cells_C[i] - state.coolant_C);
+        derivatives.cells_C[i] = (current_A * current_A * SIM_CELL_RESISTANCE_OHM - toCoolant_W) / SIM_CELL_THERMAL_MASS_J_PER_K;
+        heatToCoolant_W += toCoolant_W;
+    }
+    double radiator_WPerK = NUM_CELLS * (static_cast<double>(SIM_RADIATOR_W_PER_K) + SIM_FAN_W_PER_K);
+    derivatives.coolant_C = (heatToCoolant_W - radiator_WPerK * (state.coolant_C - SIM_AMBIENT_TEMP_C))
+                          / (NUM_CELLS * static_cast<double>(SIM_COOLANT_THERMAL_MASS_J_PER_K));
+}
+
+/**
+ * @brief Advances the reference solution by one classic fourth-order Runge-Kutta step.
+ * @param state The temperatures, advanced in place.
+ * @param current_A Current through every cell in Amperes.
+ * @param deltaTime_s The step in seconds.
+ */
+static void referenceStep(ReferenceTemperatures& state, double current_A, double deltaTime_s) {
+    auto along = [&state](const ReferenceTemperatures& slope, double scale) {
+        ReferenceTemperatures point;
+        for (size_t i = 0; i < NUM_CELLS; ++i) {
+            point.cells_C[i] = state.cells_C[i] + scale * slope.cells_C[i];
+        }
+        point.coolant_C = state.coolant_C + scale * slope.coolant_C;
+        return point;
+    };
+    ReferenceTemperatures k1, k2, k3, k4;
+    referenceDerivatives(state, current_A, k1);
+    referenceDerivatives(along(k1, deltaTime_s / 2.0), current_A, k2);
+    referenceDerivatives(along(k2, deltaTime_s / 2.0), current_A, k3);
+    referenceDerivatives(along(k3, deltaTime_s), current_A, k4);
+    for (size_t i = 0; i < NUM_CELLS; ++i) {
+        state.cells_C[i] += deltaTime_s / 6.0 * (k1.cells_C[i] + 2.0 * k2.cells_C[i] + 2.0 * k3.cells_C[i] + k4.cells_C[i]);
+    }
+    state.coolant_C += deltaTime_s / 6.0 * (k1.coolant_C + 2.0 * k2.coolant_C + 2.0 * k3.coolant_C + k4.coolant_C);
+}
+
+/**
+ * @brief Gets the cell current of the integrator benchmark at a time.
+ * @param time_s Time since the start of the run in seconds.
+ * @return Current through every cell in Amperes.
+ */
+static float integratorBenchCurrent_A(uint32_t time_s) {
+    return time_s < INTEGRATOR_BENCH_LOAD_S ? INTEGRATOR_BENCH_CURRENT_A : 0.0f;
+}
+
+/**
+ * @brief Runs one integrator at one step length through the benchmark load and prints a row.
+ * The accuracy is the largest deviation of a cell temperature from the reference solution
+ * at the end of any step, with mean-parameter cells and the coolant loop at full duty; the
+ * cost is timed over INTEGRATOR_BENCH_BANKS banks with the default variability.
+ * @param adaptive True for advanceAdaptive(), false for the forward Euler advance().
+ * @param step_s Step length in seconds; must divide INTEGRATOR_BENCH_SECONDS and INTEGRATOR_BENCH_LOAD_S.
+ */
+static void benchIntegrator(bool adaptive, uint32_t step_s) {
+    CellVariability meanCells;
+    meanCells.capacity_mAh.stddev = 0.0f;
+    meanCells.resistance_Ohm.stddev = 0.0f;
+    meanCells.selfDischarge_percentPerDay.stddev = 0.0f;
+    meanCells.thermalMass_JPerK.stddev = 0.0f;
+    SimulatedCellBank bank(NUM_CELLS, meanCells, 1);
+    bank.setThermalActuators(1.0f, 0.0f);
+    ReferenceTemperatures reference;
+    reference.cells_C.fill(SIM_AMBIENT_TEMP_C);
+    reference.coolant_C = SIM_AMBIENT_TEMP_C;
+    const long referenceSteps = std::lround(step_s / INTEGRATOR_BENCH_REFERENCE_STEP_S);
+
+    float maxError_C = 0.0f;
+    uint64_t substeps = 0;
+    for (uint32_t t = 0; t < INTEGRATOR_BENCH_SECONDS; t += step_s) {
+        float current_A = integratorBenchCurrent_A(t);
+        if (adaptive) {
+            substeps += bank.advanceAdaptive(current_A, static_cast<float>(step_s));
+        } else {
+            bank.advance(current_A, static_cast<float>(step_s));
+            ++substeps;
+        }
+        for (long k = 0; k < referenceSteps; ++k) {
+            referenceStep(reference, current_A, INTEGRATOR_BENCH_REFERENCE_STEP_S);
+        }
+        for (size_t i = 0; i < NUM_CELLS; ++i) {
+            float error_C = static_cast<float>(std::fabs(bank.getTemperatures_C()[i] - reference.cells_C[i]));
+            maxError_C = std::isfinite(error_C) ? std::max(maxError_C, error_C) : INTEGRATOR_BENCH_DIVERGED_C;
+        }
+    }
+
+    std::vector<SimulatedCellBank> banks;
+    banks.reserve(INTEGRATOR_BENCH_BANKS);
+    for (uint32_t b = 0; b < INTEGRATOR_BENCH_BANKS; ++b) {
+        banks.emplace_back(NUM_CELLS, CellVariability(), b);
+        banks.back().setThermalActuators(1.0f, 0.0f);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (SimulatedCellBank& timed : banks) {
+        for (uint32_t t = 0; t < INTEGRATOR_BENCH_SECONDS; t += step_s) {
+            if (adaptive) {
+                timed.advanceAdaptive(integratorBenchCurrent_A(t), static_cast<float>(step_s));
+            } else {
+                timed.advance(integratorBenchCurrent_A(t), static_cast<float>(step_s));
+            }
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    float checksum = 0.0f;
+    for (const SimulatedCellBank& timed : banks) {
+        checksum += timed.getTemperatures_C()[0];
+    }
+    g_benchmarkSink = checksum;
+
+    std::cout << std::left << std::setw(9) << (adaptive ? "adaptive" : "euler") << std::right
+              << " step " << std::setw(4) << step_s << "s | " << std::setw(5) << substeps << " substeps | "
+              << std::setw(7) << std::fixed << std::setprecision(2) << elapsed.count() / INTEGRATOR_BENCH_BANKS
+              << " us per bank | max error ";
+    if (maxError_C < INTEGRATOR_BENCH_DIVERGED_C) {
+        std::cout << std::setprecision(4) << maxError_C << " K" << std::endl;
+    } else {
+        std::cout << "diverged" << std::endl;
+    }
+}
+
+/**
+ * @brief Compares the forward Euler and the adaptive cell integrators for speed and accuracy over a range of step lengths.
+ * @return Process exit code.
+ */
+static int runIntegratorBenchmark() {
+    std::cout << "[LOG] Cell integrators, " << INTEGRATOR_BENCH_LOAD_S << "s at " << INTEGRATOR_BENCH_CURRENT_A
+              << "A per cell then rest, " << INTEGRATOR_BENCH_SECONDS << "s in total, against an RK4 reference at "
+              << INTEGRATOR_BENCH_REFERENCE_STEP_S << "s:" << std::endl;
+    const uint32_t steps_s[7] = {1, 5, 10, 30, 60, 300, 900};
+    for (bool adaptive : {false, true}) {
+        for (uint32_t step_s : steps_s) {
+            benchIntegrator(adaptive, step_s);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Measures the trip latency of the short-circuit detector for one fault onset.
+ * The samples step from SHORT_CIRCUIT_BENCH_LOAD_A to SHORT_CIRCUIT_BENCH_FAULT_A at the
+ * onset and are checked in spans of checkSamples, as they would become available.
+ * @param onset Index of the first fault sample within the first block.
+ * @param checkSamples Samples per check; a multiple of CURRENT_KERNEL_LANES.
+ * @return Samples from the first fault sample to the trip.
+ */
+static uint32_t shortCircuitLatency(uint32_t onset, uint32_t checkSamples) {
+    std::array<float, 2 * CURRENT_BLOCK_SAMPLES> samples;
+    for (uint32_t i = 0; i < samples.size(); ++i) {
+        samples[i] = i < onset ? SHORT_CIRCUIT_BENCH_LOAD_A : SHORT_CIRCUIT_BENCH_FAULT_A;
+    }
+    ShortCircuitDetector detector;
+    for (uint32_t i = 0; i < samples.size() && !detector.isTripped(); i += checkSamples) {
+        detector.checkBlock(samples.data() + i, checkSamples);
+    }
+    return detector.getTripLatency_samples();
+}
+
+/**
+ * @brief Times the short-circuit detector at one check granularity and prints a row.
+ * The latency is taken over every onset within a block; the screening cost is the time
+ * to pass one block of normal samples.
+ * @param checkSamples Samples per check; a multiple of CURRENT_KERNEL_LANES.
+ */
+static void benchShortCircuitGranularity(uint32_t checkSamples) {
+    uint64_t latencySum_samples = 0;
+    uint32_t maxLatency_samples = 0;
+    for (uint32_t onset = 0; onset < CURRENT_BLOCK_SAMPLES; ++onset) {
+        uint32_t latency_samples = shortCircuitLatency(onset, checkSamples);
+        latencySum_samples += latency_samples;
+        maxLatency_samples = std::max(maxLatency_samples, latency_samples);
+    }
+    double meanLatency_samples = static_cast<double>(latencySum_samples) / CURRENT_BLOCK_SAMPLES;
+
+    CurrentSampleBlock normal;
+    normal.current_A.fill(SHORT_CIRCUIT_BENCH_LOAD_A);
+    ShortCircuitDetector detector;
+    uint32_t trips = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t b = 0; b < SHORT_CIRCUIT_BENCH_BLOCKS; ++b) {
+        for (uint32_t i = 0; i < CURRENT_BLOCK_SAMPLES; i += checkSamples) {
+            trips += detector.checkBlock(normal.current_A.data() + i, checkSamples);
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    g_benchmarkSink = static_cast<float>(trips);
+
+    const double sampleInterval_ms = 1000.0 / CURRENT_SAMPLE_RATE_HZ;
+    std::cout << "Checked every " << std::setw(3) << checkSamples << " samples | latency mean "
+              << std::fixed << std::setprecision(1) << meanLatency_samples << " samples ("
+              << std::setprecision(2) << meanLatency_samples * sampleInterval_ms << "ms), max " << maxLatency_samples
+              << " samples (" << maxLatency_samples * sampleInterval_ms << "ms) | screen "
+              << std::setprecision(1) << elapsed.count() / SHORT_CIRCUIT_BENCH_BLOCKS << "ns per block" << std::endl;
+}
+
+/**
+ * @brief Benchmarks the short-circuit detector checked per block against per chunk.
+ * Also runs a short circuit through the simulated acquisition, which checks every chunk,
+ * and measures the charge the tripping block lets through before the contactor opens.
+ * @return Process exit code.
+ */
+static int runShortCircuitBenchmark() {
+    std::cout << "[LOG] Short-circuit detection, " << SHORT_CIRCUIT_BENCH_LOAD_A << "A stepping to "
+              << SHORT_CIRCUIT_BENCH_FAULT_A << "A at each position of a " << CURRENT_BLOCK_SAMPLES << "-sample block, "
+              << SHORT_CIRCUIT_DEBOUNCE_SAMPLES << " samples to debounce, " << CURRENT_SAMPLE_RATE_HZ << " Hz:" << std::endl;
+    benchShortCircuitGranularity(CURRENT_BLOCK_SAMPLES);
+    benchShortCircuitGranularity(CURRENT_KERNEL_LANES);
+
+    ShortCircuitDetector detector;
+    CurrentAcquisition acquisition;
+    acquisition.attachShortCircuitDetector(&detector);
+    acquisition.setLoadCurrent_A(SHORT_CIRCUIT_BENCH_FAULT_A);
+    acquisition.produceBlock();
+    DecimatedCurrent interval;
+    acquisition.drain(interval);
+    double blockAtFault_As = static_cast<double>(SHORT_CIRCUIT_BENCH_FAULT_A) * CURRENT_BLOCK_SAMPLES / CURRENT_SAMPLE_RATE_HZ;
+    std::cout << "Simulated acquisition | " << (detector.isTripped() ? "tripped" : "did not trip") << " after "
+              << detector.getTripLatency_samples() << " samples, contactor opened mid-block | "
+              << std::setprecision(3) << interval.charge_As << "As let through in the block instead of "
+              << blockAtFault_As << "As" << std::endl;
+    return detector.isTripped() ? 0 : 1;
+}
+
+/**
+ * @brief Measures what the sensor diagnostics add to the cost of a BMS update.
+ * Times DIAG_BENCH_TICKS updates of a single BMS (console output off), then the diagnostics
+ * alone on the readings of a second, identically seeded BMS; those are recorded first and
+ * replayed from a window of DIAG_BENCH_READINGS, so they stay in cache as they do in the
+ * BMS. Also counts how often the diagnostics reported a sensor fault and a pack-sum mismatch.
+ * @return Process exit code.
+ */
+static int runDiagnosticsBenchmark() {
+    const float deltaTime_s = static_cast<float>(BMS_UPDATE_INTERVAL_MS) / 1000.0f;
+    BMS timedBms;
+    timedBms.setConsoleOutput(false);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < DIAG_BENCH_TICKS; ++tick) {
+        timedBms.update(deltaTime_s);
+    }
+    double update_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / DIAG_BENCH_TICKS;
+
+    BMS recordedBms;
+    recordedBms.setConsoleOutput(false);
+    std::vector<std::array<BatteryCell, NUM_CELLS>> cells(DIAG_BENCH_READINGS);
+    std::vector<float> packVoltages(DIAG_BENCH_READINGS);
+    for (uint32_t reading = 0; reading < DIAG_BENCH_READINGS; ++reading) {
+        recordedBms.update(deltaTime_s);
+        cells[reading] = recordedBms.getCells();
+        packVoltages[reading] = recordedBms.getPackVoltage();
+    }
+    SensorDiagnostics diagnostics;
+    uint32_t sensorFaults = 0;
+    uint32_t mismatches = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < DIAG_BENCH_TICKS; ++tick) {
+        uint32_t reading = tick & (DIAG_BENCH_READINGS - 1);
+        diagnostics.update(cells[reading], packVoltages[reading]);
+        sensorFaults += diagnostics.hasSensorFault();
+        mismatches += diagnostics.isPackSumMismatch();
+    }
+    double diagnostics_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / DIAG_BENCH_TICKS;
+    g_benchmarkSink = static_cast<float>(sensorFaults + mismatches);
+
+    std::cout << "[LOG] Sensor diagnostics, " << DIAG_BENCH_TICKS << " updates of a " << static_cast<int>(NUM_CELLS) << "-cell pack:" << std::endl;
+    std::cout << "BMS update " << std::fixed << std::setprecision(1) << update_ns << "ns per tick | diagnostics "
+              << diagnostics_ns << "ns per tick (" << std::setprecision(2) << 100.0 * diagnostics_ns / update_ns
+              << "% of the update)" << std::endl;
+    std::cout << "Sensor fault reported in " << std::setprecision(3) << 100.0 * sensorFaults / DIAG_BENCH_TICKS
+              << "% of ticks, pack-sum mismatch in " << 100.0 * mismatches / DIAG_BENCH_TICKS << "%" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Measures the telemetry volume and reconstruction error on steady-state data.
+ * A simulated pack carries a constant TELEMETRY_BENCH_LOAD_A for TELEMETRY_BENCH_SECONDS
+ * at the update interval, read with the simulator's sensor noise (and the sample noise of
+ * the current sensor) but without injected faults; every frame is encoded and decoded again. Prints the bytes sent
+ * against full frames and, per channel group, the largest difference between the decoded
+ * and the encoded value next to the group's deadband.
+ * @return Process exit code: 0 if every reconstruction stayed within its deadband, 1 otherwise.
+ */
+static int runTelemetryBenchmark() {
+    const float deltaTime_s = static_cast<float>(BMS_UPDATE_INTERVAL_MS) / 1000.0f;
+    const uint32_t frames = static_cast<uint32_t>(TELEMETRY_BENCH_SECONDS / deltaTime_s);
+    SensorSimulator simulator;
+    simulator.setFaultInjection(false);
+    SplitMix64 random(frames);
+    std::uniform_real_distribution<float> currentNoise(-CURRENT_SAMPLE_NOISE_A, CURRENT_SAMPLE_NOISE_A);
+    TelemetryEncoder encoder;
+    TelemetryDecoder decoder;
+    TelemetryChannels channels;
+    TelemetryChannels decoded;
+    uint8_t frame[TELEMETRY_MAX_FRAME_BYTES];
+    TelemetryChannels maxError{};
+    float stateOfCharge_percent = SIM_CELL_INITIAL_SOC * 100.0f;
+    uint64_t sentBytes = 0;
+    uint32_t undecodable = 0;
+
+    for (uint32_t tick = 0; tick < frames; ++tick) {
+        std::array<float, NUM_PARALLEL_STRINGS> stringOcv_V;
+        std::array<float, NUM_PARALLEL_STRINGS> stringResistance_Ohm;
+        std::array<float, NUM_PARALLEL_STRINGS> stringCurrent_A;
+        simulator.getStringModel(stringOcv_V.data(), stringResistance_Ohm.data());
+        SensorSimulator::solveStringCurrents(1, &TELEMETRY_BENCH_LOAD_A, stringOcv_V.data(), stringResistance_Ohm.data(),
+                                             stringCurrent_A.data(), nullptr);
+        simulator.setStringCurrents(stringCurrent_A.data());
+        for (uint8_t i = 0; i < NUM_CELLS; ++i) {
+            channels[TELEMETRY_CHANNEL_VOLTAGE_BASE + i] = simulator.readVoltage(i);
+            channels[TELEMETRY_CHANNEL_TEMP_BASE + i] = simulator.readTemperature(i);
+        }
+        channels[TELEMETRY_CHANNEL_PACK_CURRENT] = TELEMETRY_BENCH_LOAD_A + currentNoise(random);
+        channels[TELEMETRY_CHANNEL_PACK_VOLTAGE] = simulator.readPackVoltage();
+        channels[TELEMETRY_CHANNEL_SOC] = stateOfCharge_percent;
+        simulator.step(deltaTime_s);
+        stateOfCharge_percent += TELEMETRY_BENCH_LOAD_A * deltaTime_s / 36.0f / (NOMINAL_CAPACITY_MAH * NUM_PARALLEL_STRINGS / 1000.0f);
+
+        size_t frameBytes = encoder.encode(channels, frame);
+        sentBytes += frameBytes;
+        if (!decoder.decode(frame, frameBytes, decoded)) {
+            ++undecodable;
+            continue;
+        }
+        for (uint16_t c = 0; c < TELEMETRY_CHANNEL_COUNT; ++c) {
+            maxError[c] = std::max(maxError[c], std::fabs(decoded[c] - channels[c]));
+        }
+    }
+
+    struct ChannelGroup {
+        const char* name;
+        uint16_t first;
+        uint16_t count;
+        float deadband;
+        const char* unit;
+    };
+    const ChannelGroup groups[] = {
+        {"cell voltage", TELEMETRY_CHANNEL_VOLTAGE_BASE, NUM_CELLS, TELEMETRY_VOLTAGE_DEADBAND_V, "V"},
+        {"cell temperature", TELEMETRY_CHANNEL_TEMP_BASE, NUM_CELLS, TELEMETRY_TEMP_DEADBAND_C, "C"},
+        {"pack current", TELEMETRY_CHANNEL_PACK_CURRENT, 1, TELEMETRY_CURRENT_DEADBAND_A, "A"},
+        {"pack voltage", TELEMETRY_CHANNEL_PACK_VOLTAGE, 1, TELEMETRY_PACK_VOLTAGE_DEADBAND_V, "V"},
+        {"SoC", TELEMETRY_CHANNEL_SOC, 1, TELEMETRY_SOC_DEADBAND_PERCENT, "%"},
+    };
+    uint64_t fullBytes = static_cast<uint64_t>(frames) * (TELEMETRY_HEADER_BYTES + sizeof(float) * TELEMETRY_CHANNEL_COUNT);
+    std::cout << "[LOG] Telemetry of a steady " << TELEMETRY_BENCH_LOAD_A << "A load, " << frames << " frames, keyframe every "
+              << TELEMETRY_KEYFRAME_INTERVAL << ":" << std::endl;
+    std::cout << sentBytes << " bytes sent, " << fullBytes << " bytes as full frames (" << std::fixed << std::setprecision(1)
+              << static_cast<double>(fullBytes) / sentBytes << "x less), " << undecodable << " frames not decodable" << std::endl;
+    bool withinDeadbands = undecodable == 0;
+    for (const ChannelGroup& group : groups) {
+        float groupError = 0.0f;
+        for (uint16_t c = group.first; c < group.first + group.count; ++c) {
+            groupError = std::max(groupError, maxError[c]);
+        }
+        withinDeadbands = withinDeadbands && groupError <= group.deadband;
+        std::cout << std::left << std::setw(16) << group.name << std::right << " | max reconstruction error "
+                  << std::setprecision(4) << groupError << group.unit << " of a " << group.deadband << group.unit
+                  << " deadband" << std::endl;
+    }
+    return withinDeadbands ? 0 : 1;
+}
+
+/**
+ * @brief Draws one randomized safety reading: a band limit, a NaN or a value spread over the ranges.
+ * @param random The random generator.
+ * @param limits The band limits of the reading, drawn exactly a quarter of the time.
+ * @param minValue Lower end of the spread.
+ * @param maxValue Upper end of the spread.
+ * @return The reading.
+ */
+template <size_t LimitCount>
+static float randomSafetyReading(SplitMix64& random, const float (&limits)[LimitCount], float minValue, float maxValue) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    float choice = unit(random);
+    if (choice < SAFETY_BENCH_NAN_SHARE) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    if (choice < 0.25f) {
+        return limits[static_cast<size_t>(unit(random) * LimitCount) % LimitCount];
+    }
+    return minValue + unit(random) * (maxValue - minValue);
+}
+
+/**
+ * @brief Replays frames through evaluate() one at a time, as evaluateBatch() must match.
+ * @param manager The manager to evaluate with.
+ * @param frames The frames.
+ * @param states Receives the state after every frame.
+ * @return Number of state transitions.
+ */
+static size_t evaluatePerFrame(SafetyManager& manager, const SafetyFrames& frames, std::vector<SystemState>& states) {
+    states.resize(frames.frameCount);
+    size_t transitions = 0;
+    std::array<BatteryCell, NUM_CELLS> cells;
+    for (size_t t = 0; t < frames.frameCount; ++t) {
+        for (uint8_t c = 0; c < NUM_CELLS; ++c) {
+            cells[c].setVoltage(frames.cellVoltages[t * NUM_CELLS + c]);
+            cells[c].setTemperature(frames.cellTemperatures[t * NUM_CELLS + c]);
+        }
+        manager.evaluate(cells, frames.packCurrents[t], frames.stateOfHealth_percent[t]);
+        states[t] = manager.getCurrentState();
+        transitions += manager.hasStateChanged();
+    }
+    return transitions;
+}
+
+/**
+ * @brief Checks the batch safety evaluation against evaluate() and measures its replay rate.
+ * First SAFETY_BENCH_RANDOM_FRAMES randomized frames (exact band limits, NaNs and values
+ * across and beyond every band) are evaluated both ways and compared frame by frame, along
+ * with the transition counts and the final states. Then SAFETY_BENCH_REPLAY_SECONDS of 1 Hz
+ * frames of a pack in normal use (noisy readings with occasional excursions) are replayed
+ * both ways and timed.
+ * @return Process exit code: 0 if both ways agree, 1 otherwise.
+ */
+static int runSafetyBenchmark() {
+    const float voltageLimits[] = {MIN_VOLTAGE_FAULT, MIN_VOLTAGE_CRITICAL, MIN_VOLTAGE_WARNING, MIN_VOLTAGE_NORMAL,
+                                   MAX_VOLTAGE_NORMAL, MAX_VOLTAGE_WARNING, MAX_VOLTAGE_CRITICAL, MAX_VOLTAGE_FAULT};
+    const float temperatureLimits[] = {MIN_TEMP_FAULT, MIN_TEMP_CRITICAL, MIN_TEMP_WARNING, MIN_TEMP_NORMAL,
+                                       MAX_TEMP_NORMAL, MAX_TEMP_WARNING, MAX_TEMP_CRITICAL, MAX_TEMP_FAULT};
+    const float currentLimits[] = {-MAX_DISCHARGE_CURRENT_CRITICAL_A, -MAX_DISCHARGE_CURRENT_WARNING_A,
+                                   MAX_CHARGE_CURRENT_WARNING_A, MAX_CHARGE_CURRENT_CRITICAL_A};
+    const float sohLimits[] = {SOH_THRESHOLD_CRITICAL, SOH_THRESHOLD_WARNING};
+
+    SplitMix64 random(SAFETY_BENCH_RANDOM_FRAMES);
+    std::vector<float> voltages(static_cast<size_t>(SAFETY_BENCH_RANDOM_FRAMES) * NUM_CELLS);
+    std::vector<float> temperatures(voltages.size());
+    std::vector<float> currents(SAFETY_BENCH_RANDOM_FRAMES);
+    std::vector<float> soh(SAFETY_BENCH_RANDOM_FRAMES);
+    for (size_t i = 0; i < voltages.size(); ++i) {
+        voltages[i] = randomSafetyReading(random, voltageLimits, MIN_VOLTAGE_FAULT - 0.5f, MAX_VOLTAGE_FAULT + 0.5f);
+        temperatures[i] = randomSafetyReading(random, temperatureLimits, MIN_TEMP_FAULT - 10.0f, MAX_TEMP_FAULT + 10.0f);
+    }
+    for (size_t t = 0; t < currents.size(); ++t) {
+        currents[t] = randomSafetyReading(random, currentLimits, -2.0f * MAX_DISCHARGE_CURRENT_CRITICAL_A,
+                                          2.0f * MAX_CHARGE_CURRENT_CRITICAL_A);
+        soh[t] = randomSafetyReading(random, sohLimits, 40.0f, 100.0f);
+    }
+    SafetyFrames frames{currents.size(), voltages.data(), temperatures.data(), currents.data(), soh.data()};
+
+    SafetyManager batchManager;
+    SafetyManager frameManager;
+    std::vector<SystemState> batchStates;
+    std::vector<SystemState> frameStates;
+    size_t batchTransitions = batchManager.evaluateBatch(frames, batchStates);
+    size_t frameTransitions = evaluatePerFrame(frameManager, frames, frameStates);
+    size_t mismatches = 0;
+    for (size_t t = 0; t < frames.frameCount; ++t) {
+        mismatches += batchStates[t] != frameStates[t];
+    }
+    bool agree = mismatches == 0 && batchTransitions == frameTransitions
+                 && batchManager.getCurrentState() == frameManager.getCurrentState()
+                 && batchManager.getPreviousState() == frameManager.getPreviousState();
+    std::cout << "[LOG] Batch safety evaluation against evaluate() on " << frames.frameCount << " randomized "
+              << static_cast<int>(NUM_CELLS) << "-cell frames:" << std::endl;
+    std::cout << mismatches << " mismatched states, " << batchTransitions << " vs " << frameTransitions
+              << " transitions, final state " << toString(batchManager.getCurrentState()) << " vs "
+              << toString(frameManager.getCurrentState()) << std::endl;
+
+    // A month of 1 Hz frames of a pack in normal use: noisy readings, occasional excursions
+    std::normal_distribution<float> voltageNoise(3.7f, 0.05f);
+    std::normal_distribution<float> temperatureNoise(30.0f, 3.0f);
+    std::normal_distribution<float> load(-5.0f, 4.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    voltages.resize(static_cast<size_t>(SAFETY_BENCH_REPLAY_SECONDS) * NUM_CELLS);
+    temperatures.resize(voltages.size());
+    currents.resize(SAFETY_BENCH_REPLAY_SECONDS);
+    soh.resize(SAFETY_BENCH_REPLAY_SECONDS);
+    for (size_t i = 0; i < voltages.size(); ++i) {
+        voltages[i] = unit(random) < SIM_FAULT_PROBABILITY ? MAX_VOLTAGE_WARNING + 0.01f : voltageNoise(random);
+        temperatures[i] = temperatureNoise(random);
+    }
+    for (size_t t = 0; t < currents.size(); ++t) {
+        currents[t] = load(random);
+        soh[t] = 95.0f;
+    }
+    frames = SafetyFrames{currents.size(), voltages.data(), temperatures.data(), currents.data(), soh.data()};
+
+    auto start = std::chrono::steady_clock::now();
+    size_t replayTransitions = batchManager.evaluateBatch(frames, batchStates);
+    double batch_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    size_t perFrameTransitions = evaluatePerFrame(frameManager, frames, frameStates);
+    double perFrame_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    agree = agree && replayTransitions == perFrameTransitions && batchStates == frameStates;
+    g_benchmarkSink = static_cast<float>(replayTransitions + perFrameTransitions);
+
+    std::cout << "[LOG] Replay of " << SAFETY_BENCH_REPLAY_SECONDS / 86400 << " days of 1 Hz frames (" << frames.frameCount
+              << " frames, " << replayTransitions << " transitions):" << std::endl;
+    std::cout << "evaluateBatch() " << std::fixed << std::setprecision(1) << batch_ms << "ms ("
+              << std::setprecision(0) << frames.frameCount / batch_ms / 1000.0 << "M frames/s) | evaluate() per frame "
+              << std::setprecision(1) << perFrame_ms << "ms (" << std::setprecision(0)
+              << frames.frameCount / perFrame_ms / 1000.0 << "M frames/s)" << std::endl;
+    std::cout << (agree ? "[LOG] Batch and per-frame evaluation agree." : "[ERROR] Batch and per-frame evaluation differ.")
+              << std::endl;
+    return agree ? 0 : 1;
+}
+
+/**
+ * @brief Generates a synthetic ECM trace of cells with known parameters.
+ * The cells spread around the nominal cell (capacity and R0 as the simulated cell bank
+ * spreads them, R1 and the RC time constant by +-50%) and start between 30% and 70% SoC.
+ * The current is held for ECM_BENCH_SEGMENT_MIN_S to ECM_BENCH_SEGMENT_MAX_S at a time:
+ * rest, a discharge of up to 1C or a charge of up to C/2, steered so the nominal cell stays
+ * between 20% and 80% SoC. The voltages are the model's plus ECM_BENCH_NOISE_V of noise.
+ * @param random The random generator.
+ * @param trace Output trace.
+ * @param truth Output, the parameters of every cell.
+ */
+static void generateEcmTrace(SplitMix64& random, EcmTrace& trace, std::vector<EcmParameters>& truth) {
+    std::normal_distribution<float> spread(0.0f, 1.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    truth.resize(ECM_BENCH_CELLS);
+    for (EcmParameters& cell : truth) {
+        cell.r0_Ohm = SIM_CELL_RESISTANCE_OHM * (1.0f + SIM_CELL_RESISTANCE_SPREAD * spread(random));
+        cell.r1_Ohm = ECM_FIT_INITIAL_R1_OHM * (0.5f + unit(random));
+        cell.c1_F = ECM_FIT_INITIAL_TAU_S * (0.5f + unit(random)) / cell.r1_Ohm;
+        cell.capacity_mAh = NOMINAL_CAPACITY_MAH * (1.0f + SIM_CELL_CAPACITY_SPREAD * spread(random));
+        cell.initialSoc = 0.3f + 0.4f * unit(random);
+        cell.rmsError_V = 0.0f;
+    }
+
+    trace.deltaTime_s = 1.0f;
+    trace.cellCount = ECM_BENCH_CELLS;
+    trace.current_A.resize(ECM_BENCH_SAMPLES);
+    const float oneC_A = NOMINAL_CAPACITY_MAH / 1000.0f;
+    float soc = 0.5f;
+    for (uint32_t t = 0; t < ECM_BENCH_SAMPLES;) {
+        uint32_t length = ECM_BENCH_SEGMENT_MIN_S
+                        + static_cast<uint32_t>(unit(random) * (ECM_BENCH_SEGMENT_MAX_S - ECM_BENCH_SEGMENT_MIN_S));
+        float choice = unit(random);
+        float current_A = 0.0f;
+        if (soc > 0.8f || (soc >= 0.2f && choice < 0.4f)) {
+            current_A = -oneC_A * unit(random);
+        } else if (soc < 0.2f || choice < 0.8f) {
+            current_A = 0.5f * oneC_A * unit(random);
+        }
+        for (uint32_t end = std::min(t + length, ECM_BENCH_SAMPLES); t < end; ++t) {
+            trace.current_A[t] = current_A;
+        }
+        soc += current_A * length * trace.deltaTime_s / (NOMINAL_CAPACITY_MAH * 3.6f);
+    }
+
+    EcmIdentifier::simulate(trace, truth, trace.cellVoltages_V);
+    for (float& voltage : trace.cellVoltages_V) {
+        voltage += ECM_BENCH_NOISE_V * spread(random);
+    }
+}
+
+/**
+ * @brief Benchmarks the ECM identification on a synthetic trace with known parameters.
+ * Fits the trace of generateEcmTrace() on every hardware thread and then on one, and prints the
+ * time of each and the worst relative error of every fitted parameter.
+ * @param tracePath If not null, the synthetic trace is also written there for --fit-ecm.
+ * @return Process exit code.
+ */
+static int runEcmBenchmark(const char* tracePath) {
+    SplitMix64 random(ECM_BENCH_CELLS);
+    EcmTrace trace;
+    std::vector<EcmParameters> truth;
+    generateEcmTrace(random, trace, truth);
+    if (tracePath != nullptr) {
+        if (!EcmIdentifier::saveTrace(tracePath, trace)) {
+            std::cerr << "[ERROR] Could not write " << tracePath << std::endl;
+            return 1;
+        }
+        std::cout << "[LOG] Wrote the synthetic trace to " << tracePath << std::endl;
+    }
+
+    std::cout << "[LOG] ECM identification of " << ECM_BENCH_CELLS << " cells over " << ECM_BENCH_SAMPLES
+              << " samples at 1 Hz, " << ECM_BENCH_NOISE_V * 1000.0f << "mV noise:" << std::endl;
+    const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threadCount = hardwareThreads; threadCount >= 1; threadCount = (threadCount > 1 ? 1 : 0)) {
+        EcmIdentifier identifier(threadCount);
+        std::vector<EcmParameters> fitted;
+        auto start = std::chrono::steady_clock::now();
+        identifier.fit(trace, fitted);
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+        float r0Error = 0.0f;
+        float r1Error = 0.0f;
+        float c1Error = 0.0f;
+        float capacityError = 0.0f;
+        for (size_t c = 0; c < fitted.size(); ++c) {
+            r0Error = std::max(r0Error, std::fabs(fitted[c].r0_Ohm / truth[c].r0_Ohm - 1.0f));
+            r1Error = std::max(r1Error, std::fabs(fitted[c].r1_Ohm / truth[c].r1_Ohm - 1.0f));
+            c1Error = std::max(c1Error, std::fabs(fitted[c].c1_F / truth[c].c1_F - 1.0f));
+            capacityError = std::max(capacityError, std::fabs(fitted[c].capacity_mAh / truth[c].capacity_mAh - 1.0f));
+        }
+        std::cout << std::setw(2) << threadCount << " threads | " << std::fixed << std::setprecision(1) << elapsed.count() << "ms | worst relative error R0 "
+                  << std::setprecision(2) << 100.0f * r0Error << "%, R1 " << 100.0f * r1Error << "%, C1 "
+                  << 100.0f * c1Error << "%, capacity " << std::setprecision(3) << 100.0f * capacityError << "%" << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * @brief Main entry point of the BMS prototype application.
+ * Without arguments, initializes a single BMS and runs its update loop.
+ * With "--fleet <packs>", simulates a fleet of packs instead; "--fleet <packs> --pack-major"
+ * runs the fleet's estimators in pack-major mode.
+ * With "--lifetime <packs> <days>", simulates the usage of a fleet over that many days
+ * with event-driven stepping; "--fixed-step" evaluates every time step instead, and
+ * "--compare" runs both and checks that their safety outcomes agree.
+ * With "--fit-ecm <trace.csv> [<output>]", identifies the cell parameters of a recorded
+ * trace and writes them to the output (ECM_PARAMETER_FILE_PATH by default), where the
+ * other modes pick them up at startup.
+ * With "--dashboard", shows the single BMS on a live terminal dashboard.
+ * With "--bench-sketch", measures the accuracy and merge cost of the fleet quantile sketches.
+ * With "--bench-cells", times the compiled cell kernels of every supported pack size
+ * against the generic loops.
+ * With "--bench-sink <packs>", measures the sustained write rate of the file sink
+ * backends with that many packs recording telemetry at once.
+ * With "--bench-bands", times the band lookup table against the compare kernels on
+ * frames of ADC codes.
+ * With "--bench-thermal", measures the time the cells spend above MAX_TEMP_WARNING under
+ * aggressive drive cycles with and without thermal management.
+ * With "--bench-integrator", compares the forward Euler and the adaptive cell integrators
+ * for speed and accuracy at step lengths from 1s to 15 minutes.
+ * With "--bench-diagnostics", measures the share of the sensor diagnostics in the cost of
+ * a BMS update.
+ * With "--bench-short-circuit", measures the latency of the short-circuit detector
+ * checked per block and per chunk of samples.
+ * With "--bench-telemetry", measures the telemetry compression and reconstruction error
+ * on steady-state data.
+ * With "--bench-safety", checks the batch safety evaluation against evaluate() and
+ * measures its replay rate.
+ * With "--bench-ecm [<trace.csv>]", fits a synthetic trace of cells with known parameters
+ * and reports the time and the parameter errors; the trace is also written to the file,
+ * if given, for --fit-ecm.
+ */
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && std::strcmp(argv[1], "--dashboard") == 0) {
+        return runDashboard();
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--fleet") == 0) {
+        bool packMajor = argc >= 4 && std::strcmp(argv[3], "--pack-major") == 0;
+        return runFleet(std::strtoul(argv[2], nullptr, 10), packMajor ? FleetExecution::PACK_MAJOR : FleetExecution::PER_PACK);
+    }
+    if (argc >= 4 && std::strcmp(argv[1], "--lifetime") == 0) {
+        if (argc >= 5 && std::strcmp(argv[4], "--compare") == 0) {
+            return runLifetimeComparison(std::strtoul(argv[2], nullptr, 10), std::strtoull(argv[3], nullptr, 10));
+        }
+        bool fixedStep = argc >= 5 && std::strcmp(argv[4], "--fixed-step") == 0;
+        return runLifetime(std::strtoul(argv[2], nullptr, 10), std::strtoull(argv[3], nullptr, 10),
+                           fixedStep ? SimulationStepping::FIXED_STEP : SimulationStepping::EVENT_DRIVEN);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--fit-ecm") == 0) {
+        return runEcmFit(argv[2], argc >= 4 ? argv[3] : ECM_PARAMETER_FILE_PATH);
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--bench-sketch") == 0) {
+        return runSketchBenchmark();
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--bench-cells") == 0) {
+        return runCellKernelBenchmark();
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--bench-sink") == 0) {
+        return runSinkBenchmark(std::strtoul(argv[2], nullptr, 10));
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--bench-bands") == 0) {
+        return runBandBenchmark();
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--bench-diagnostics") == 0) {
+        return runDiagnosticsBenchmark();
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--bench-ecm") == 0) {
+        return runEcmBenchmark(argc >= 3 ? argv[2] : nullptr);
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--bench-safety") == 0) {
+        return runSafetyBenchmark();
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--bench-telemetry") == 0) {
+        return runTelemetryBenchmark();
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--bench-short-circuit") == 0) {
+        return runShortCircuitBenchmark();
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--bench-integrator") == 0) {
+        return runIntegratorBenchmark();
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--bench-thermal") == 0) {
+        return runThermalBenchmark();
+    }
+    return runSinglePack();
+}